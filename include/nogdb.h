@@ -22,6 +22,7 @@
 #ifndef __NOGDB_H_INCLUDED_
 #define __NOGDB_H_INCLUDED_
 
+#include <functional>
 #include <iostream>
 #include <map>
 #include <vector>
@@ -76,7 +77,23 @@ namespace nogdb {
         static void
         createIndex(Txn &txn, const std::string &className, const std::string &propertyName, bool isUnique = false);
 
+        // build an index from a snapshot in read-only txns and only take the writer lock to write the index
+        // together with records which have been changed since the snapshot
+        static void createIndex(Context &ctx, const std::string &className, const std::string &propertyName,
+                                bool isUnique = false);
+
         static void dropIndex(Txn &txn, const std::string &className, const std::string &propertyName);
+
+        static void createCompositeIndex(Txn &txn, const std::string &className,
+                                         const std::vector<std::string> &propertyNames, bool isUnique = false);
+
+        static void
+        dropCompositeIndex(Txn &txn, const std::string &className, const std::vector<std::string> &propertyNames);
+
+    private:
+        // validate and add an index whose entries are written by addEntries(indexId, type) in the same txn
+        static void createIndex(Txn &txn, const std::string &className, const std::string &propertyName, bool isUnique,
+                                const std::function<void(IndexId, PropertyType)> &addEntries);
     };
 
     //*************************************************************
@@ -90,6 +107,9 @@ namespace nogdb {
 
         static const RecordDescriptor create(Txn &txn, const std::string &className, const Record &record = Record{});
 
+        static std::vector<RecordDescriptor>
+        createBatch(Txn &txn, const std::string &className, const std::vector<Record> &records);
+
         static void update(Txn &txn, const RecordDescriptor &recordDescriptor, const Record &record);
 
         static void destroy(Txn &txn, const RecordDescriptor &recordDescriptor);
@@ -98,8 +118,14 @@ namespace nogdb {
 
         static ResultSet get(const Txn &txn, const std::string &className);
 
+        static ResultSet get(const Txn &txn, const std::string &className, const PropertyFilter &propertyFilter);
+
+        static ResultSetView getView(const Txn &txn, const std::string &className);
+
         static ResultSetCursor getCursor(Txn &txn, const std::string &className);
 
+        static ResultSetCursor getCursor(Txn &txn, const std::string &className, const PropertyFilter &propertyFilter);
+
         static ResultSet getInEdge(const Txn &txn, const RecordDescriptor &recordDescriptor,
                                    const ClassFilter &classFilter = ClassFilter{});
 
@@ -224,6 +250,9 @@ namespace nogdb {
         create(Txn &txn, const std::string &className, const RecordDescriptor &srcVertexRecordDescriptor,
                const RecordDescriptor &dstVertexRecordDescriptor, const Record &record = Record{});
 
+        static std::vector<RecordDescriptor>
+        createBatch(Txn &txn, const std::string &className, const std::vector<EdgeRecord> &edgeRecords);
+
         static void update(Txn &txn, const RecordDescriptor &recordDescriptor, const Record &record);
 
         static void updateSrc(Txn &txn, const RecordDescriptor &recordDescriptor,
@@ -238,8 +267,14 @@ namespace nogdb {
 
         static ResultSet get(const Txn &txn, const std::string &className);
 
+        static ResultSet get(const Txn &txn, const std::string &className, const PropertyFilter &propertyFilter);
+
+        static ResultSetView getView(const Txn &txn, const std::string &className);
+
         static ResultSetCursor getCursor(Txn &txn, const std::string &className);
 
+        static ResultSetCursor getCursor(Txn &txn, const std::string &className, const PropertyFilter &propertyFilter);
+
         static Result getSrc(const Txn &txn, const RecordDescriptor &recordDescriptor);
 
         static Result getDst(const Txn &txn, const RecordDescriptor &recordDescriptor);
@@ -278,6 +313,9 @@ namespace nogdb {
 
         static Record getRecord(const Txn &txn, const RecordDescriptor &recordDescriptor);
 
+        static Record
+        getRecord(const Txn &txn, const RecordDescriptor &recordDescriptor, const PropertyFilter &propertyFilter);
+
         static const std::vector<ClassDescriptor> getSchema(const Txn &txn);
 
         static const ClassDescriptor getSchema(const Txn &txn, const std::string &className);
@@ -37,6 +37,8 @@ namespace nogdb {
 
     class MultiCondition;
 
+    class TextMatcher;
+
     class Condition {
     private:
         friend class MultiCondition;
@@ -136,6 +138,7 @@ namespace nogdb {
             auto tmp(*this);
             tmp.valueBytes = Bytes{value_};
             tmp.comp = Comparator::LIKE;
+            tmp.compileMatcher();
             return tmp;
         }
 
@@ -144,12 +147,14 @@ namespace nogdb {
             auto tmp(*this);
             tmp.valueBytes = Bytes{value_};
             tmp.comp = Comparator::REGEX;
+            tmp.compileMatcher();
             return tmp;
         }
 
         Condition ignoreCase() const {
             auto tmp(*this);
             tmp.isIgnoreCase = true;
+            tmp.compileMatcher();
             return tmp;
         }
 
@@ -243,6 +248,9 @@ namespace nogdb {
         Comparator comp;
         bool isIgnoreCase{false};
         bool isNegative{false};
+        std::shared_ptr<const TextMatcher> matcher{nullptr};
+
+        void compileMatcher();
     };
 
     class MultiCondition {
@@ -407,6 +415,35 @@ namespace nogdb {
         //bool isExclude{false};
     };
 
+    // a list of property names to be retrieved from records (all properties if it is empty)
+    class PropertyFilter {
+    public:
+        PropertyFilter() = default;
+
+        ~PropertyFilter() noexcept = default;
+
+        PropertyFilter(const std::initializer_list<std::string> &initializerList);
+
+        PropertyFilter(const std::vector<std::string> &propertyNames_);
+
+        PropertyFilter(const std::list<std::string> &propertyNames_);
+
+        PropertyFilter(const std::set<std::string> &propertyNames_);
+
+        void add(const std::string &propertyName);
+
+        void remove(const std::string &propertyName);
+
+        size_t size() const;
+
+        bool empty() const;
+
+        const std::set<std::string> &getPropertyName() const;
+
+    private:
+        std::set<std::string> propertyNames{};
+    };
+
 }
 
 #endif
@@ -58,6 +58,12 @@ namespace nogdb {
 
     class BaseTxn;
 
+    class DBHandlerRegistry;
+
+    class Reclaimer;
+
+    class ClassScanner;
+
     class Condition;
 
     class MultiCondition;
@@ -91,6 +97,8 @@ namespace nogdb {
 
         friend class Txn;
 
+        friend class ClassScanner;
+
         Context() = default;
 
         Context(const std::string &dbPath);
@@ -99,7 +107,13 @@ namespace nogdb {
 
         explicit Context(const std::string &dbPath, unsigned long maxDbSize);
 
-        Context(const std::string &dbPath, unsigned int maxDbNum, unsigned long maxDbSize);
+        explicit Context(const std::string &dbPath, RecordFormat recordFormat);
+
+        // NOTE: recordFormat only applies to a newly created database, otherwise a format of an existing one is used
+        Context(const std::string &dbPath, unsigned int maxDbNum, unsigned long maxDbSize,
+                RecordFormat recordFormat = RecordFormat::SEQUENTIAL);
+
+        ~Context() noexcept;
 
         Context(const Context &ctx);
 
@@ -115,12 +129,26 @@ namespace nogdb {
 
         std::pair<TxnId, TxnId> getMinActiveTxnId() const;
 
+        // reclaim deleted elements and old versions in memory every intervalMs milliseconds in a background thread
+        // in addition to the end of each txn (0 stops the background thread)
+        void setReclaimInterval(unsigned int intervalMs);
+
+        // scan each class without a usable index with up to numThreads threads in read-only txns
+        // (0 uses all hardware threads and 1, the default, scans on the calling thread only)
+        // NOTE: a condition function given to find records may then be called by many threads at the same time
+        void setNumScanThreads(unsigned int numThreads);
+
+        ScanStat getScanStat() const;
+
     private:
         std::shared_ptr<EnvHandlerPtr> envHandler;
         std::shared_ptr<DBInfo> dbInfo;
         std::shared_ptr<Schema> dbSchema;
         std::shared_ptr<TxnStat> dbTxnStat;
         std::shared_ptr<Graph> dbRelation;
+        std::shared_ptr<DBHandlerRegistry> dbHandlerRegistry;
+        std::shared_ptr<Reclaimer> dbReclaimer;
+        std::shared_ptr<ClassScanner> dbScanner;
 
         mutable std::shared_ptr<boost::shared_mutex> dbInfoMutex;
         mutable std::shared_ptr<boost::shared_mutex> dbWriterMutex;
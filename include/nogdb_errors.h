@@ -63,6 +63,7 @@
 #define CTX_DUPLICATE_INDEX             0x6020
 #define CTX_INVALID_INDEX_CONSTRAINT    0x6030
 #define CTX_UNIQUE_CONSTRAINT           0x6040
+#define CTX_INVALID_COMPOSITE_INDEX     0x6050
 #define CTX_IS_LOCKED                   0x9fc0
 #define CTX_LIMIT_DBSCHEMA              0x9fd0
 #define CTX_INTERNAL_ERR                0x9fe0
@@ -180,6 +181,8 @@ namespace nogdb {
                             return "CTX_INVALID_INDEX_CONSTRAINT: An index couldn't be created with a unique constraint due to some duplicated values in existing records";
                         case CTX_UNIQUE_CONSTRAINT:
                             return "CTX_UNIQUE_CONSTRAINT: A record has some duplicated values when a unique constraint is applied";
+                        case CTX_INVALID_COMPOSITE_INDEX:
+                            return "CTX_INVALID_COMPOSITE_INDEX: A composite index requires at least two distinct properties";
                         case CTX_UNKNOWN_ERR:
                         default:
                             return "CTX_UNKNOWN_ERR: Unknown";
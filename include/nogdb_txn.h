@@ -41,9 +41,12 @@ namespace nogdb {
         friend struct Vertex;
         friend struct Edge;
         friend struct Traverse;
+        friend struct BulkLoader;
 
         friend class ResultSetCursor;
 
+        friend class ClassScanner;
+
         enum Mode {
             READ_ONLY, READ_WRITE
         };
@@ -26,6 +26,7 @@
 #include <cstdint>
 #include <cstring>
 #include <map>
+#include <set>
 #include <unordered_map>
 #include <vector>
 #include <string>
@@ -58,6 +59,18 @@ namespace nogdb {
         UNDEFINED = 'n'
     };
 
+    // a layout of record raw data which is selected when a database is created
+    enum class RecordFormat {
+        SEQUENTIAL = 's',   // a sequence of property blocks (the original layout)
+        INDEXED = 'x'       // a sorted property id header with an offset table for direct property access
+    };
+
+    // a layout of indexes on signed numeric and real properties which is selected when a database is created
+    enum class IndexFormat {
+        SIGNED_SPLIT = 's', // separated tables for positive and negative values (the original layout)
+        ORDERED = 'o'       // a single table with order-preserving big-endian keys
+    };
+
     typedef uint16_t ClassId;
     typedef uint16_t PropertyId;
     typedef uint32_t PositionId;
@@ -78,6 +91,16 @@ namespace nogdb {
         ClassId numClass{0};           // a number of classes in the database.
         IndexId maxIndexId{0};         // the largest index number(id) in the entire database.
         IndexId numIndex{0};           // a number of indexes in the database.
+        RecordFormat recordFormat{RecordFormat::SEQUENTIAL}; // a layout of record raw data in the database.
+        IndexFormat indexFormat{IndexFormat::ORDERED};       // a layout of signed numeric and real indexes.
+    };
+
+    struct ScanStat {
+        ScanStat() = default;
+
+        uint64_t numParallelScans{0};     // a number of class scans which have been split among threads.
+        uint64_t numSnapshotFallbacks{0}; // a number of class scans which could not be split among threads (in full
+                                          // or in part) since a newer snapshot had been committed.
     };
 
     class Bytes {
@@ -207,6 +230,56 @@ namespace nogdb {
         std::map<std::string, Bytes> properties{};
     };
 
+    struct ClassPropertyInfo;
+
+    // a read-only record which refers to the raw data in the datastore directly and
+    // decodes its properties only when they are accessed
+    // NOTE: a record view is valid only until the read-only transaction which created it is completed
+    class RecordView {
+    public:
+        friend struct Parser;
+
+        RecordView() = default;
+
+        Bytes get(const std::string &propName) const;
+
+        std::vector<std::string> getProperties() const;
+
+        uint8_t getTinyIntU(const std::string &propName) const;
+
+        int8_t getTinyInt(const std::string &propName) const;
+
+        uint16_t getSmallIntU(const std::string &propName) const;
+
+        int16_t getSmallInt(const std::string &propName) const;
+
+        uint32_t getIntU(const std::string &propName) const;
+
+        int32_t getInt(const std::string &propName) const;
+
+        uint64_t getBigIntU(const std::string &propName) const;
+
+        int64_t getBigInt(const std::string &propName) const;
+
+        double getReal(const std::string &propName) const;
+
+        std::string getText(const std::string &propName) const;
+
+        Record toRecord() const;
+
+        bool empty() const;
+
+    private:
+        const unsigned char *value_{nullptr};
+        size_t size_{0};
+        std::shared_ptr<const ClassPropertyInfo> classPropertyInfo_{nullptr};
+
+        bool find(const std::string &propName, const unsigned char *&value, size_t &size) const;
+
+        template<typename T>
+        T getNumeric(const std::string &propName) const;
+    };
+
     struct RecordDescriptor {
         RecordDescriptor() = default;
 
@@ -241,6 +314,9 @@ namespace nogdb {
 
     typedef std::map<std::string, PropertyDescriptor> ClassProperty;
 
+    // an ordered list of property names of a composite index and whether the index is unique
+    typedef std::map<IndexId, std::pair<std::vector<std::string>, bool>> CompositeIndexInfo;
+
     struct ClassDescriptor {
         ClassDescriptor() = default;
 
@@ -266,6 +342,7 @@ namespace nogdb {
         ClassProperty properties{};
         std::string super{""};
         std::vector<std::string> sub{};
+        CompositeIndexInfo compositeIndexInfo{};
     };
 
     struct Result {
@@ -280,9 +357,32 @@ namespace nogdb {
 
     typedef std::vector<Result> ResultSet;
 
-    class Txn;
+    // a source vertex, a destination vertex, and properties of an edge to be created in a batch
+    struct EdgeRecord {
+        EdgeRecord() = default;
 
-    struct ClassPropertyInfo;
+        EdgeRecord(const RecordDescriptor &srcVertex_, const RecordDescriptor &dstVertex_,
+                   const Record &record_ = Record{})
+                : srcVertex{srcVertex_}, dstVertex{dstVertex_}, record{record_} {}
+
+        RecordDescriptor srcVertex{};
+        RecordDescriptor dstVertex{};
+        Record record{};
+    };
+
+    struct ResultView {
+        ResultView() = default;
+
+        ResultView(const RecordDescriptor &recordDescriptor_, const RecordView &record_)
+                : descriptor{recordDescriptor_}, record{record_} {}
+
+        RecordDescriptor descriptor{};
+        RecordView record{};
+    };
+
+    typedef std::vector<ResultView> ResultSetView;
+
+    class Txn;
 
     class ResultSetCursor {
     public:
@@ -329,16 +429,25 @@ namespace nogdb {
 
         const Result *operator->() const;
 
+        // a zero-copy view of the current record which is available in a read-only transaction only
+        ResultView getView() const;
+
     private:
-        typedef std::unordered_map<ClassId, ClassPropertyInfo> ClassPropertyCache;
+        typedef std::unordered_map<ClassId, std::shared_ptr<const ClassPropertyInfo>> ClassPropertyCache;
 
         Txn &txn;
         std::unique_ptr<ClassPropertyCache> classPropertyInfos;
         std::vector<RecordDescriptor> metadata{};
+        // property names to be retrieved from records (all properties if it is empty)
+        std::set<std::string> propertyNames{};
         long long currentIndex;
-        Result result;
+        // the current record is materialized only when it is dereferenced
+        mutable Result result;
+        mutable bool isResultLoaded{false};
+
+        std::shared_ptr<const ClassPropertyInfo> resolveClassPropertyInfo(ClassId classId) const;
 
-        const ClassPropertyInfo resolveClassPropertyInfo(ClassId classId);
+        void moveTo(long long index);
     };
 
 }
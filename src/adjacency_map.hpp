@@ -0,0 +1,382 @@
+/*
+ *  Copyright (C) 2018, Throughwave (Thailand) Co., Ltd.
+ *  <peerawich at throughwave dot co dot th>
+ *
+ *  This file is part of libnogdb, the NogDB core library in C++.
+ *
+ *  libnogdb is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef __ADJACENCY_MAP_HPP_INCLUDED_
+#define __ADJACENCY_MAP_HPP_INCLUDED_
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <map>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#include "spinlock.hpp"
+#include "version_control.hpp"
+
+namespace nogdb {
+
+    // A two-level (edge class id, position id) map of vertex adjacencies.
+    // Entries which are visible to every running and future txn live in sorted vectors grouped by the first key
+    // without any version information. Uncommitted or recently committed entries are kept in a small overlay
+    // of version controls and are folded back into the groups once no active txn can see an older state.
+    template<typename FirstKeyT, typename SecondKeyT, typename T, typename LockT = RWSpinLock>
+    class AdjacencyMap {
+    public:
+        typedef std::pair<SecondKeyT, T> Entry;
+
+        struct Group {
+            FirstKeyT key;
+            std::vector<Entry> entries;
+        };
+
+        typedef std::pair<FirstKeyT, SecondKeyT> OverlayKey;
+        typedef std::map<OverlayKey, VersionControl<T>> Overlay;
+
+        AdjacencyMap() = default;
+
+        AdjacencyMap(const AdjacencyMap &) = delete;
+
+        AdjacencyMap &operator=(const AdjacencyMap &) = delete;
+
+        // add an uncommitted version of an entry
+        void insert(const FirstKeyT &key1, const SecondKeyT &key2, const T &object) {
+            RWSpinLockGuard<LockT> _(spinlock_, RWSpinLockMode::EXCLUSIVE_SPLOCK);
+            getOrDetach(key1, key2).addLatestVersion(object);
+        }
+
+        // add an entry which is visible to all txns without locking, which is only safe while no other thread can
+        // reach the map yet (e.g. a vertex which has not been published while a graph is being loaded)
+        void insertUnpublished(const FirstKeyT &key1, const SecondKeyT &key2, const T &object) {
+            insertBase(key1, key2, object);
+        }
+
+        std::pair<T, bool> find(const FirstKeyT &key1, const SecondKeyT &key2) const {
+            RWSpinLockGuard<LockT> _(spinlock_);
+            if (auto versions = findOverlay(key1, key2)) {
+                return versions->getLatestVersion();
+            }
+            return findBase(key1, key2);
+        }
+
+        std::pair<T, bool> find(TxnId refTxnId, const FirstKeyT &key1, const SecondKeyT &key2) const {
+            RWSpinLockGuard<LockT> _(spinlock_);
+            if (auto versions = findOverlay(key1, key2)) {
+                return versions->getStableVersion(refTxnId);
+            }
+            return findBase(key1, key2);
+        }
+
+        void erase(const FirstKeyT &key1, const SecondKeyT &key2) {
+            RWSpinLockGuard<LockT> _(spinlock_, RWSpinLockMode::EXCLUSIVE_SPLOCK);
+            auto findEntry = findBase(key1, key2);
+            if (findEntry.second || findOverlay(key1, key2)) {
+                getOrDetach(key1, key2).deleteLatestVersion();
+            }
+        }
+
+        // aka. commit
+        void upgrade(const FirstKeyT &key1, const SecondKeyT &key2, TxnId versionId) {
+            RWSpinLockGuard<LockT> _(spinlock_, RWSpinLockMode::EXCLUSIVE_SPLOCK);
+            if (auto versions = findOverlay(key1, key2)) {
+                versions->upgradeStableVersion(versionId);
+            }
+        }
+
+        void clear(const FirstKeyT &key1, const SecondKeyT &key2, TxnId baseTxnId) {
+            RWSpinLockGuard<LockT> _(spinlock_, RWSpinLockMode::EXCLUSIVE_SPLOCK);
+            if (overlay_ == nullptr) {
+                return;
+            }
+            auto iter = overlay_->find(OverlayKey{key1, key2});
+            if (iter != overlay_->end()) {
+                auto remaining = (baseTxnId == 0) ? iter->second.clearUnstableVersion()
+                                                  : iter->second.clearStableVersion(baseTxnId);
+                if (remaining == 0 || fold(iter->first, iter->second, baseTxnId)) {
+                    overlay_->erase(iter);
+                }
+                if (overlay_->empty()) {
+                    overlay_.reset();
+                }
+            }
+        }
+
+        void clear(TxnId baseTxnId) {
+            RWSpinLockGuard<LockT> _(spinlock_, RWSpinLockMode::EXCLUSIVE_SPLOCK);
+            if (overlay_ == nullptr) {
+                return;
+            }
+            for (auto it = overlay_->begin(); it != overlay_->end();) {
+                if (it->second.clearStableVersion(baseTxnId) == 0 || fold(it->first, it->second, baseTxnId)) {
+                    it = overlay_->erase(it);
+                } else {
+                    ++it;
+                }
+            }
+            if (overlay_->empty()) {
+                overlay_.reset();
+            }
+        }
+
+        // second keys are listed from the newest to the oldest element of each first key
+        std::map<FirstKeyT, std::vector<SecondKeyT>> keys() const {
+            RWSpinLockGuard<LockT> _(spinlock_);
+            auto keys = std::map<FirstKeyT, std::vector<SecondKeyT>> {};
+            for (const auto &group: base_) {
+                keys.emplace(group.key, std::vector<SecondKeyT>{});
+            }
+            if (overlay_ != nullptr) {
+                for (const auto &element: *overlay_) {
+                    keys.emplace(element.first.first, std::vector<SecondKeyT>{});
+                }
+            }
+            for (auto &element: keys) {
+                element.second = collectKeys(element.first);
+            }
+            return keys;
+        }
+
+        std::vector<SecondKeyT> keys(const FirstKeyT &firstKey) const {
+            RWSpinLockGuard<LockT> _(spinlock_);
+            return collectKeys(firstKey);
+        }
+
+        // visit elements which are visible to the latest version (or to refTxnId) in the same order as keys()
+        // NOTE: the whole map is locked for reading while visiting so the visitor must not modify it
+        template<typename Visitor>
+        void forEachLatest(Visitor &&visitor) const {
+            RWSpinLockGuard<LockT> _(spinlock_);
+            visitAll(LatestVersion{}, visitor);
+        }
+
+        template<typename Visitor>
+        void forEachLatest(const FirstKeyT &key1, Visitor &&visitor) const {
+            RWSpinLockGuard<LockT> _(spinlock_);
+            visitGroup(key1, LatestVersion{}, visitor);
+        }
+
+        template<typename Visitor>
+        void forEachStable(TxnId refTxnId, Visitor &&visitor) const {
+            RWSpinLockGuard<LockT> _(spinlock_);
+            visitAll(StableVersion{refTxnId}, visitor);
+        }
+
+        template<typename Visitor>
+        void forEachStable(TxnId refTxnId, const FirstKeyT &key1, Visitor &&visitor) const {
+            RWSpinLockGuard<LockT> _(spinlock_);
+            visitGroup(key1, StableVersion{refTxnId}, visitor);
+        }
+
+    private:
+        mutable LockT spinlock_{};
+        std::vector<Group> base_{};
+        std::unique_ptr<Overlay> overlay_{};
+
+        struct LatestVersion {
+            std::pair<T, bool> operator()(const VersionControl<T> &versions) const {
+                return versions.getLatestVersion();
+            }
+        };
+
+        struct StableVersion {
+            TxnId refTxnId;
+
+            std::pair<T, bool> operator()(const VersionControl<T> &versions) const {
+                return versions.getStableVersion(refTxnId);
+            }
+        };
+
+        template<typename GetVersion, typename Visitor>
+        void visitAll(const GetVersion &getVersion, Visitor &visitor) const {
+            auto group = base_.cbegin();
+            auto element = typename Overlay::const_iterator{};
+            if (overlay_ != nullptr) {
+                element = overlay_->cbegin();
+            }
+            // walk first keys of both the groups and the overlay in ascending order
+            while (true) {
+                auto hasGroup = group != base_.cend();
+                auto hasElement = overlay_ != nullptr && element != overlay_->cend();
+                if (!hasGroup && !hasElement) {
+                    break;
+                }
+                auto key1 = (!hasElement || (hasGroup && group->key <= element->first.first)) ?
+                            group->key : element->first.first;
+                visitGroup(key1, getVersion, visitor);
+                if (hasGroup && group->key == key1) {
+                    ++group;
+                }
+                if (hasElement) {
+                    element = overlay_->upper_bound(OverlayKey{key1, std::numeric_limits<SecondKeyT>::max()});
+                }
+            }
+        }
+
+        template<typename GetVersion, typename Visitor>
+        void visitGroup(const FirstKeyT &key1, const GetVersion &getVersion, Visitor &visitor) const {
+            auto group = findGroup(key1);
+            auto numEntries = (group != base_.cend()) ? group->entries.size() : size_t{0};
+            auto element = typename Overlay::const_reverse_iterator{};
+            auto lastElement = typename Overlay::const_reverse_iterator{};
+            if (overlay_ != nullptr) {
+                element = typename Overlay::const_reverse_iterator{
+                        overlay_->upper_bound(OverlayKey{key1, std::numeric_limits<SecondKeyT>::max()})};
+                lastElement = typename Overlay::const_reverse_iterator{
+                        overlay_->lower_bound(OverlayKey{key1, SecondKeyT{}})};
+            }
+            // merge both sorted sequences from the newest to the oldest element
+            while (true) {
+                auto hasElement = overlay_ != nullptr && element != lastElement;
+                if (numEntries == 0 && !hasElement) {
+                    break;
+                }
+                if (!hasElement || (numEntries > 0 && element->first.second < group->entries[numEntries - 1].first)) {
+                    const auto &entry = group->entries[--numEntries];
+                    visitor(key1, entry.first, entry.second);
+                } else {
+                    auto version = getVersion(element->second);
+                    if (version.second) {
+                        visitor(key1, element->first.second, version.first);
+                    }
+                    ++element;
+                }
+            }
+        }
+
+        static bool isEntryLess(const Entry &lhs, const SecondKeyT &rhs) {
+            return lhs.first < rhs;
+        }
+
+        static bool isGroupLess(const Group &lhs, const FirstKeyT &rhs) {
+            return lhs.key < rhs;
+        }
+
+        typename std::vector<Group>::const_iterator findGroup(const FirstKeyT &key1) const {
+            auto group = std::lower_bound(base_.cbegin(), base_.cend(), key1, isGroupLess);
+            return (group != base_.cend() && group->key == key1) ? group : base_.cend();
+        }
+
+        std::pair<T, bool> findBase(const FirstKeyT &key1, const SecondKeyT &key2) const {
+            auto group = findGroup(key1);
+            if (group != base_.cend()) {
+                auto entry = std::lower_bound(group->entries.cbegin(), group->entries.cend(), key2, isEntryLess);
+                if (entry != group->entries.cend() && entry->first == key2) {
+                    return std::make_pair(entry->second, true);
+                }
+            }
+            return std::make_pair(T{}, false);
+        }
+
+        std::vector<SecondKeyT> collectKeys(const FirstKeyT &firstKey) const {
+            auto keys = std::vector<SecondKeyT> {};
+            auto group = findGroup(firstKey);
+            if (group != base_.cend()) {
+                keys.reserve(group->entries.size());
+                for (const auto &entry: group->entries) {
+                    keys.push_back(entry.first);
+                }
+            }
+            if (overlay_ != nullptr) {
+                auto numBaseKeys = keys.size();
+                auto first = overlay_->lower_bound(OverlayKey{firstKey, SecondKeyT{}});
+                for (auto it = first; it != overlay_->cend() && it->first.first == firstKey; ++it) {
+                    keys.push_back(it->first.second);
+                }
+                std::inplace_merge(keys.begin(), keys.begin() + numBaseKeys, keys.end());
+            }
+            std::reverse(keys.begin(), keys.end());
+            return keys;
+        }
+
+        const VersionControl<T> *findOverlay(const FirstKeyT &key1, const SecondKeyT &key2) const {
+            if (overlay_ != nullptr) {
+                auto iter = overlay_->find(OverlayKey{key1, key2});
+                if (iter != overlay_->cend()) {
+                    return &iter->second;
+                }
+            }
+            return nullptr;
+        }
+
+        VersionControl<T> *findOverlay(const FirstKeyT &key1, const SecondKeyT &key2) {
+            return const_cast<VersionControl<T> *>(static_cast<const AdjacencyMap *>(this)->findOverlay(key1, key2));
+        }
+
+        void insertBase(const FirstKeyT &key1, const SecondKeyT &key2, const T &object) {
+            // entries usually come in the order of record ids so appending is the common case
+            auto group = (!base_.empty() && base_.back().key == key1) ? base_.end() - 1 :
+                         std::lower_bound(base_.begin(), base_.end(), key1, isGroupLess);
+            if (group == base_.end() || group->key != key1) {
+                group = base_.insert(group, Group{key1, std::vector<Entry>{}});
+            }
+            auto &entries = group->entries;
+            if (entries.empty() || entries.back().first < key2) {
+                entries.emplace_back(key2, object);
+            } else {
+                auto entry = std::lower_bound(entries.begin(), entries.end(), key2, isEntryLess);
+                if (entry != entries.end() && entry->first == key2) {
+                    entry->second = object;
+                } else {
+                    entries.emplace(entry, key2, object);
+                }
+            }
+        }
+
+        // get the version control of an entry, moving a committed entry from the groups into the overlay if needed
+        VersionControl<T> &getOrDetach(const FirstKeyT &key1, const SecondKeyT &key2) {
+            if (overlay_ == nullptr) {
+                overlay_ = std::unique_ptr<Overlay>(new Overlay{});
+            }
+            auto result = overlay_->emplace(std::piecewise_construct,
+                                            std::forward_as_tuple(key1, key2), std::forward_as_tuple());
+            auto &versions = result.first->second;
+            if (result.second) {
+                auto group = std::lower_bound(base_.begin(), base_.end(), key1, isGroupLess);
+                if (group != base_.end() && group->key == key1) {
+                    auto &entries = group->entries;
+                    auto entry = std::lower_bound(entries.begin(), entries.end(), key2, isEntryLess);
+                    if (entry != entries.end() && entry->first == key2) {
+                        // a committed entry is visible to all txns since the very first version
+                        versions.addLatestVersion(entry->second);
+                        versions.upgradeStableVersion(0);
+                        entries.erase(entry);
+                        if (entries.empty()) {
+                            base_.erase(group);
+                        }
+                    }
+                }
+            }
+            return versions;
+        }
+
+        bool fold(const OverlayKey &key, const VersionControl<T> &versions, TxnId baseTxnId) {
+            auto settledVersion = versions.getSettledVersion(baseTxnId);
+            if (settledVersion.second) {
+                insertBase(key.first, key.second, settledVersion.first);
+            }
+            return settledVersion.second;
+        }
+    };
+
+}
+
+#endif
@@ -0,0 +1,235 @@
+/*
+ *  Copyright (C) 2018, Throughwave (Thailand) Co., Ltd.
+ *  <peerawich at throughwave dot co dot th>
+ *
+ *  This file is part of libnogdb, the NogDB core library in C++.
+ *
+ *  libnogdb is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <tuple>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "adjacency_snapshot.hpp"
+
+namespace nogdb {
+
+    namespace {
+
+        const char SNAPSHOT_MAGIC[8] = {'N', 'O', 'G', 'D', 'B', 'A', 'D', 'J'};
+        constexpr uint32_t SNAPSHOT_VERSION = 1;
+
+        struct Header {
+            char magic[8];
+            uint32_t version;
+            uint32_t reserved;
+            uint64_t txnId;
+            uint64_t numVertices;
+            uint64_t numEdges;
+        };
+
+        struct PackedRecordId {
+            ClassId classId;
+            uint16_t reserved;
+            PositionId positionId;
+        };
+
+        // an outgoing edge of a vertex with an index of its destination vertex
+        struct OutEdge {
+            PackedRecordId rid;
+            uint64_t target;
+        };
+
+        PackedRecordId pack(const RecordId &rid) {
+            auto packed = PackedRecordId{};
+            packed.classId = rid.first;
+            packed.reserved = 0;
+            packed.positionId = rid.second;
+            return packed;
+        }
+
+        RecordId unpack(const PackedRecordId &packed) {
+            return RecordId{packed.classId, packed.positionId};
+        }
+
+        bool writeAll(int fd, const void *data, size_t size) {
+            auto bytes = static_cast<const char *>(data);
+            while (size > 0) {
+                auto written = ::write(fd, bytes, size);
+                if (written <= 0) {
+                    return false;
+                }
+                bytes += written;
+                size -= static_cast<size_t>(written);
+            }
+            return true;
+        }
+
+    }
+
+    bool AdjacencySnapshot::write(const std::string &filePath, Graph &graph, uint64_t txnId) noexcept {
+        auto tmpFilePath = filePath + ".tmp";
+        auto fd = -1;
+        try {
+            // collect committed edges ordered by their source vertices
+            auto relations = std::vector<Graph::EdgeRelation>{};
+            auto isComplete = true;
+            relations.reserve(graph.edges.size());
+            graph.edges.forEach([&](const RecordId &, const std::shared_ptr<Graph::Edge> &edge) {
+                if (!isComplete || edge->getState().second != TxnObject::StatusFlag::COMMITTED_CREATE) {
+                    return;
+                }
+                auto source = edge->source.getLatestVersion();
+                auto target = edge->target.getLatestVersion();
+                auto sourceVertex = (source.second) ? source.first.lock() : nullptr;
+                auto targetVertex = (target.second) ? target.first.lock() : nullptr;
+                if (sourceVertex == nullptr || targetVertex == nullptr) {
+                    isComplete = false;
+                    return;
+                }
+                relations.emplace_back(edge->rid, sourceVertex->rid, targetVertex->rid);
+            });
+            if (!isComplete) {
+                return false;
+            }
+            std::sort(relations.begin(), relations.end(),
+                      [](const Graph::EdgeRelation &lhs, const Graph::EdgeRelation &rhs) {
+                          return std::tie(std::get<1>(lhs), std::get<0>(lhs)) <
+                                 std::tie(std::get<1>(rhs), std::get<0>(rhs));
+                      });
+            auto vertexIds = std::vector<RecordId>{};
+            vertexIds.reserve(relations.size() * 2);
+            for (const auto &relation: relations) {
+                vertexIds.emplace_back(std::get<1>(relation));
+                vertexIds.emplace_back(std::get<2>(relation));
+            }
+            std::sort(vertexIds.begin(), vertexIds.end());
+            vertexIds.erase(std::unique(vertexIds.begin(), vertexIds.end()), vertexIds.end());
+            auto indexOf = [&vertexIds](const RecordId &rid) {
+                return static_cast<uint64_t>(std::lower_bound(vertexIds.begin(), vertexIds.end(), rid) -
+                                             vertexIds.begin());
+            };
+            auto vertices = std::vector<PackedRecordId>{};
+            vertices.reserve(vertexIds.size());
+            for (const auto &vertexId: vertexIds) {
+                vertices.emplace_back(pack(vertexId));
+            }
+            auto offsets = std::vector<uint64_t>(vertexIds.size() + 1, 0);
+            auto outEdges = std::vector<OutEdge>{};
+            outEdges.reserve(relations.size());
+            for (const auto &relation: relations) {
+                ++offsets[indexOf(std::get<1>(relation)) + 1];
+                auto outEdge = OutEdge{};
+                outEdge.rid = pack(std::get<0>(relation));
+                outEdge.target = indexOf(std::get<2>(relation));
+                outEdges.emplace_back(outEdge);
+            }
+            for (auto i = size_t{1}; i < offsets.size(); ++i) {
+                offsets[i] += offsets[i - 1];
+            }
+            auto header = Header{};
+            memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+            header.version = SNAPSHOT_VERSION;
+            header.reserved = 0;
+            header.txnId = txnId;
+            header.numVertices = vertices.size();
+            header.numEdges = outEdges.size();
+
+            fd = ::open(tmpFilePath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0664);
+            if (fd < 0) {
+                return false;
+            }
+            auto isWritten = writeAll(fd, &header, sizeof(header)) &&
+                             writeAll(fd, vertices.data(), vertices.size() * sizeof(PackedRecordId)) &&
+                             writeAll(fd, offsets.data(), offsets.size() * sizeof(uint64_t)) &&
+                             writeAll(fd, outEdges.data(), outEdges.size() * sizeof(OutEdge)) &&
+                             ::fsync(fd) == 0;
+            ::close(fd);
+            fd = -1;
+            if (!isWritten || ::rename(tmpFilePath.c_str(), filePath.c_str()) != 0) {
+                ::unlink(tmpFilePath.c_str());
+                return false;
+            }
+            return true;
+        } catch (...) {
+            if (fd >= 0) {
+                ::close(fd);
+                ::unlink(tmpFilePath.c_str());
+            }
+            return false;
+        }
+    }
+
+    bool AdjacencySnapshot::read(const std::string &filePath, uint64_t txnId, uint64_t numRelations,
+                                 std::vector<std::vector<Graph::EdgeRelation>> &relationParts) {
+        auto fd = ::open(filePath.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat fileStat;
+        if (::fstat(fd, &fileStat) != 0 || static_cast<size_t>(fileStat.st_size) < sizeof(Header)) {
+            ::close(fd);
+            return false;
+        }
+        auto fileSize = static_cast<size_t>(fileStat.st_size);
+        auto mapped = ::mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapped == MAP_FAILED) {
+            return false;
+        }
+        auto data = static_cast<const char *>(mapped);
+        auto isValid = false;
+        auto header = Header{};
+        memcpy(&header, data, sizeof(header));
+        if (memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) == 0 && header.version == SNAPSHOT_VERSION &&
+            header.txnId == txnId && header.numEdges == numRelations &&
+            header.numVertices < fileSize && header.numEdges < fileSize &&
+            fileSize == sizeof(Header) + header.numVertices * sizeof(PackedRecordId) +
+                        (header.numVertices + 1) * sizeof(uint64_t) + header.numEdges * sizeof(OutEdge)) {
+            auto vertices = reinterpret_cast<const PackedRecordId *>(data + sizeof(Header));
+            auto offsets = reinterpret_cast<const uint64_t *>(vertices + header.numVertices);
+            auto outEdges = reinterpret_cast<const OutEdge *>(offsets + header.numVertices + 1);
+            isValid = (offsets[0] == 0 && offsets[header.numVertices] == header.numEdges);
+            auto numParts = Graph::getNumLoadThreads(header.numEdges);
+            relationParts.assign(numParts, std::vector<Graph::EdgeRelation>{});
+            for (auto vertex = uint64_t{0}; isValid && vertex < header.numVertices; ++vertex) {
+                if (offsets[vertex] > offsets[vertex + 1] || offsets[vertex + 1] > header.numEdges) {
+                    isValid = false;
+                    break;
+                }
+                auto srcId = unpack(vertices[vertex]);
+                for (auto i = offsets[vertex]; i < offsets[vertex + 1]; ++i) {
+                    if (outEdges[i].target >= header.numVertices) {
+                        isValid = false;
+                        break;
+                    }
+                    auto &relations = relationParts[i * numParts / header.numEdges];
+                    relations.emplace_back(unpack(outEdges[i].rid), srcId, unpack(vertices[outEdges[i].target]));
+                }
+            }
+        }
+        ::munmap(mapped, fileSize);
+        if (!isValid) {
+            relationParts.clear();
+        }
+        return isValid;
+    }
+
+}
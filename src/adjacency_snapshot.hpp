@@ -0,0 +1,60 @@
+/*
+ *  Copyright (C) 2018, Throughwave (Thailand) Co., Ltd.
+ *  <peerawich at throughwave dot co dot th>
+ *
+ *  This file is part of libnogdb, the NogDB core library in C++.
+ *
+ *  libnogdb is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef __ADJACENCY_SNAPSHOT_HPP_INCLUDED_
+#define __ADJACENCY_SNAPSHOT_HPP_INCLUDED_
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "graph.hpp"
+
+#include "nogdb_types.h"
+
+namespace nogdb {
+
+    // a file of committed relations in the compressed sparse row layout which is written when a database is closed,
+    // so that the graph can be rebuilt from it without walking the relation table on the next opening
+    // NOTE: the mmapped arrays are not used in place as the committed layer of the graph. Relations are copied out
+    // of them and the graph is still built through Graph::loadEdges, since vertices and edges in memory are
+    // versioned objects which are shared with adjacencies
+    // NOTE: a snapshot is tagged with the last committed datastore txn id and is only used if nothing has been
+    // committed since it was written. Changes of relations after that cannot be replayed on top of it since the
+    // datastore does not keep a log of them, so any later commit means a full walk of the relation table
+    struct AdjacencySnapshot {
+        AdjacencySnapshot() = delete;
+
+        ~AdjacencySnapshot() noexcept = delete;
+
+        // write committed edges in the graph into a file (replaced atomically), return false on failure
+        static bool write(const std::string &filePath, Graph &graph, uint64_t txnId) noexcept;
+
+        // read relations from a file if it is valid, tagged with txnId, and has numRelations edges,
+        // otherwise return false
+        // NOTE: relations are split into parts of about the same size for Graph::loadEdges
+        static bool read(const std::string &filePath, uint64_t txnId, uint64_t numRelations,
+                         std::vector<std::vector<Graph::EdgeRelation>> &relationParts);
+    };
+
+}
+
+#endif
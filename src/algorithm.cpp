@@ -58,7 +58,7 @@ namespace nogdb {
             default:
                 auto result = ResultSet{};
                 auto classDescriptor = Schema::ClassDescriptorPtr{};
-                auto classPropertyInfo = ClassPropertyInfo{};
+                auto classPropertyInfo = std::shared_ptr<const ClassPropertyInfo>{};
                 auto classDBHandler = Datastore::DBHandler{};
                 auto visited = std::unordered_set<RecordId, Graph::RecordIdHash>{recordDescriptor.rid};
                 auto queue = std::queue<std::pair<unsigned int, RecordId>> {};
@@ -84,11 +84,10 @@ namespace nogdb {
                         classDescriptor = Generic::getClassDescriptor(txn, recordDescriptor.rid.first,
                                                                       ClassType::UNDEFINED);
                         classPropertyInfo = Generic::getClassMapProperty(*txn.txnBase, classDescriptor);
-                        classDBHandler = Datastore::openDbi(txn.txnBase->getDsTxnHandler(),
-                                                            std::to_string(recordDescriptor.rid.first), true);
+                        classDBHandler = txn.txnBase->openClassDbi(recordDescriptor.rid.first);
                         auto keyValue = Datastore::getRecord(txn.txnBase->getDsTxnHandler(),
                                                              classDBHandler, recordDescriptor.rid.second);
-                        auto record = Parser::parseRawData(keyValue, classPropertyInfo);
+                        auto record = Parser::parseRawData(keyValue, *classPropertyInfo);
                         result.emplace_back(Result{recordDescriptor, record});
                     }
                     while (!queue.empty()) {
@@ -161,7 +160,7 @@ namespace nogdb {
             default:
                 auto result = ResultSet{};
                 auto classDescriptor = Schema::ClassDescriptorPtr{};
-                auto classPropertyInfo = ClassPropertyInfo{};
+                auto classPropertyInfo = std::shared_ptr<const ClassPropertyInfo>{};
                 auto classDBHandler = Datastore::DBHandler{};
                 auto visited = std::unordered_set<RecordId, Graph::RecordIdHash> {};
                 auto usedEdges = std::unordered_set<RecordId, Graph::RecordIdHash> {};
@@ -257,18 +256,17 @@ namespace nogdb {
         } else {
             auto result = ResultSet{};
             auto classDescriptor = Schema::ClassDescriptorPtr{};
-            auto classPropertyInfo = ClassPropertyInfo{};
+            auto classPropertyInfo = std::shared_ptr<const ClassPropertyInfo>{};
             auto classDBHandler = Datastore::DBHandler{};
             try {
                 if (srcVertexRecordDescriptor == dstVertexRecordDescriptor) {
                     classDescriptor = Generic::getClassDescriptor(txn, srcVertexRecordDescriptor.rid.first,
                                                                   ClassType::UNDEFINED);
                     classPropertyInfo = Generic::getClassMapProperty(*txn.txnBase, classDescriptor);
-                    classDBHandler = Datastore::openDbi(txn.txnBase->getDsTxnHandler(),
-                                                        std::to_string(srcVertexRecordDescriptor.rid.first), true);
+                    classDBHandler = txn.txnBase->openClassDbi(srcVertexRecordDescriptor.rid.first);
                     auto keyValue = Datastore::getRecord(txn.txnBase->getDsTxnHandler(),
                                                          classDBHandler, srcVertexRecordDescriptor.rid.second);
-                    auto record = Parser::parseRawData(keyValue, classPropertyInfo);
+                    auto record = Parser::parseRawData(keyValue, *classPropertyInfo);
                     result.emplace_back(Result{srcVertexRecordDescriptor, record});
                 } else {
                     bool found = false;
@@ -280,22 +278,21 @@ namespace nogdb {
                         auto vertex = queue.front();
                         queue.pop();
                         auto edgeRecordDescriptors = std::vector<RecordDescriptor>{};
+                        auto visitEdge = [&](const RecordId &edge) {
+                            auto tmpResult = retrieve(txn, classDescriptor, classPropertyInfo,
+                                                      classDBHandler, edge, pathFilter, ClassType::EDGE);
+                            if (!tmpResult.record.empty()) {
+                                edgeRecordDescriptors.emplace_back(RecordDescriptor{edge});
+                            }
+                        };
                         if (edgeClassIds.empty()) {
-                            for (const auto &edge: txn.txnCtx.dbRelation->getEdgeOut(*(txn.txnBase), vertex, 0)) {
-                                auto tmpResult = retrieve(txn, classDescriptor, classPropertyInfo,
-                                                          classDBHandler, edge, pathFilter, ClassType::EDGE);
-                                if (!tmpResult.record.empty()) {
-                                    edgeRecordDescriptors.emplace_back(RecordDescriptor{edge});
-                                }
+                            for (const auto &edge: txn.txnCtx.dbRelation->getEdgeOut(*(txn.txnBase), vertex)) {
+                                visitEdge(edge);
                             }
                         } else {
                             for (const auto &edgeId: edgeClassIds) {
                                 for (const auto &edge: txn.txnCtx.dbRelation->getEdgeOut(*(txn.txnBase), vertex, edgeId)) {
-                                    auto tmpResult = retrieve(txn, classDescriptor, classPropertyInfo,
-                                                              classDBHandler, edge, pathFilter, ClassType::EDGE);
-                                    if (!tmpResult.record.empty()) {
-                                        edgeRecordDescriptors.emplace_back(RecordDescriptor{edge});
-                                    }
+                                    visitEdge(edge);
                                 }
                             }
                         }
@@ -325,11 +322,10 @@ namespace nogdb {
                         classDescriptor = Generic::getClassDescriptor(txn, srcVertexRecordDescriptor.rid.first,
                                                                       ClassType::UNDEFINED);
                         classPropertyInfo = Generic::getClassMapProperty(*txn.txnBase, classDescriptor);
-                        classDBHandler = Datastore::openDbi(txn.txnBase->getDsTxnHandler(),
-                                                            std::to_string(srcVertexRecordDescriptor.rid.first), true);
+                        classDBHandler = txn.txnBase->openClassDbi(srcVertexRecordDescriptor.rid.first);
                         auto keyValue = Datastore::getRecord(txn.txnBase->getDsTxnHandler(),
                                                              classDBHandler, srcVertexRecordDescriptor.rid.second);
-                        auto record = Parser::parseRawData(keyValue, classPropertyInfo);
+                        auto record = Parser::parseRawData(keyValue, *classPropertyInfo);
                         result.emplace_back(Result{srcVertexRecordDescriptor, record});
                         std::reverse(result.begin(), result.end());
                     }
@@ -367,7 +363,7 @@ namespace nogdb {
             default:
                 auto result = std::vector<RecordDescriptor>{};
                 auto classDescriptor = Schema::ClassDescriptorPtr{};
-                auto classPropertyInfo = ClassPropertyInfo{};
+                auto classPropertyInfo = std::shared_ptr<const ClassPropertyInfo>{};
                 auto classDBHandler = Datastore::DBHandler{};
                 auto visited = std::unordered_set<RecordId, Graph::RecordIdHash>{recordDescriptor.rid};
                 auto queue = std::queue<std::pair<unsigned int, RecordId>> {};
@@ -467,7 +463,7 @@ namespace nogdb {
             default:
                 auto result = std::vector<RecordDescriptor>{};
                 auto classDescriptor = Schema::ClassDescriptorPtr{};
-                auto classPropertyInfo = ClassPropertyInfo{};
+                auto classPropertyInfo = std::shared_ptr<const ClassPropertyInfo>{};
                 auto classDBHandler = Datastore::DBHandler{};
                 auto visited = std::unordered_set<RecordId, Graph::RecordIdHash> {};
                 auto usedEdges = std::unordered_set<RecordId, Graph::RecordIdHash> {};
@@ -573,7 +569,7 @@ namespace nogdb {
         } else {
             auto result = std::vector<RecordDescriptor>{};
             auto classDescriptor = Schema::ClassDescriptorPtr{};
-            auto classPropertyInfo = ClassPropertyInfo{};
+            auto classPropertyInfo = std::shared_ptr<const ClassPropertyInfo>{};
             auto classDBHandler = Datastore::DBHandler{};
             try {
                 if (srcVertexRecordDescriptor == dstVertexRecordDescriptor) {
@@ -588,26 +584,23 @@ namespace nogdb {
                         auto vertex = queue.front();
                         queue.pop();
                         auto edgeRecordDescriptors = std::vector<RecordDescriptor>{};
+                        auto visitEdge = [&](const RecordId &edge) {
+                            auto tmpRdesc = (pathFilter.isSetVertex() || pathFilter.isSetEdge()) ?
+                                            retrieveRdesc(txn, classDescriptor, classPropertyInfo,
+                                                          classDBHandler, edge, pathFilter, ClassType::EDGE) :
+                                            RecordDescriptor{edge};
+                            if (tmpRdesc != RecordDescriptor{}) {
+                                edgeRecordDescriptors.emplace_back(RecordDescriptor{edge});
+                            }
+                        };
                         if (edgeClassIds.empty()) {
-                            for (const auto &edge: txn.txnCtx.dbRelation->getEdgeOut(*(txn.txnBase), vertex, 0)) {
-                                auto tmpRdesc = (pathFilter.isSetVertex() || pathFilter.isSetEdge()) ?
-                                                retrieveRdesc(txn, classDescriptor, classPropertyInfo,
-                                                              classDBHandler, edge, pathFilter, ClassType::EDGE) :
-                                                RecordDescriptor{edge};
-                                if (tmpRdesc != RecordDescriptor{}) {
-                                    edgeRecordDescriptors.emplace_back(RecordDescriptor{edge});
-                                }
+                            for (const auto &edge: txn.txnCtx.dbRelation->getEdgeOut(*(txn.txnBase), vertex)) {
+                                visitEdge(edge);
                             }
                         } else {
                             for (const auto &edgeId: edgeClassIds) {
                                 for (const auto &edge: txn.txnCtx.dbRelation->getEdgeOut(*(txn.txnBase), vertex, edgeId)) {
-                                    auto tmpRdesc = (pathFilter.isSetVertex() || pathFilter.isSetEdge()) ?
-                                                    retrieveRdesc(txn, classDescriptor, classPropertyInfo,
-                                                                  classDBHandler, edge, pathFilter, ClassType::EDGE) :
-                                                    RecordDescriptor{edge};
-                                    if (tmpRdesc != RecordDescriptor{}) {
-                                        edgeRecordDescriptors.emplace_back(RecordDescriptor{edge});
-                                    }
+                                    visitEdge(edge);
                                 }
                             }
                         }
@@ -101,7 +101,7 @@ namespace nogdb {
 
         inline static Result retrieve(const Txn &txn,
                                       Schema::ClassDescriptorPtr &classDescriptor,
-                                      ClassPropertyInfo &classPropertyInfo,
+                                      std::shared_ptr<const ClassPropertyInfo> &classPropertyInfo,
                                       Datastore::DBHandler &classDBHandler,
                                       const RecordId &rid,
                                       const PathFilter &pathFilter,
@@ -110,10 +110,10 @@ namespace nogdb {
             if (classDescriptor == nullptr || classDescriptor->id != rid.first) {
                 classDescriptor = Generic::getClassDescriptor(txn, rid.first, ClassType::UNDEFINED);
                 classPropertyInfo = Generic::getClassMapProperty(*txn.txnBase, classDescriptor);
-                classDBHandler = Datastore::openDbi(dsTxnHandler, std::to_string(rid.first), true);
+                classDBHandler = txn.txnBase->openClassDbi(rid.first);
             }
             auto keyValue = Datastore::getRecord(dsTxnHandler, classDBHandler, rid.second);
-            auto record = Parser::parseRawData(keyValue, classPropertyInfo);
+            auto record = Parser::parseRawData(keyValue, *classPropertyInfo);
             auto name = BaseTxn::getCurrentVersion(*txn.txnBase, classDescriptor->name).first;
             auto tmpRecord = record.set(CLASS_NAME_PROPERTY, name).set(RECORD_ID_PROPERTY, rid2str(rid));
             if (pathFilter.isSetVertex() && type == ClassType::VERTEX) {
@@ -135,7 +135,7 @@ namespace nogdb {
 
         inline static RecordDescriptor retrieveRdesc(const Txn &txn,
                                                      Schema::ClassDescriptorPtr &classDescriptor,
-                                                     ClassPropertyInfo &classPropertyInfo,
+                                                     std::shared_ptr<const ClassPropertyInfo> &classPropertyInfo,
                                                      Datastore::DBHandler &classDBHandler,
                                                      const RecordId &rid,
                                                      const PathFilter &pathFilter,
@@ -144,10 +144,10 @@ namespace nogdb {
             if (classDescriptor == nullptr || classDescriptor->id != rid.first) {
                 classDescriptor = Generic::getClassDescriptor(txn, rid.first, ClassType::UNDEFINED);
                 classPropertyInfo = Generic::getClassMapProperty(*txn.txnBase, classDescriptor);
-                classDBHandler = Datastore::openDbi(dsTxnHandler, std::to_string(rid.first), true);
+                classDBHandler = txn.txnBase->openClassDbi(rid.first);
             }
             auto keyValue = Datastore::getRecord(dsTxnHandler, classDBHandler, rid.second);
-            auto record = Parser::parseRawData(keyValue, classPropertyInfo);
+            auto record = Parser::parseRawData(keyValue, *classPropertyInfo);
             auto name = BaseTxn::getCurrentVersion(*txn.txnBase, classDescriptor->name).first;
             auto tmpRecord = record.set(CLASS_NAME_PROPERTY, name).set(RECORD_ID_PROPERTY, rid2str(rid));
             if (pathFilter.isSetVertex() && type == ClassType::VERTEX) {
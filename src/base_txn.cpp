@@ -24,8 +24,10 @@
 #include <tuple>
 
 #include "shared_lock.hpp"
+#include "constant.hpp"
 #include "env_handler.hpp"
 #include "base_txn.hpp"
+#include "reclaimer.hpp"
 #include "utils.hpp" // for benchmarking
 
 #include "nogdb_errors.h"
@@ -35,7 +37,13 @@ namespace nogdb {
     BaseTxn::BaseTxn(Context &ctx, bool isReadWrite, bool inMemory)
             : dsTxnHandler{nullptr},
               txnType{(isReadWrite) ? TxnType::READ_WRITE : TxnType::READ_ONLY},
+              dbSchema{ctx.dbSchema},
+              dbHandlerRegistry{ctx.dbHandlerRegistry},
               isWithDataStore{!inMemory} {
+        // take the epoch before the datastore snapshot so that dbi dropped in between will never be published
+        dbHandlerEpoch = dbHandlerRegistry->getEpoch();
+        // only handles published before the datastore snapshot can be used by this txn
+        dbHandlerGeneration = dbHandlerRegistry->getGeneration();
         if (!isReadWrite) {
             if (isWithDataStore) {
                 try {
@@ -44,10 +52,11 @@ namespace nogdb {
                     throw Error(err, Error::Type::DATASTORE);
                 }
             }
+            // the index format never changes after a database has been opened
+            dbInfo.indexFormat = ctx.dbInfo->indexFormat;
             txnId = ctx.dbTxnStat->fetchAddMaxTxnId();
-            // get the recent version that was committed
-            versionId = ctx.dbTxnStat->maxVersionId;
-            ctx.dbTxnStat->addActiveTxnId(txnId, versionId);
+            // get the recent version that was committed while registering, so that it can never be reclaimed
+            activeTxnSlot = ctx.dbTxnStat->addActiveTxnId(txnId, versionId);
         } else {
             if (isWithDataStore) {
                 try {
@@ -79,6 +88,94 @@ namespace nogdb {
         }
     }
 
+    Datastore::DBHandler BaseTxn::openClassDbi(ClassId classId) {
+        return openDbi(DBHandlerRegistry::CLASS, classId, true, true);
+    }
+
+    bool BaseTxn::isPublishedClassDbi(ClassId classId) const {
+        auto dbHandler = Datastore::DBHandler{0};
+        return dbHandlerRegistry->find(DBHandlerRegistry::makeKey(DBHandlerRegistry::CLASS, classId),
+                                       dbHandlerGeneration, dbHandler);
+    }
+
+    Datastore::DBHandler BaseTxn::openIndexDbi(IndexId indexId, bool isNumericKey, bool isUnique) {
+        return openDbi(DBHandlerRegistry::INDEX, indexId, isNumericKey, isUnique);
+    }
+
+    Datastore::DBHandler BaseTxn::openSignedIndexDbi(IndexId indexId, bool isPositive, bool isUnique) {
+        return openDbi((isPositive) ? DBHandlerRegistry::INDEX_POSITIVE : DBHandlerRegistry::INDEX_NEGATIVE,
+                       indexId, true, isUnique);
+    }
+
+    Datastore::DBHandler BaseTxn::openRelationDbi() {
+        return openDbi(DBHandlerRegistry::RELATION, 0, false, true);
+    }
+
+    Datastore::DBHandler
+    BaseTxn::openDbi(DBHandlerRegistry::DBType type, uint32_t id, bool isNumericKey, bool isUnique) {
+        if (isCompleted) {
+            // the datastore txn handle is no longer valid
+            throw Datastore::ErrorType{MDB_BAD_TXN};
+        }
+        auto key = DBHandlerRegistry::makeKey(type, id);
+        auto iterator = ucDBHandlers.find(key);
+        if (iterator != ucDBHandlers.cend()) {
+            return iterator->second;
+        }
+        auto dbHandler = Datastore::DBHandler{0};
+        if (!dbHandlerRegistry->find(key, dbHandlerGeneration, dbHandler)) {
+            // build a dbi name only when it has never been opened before
+            auto dbName = std::string{};
+            switch (type) {
+                case DBHandlerRegistry::CLASS:
+                    dbName = std::to_string(id);
+                    break;
+                case DBHandlerRegistry::INDEX:
+                    dbName = TB_INDEXING_PREFIX + std::to_string(id);
+                    break;
+                case DBHandlerRegistry::INDEX_POSITIVE:
+                    dbName = TB_INDEXING_PREFIX + std::to_string(id) + "_positive";
+                    break;
+                case DBHandlerRegistry::INDEX_NEGATIVE:
+                    dbName = TB_INDEXING_PREFIX + std::to_string(id) + "_negative";
+                    break;
+                case DBHandlerRegistry::RELATION:
+                    dbName = TB_RELATIONS;
+                    break;
+            }
+            dbHandler = Datastore::openDbi(dsTxnHandler, dbName, isNumericKey, isUnique);
+        }
+        ucDBHandlers.emplace(key, dbHandler);
+        return dbHandler;
+    }
+
+    void BaseTxn::dropDbi(DBHandlerRegistry::DBType type, uint32_t id, Datastore::DBHandler dbHandler) {
+        auto key = DBHandlerRegistry::makeKey(type, id);
+        // lmdb closes a dropped handle immediately even if this txn is aborted later
+        ucDBHandlers.erase(key);
+        auto newEpoch = dbHandlerRegistry->erase(key);
+        if (newEpoch == dbHandlerEpoch + 1) {
+            dbHandlerEpoch = newEpoch;
+        }
+        droppedDBHandlers.emplace_back(key);
+        Datastore::dropDbi(dsTxnHandler, dbHandler);
+    }
+
+    void BaseTxn::publishDbi() {
+        dbHandlerRegistry->publish(ucDBHandlers, dbHandlerEpoch);
+        ucDBHandlers.clear();
+    }
+
+    void BaseTxn::endReadOnlyDatastore() noexcept {
+        // committing (instead of aborting) a read-only txn keeps its newly opened dbi alive in the environment
+        try {
+            Datastore::commitTxn(dsTxnHandler);
+            publishDbi();
+        } catch (Datastore::ErrorType &err) {
+            ucDBHandlers.clear();
+        }
+    }
+
     void BaseTxn::addUncommittedVertex(const std::shared_ptr<Graph::Vertex> &vertex) {
         if (ucVertices.find(vertex->rid) == ucVertices.cend()) {
             ucVertices.emplace(vertex->rid, vertex);
@@ -122,38 +219,72 @@ namespace nogdb {
                     } catch (Datastore::ErrorType &err) {
                         throw Error(err, Error::Type::DATASTORE);
                     }
+                    // invalidate dropped dbi again for readers which began before this commit
+                    for (const auto &key: droppedDBHandlers) {
+                        auto newEpoch = dbHandlerRegistry->erase(key);
+                        if (newEpoch == dbHandlerEpoch + 1) {
+                            dbHandlerEpoch = newEpoch;
+                        }
+                    }
+                    publishDbi();
                 }
-                auto oldestTxn = ctx.dbTxnStat->minActiveTxnId();
-                auto currentMinVersion = (oldestTxn.first != 0) ? oldestTxn.second : versionId - 1;
+                // the previous version is the latest one until this txn is committed
+                auto currentMinVersion = ctx.dbTxnStat->minActiveVersionId();
                 // commit changes in database schema
                 if (ucSchema.size() > 0) {
                     DeleteQueue<ClassId> tmpDeletedClassId;
+                    DeleteQueue<ClassId> tmpStaleClassId;
+                    DeleteQueue<std::pair<ClassId, std::string>> tmpStaleClassNames;
                     for (const auto &classDescriptor: ucSchema) {
                         if (auto classDescriptorPtr = classDescriptor.second) {
                             auto currentStatus = classDescriptorPtr->getState().second;
                             if (currentStatus == TxnObject::StatusFlag::UNCOMMITTED_DELETE) {
                                 tmpDeletedClassId.emplace_back(std::make_pair(classDescriptorPtr->id, versionId));
+                                dbHandlerRegistry->erase(
+                                        DBHandlerRegistry::makeKey(DBHandlerRegistry::CLASS, classDescriptorPtr->id));
                             } else if (currentStatus == TxnObject::StatusFlag::UNCOMMITTED_CREATE) {
                                 ctx.dbSchema->schemaInfo.lockAndEmplace(classDescriptorPtr->id, classDescriptorPtr);
                             } else {
+                                auto oldName = classDescriptorPtr->name.getStableVersion();
+                                auto newName = classDescriptorPtr->name.getUnstableVersion();
+                                if (oldName.second && newName.second && oldName.first != newName.first) {
+                                    tmpStaleClassNames.emplace_back(
+                                            std::make_pair(std::make_pair(classDescriptorPtr->id, oldName.first),
+                                                           versionId));
+                                }
                                 classDescriptorPtr->name.clearStableVersion(currentMinVersion);
                                 classDescriptorPtr->properties.clearStableVersion(currentMinVersion);
                                 classDescriptorPtr->super.clearStableVersion(currentMinVersion);
                                 classDescriptorPtr->sub.clearStableVersion(currentMinVersion);
+                                classDescriptorPtr->compositeIndexes.clearStableVersion(currentMinVersion);
+                                tmpStaleClassId.emplace_back(std::make_pair(classDescriptorPtr->id, versionId));
                             }
                             classDescriptorPtr->updateState(versionId);
                             classDescriptorPtr->name.upgradeStableVersion(versionId);
                             classDescriptorPtr->properties.upgradeStableVersion(versionId);
                             classDescriptorPtr->super.upgradeStableVersion(versionId);
                             classDescriptorPtr->sub.upgradeStableVersion(versionId);
+                            classDescriptorPtr->compositeIndexes.upgradeStableVersion(versionId);
+                            // a name is indexed after it is committed so that a stale name being erased concurrently
+                            // is either seen as the current name or inserted again
+                            if (currentStatus != TxnObject::StatusFlag::UNCOMMITTED_DELETE) {
+                                ctx.dbSchema->classNames.insert(classDescriptorPtr->name.getStableVersion().first,
+                                                                classDescriptorPtr->id);
+                            }
                         }
                     }
                     ctx.dbSchema->deletedClassId.push_back(tmpDeletedClassId);
+                    ctx.dbSchema->staleClassId.push_back(tmpStaleClassId);
+                    ctx.dbSchema->staleClassNames.push_back(tmpStaleClassNames);
+                    // property layouts resolved against the previous schema version must be resolved again
+                    ctx.dbSchema->classProperties.reset(versionId);
                 }
                 // commit changes in database relation
                 if (ucVertices.size() + ucEdges.size() > 0) {
                     DeleteQueue<RecordId> tmpDeletedVertices;
                     DeleteQueue<RecordId> tmpDeletedEdges;
+                    DeleteQueue<RecordId> tmpStaleVertices;
+                    DeleteQueue<RecordId> tmpStaleEdges;
                     for (const auto &vertex: ucVertices) {
                         if (auto vertexPtr = vertex.second) {
                             auto currentStatus = vertexPtr->getState().second;
@@ -175,35 +306,32 @@ namespace nogdb {
                             } else {
                                 edgePtr->source.clearStableVersion(currentMinVersion);
                                 edgePtr->target.clearStableVersion(currentMinVersion);
+                                tmpStaleEdges.emplace_back(std::make_pair(edgePtr->rid, versionId));
                             }
 
                             auto srcVertexUnstable = edgePtr->source.getUnstableVersion();
                             if (auto srcVertexUnstablePtr = srcVertexUnstable.first.lock()) {
                                 srcVertexUnstablePtr->out.clear(currentMinVersion);
-                                if (auto tmp = srcVertexUnstablePtr->out.get(edgePtr->rid.first, edgePtr->rid.second)) {
-                                    tmp->upgradeStableVersion(versionId);
-                                }
+                                srcVertexUnstablePtr->out.upgrade(edgePtr->rid.first, edgePtr->rid.second, versionId);
+                                tmpStaleVertices.emplace_back(std::make_pair(srcVertexUnstablePtr->rid, versionId));
                             }
                             auto srcVertexStable = edgePtr->source.getStableVersion();
                             if (auto srcVertexStablePtr = srcVertexStable.first.lock()) {
                                 srcVertexStablePtr->out.clear(currentMinVersion);
-                                if (auto tmp = srcVertexStablePtr->out.get(edgePtr->rid.first, edgePtr->rid.second)) {
-                                    tmp->upgradeStableVersion(versionId);
-                                }
+                                srcVertexStablePtr->out.upgrade(edgePtr->rid.first, edgePtr->rid.second, versionId);
+                                tmpStaleVertices.emplace_back(std::make_pair(srcVertexStablePtr->rid, versionId));
                             }
                             auto dstVertexUnstable = edgePtr->target.getUnstableVersion();
                             if (auto dstVertexUnstablePtr = dstVertexUnstable.first.lock()) {
                                 dstVertexUnstablePtr->in.clear(currentMinVersion);
-                                if (auto tmp = dstVertexUnstablePtr->in.get(edgePtr->rid.first, edgePtr->rid.second)) {
-                                    tmp->upgradeStableVersion(versionId);
-                                }
+                                dstVertexUnstablePtr->in.upgrade(edgePtr->rid.first, edgePtr->rid.second, versionId);
+                                tmpStaleVertices.emplace_back(std::make_pair(dstVertexUnstablePtr->rid, versionId));
                             }
                             auto dstVertexStable = edgePtr->target.getStableVersion();
                             if (auto dstVertexStablePtr = dstVertexStable.first.lock()) {
                                 dstVertexStablePtr->in.clear(currentMinVersion);
-                                if (auto tmp = dstVertexStablePtr->in.get(edgePtr->rid.first, edgePtr->rid.second)) {
-                                    tmp->upgradeStableVersion(versionId);
-                                }
+                                dstVertexStablePtr->in.upgrade(edgePtr->rid.first, edgePtr->rid.second, versionId);
+                                tmpStaleVertices.emplace_back(std::make_pair(dstVertexStablePtr->rid, versionId));
                             }
                             edgePtr->updateState(versionId);
                             edgePtr->source.upgradeStableVersion(versionId);
@@ -212,6 +340,8 @@ namespace nogdb {
                     }
                     ctx.dbRelation->deletedVertices.push_back(tmpDeletedVertices);
                     ctx.dbRelation->deletedEdges.push_back(tmpDeletedEdges);
+                    ctx.dbRelation->staleVertices.push_back(tmpStaleVertices);
+                    ctx.dbRelation->staleEdges.push_back(tmpStaleEdges);
                 }
                 if (ucSchema.size() + ucVertices.size() + ucEdges.size() > 0) {
                     {   // save changes in dbInfo
@@ -221,19 +351,12 @@ namespace nogdb {
                     // allow the next txns to see the latest version and updates
                     ctx.dbTxnStat->fetchAddMaxVersionId();
                 }
-                auto minTxn = ctx.dbTxnStat->minActiveTxnId();
-                if (minTxn.first == 0 && minTxn.second == 0) {
-                    ctx.dbSchema->clearDeletedElements(versionId);
-                    ctx.dbRelation->clearDeletedElements(versionId);
-                }
+                ctx.dbReclaimer->reclaim();
             } else {
-                if (ctx.dbTxnStat->isLastMinVersionId(txnId)) {
-                    ctx.dbSchema->clearDeletedElements(versionId + 1);
-                    ctx.dbRelation->clearDeletedElements(versionId + 1);
-                }
-                ctx.dbTxnStat->removeActiveTxnId(txnId);
+                ctx.dbTxnStat->removeActiveTxnId(txnId, activeTxnSlot);
+                ctx.dbReclaimer->reclaim();
                 if (isWithDataStore) {
-                    Datastore::abortTxn(dsTxnHandler);
+                    endReadOnlyDatastore();
                 }
             }
             isCompleted = true;
@@ -306,13 +429,15 @@ namespace nogdb {
                     classDescriptorPtr->properties.disableUnstableVersion();
                     classDescriptorPtr->super.disableUnstableVersion();
                     classDescriptorPtr->sub.disableUnstableVersion();
+                    classDescriptorPtr->compositeIndexes.disableUnstableVersion();
                 }
             } else {
-                if (ctx.dbTxnStat->isLastMinVersionId(txnId)) {
-                    ctx.dbRelation->clearDeletedElements(versionId + 1);
-                    ctx.dbSchema->clearDeletedElements(versionId + 1);
+                ctx.dbTxnStat->removeActiveTxnId(txnId, activeTxnSlot);
+                ctx.dbReclaimer->reclaim();
+                if (isWithDataStore) {
+                    endReadOnlyDatastore();
+                    isCommitDatastore = true;
                 }
-                ctx.dbTxnStat->removeActiveTxnId(txnId);
             }
             if (isWithDataStore && !isCommitDatastore) {
                 Datastore::abortTxn(dsTxnHandler);
@@ -23,8 +23,10 @@
 #define __BASE_TXN_HPP_INCLUDED_
 
 #include <atomic>
+#include <vector>
 
 #include "datastore.hpp"
+#include "dbi_registry.hpp"
 #include "txn_object.hpp"
 #include "graph.hpp"
 #include "schema.hpp"
@@ -65,6 +67,22 @@ namespace nogdb {
 
         const TxnId &getTxnId() const { return txnId; }
 
+        // property layouts of classes shared by txns which see the latest committed schema
+        Schema::ClassPropertyTable &getClassPropertyTable() const { return dbSchema->classProperties; }
+
+        Datastore::DBHandler openClassDbi(ClassId classId);
+
+        // check if a handle of a class table has been published, so that it is also valid in txns beginning later
+        bool isPublishedClassDbi(ClassId classId) const;
+
+        Datastore::DBHandler openIndexDbi(IndexId indexId, bool isNumericKey, bool isUnique);
+
+        Datastore::DBHandler openSignedIndexDbi(IndexId indexId, bool isPositive, bool isUnique);
+
+        Datastore::DBHandler openRelationDbi();
+
+        void dropDbi(DBHandlerRegistry::DBType type, uint32_t id, Datastore::DBHandler dbHandler);
+
         void addUncommittedVertex(const std::shared_ptr<Graph::Vertex> &vertex);
 
         void addUncommittedEdge(const std::shared_ptr<Graph::Edge> &edge);
@@ -118,15 +136,29 @@ namespace nogdb {
         Datastore::TxnHandler *dsTxnHandler;
         TxnId txnId;
         TxnId versionId;
+        size_t activeTxnSlot{0};
         TxnType txnType;
         Schema::SchemaElements<ClassId, Schema::ClassDescriptor> ucSchema;
         Graph::GraphElements<Graph::Vertex> ucVertices;
         Graph::GraphElements<Graph::Edge> ucEdges;
 
+        std::shared_ptr<Schema> dbSchema;
+        std::shared_ptr<DBHandlerRegistry> dbHandlerRegistry;
+        uint64_t dbHandlerEpoch{0};
+        uint64_t dbHandlerGeneration{0};
+        DBHandlerRegistry::DBHandlers ucDBHandlers;
+        std::vector<DBHandlerRegistry::Key> droppedDBHandlers;
+
         bool isWithDataStore;
         bool isCompleted{false}; // throw error if working with isCompleted = true
         bool isCommitDatastore{false};
 
+        Datastore::DBHandler openDbi(DBHandlerRegistry::DBType type, uint32_t id, bool isNumericKey, bool isUnique);
+
+        void publishDbi();
+
+        void endReadOnlyDatastore() noexcept;
+
     };
 
 }
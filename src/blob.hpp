@@ -22,6 +22,8 @@
 #ifndef __BLOB_HPP_INCLUDED_
 #define __BLOB_HPP_INCLUDED_
 
+#include <cstddef>
+
 namespace nogdb {
 
     class Blob {
@@ -29,6 +29,7 @@
 #include "base_txn.hpp"
 #include "env_handler.hpp"
 #include "datastore.hpp"
+#include "relation.hpp"
 #include "generic.hpp"
 #include "validate.hpp"
 
@@ -71,7 +72,7 @@ namespace nogdb {
             value.append(className.c_str(), strlen(className.c_str()));
             Datastore::putRecord(dsTxnHandler, classDBHandler, dbInfo.maxClassId, value, true);
             // create interface for itself
-            auto newClassDBHandler = Datastore::openDbi(dsTxnHandler, std::to_string(dbInfo.maxClassId), true);
+            auto newClassDBHandler = txn.txnBase->openClassDbi(dbInfo.maxClassId);
             Datastore::putRecord(dsTxnHandler, newClassDBHandler, EM_MAXRECNUM, PositionId{1}, true);
 
             // update in-memory schema and info
@@ -122,7 +123,7 @@ namespace nogdb {
             value.append(className.c_str(), strlen(className.c_str()));
             Datastore::putRecord(dsTxnHandler, classDBHandler, dbInfo.maxClassId, value, true);
             // create interface for itself
-            auto newClassDBHandler = Datastore::openDbi(dsTxnHandler, std::to_string(dbInfo.maxClassId), true);
+            auto newClassDBHandler = txn.txnBase->openClassDbi(dbInfo.maxClassId);
             Datastore::putRecord(dsTxnHandler, newClassDBHandler, EM_MAXRECNUM, PositionId{1}, true);
 
             // update in-memory schema and info
@@ -162,8 +163,12 @@ namespace nogdb {
             if (!property.second.indexInfo.empty()) {
                 throw Error(CTX_IN_USED_PROPERTY, Error::Type::CONTEXT);
             }
+            Validate::isNotUsedInCompositeIndex(*txn.txnBase, foundClass, property.second.id);
             propertyIds.push_back(property.second.id);
         }
+        if (!foundClass->compositeIndexes.getLatestVersion().first.empty()) {
+            throw Error(CTX_IN_USED_PROPERTY, Error::Type::CONTEXT);
+        }
 
         auto rids = std::vector<RecordId>{};
         auto dsTxnHandler = txn.txnBase->getDsTxnHandler();
@@ -180,8 +185,8 @@ namespace nogdb {
                 //TODO: implement existing index deletion if needed
             }
             // delete all associated relations
-            auto relationDBHandler = Datastore::openDbi(dsTxnHandler, TB_RELATIONS);
-            auto dbHandler = Datastore::openDbi(dsTxnHandler, std::to_string(foundClass->id), true);
+            auto relationDBHandler = txn.txnBase->openRelationDbi();
+            auto dbHandler = txn.txnBase->openClassDbi(foundClass->id);
             auto cursorHandler = Datastore::CursorHandlerWrapper(dsTxnHandler, dbHandler);
             auto keyValue = Datastore::getNextCursor(cursorHandler.get());
             while (!keyValue.empty()) {
@@ -189,13 +194,13 @@ namespace nogdb {
                 if (*key != EM_MAXRECNUM) {
                     auto recordId = RecordId{foundClass->id, *key};
                     if (foundClass->type == ClassType::EDGE) {
-                        Datastore::deleteRecord(dsTxnHandler, relationDBHandler, rid2str(recordId));
+                        Relation::remove(dsTxnHandler, relationDBHandler, recordId);
                     } else {
                         try {
                             for (const auto &edgeId : txn.txnCtx.dbRelation->getEdgeInOut(*txn.txnBase, recordId)) {
-                                auto edgeClassDBHandler = Datastore::openDbi(dsTxnHandler, std::to_string(edgeId.first), true);
+                                auto edgeClassDBHandler = txn.txnBase->openClassDbi(edgeId.first);
                                 Datastore::deleteRecord(dsTxnHandler, edgeClassDBHandler, edgeId.second);
-                                Datastore::deleteRecord(dsTxnHandler, relationDBHandler, rid2str(edgeId));
+                                Relation::remove(dsTxnHandler, relationDBHandler, edgeId);
                             }
                         } catch (Graph::ErrorType &err) {
                             if (err != GRAPH_NOEXST_VERTEX) {
@@ -209,7 +214,7 @@ namespace nogdb {
             }
 
             // drop the actual table
-            Datastore::dropDbi(dsTxnHandler, dbHandler);
+            txn.txnBase->dropDbi(DBHandlerRegistry::CLASS, foundClass->id, dbHandler);
 
             // prepare for class inheritance
             auto superClassDescriptor = foundClass->super.getLatestVersion().first.lock();
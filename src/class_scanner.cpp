@@ -0,0 +1,91 @@
+/*
+ *  Copyright (C) 2018, Throughwave (Thailand) Co., Ltd.
+ *  <peerawich at throughwave dot co dot th>
+ *
+ *  This file is part of libnogdb, the NogDB core library in C++.
+ *
+ *  libnogdb is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "class_scanner.hpp"
+
+namespace nogdb {
+
+    ClassScanner::~ClassScanner() noexcept {
+        stopWorkers();
+    }
+
+    void ClassScanner::setNumThreads(unsigned int numThreads) {
+        std::lock_guard<std::mutex> _(configMutex_);
+        numThreads = (numThreads == 0) ? std::max(std::thread::hardware_concurrency(), 1U) : numThreads;
+        stopWorkers();
+        {
+            std::lock_guard<std::mutex> poolLock(poolMutex_);
+            isStopping_ = false;
+        }
+        try {
+            for (auto i = 1U; i < numThreads; ++i) {
+                workers_.emplace_back([this]() {
+                    std::unique_lock<std::mutex> lock(poolMutex_);
+                    while (true) {
+                        poolCondition_.wait(lock, [this]() { return isStopping_ || !tasks_.empty(); });
+                        if (isStopping_) {
+                            return;
+                        }
+                        auto task = std::move(tasks_.front());
+                        tasks_.pop_front();
+                        lock.unlock();
+                        task();
+                        lock.lock();
+                    }
+                });
+            }
+        } catch (...) {
+            stopWorkers();
+            numThreads_ = 1;
+            throw;
+        }
+        numThreads_ = numThreads;
+    }
+
+    void ClassScanner::submit(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> _(poolMutex_);
+            if (workers_.empty() || isStopping_) {
+                return;
+            }
+            tasks_.push_back(std::move(task));
+        }
+        poolCondition_.notify_one();
+    }
+
+    void ClassScanner::stopWorkers() noexcept {
+        {
+            std::lock_guard<std::mutex> _(poolMutex_);
+            isStopping_ = true;
+            // queued tasks of scans which have already ended would only return immediately
+            tasks_.clear();
+        }
+        poolCondition_.notify_all();
+        for (auto &worker: workers_) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+        std::lock_guard<std::mutex> _(poolMutex_);
+        workers_.clear();
+    }
+
+}
@@ -0,0 +1,276 @@
+/*
+ *  Copyright (C) 2018, Throughwave (Thailand) Co., Ltd.
+ *  <peerawich at throughwave dot co dot th>
+ *
+ *  This file is part of libnogdb, the NogDB core library in C++.
+ *
+ *  libnogdb is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef __CLASS_SCANNER_HPP_INCLUDED_
+#define __CLASS_SCANNER_HPP_INCLUDED_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "constant.hpp"
+#include "schema.hpp"
+#include "datastore.hpp"
+#include "env_handler.hpp"
+#include "base_txn.hpp"
+
+#include "nogdb_context.h"
+#include "nogdb_txn.h"
+
+namespace nogdb {
+
+    // scans records of classes in ranges of position ids, which are taken by a calling thread and a persistent pool
+    // of worker threads each with its own read-only datastore txn, and merges results in the order of keys
+    // NOTE: a scan is sequential unless more than one thread is set on a context, a calling txn is read-only,
+    // since uncommitted records of a read-write txn cannot be seen by other txns, and there are at least
+    // CLASS_SCAN_MIN_RECORDS_PER_THREAD records of published class tables for every thread to be used
+    // NOTE: an lmdb txn cannot be shared among threads and a new one always reads the latest snapshot, so a scan of
+    // an older snapshot than the last commit is sequential, and a worker which begins its txn after another commit
+    // leaves all parts to the others, both of which are counted in ScanStat::numSnapshotFallbacks
+    class ClassScanner {
+    public:
+        ClassScanner() = default;
+
+        ~ClassScanner() noexcept;
+
+        ClassScanner(const ClassScanner &) = delete;
+
+        ClassScanner &operator=(const ClassScanner &) = delete;
+
+        // 0 uses all hardware threads and 1 disables parallel scans
+        // NOTE: the pool is restarted with numThreads - 1 workers, and the calling thread of a scan is the last one
+        void setNumThreads(unsigned int numThreads);
+
+        unsigned int getNumThreads() const { return numThreads_; }
+
+        ScanStat getStat() const {
+            auto stat = ScanStat{};
+            stat.numParallelScans = numParallelScans_.load(std::memory_order_relaxed);
+            stat.numSnapshotFallbacks = numSnapshotFallbacks_.load(std::memory_order_relaxed);
+            return stat;
+        }
+
+        // call visit(result, classIndex, positionId, keyValue) for every record of classes where classIndex is a
+        // position in classInfos and result is a part of the returned vector in which matching elements are kept
+        // NOTE: visit may be called by many threads at the same time but never for the same part
+        template<typename T, typename Visitor>
+        static std::vector<T> scan(const Txn &txn, const std::vector<ClassInfo> &classInfos, const Visitor &visit) {
+            struct Part {
+                size_t classIndex;
+                Datastore::DBHandler classDBHandler;
+                uint64_t lower;
+                uint64_t upper;
+            };
+            auto dsTxnHandler = txn.txnBase->getDsTxnHandler();
+            auto &scanner = txn.txnCtx.dbScanner;
+            auto numThreads = (scanner != nullptr && txn.getTxnMode() == Txn::READ_ONLY) ?
+                              scanner->getNumThreads() : 1U;
+            // dbi handles are opened by the calling thread before they are shared with the other threads
+            // NOTE: a handle which has just been opened by a calling txn is not valid in any other txn until the
+            // calling txn ends, so a class with such a handle is scanned only by the calling thread
+            auto parts = std::vector<Part>{};
+            auto localParts = std::vector<size_t>{};
+            auto sharedParts = std::vector<size_t>{};
+            auto numSharedRecords = size_t{0};
+            for (auto classIndex = size_t{0}; classIndex < classInfos.size(); ++classIndex) {
+                auto classDBHandler = txn.txnBase->openClassDbi(classInfos[classIndex].id);
+                auto lower = uint64_t{EM_MAXRECNUM} + 1;
+                auto upper = uint64_t{std::numeric_limits<PositionId>::max()} + 1;
+                auto numParts = uint64_t{1};
+                auto isShared = numThreads > 1 && txn.txnBase->isPublishedClassDbi(classInfos[classIndex].id);
+                if (isShared) {
+                    auto numRecords = Datastore::getNumRecords(dsTxnHandler, classDBHandler);
+                    numSharedRecords += numRecords;
+                    numParts = std::max<uint64_t>(std::min<uint64_t>(numThreads,
+                                                                     numRecords / CLASS_SCAN_MIN_RECORDS_PER_THREAD), 1);
+                    if (numParts > 1) {
+                        auto firstCursor = Datastore::CursorHandlerWrapper(dsTxnHandler, classDBHandler);
+                        auto lastCursor = Datastore::CursorHandlerWrapper(dsTxnHandler, classDBHandler);
+                        auto firstKeyValue = Datastore::getSetRangeCursor(firstCursor.get(),
+                                                                          static_cast<PositionId>(lower));
+                        auto lastKeyValue = Datastore::getPrevCursor(lastCursor.get());
+                        lower = *Datastore::getKeyAsNumeric<PositionId>(firstKeyValue);
+                        upper = uint64_t{*Datastore::getKeyAsNumeric<PositionId>(lastKeyValue)} + 1;
+                        numParts = std::min(numParts, upper - lower);
+                    }
+                }
+                for (auto i = uint64_t{0}; i < numParts; ++i) {
+                    (isShared ? sharedParts : localParts).push_back(parts.size());
+                    parts.push_back(Part{classIndex, classDBHandler,
+                                         lower + (upper - lower) * i / numParts,
+                                         lower + (upper - lower) * (i + 1) / numParts});
+                }
+            }
+            auto scanPart = [&visit](const Part &part, Datastore::TxnHandler *partTxn, std::vector<T> &result) {
+                auto cursorHandler = Datastore::CursorHandlerWrapper(partTxn, part.classDBHandler);
+                for (auto keyValue = Datastore::getSetRangeCursor(cursorHandler.get(),
+                                                                  static_cast<PositionId>(part.lower));
+                     !keyValue.empty();
+                     keyValue = Datastore::getNextCursor(cursorHandler.get())) {
+                    auto positionId = *Datastore::getKeyAsNumeric<PositionId>(keyValue);
+                    if (positionId >= part.upper) {
+                        break;
+                    }
+                    visit(result, part.classIndex, positionId, keyValue);
+                }
+            };
+            // threads are only started when there are enough records for each of them
+            auto numWorkers = std::min<size_t>(std::min<size_t>(numThreads, sharedParts.size()),
+                                               numSharedRecords / CLASS_SCAN_MIN_RECORDS_PER_THREAD);
+            // new txns of workers always read the latest snapshot, so a scan of an older snapshot stays on the
+            // calling thread
+            auto envHandler = txn.txnCtx.envHandler->get();
+            auto snapshotId = Datastore::getTxnId(dsTxnHandler);
+            auto isFallback = numWorkers > 1 && Datastore::getLastTxnId(envHandler) != snapshotId;
+            if (isFallback) {
+                ++scanner->numSnapshotFallbacks_;
+            }
+            if (numWorkers <= 1 || isFallback) {
+                auto result = std::vector<T>{};
+                for (const auto &part: parts) {
+                    scanPart(part, dsTxnHandler, result);
+                }
+                return result;
+            }
+
+            // a state of a scan is shared with workers of the pool since a worker may only start after the scan
+            // has ended, in which case it returns without touching anything else of the scan
+            struct SharedState {
+                std::vector<std::vector<T>> results;
+                std::vector<std::exception_ptr> errors;
+                std::atomic<size_t> nextSharedPart{0};
+                std::atomic<bool> isFallback{false};
+                std::mutex mutex{};
+                std::condition_variable condition{};
+                size_t numActiveWorkers{0};
+                bool isClosed{false};
+            };
+            auto state = std::make_shared<SharedState>();
+            state->results.resize(parts.size());
+            state->errors.resize(parts.size());
+            auto scanSharedParts = [&parts, &sharedParts, &scanPart](SharedState &state,
+                                                                     Datastore::TxnHandler *partTxn) {
+                for (auto i = state.nextSharedPart++; i < sharedParts.size(); i = state.nextSharedPart++) {
+                    auto part = sharedParts[i];
+                    try {
+                        scanPart(parts[part], partTxn, state.results[part]);
+                    } catch (...) {
+                        state.errors[part] = std::current_exception();
+                    }
+                }
+            };
+            auto scanWorkerParts = [state, envHandler, snapshotId, &scanSharedParts]() {
+                {
+                    std::lock_guard<std::mutex> _(state->mutex);
+                    if (state->isClosed) {
+                        return;
+                    }
+                    ++state->numActiveWorkers;
+                }
+                // a worker which cannot read the same snapshot after another commit leaves all parts to the others
+                auto partTxn = static_cast<Datastore::TxnHandler *>(nullptr);
+                try {
+                    partTxn = Datastore::beginTxn(envHandler, Datastore::TXN_RO);
+                } catch (Datastore::ErrorType &) {
+                    partTxn = nullptr;
+                }
+                if (partTxn != nullptr && Datastore::getTxnId(partTxn) == snapshotId) {
+                    scanSharedParts(*state, partTxn);
+                } else {
+                    state->isFallback = true;
+                }
+                if (partTxn != nullptr) {
+                    Datastore::abortTxn(partTxn);
+                }
+                {
+                    std::lock_guard<std::mutex> _(state->mutex);
+                    --state->numActiveWorkers;
+                }
+                state->condition.notify_all();
+            };
+            for (auto i = size_t{1}; i < numWorkers; ++i) {
+                scanner->submit(scanWorkerParts);
+            }
+            for (const auto &part: localParts) {
+                try {
+                    scanPart(parts[part], dsTxnHandler, state->results[part]);
+                } catch (...) {
+                    state->errors[part] = std::current_exception();
+                }
+            }
+            scanSharedParts(*state, dsTxnHandler);
+            {
+                // all parts have been taken, so only workers which are still scanning their parts are waited for
+                std::unique_lock<std::mutex> lock(state->mutex);
+                state->isClosed = true;
+                state->condition.wait(lock, [&state]() { return state->numActiveWorkers == 0; });
+            }
+            ++scanner->numParallelScans_;
+            if (state->isFallback) {
+                ++scanner->numSnapshotFallbacks_;
+            }
+            for (const auto &error: state->errors) {
+                if (error) {
+                    std::rethrow_exception(error);
+                }
+            }
+            auto numResults = size_t{0};
+            for (const auto &result: state->results) {
+                numResults += result.size();
+            }
+            auto result = std::vector<T>{};
+            result.reserve(numResults);
+            for (auto &partResult: state->results) {
+                std::move(partResult.begin(), partResult.end(), std::back_inserter(result));
+            }
+            return result;
+        }
+
+    private:
+        std::atomic<unsigned int> numThreads_{1};
+        std::atomic<uint64_t> numParallelScans_{0};
+        std::atomic<uint64_t> numSnapshotFallbacks_{0};
+
+        std::mutex configMutex_{};
+        std::mutex poolMutex_{};
+        std::condition_variable poolCondition_{};
+        std::deque<std::function<void()>> tasks_{};
+        std::vector<std::thread> workers_{};
+        bool isStopping_{false};
+
+        // queue a task for the pool (or drop it if there is no worker)
+        void submit(std::function<void()> task);
+
+        void stopWorkers() noexcept;
+    };
+
+}
+
+#endif
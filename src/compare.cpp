@@ -22,7 +22,6 @@
 #include <cassert>
 #include <vector>
 #include <algorithm>
-#include <regex>
 
 #include "shared_lock.hpp"
 #include "constant.hpp"
@@ -33,7 +32,10 @@
 #include "generic.hpp"
 #include "compare.hpp"
 #include "index.hpp"
+#include "class_scanner.hpp"
 #include "utils.hpp"
+#include "text_matcher.hpp"
+#include "text_search.hpp"
 
 #include "nogdb_errors.h"
 #include "nogdb_compare.h"
@@ -41,11 +43,6 @@
 namespace nogdb {
 
     bool Compare::compareBytesValue(const Bytes &value, PropertyType type, const Condition &condition) {
-        auto to_lower = [](const std::string &text) {
-            auto tmp = std::string{};
-            std::transform(text.cbegin(), text.cend(), std::back_inserter(tmp), ::tolower);
-            return tmp;
-        };
         auto cmp_function = [&](const Bytes &cmpValue1,
                                 const Bytes &cmpValue2,
                                 Condition::Comparator cmp,
@@ -283,44 +280,44 @@ namespace nogdb {
                             throw Error(CTX_INVALID_COMPARATOR, Error::Type::CONTEXT);
                     }
                 case PropertyType::TEXT: {
-                    auto textValue = (isIgnoreCase) ? to_lower(value.toText()) : value.toText();
-                    auto textCmpValue1 = (isIgnoreCase) ? to_lower(cmpValue1.toText()) : cmpValue1.toText();
-                    auto textCmpValue2 = (cmpValue2.empty()) ? "" : ((isIgnoreCase) ? to_lower(cmpValue2.toText())
-                                                                                    : cmpValue2.toText());
+                    auto text = static_cast<const unsigned char *>(value.getRaw());
+                    auto size = value.size();
+                    auto compareText = [&](const Bytes &cmpValue) {
+                        return TextSearch::compare(text, size, cmpValue.getRaw(), cmpValue.size(), isIgnoreCase);
+                    };
                     switch (cmp) {
                         case Condition::Comparator::EQUAL:
-                            return textValue == textCmpValue1;
+                            return compareText(cmpValue1) == 0;
                         case Condition::Comparator::GREATER:
-                            return textValue > textCmpValue1;
+                            return compareText(cmpValue1) > 0;
                         case Condition::Comparator::GREATER_EQUAL:
-                            return textValue >= textCmpValue1;
+                            return compareText(cmpValue1) >= 0;
                         case Condition::Comparator::LESS:
-                            return textValue < textCmpValue1;
+                            return compareText(cmpValue1) < 0;
                         case Condition::Comparator::LESS_EQUAL:
-                            return textValue <= textCmpValue1;
+                            return compareText(cmpValue1) <= 0;
                         case Condition::Comparator::CONTAIN:
-                            return textValue.find(textCmpValue1) < strlen(textValue.c_str());
+                            // a text is only searched up to its first null character as std::string::c_str() does
+                            return TextSearch::find(text, size, cmpValue1.getRaw(), cmpValue1.size(), isIgnoreCase) <
+                                   strnlen(reinterpret_cast<const char *>(text), size);
                         case Condition::Comparator::BEGIN_WITH:
-                            return textValue.find(textCmpValue1) == 0;
+                            return TextSearch::beginWith(text, size, cmpValue1.getRaw(), cmpValue1.size(), isIgnoreCase);
                         case Condition::Comparator::END_WITH:
-                            std::reverse(textValue.begin(), textValue.end());
-                            std::reverse(textCmpValue1.begin(), textCmpValue1.end());
-                            return textValue.find(textCmpValue1) == 0;
+                            return TextSearch::endWith(text, size, cmpValue1.getRaw(), cmpValue1.size(), isIgnoreCase);
                         case Condition::Comparator::LIKE:
-                            replaceAll(textCmpValue1, "%", "(.*)");
-                            replaceAll(textCmpValue1, "_", "(.)");
-                            return std::regex_match(textValue, std::regex(textCmpValue1));
-                        case Condition::Comparator::REGEX: {
-                            return std::regex_match(textValue, std::regex(textCmpValue1));
-                        }
+                            return TextMatcher{TextMatcher::Kind::LIKE, cmpValue1.toText(), isIgnoreCase}
+                                    .match(value.getRaw(), value.size());
+                        case Condition::Comparator::REGEX:
+                            return TextMatcher{TextMatcher::Kind::REGEX, cmpValue1.toText(), isIgnoreCase}
+                                    .match(value.getRaw(), value.size());
                         case Condition::Comparator::BETWEEN:
-                            return (textCmpValue1 <= textValue) && (textValue <= textCmpValue2);
+                            return compareText(cmpValue1) >= 0 && compareText(cmpValue2) <= 0;
                         case Condition::Comparator::BETWEEN_NO_LOWER:
-                            return (textCmpValue1 < textValue) && (textValue <= textCmpValue2);
+                            return compareText(cmpValue1) > 0 && compareText(cmpValue2) <= 0;
                         case Condition::Comparator::BETWEEN_NO_UPPER:
-                            return (textCmpValue1 <= textValue) && (textValue < textCmpValue2);
+                            return compareText(cmpValue1) >= 0 && compareText(cmpValue2) < 0;
                         case Condition::Comparator::BETWEEN_NO_BOUND:
-                            return (textCmpValue1 < textValue) && (textValue < textCmpValue2);
+                            return compareText(cmpValue1) > 0 && compareText(cmpValue2) < 0;
                         default:
                             throw Error(CTX_INVALID_COMPARATOR, Error::Type::CONTEXT);
                     }
@@ -336,6 +333,10 @@ namespace nogdb {
                     throw Error(CTX_INVALID_PROPTYPE, Error::Type::CONTEXT);
             }
         };
+        if (type == PropertyType::TEXT && condition.matcher &&
+            (condition.comp == Condition::Comparator::LIKE || condition.comp == Condition::Comparator::REGEX)) {
+            return condition.matcher->match(value.getRaw(), value.size()) ^ condition.isNegative;
+        }
         if (condition.comp == Condition::Comparator::IN) {
             for (const auto &valueBytes: condition.valueSet) {
                 if (cmp_function(valueBytes, Bytes{}, Condition::Comparator::EQUAL, condition.isIgnoreCase) ^
@@ -362,80 +363,54 @@ namespace nogdb {
                                           const std::vector<ClassInfo> &classInfos,
                                           const Condition &condition,
                                           PropertyType type) {
-        auto result = ResultSet{};
         try {
+            auto predicates = std::vector<RawPredicate>{};
             for (const auto &classInfo: classInfos) {
-                auto classDBHandler = Datastore::openDbi(txn.txnBase->getDsTxnHandler(), std::to_string(classInfo.id), true);
-                auto cursorHandler = Datastore::CursorHandlerWrapper(txn.txnBase->getDsTxnHandler(), classDBHandler);
-                auto keyValue = Datastore::getNextCursor(cursorHandler.get());
-                while (!keyValue.empty()) {
-                    auto key = Datastore::getKeyAsNumeric<PositionId>(keyValue);
-                    if (*key != EM_MAXRECNUM) {
-                        auto record = Parser::parseRawData(keyValue, classInfo.propertyInfo);
-                        auto tmpRecord = record.set(CLASS_NAME_PROPERTY, classInfo.name)
-                                .set(RECORD_ID_PROPERTY, rid2str(RecordId{classInfo.id, *key}));
-                        if (condition.comp != Condition::Comparator::IS_NULL &&
-                            condition.comp != Condition::Comparator::NOT_NULL) {
-                            if (tmpRecord.get(condition.propName).empty()) {
-                                keyValue = Datastore::getNextCursor(cursorHandler.get());
-                                continue;
-                            }
-                            if (compareBytesValue(tmpRecord.get(condition.propName), type, condition)) {
-                                result.push_back(Result{RecordDescriptor{classInfo.id, *key}, record});
-                            }
-                        } else {
-                            switch (condition.comp) {
-                                case Condition::Comparator::IS_NULL:
-                                    if (tmpRecord.get(condition.propName).empty()) {
-                                        result.push_back(Result{RecordDescriptor{classInfo.id, *key}, record});
-                                    }
-                                    break;
-                                case Condition::Comparator::NOT_NULL:
-                                    if (!tmpRecord.get(condition.propName).empty()) {
-                                        result.push_back(Result{RecordDescriptor{classInfo.id, *key}, record});
-                                    }
-                                    break;
-                                default:
-                                    throw Error(CTX_INVALID_COMPARATOR, Error::Type::CONTEXT);
-                            }
-                        }
-                    }
-                    keyValue = Datastore::getNextCursor(cursorHandler.get());
-                }
+                predicates.emplace_back(condition, type, classInfo);
             }
+            auto visit = [&](ResultSet &result, size_t classIndex, PositionId positionId,
+                             const KeyValue &keyValue) {
+                auto &classInfo = classInfos[classIndex];
+                auto rid = RecordId{classInfo.id, positionId};
+                auto &rawData = keyValue.value();
+                // only a matching record is parsed
+                if (predicates[classIndex](rid, static_cast<const unsigned char *>(rawData.mv_data), rawData.mv_size)) {
+                    auto record = Parser::parseRawData(keyValue, classInfo.propertyInfo);
+                    record.set(CLASS_NAME_PROPERTY, classInfo.name).set(RECORD_ID_PROPERTY, rid2str(rid));
+                    result.push_back(Result{RecordDescriptor{rid}, record});
+                }
+            };
+            return ClassScanner::scan<Result>(txn, classInfos, visit);
         } catch (Datastore::ErrorType &err) {
             throw Error(err, Error::Type::DATASTORE);
         }
-        return result;
     }
 
     ResultSet Compare::getRecordMultiCondition(const Txn &txn,
                                                const std::vector<ClassInfo> &classInfos,
                                                const MultiCondition &conditions,
                                                const PropertyMapType &types) {
-        auto result = ResultSet{};
         try {
+            auto predicates = std::vector<RawPredicate>{};
             for (const auto &classInfo: classInfos) {
-                auto classDBHandler = Datastore::openDbi(txn.txnBase->getDsTxnHandler(), std::to_string(classInfo.id), true);
-                auto cursorHandler = Datastore::CursorHandlerWrapper(txn.txnBase->getDsTxnHandler(), classDBHandler);
-                auto keyValue = Datastore::getNextCursor(cursorHandler.get());
-                while (!keyValue.empty()) {
-                    auto key = Datastore::getKeyAsNumeric<PositionId>(keyValue);
-                    if (*key != EM_MAXRECNUM) {
-                        auto record = Parser::parseRawData(keyValue, classInfo.propertyInfo);
-                        auto tmpRecord = record.set(CLASS_NAME_PROPERTY, classInfo.name)
-                                .set(RECORD_ID_PROPERTY, rid2str(RecordId{classInfo.id, *key}));
-                        if (conditions.execute(tmpRecord, types)) {
-                            result.push_back(Result{RecordDescriptor{classInfo.id, *key}, record});
-                        }
-                    }
-                    keyValue = Datastore::getNextCursor(cursorHandler.get());
-                }
+                predicates.emplace_back(conditions, types, classInfo);
             }
+            auto visit = [&](ResultSet &result, size_t classIndex, PositionId positionId,
+                             const KeyValue &keyValue) {
+                auto &classInfo = classInfos[classIndex];
+                auto rid = RecordId{classInfo.id, positionId};
+                auto &rawData = keyValue.value();
+                // only a matching record is parsed
+                if (predicates[classIndex](rid, static_cast<const unsigned char *>(rawData.mv_data), rawData.mv_size)) {
+                    auto record = Parser::parseRawData(keyValue, classInfo.propertyInfo);
+                    record.set(CLASS_NAME_PROPERTY, classInfo.name).set(RECORD_ID_PROPERTY, rid2str(rid));
+                    result.push_back(Result{RecordDescriptor{rid}, record});
+                }
+            };
+            return ClassScanner::scan<Result>(txn, classInfos, visit);
         } catch (Datastore::ErrorType &err) {
             throw Error(err, Error::Type::DATASTORE);
         }
-        return result;
     }
 
     ResultSet Compare::getEdgeCondition(const Txn &txn,
@@ -454,7 +429,7 @@ namespace nogdb {
                 auto result = ResultSet{};
                 try {
                     auto classDescriptor = Schema::ClassDescriptorPtr{};
-                    auto classPropertyInfo = ClassPropertyInfo{};
+                    auto classPropertyInfo = std::shared_ptr<const ClassPropertyInfo>{};
                     auto classDBHandler = Datastore::DBHandler{};
                     auto filter = [&condition, &type](const Record &record) {
                         if (condition.comp != Condition::Comparator::IS_NULL &&
@@ -488,10 +463,10 @@ namespace nogdb {
                         if (classDescriptor == nullptr || classDescriptor->id != edge.first) {
                             classDescriptor = Generic::getClassDescriptor(txn, edge.first, ClassType::UNDEFINED);
                             classPropertyInfo = Generic::getClassMapProperty(*txn.txnBase, classDescriptor);
-                            classDBHandler = Datastore::openDbi(txn.txnBase->getDsTxnHandler(), std::to_string(edge.first), true);
+                            classDBHandler = txn.txnBase->openClassDbi(edge.first);
                         }
                         auto keyValue = Datastore::getRecord(txn.txnBase->getDsTxnHandler(), classDBHandler, edge.second);
-                        auto record = Parser::parseRawData(keyValue, classPropertyInfo);
+                        auto record = Parser::parseRawData(keyValue, *classPropertyInfo);
                         auto name = BaseTxn::getCurrentVersion(*txn.txnBase, classDescriptor->name).first;
                         auto tmpRecord = record.set(CLASS_NAME_PROPERTY, name).set(RECORD_ID_PROPERTY, rid2str(edge));
                         if (filter(tmpRecord)) {
@@ -538,16 +513,16 @@ namespace nogdb {
                 auto result = ResultSet{};
                 try {
                     auto classDescriptor = Schema::ClassDescriptorPtr{};
-                    auto classPropertyInfo = ClassPropertyInfo{};
+                    auto classPropertyInfo = std::shared_ptr<const ClassPropertyInfo>{};
                     auto classDBHandler = Datastore::DBHandler{};
                     auto retrieve = [&](ResultSet &result, const RecordId &edge) {
                         if (classDescriptor == nullptr || classDescriptor->id != edge.first) {
                             classDescriptor = Generic::getClassDescriptor(txn, edge.first, ClassType::UNDEFINED);
                             classPropertyInfo = Generic::getClassMapProperty(*txn.txnBase, classDescriptor);
-                            classDBHandler = Datastore::openDbi(txn.txnBase->getDsTxnHandler(), std::to_string(edge.first), true);
+                            classDBHandler = txn.txnBase->openClassDbi(edge.first);
                         }
                         auto keyValue = Datastore::getRecord(txn.txnBase->getDsTxnHandler(), classDBHandler, edge.second);
-                        auto record = Parser::parseRawData(keyValue, classPropertyInfo);
+                        auto record = Parser::parseRawData(keyValue, *classPropertyInfo);
                         auto name = BaseTxn::getCurrentVersion(*txn.txnBase, classDescriptor->name).first;
                         auto tmpRecord = record.set(CLASS_NAME_PROPERTY, name).set(RECORD_ID_PROPERTY, rid2str(edge));
                         if (conditions.execute(tmpRecord, types)) {
@@ -651,6 +626,10 @@ namespace nogdb {
             throw Error(CTX_NOEXST_PROPERTY, Error::Type::CONTEXT);
         }
         auto &classId = (*classDescriptors.cbegin())->id;
+        auto foundCompositeIndex = Index::hasCompositeIndex(*classInfos.cbegin(), conditions);
+        if (foundCompositeIndex.second) {
+            return Generic::getMultipleRecordFromRedesc(txn, Index::getCompositeIndexRecord(txn, classId, foundCompositeIndex.first));
+        }
         auto foundIndex = Index::hasIndex(classId, *classInfos.cbegin(), conditions);
         if (foundIndex.second) {
             return Generic::getMultipleRecordFromRedesc(txn, Index::getIndexRecord(txn, classId, foundIndex.first, conditions));
@@ -777,29 +756,21 @@ namespace nogdb {
     ResultSet Compare::getRecordCondition(const Txn &txn,
                                           const std::vector<ClassInfo> &classInfos,
                                           bool (*condition)(const Record &record)) {
-        auto result = ResultSet{};
         try {
-            for (const auto &classInfo: classInfos) {
-                auto classDBHandler = Datastore::openDbi(txn.txnBase->getDsTxnHandler(), std::to_string(classInfo.id), true);
-                auto cursorHandler = Datastore::CursorHandlerWrapper(txn.txnBase->getDsTxnHandler(), classDBHandler);
-                auto keyValue = Datastore::getNextCursor(cursorHandler.get());
-                while (!keyValue.empty()) {
-                    auto key = Datastore::getKeyAsNumeric<PositionId>(keyValue);
-                    if (*key != EM_MAXRECNUM) {
-                        auto record = Parser::parseRawData(keyValue, classInfo.propertyInfo);
-                        auto tmpRecord = record.set(CLASS_NAME_PROPERTY, classInfo.name)
-                                .set(RECORD_ID_PROPERTY, rid2str(RecordId{classInfo.id, *key}));
-                        if ((*condition)(tmpRecord)) {
-                            result.push_back(Result{RecordDescriptor{classInfo.id, *key}, record});
-                        }
-                    }
-                    keyValue = Datastore::getNextCursor(cursorHandler.get());
+            auto visit = [&](ResultSet &result, size_t classIndex, PositionId positionId,
+                             const KeyValue &keyValue) {
+                auto &classInfo = classInfos[classIndex];
+                auto record = Parser::parseRawData(keyValue, classInfo.propertyInfo);
+                auto tmpRecord = record.set(CLASS_NAME_PROPERTY, classInfo.name)
+                        .set(RECORD_ID_PROPERTY, rid2str(RecordId{classInfo.id, positionId}));
+                if ((*condition)(tmpRecord)) {
+                    result.push_back(Result{RecordDescriptor{classInfo.id, positionId}, record});
                 }
-            }
+            };
+            return ClassScanner::scan<Result>(txn, classInfos, visit);
         } catch (Datastore::ErrorType &err) {
             throw Error(err, Error::Type::DATASTORE);
         }
-        return result;
     }
 
     ResultSet Compare::compareCondition(const Txn &txn,
@@ -826,16 +797,16 @@ namespace nogdb {
                 auto result = ResultSet{};
                 try {
                     auto classDescriptor = Schema::ClassDescriptorPtr{};
-                    auto classPropertyInfo = ClassPropertyInfo{};
+                    auto classPropertyInfo = std::shared_ptr<const ClassPropertyInfo>{};
                     auto classDBHandler = Datastore::DBHandler{};
                     auto retrieve = [&](ResultSet &result, const RecordId &edge) {
                         if (classDescriptor == nullptr || classDescriptor->id != edge.first) {
                             classDescriptor = Generic::getClassDescriptor(txn, edge.first, ClassType::UNDEFINED);
                             classPropertyInfo = Generic::getClassMapProperty(*txn.txnBase, classDescriptor);
-                            classDBHandler = Datastore::openDbi(txn.txnBase->getDsTxnHandler(), std::to_string(edge.first), true);
+                            classDBHandler = txn.txnBase->openClassDbi(edge.first);
                         }
                         auto keyValue = Datastore::getRecord(txn.txnBase->getDsTxnHandler(), classDBHandler, edge.second);
-                        auto record = Parser::parseRawData(keyValue, classPropertyInfo);
+                        auto record = Parser::parseRawData(keyValue, *classPropertyInfo);
                         auto name = BaseTxn::getCurrentVersion(*txn.txnBase, classDescriptor->name).first;
                         auto tmpRecord = record.set(CLASS_NAME_PROPERTY, name).set(RECORD_ID_PROPERTY, rid2str(edge));
                         if ((*condition)(tmpRecord)) {
@@ -192,6 +192,78 @@ namespace nogdb {
                                        std::vector<ClassId>
                                        (Graph::*func2)(const BaseTxn &baseTxn, const RecordId &rid),
                                        const MultiCondition &conditions, const ClassFilter &classFilter);
+
+        //*****************************************************************
+        //*  raw data supported functions                                 *
+        //*****************************************************************
+
+        // a condition or a multi-condition compiled against the property layout of a class which is evaluated
+        // directly on raw data of records, so that only matching records have to be parsed
+        // NOTE: operands are decoded once per class and values are compared in place without being copied, except
+        // for comparators which need a text to be transformed (e.g. ignore case, like, and regex)
+        class RawPredicate {
+        public:
+            RawPredicate(const Condition &condition, PropertyType type, const ClassInfo &classInfo);
+
+            RawPredicate(const MultiCondition &conditions, const PropertyMapType &types, const ClassInfo &classInfo);
+
+            bool operator()(const RecordId &rid, const unsigned char *data, size_t size) const;
+
+        private:
+            enum class Source {
+                NONE, PROPERTY, CLASS_NAME, RECORD_ID
+            };
+
+            struct Operand {
+                int64_t signedValue{0};
+                uint64_t unsignedValue{0};
+                double realValue{0};
+                std::string textValue{};
+            };
+
+            struct Leaf {
+                explicit Leaf(const Condition &condition_) : condition{condition_} {}
+
+                Condition condition;
+                Source source{Source::NONE};
+                PropertyId propertyId{0};
+                PropertyType type{PropertyType::UNDEFINED};
+                bool isTypeFound{true};
+                // a negation is applied to null checking in a multi-condition but not in a single condition
+                bool isNullNegatable{false};
+                bool isInPlace{false};
+                std::vector<Operand> operands{};
+            };
+
+            struct Node {
+                bool isCondition{false};
+                size_t leaf{0};
+                size_t left{0};
+                size_t right{0};
+                bool isAnd{true};
+                bool isNegative{false};
+            };
+
+            std::string className{};
+            std::vector<Leaf> leaves{};
+            // nodes of a multi-condition in post-order (a root is the last one)
+            std::vector<Node> nodes{};
+
+            void addLeaf(const Condition &condition, PropertyType type, bool isTypeFound, const ClassInfo &classInfo);
+
+            size_t addNode(const std::shared_ptr<MultiCondition::ExprNode> &exprNode, const PropertyMapType &types,
+                           const ClassInfo &classInfo);
+
+            bool check(const Node &node, const RecordId &rid, const unsigned char *data, size_t size) const;
+
+            bool check(const Leaf &leaf, const RecordId &rid, const unsigned char *data, size_t size) const;
+
+            template<typename T>
+            static bool compare(const T &value, Condition::Comparator cmp, const T &lower, const T &upper);
+
+            static bool compare(const unsigned char *value, size_t size, Condition::Comparator cmp,
+                                const std::string &lower, const std::string &upper, bool isIgnoreCase);
+        };
     };
 }
 
@@ -31,6 +31,7 @@
 #include "generic.hpp"
 #include "compare.hpp"
 #include "index.hpp"
+#include "class_scanner.hpp"
 
 #include "nogdb_errors.h"
 #include "nogdb_compare.h"
@@ -44,51 +45,24 @@ namespace nogdb {
     std::vector<RecordDescriptor>
     Compare::getRdescCondition(const Txn &txn, const std::vector<ClassInfo> &classInfos, const Condition &condition,
                                PropertyType type) {
-        auto result = std::vector<RecordDescriptor>{};
         try {
+            auto predicates = std::vector<RawPredicate>{};
             for (const auto &classInfo: classInfos) {
-                auto classDBHandler = Datastore::openDbi(txn.txnBase->getDsTxnHandler(), std::to_string(classInfo.id), true);
-                auto cursorHandler = Datastore::CursorHandlerWrapper(txn.txnBase->getDsTxnHandler(), classDBHandler);
-                auto keyValue = Datastore::getNextCursor(cursorHandler.get());
-                while (!keyValue.empty()) {
-                    auto key = Datastore::getKeyAsNumeric<PositionId>(keyValue);
-                    if (*key != EM_MAXRECNUM) {
-                        auto record = Parser::parseRawData(keyValue, classInfo.propertyInfo);
-                        auto tmpRecord = record.set(CLASS_NAME_PROPERTY, classInfo.name)
-                                .set(RECORD_ID_PROPERTY, rid2str(RecordId{classInfo.id, *key}));
-                        if (condition.comp != Condition::Comparator::IS_NULL &&
-                            condition.comp != Condition::Comparator::NOT_NULL) {
-                            if (tmpRecord.get(condition.propName).empty()) {
-                                keyValue = Datastore::getNextCursor(cursorHandler.get());
-                                continue;
-                            }
-                            if (compareBytesValue(tmpRecord.get(condition.propName), type, condition)) {
-                                result.push_back(RecordDescriptor{classInfo.id, *key});
-                            }
-                        } else {
-                            switch (condition.comp) {
-                                case Condition::Comparator::IS_NULL:
-                                    if (tmpRecord.get(condition.propName).empty()) {
-                                        result.push_back(RecordDescriptor{classInfo.id, *key});
-                                    }
-                                    break;
-                                case Condition::Comparator::NOT_NULL:
-                                    if (!tmpRecord.get(condition.propName).empty()) {
-                                        result.push_back(RecordDescriptor{classInfo.id, *key});
-                                    }
-                                    break;
-                                default:
-                                    throw Error(CTX_INVALID_COMPARATOR, Error::Type::CONTEXT);
-                            }
-                        }
-                    }
-                    keyValue = Datastore::getNextCursor(cursorHandler.get());
-                }
+                predicates.emplace_back(condition, type, classInfo);
             }
+            auto visit = [&](std::vector<RecordDescriptor> &result, size_t classIndex, PositionId positionId,
+                             const KeyValue &keyValue) {
+                auto rid = RecordId{classInfos[classIndex].id, positionId};
+                auto &rawData = keyValue.value();
+                // no record has to be parsed for its descriptor
+                if (predicates[classIndex](rid, static_cast<const unsigned char *>(rawData.mv_data), rawData.mv_size)) {
+                    result.push_back(RecordDescriptor{rid});
+                }
+            };
+            return ClassScanner::scan<RecordDescriptor>(txn, classInfos, visit);
         } catch (Datastore::ErrorType &err) {
             throw Error(err, Error::Type::DATASTORE);
         }
-        return result;
     }
 
     std::vector<RecordDescriptor>
@@ -96,29 +70,24 @@ namespace nogdb {
                                     const std::vector<ClassInfo> &classInfos,
                                     const MultiCondition &conditions,
                                     const PropertyMapType &types) {
-        auto result = std::vector<RecordDescriptor>{};
         try {
+            auto predicates = std::vector<RawPredicate>{};
             for (const auto &classInfo: classInfos) {
-                auto classDBHandler = Datastore::openDbi(txn.txnBase->getDsTxnHandler(), std::to_string(classInfo.id), true);
-                auto cursorHandler = Datastore::CursorHandlerWrapper(txn.txnBase->getDsTxnHandler(), classDBHandler);
-                auto keyValue = Datastore::getNextCursor(cursorHandler.get());
-                while (!keyValue.empty()) {
-                    auto key = Datastore::getKeyAsNumeric<PositionId>(keyValue);
-                    if (*key != EM_MAXRECNUM) {
-                        auto record = Parser::parseRawData(keyValue, classInfo.propertyInfo);
-                        auto tmpRecord = record.set(CLASS_NAME_PROPERTY, classInfo.name)
-                                .set(RECORD_ID_PROPERTY, rid2str(RecordId{classInfo.id, *key}));
-                        if (conditions.execute(tmpRecord, types)) {
-                            result.push_back(RecordDescriptor{classInfo.id, *key});
-                        }
-                    }
-                    keyValue = Datastore::getNextCursor(cursorHandler.get());
-                }
+                predicates.emplace_back(conditions, types, classInfo);
             }
+            auto visit = [&](std::vector<RecordDescriptor> &result, size_t classIndex, PositionId positionId,
+                             const KeyValue &keyValue) {
+                auto rid = RecordId{classInfos[classIndex].id, positionId};
+                auto &rawData = keyValue.value();
+                // no record has to be parsed for its descriptor
+                if (predicates[classIndex](rid, static_cast<const unsigned char *>(rawData.mv_data), rawData.mv_size)) {
+                    result.push_back(RecordDescriptor{rid});
+                }
+            };
+            return ClassScanner::scan<RecordDescriptor>(txn, classInfos, visit);
         } catch (Datastore::ErrorType &err) {
             throw Error(err, Error::Type::DATASTORE);
         }
-        return result;
     }
 
     std::vector<RecordDescriptor>
@@ -135,7 +104,7 @@ namespace nogdb {
                 auto result = std::vector<RecordDescriptor>{};
                 try {
                     auto classDescriptor = Schema::ClassDescriptorPtr{};
-                    auto classPropertyInfo = ClassPropertyInfo{};
+                    auto classPropertyInfo = std::shared_ptr<const ClassPropertyInfo>{};
                     auto classDBHandler = Datastore::DBHandler{};
                     auto filter = [&condition, &type](const Record &record) {
                         if (condition.comp != Condition::Comparator::IS_NULL &&
@@ -169,10 +138,10 @@ namespace nogdb {
                         if (classDescriptor == nullptr || classDescriptor->id != edge.first) {
                             classDescriptor = Generic::getClassDescriptor(txn, edge.first, ClassType::UNDEFINED);
                             classPropertyInfo = Generic::getClassMapProperty(*txn.txnBase, classDescriptor);
-                            classDBHandler = Datastore::openDbi(txn.txnBase->getDsTxnHandler(), std::to_string(edge.first), true);
+                            classDBHandler = txn.txnBase->openClassDbi(edge.first);
                         }
                         auto keyValue = Datastore::getRecord(txn.txnBase->getDsTxnHandler(), classDBHandler, edge.second);
-                        auto record = Parser::parseRawData(keyValue, classPropertyInfo);
+                        auto record = Parser::parseRawData(keyValue, *classPropertyInfo);
                         auto name = BaseTxn::getCurrentVersion(*txn.txnBase, classDescriptor->name).first;
                         auto tmpRecord = record.set(CLASS_NAME_PROPERTY, name).set(RECORD_ID_PROPERTY, rid2str(edge));
                         if (filter(tmpRecord)) {
@@ -218,16 +187,16 @@ namespace nogdb {
                 auto result = std::vector<RecordDescriptor>{};
                 try {
                     auto classDescriptor = Schema::ClassDescriptorPtr{};
-                    auto classPropertyInfo = ClassPropertyInfo{};
+                    auto classPropertyInfo = std::shared_ptr<const ClassPropertyInfo>{};
                     auto classDBHandler = Datastore::DBHandler{};
                     auto retrieve = [&](std::vector<RecordDescriptor> &result, const RecordId &edge) {
                         if (classDescriptor == nullptr || classDescriptor->id != edge.first) {
                             classDescriptor = Generic::getClassDescriptor(txn, edge.first, ClassType::UNDEFINED);
                             classPropertyInfo = Generic::getClassMapProperty(*txn.txnBase, classDescriptor);
-                            classDBHandler = Datastore::openDbi(txn.txnBase->getDsTxnHandler(), std::to_string(edge.first), true);
+                            classDBHandler = txn.txnBase->openClassDbi(edge.first);
                         }
                         auto keyValue = Datastore::getRecord(txn.txnBase->getDsTxnHandler(), classDBHandler, edge.second);
-                        auto record = Parser::parseRawData(keyValue, classPropertyInfo);
+                        auto record = Parser::parseRawData(keyValue, *classPropertyInfo);
                         auto name = BaseTxn::getCurrentVersion(*txn.txnBase, classDescriptor->name).first;
                         auto tmpRecord = record.set(CLASS_NAME_PROPERTY, name).set(RECORD_ID_PROPERTY, rid2str(edge));
                         if (conditions.execute(tmpRecord, types)) {
@@ -326,6 +295,10 @@ namespace nogdb {
             throw Error(CTX_NOEXST_PROPERTY, Error::Type::CONTEXT);
         }
         auto &classId = (*classDescriptors.cbegin())->id;
+        auto foundCompositeIndex = Index::hasCompositeIndex(*classInfos.cbegin(), conditions);
+        if (foundCompositeIndex.second) {
+            return Index::getCompositeIndexRecord(txn, classId, foundCompositeIndex.first);
+        }
         auto foundIndex = Index::hasIndex(classId, *classInfos.cbegin(), conditions);
         if (foundIndex.second) {
             return Index::getIndexRecord(txn, classId, foundIndex.first, conditions);
@@ -448,29 +421,21 @@ namespace nogdb {
     std::vector<RecordDescriptor>
     Compare::getRdescCondition(const Txn &txn, const std::vector<ClassInfo> &classInfos,
                                bool (*condition)(const Record &record)) {
-        auto result = std::vector<RecordDescriptor>{};
         try {
-            for (const auto &classInfo: classInfos) {
-                auto classDBHandler = Datastore::openDbi(txn.txnBase->getDsTxnHandler(), std::to_string(classInfo.id), true);
-                auto cursorHandler = Datastore::CursorHandlerWrapper(txn.txnBase->getDsTxnHandler(), classDBHandler);
-                auto keyValue = Datastore::getNextCursor(cursorHandler.get());
-                while (!keyValue.empty()) {
-                    auto key = Datastore::getKeyAsNumeric<PositionId>(keyValue);
-                    if (*key != EM_MAXRECNUM) {
-                        auto record = Parser::parseRawData(keyValue, classInfo.propertyInfo);
-                        auto tmpRecord = record.set(CLASS_NAME_PROPERTY, classInfo.name)
-                                .set(RECORD_ID_PROPERTY, rid2str(RecordId{classInfo.id, *key}));
-                        if ((*condition)(tmpRecord)) {
-                            result.push_back(RecordDescriptor{classInfo.id, *key});
-                        }
-                    }
-                    keyValue = Datastore::getNextCursor(cursorHandler.get());
+            auto visit = [&](std::vector<RecordDescriptor> &result, size_t classIndex, PositionId positionId,
+                             const KeyValue &keyValue) {
+                auto &classInfo = classInfos[classIndex];
+                auto record = Parser::parseRawData(keyValue, classInfo.propertyInfo);
+                auto tmpRecord = record.set(CLASS_NAME_PROPERTY, classInfo.name)
+                        .set(RECORD_ID_PROPERTY, rid2str(RecordId{classInfo.id, positionId}));
+                if ((*condition)(tmpRecord)) {
+                    result.push_back(RecordDescriptor{classInfo.id, positionId});
                 }
-            }
+            };
+            return ClassScanner::scan<RecordDescriptor>(txn, classInfos, visit);
         } catch (Datastore::ErrorType &err) {
             throw Error(err, Error::Type::DATASTORE);
         }
-        return result;
     }
 
     std::vector<RecordDescriptor>
@@ -496,16 +461,16 @@ namespace nogdb {
                 auto result = std::vector<RecordDescriptor>{};
                 try {
                     auto classDescriptor = Schema::ClassDescriptorPtr{};
-                    auto classPropertyInfo = ClassPropertyInfo{};
+                    auto classPropertyInfo = std::shared_ptr<const ClassPropertyInfo>{};
                     auto classDBHandler = Datastore::DBHandler{};
                     auto retrieve = [&](std::vector<RecordDescriptor> &result, const RecordId &edge) {
                         if (classDescriptor == nullptr || classDescriptor->id != edge.first) {
                             classDescriptor = Generic::getClassDescriptor(txn, edge.first, ClassType::UNDEFINED);
                             classPropertyInfo = Generic::getClassMapProperty(*txn.txnBase, classDescriptor);
-                            classDBHandler = Datastore::openDbi(txn.txnBase->getDsTxnHandler(), std::to_string(edge.first), true);
+                            classDBHandler = txn.txnBase->openClassDbi(edge.first);
                         }
                         auto keyValue = Datastore::getRecord(txn.txnBase->getDsTxnHandler(), classDBHandler, edge.second);
-                        auto record = Parser::parseRawData(keyValue, classPropertyInfo);
+                        auto record = Parser::parseRawData(keyValue, *classPropertyInfo);
                         auto name = BaseTxn::getCurrentVersion(*txn.txnBase, classDescriptor->name).first;
                         auto tmpRecord = record.set(CLASS_NAME_PROPERTY, name).set(RECORD_ID_PROPERTY, rid2str(edge));
                         if ((*condition)(tmpRecord)) {
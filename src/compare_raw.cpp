@@ -0,0 +1,363 @@
+/*
+ *  Copyright (C) 2018, Throughwave (Thailand) Co., Ltd.
+ *  <peerawich at throughwave dot co dot th>
+ *
+ *  This file is part of libnogdb, the NogDB core library in C++.
+ *
+ *  libnogdb is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include "constant.hpp"
+#include "parser.hpp"
+#include "compare.hpp"
+#include "text_matcher.hpp"
+#include "text_search.hpp"
+
+#include "nogdb_errors.h"
+#include "nogdb_compare.h"
+
+namespace nogdb {
+
+    namespace {
+
+        template<typename T>
+        T toRawNumeric(const unsigned char *value, size_t size) {
+            T result = 0;
+            if (size > 0) {
+                memcpy(static_cast<void *>(&result), static_cast<const void *>(value), std::min(size, sizeof(T)));
+            }
+            return result;
+        }
+
+    }
+
+    Compare::RawPredicate::RawPredicate(const Condition &condition, PropertyType type, const ClassInfo &classInfo)
+            : className{classInfo.name} {
+        auto node = Node{};
+        node.isCondition = true;
+        node.leaf = leaves.size();
+        addLeaf(condition, type, true, classInfo);
+        nodes.emplace_back(node);
+    }
+
+    Compare::RawPredicate::RawPredicate(const MultiCondition &conditions, const PropertyMapType &types,
+                                        const ClassInfo &classInfo)
+            : className{classInfo.name} {
+        addNode(conditions.root, types, classInfo);
+    }
+
+    bool Compare::RawPredicate::operator()(const RecordId &rid, const unsigned char *data, size_t size) const {
+        return check(nodes.back(), rid, data, size);
+    }
+
+    void Compare::RawPredicate::addLeaf(const Condition &condition, PropertyType type, bool isTypeFound,
+                                        const ClassInfo &classInfo) {
+        leaves.emplace_back(condition);
+        auto &leaf = leaves.back();
+        leaf.type = type;
+        leaf.isTypeFound = isTypeFound;
+        if (condition.propName == CLASS_NAME_PROPERTY) {
+            leaf.source = Source::CLASS_NAME;
+        } else if (condition.propName == RECORD_ID_PROPERTY) {
+            leaf.source = Source::RECORD_ID;
+        } else {
+            auto foundProperty = classInfo.propertyInfo.nameToDesc.find(condition.propName);
+            if (foundProperty != classInfo.propertyInfo.nameToDesc.cend()) {
+                leaf.source = Source::PROPERTY;
+                leaf.propertyId = foundProperty->second.id;
+            }
+        }
+        if (condition.comp == Condition::Comparator::IS_NULL || condition.comp == Condition::Comparator::NOT_NULL) {
+            return;
+        }
+        switch (type) {
+            case PropertyType::TINYINT:
+            case PropertyType::UNSIGNED_TINYINT:
+            case PropertyType::SMALLINT:
+            case PropertyType::UNSIGNED_SMALLINT:
+            case PropertyType::INTEGER:
+            case PropertyType::UNSIGNED_INTEGER:
+            case PropertyType::BIGINT:
+            case PropertyType::UNSIGNED_BIGINT:
+            case PropertyType::REAL:
+                leaf.isInPlace = true;
+                break;
+            case PropertyType::TEXT:
+                leaf.isInPlace = condition.comp != Condition::Comparator::LIKE &&
+                                 condition.comp != Condition::Comparator::REGEX;
+                break;
+            default:
+                break;
+        }
+        if (!leaf.isInPlace) {
+            return;
+        }
+        auto toOperand = [&type](const Bytes &bytes) {
+            auto operand = Operand{};
+            auto raw = static_cast<const unsigned char *>(bytes.getRaw());
+            switch (type) {
+                case PropertyType::TINYINT:
+                    operand.signedValue = toRawNumeric<int8_t>(raw, bytes.size());
+                    break;
+                case PropertyType::UNSIGNED_TINYINT:
+                    operand.unsignedValue = toRawNumeric<uint8_t>(raw, bytes.size());
+                    break;
+                case PropertyType::SMALLINT:
+                    operand.signedValue = toRawNumeric<int16_t>(raw, bytes.size());
+                    break;
+                case PropertyType::UNSIGNED_SMALLINT:
+                    operand.unsignedValue = toRawNumeric<uint16_t>(raw, bytes.size());
+                    break;
+                case PropertyType::INTEGER:
+                    operand.signedValue = toRawNumeric<int32_t>(raw, bytes.size());
+                    break;
+                case PropertyType::UNSIGNED_INTEGER:
+                    operand.unsignedValue = toRawNumeric<uint32_t>(raw, bytes.size());
+                    break;
+                case PropertyType::BIGINT:
+                    operand.signedValue = toRawNumeric<int64_t>(raw, bytes.size());
+                    break;
+                case PropertyType::UNSIGNED_BIGINT:
+                    operand.unsignedValue = toRawNumeric<uint64_t>(raw, bytes.size());
+                    break;
+                case PropertyType::REAL:
+                    operand.realValue = toRawNumeric<double>(raw, bytes.size());
+                    break;
+                default:
+                    operand.textValue = bytes.toText();
+                    break;
+            }
+            return operand;
+        };
+        if (condition.comp == Condition::Comparator::IN ||
+            (condition.comp >= Condition::Comparator::BETWEEN &&
+             condition.comp <= Condition::Comparator::BETWEEN_NO_BOUND)) {
+            for (const auto &value: condition.valueSet) {
+                leaf.operands.emplace_back(toOperand(value));
+            }
+            if (condition.comp != Condition::Comparator::IN && leaf.operands.size() < 2) {
+                leaf.isInPlace = false;
+            }
+        } else {
+            leaf.operands.emplace_back(toOperand(condition.valueBytes));
+        }
+    }
+
+    size_t Compare::RawPredicate::addNode(const std::shared_ptr<MultiCondition::ExprNode> &exprNode,
+                                          const PropertyMapType &types,
+                                          const ClassInfo &classInfo) {
+        auto node = Node{};
+        if (exprNode->checkIfCondition()) {
+            const auto &condition = std::static_pointer_cast<MultiCondition::ConditionNode>(exprNode)->getCondition();
+            auto foundType = types.find(condition.propName);
+            node.isCondition = true;
+            node.leaf = leaves.size();
+            addLeaf(condition, (foundType != types.cend()) ? foundType->second : PropertyType::UNDEFINED,
+                    foundType != types.cend(), classInfo);
+            leaves.back().isNullNegatable = true;
+        } else {
+            auto compositeNode = std::static_pointer_cast<MultiCondition::CompositeNode>(exprNode);
+            node.left = addNode(compositeNode->getLeftNode(), types, classInfo);
+            node.right = addNode(compositeNode->getRightNode(), types, classInfo);
+            node.isAnd = compositeNode->getOperator() == MultiCondition::Operator::AND;
+            node.isNegative = compositeNode->getIsNegative();
+        }
+        nodes.emplace_back(node);
+        return nodes.size() - 1;
+    }
+
+    bool Compare::RawPredicate::check(const Node &node, const RecordId &rid, const unsigned char *data,
+                                      size_t size) const {
+        if (node.isCondition) {
+            return check(leaves[node.leaf], rid, data, size);
+        }
+        // the same order of evaluation as MultiCondition::CompositeNode::check
+        const auto &left = nodes[node.left];
+        const auto &right = nodes[node.right];
+        const auto &first = (right.isCondition) ? right : left;
+        const auto &second = (right.isCondition) ? left : right;
+        if (node.isAnd) {
+            return check(first, rid, data, size) ? (check(second, rid, data, size) ^ node.isNegative)
+                                                 : node.isNegative;
+        } else {
+            return check(first, rid, data, size) ? !node.isNegative
+                                                 : (check(second, rid, data, size) ^ node.isNegative);
+        }
+    }
+
+    bool Compare::RawPredicate::check(const Leaf &leaf, const RecordId &rid, const unsigned char *data,
+                                      size_t size) const {
+        if (!leaf.isTypeFound) {
+            throw Error(CTX_UNKNOWN_ERR, Error::Type::CONTEXT);
+        }
+        auto value = static_cast<const unsigned char *>(nullptr);
+        auto valueSize = size_t{0};
+        auto recordId = std::string{};
+        switch (leaf.source) {
+            case Source::PROPERTY:
+                if (!Parser::findRawProperty(data, size, leaf.propertyId, value, valueSize)) {
+                    valueSize = 0;
+                }
+                break;
+            case Source::CLASS_NAME:
+                value = reinterpret_cast<const unsigned char *>(className.data());
+                valueSize = className.size();
+                break;
+            case Source::RECORD_ID:
+                recordId = rid2str(rid);
+                value = reinterpret_cast<const unsigned char *>(recordId.data());
+                valueSize = recordId.size();
+                break;
+            default:
+                break;
+        }
+        const auto &condition = leaf.condition;
+        switch (condition.comp) {
+            case Condition::Comparator::IS_NULL:
+                return (valueSize == 0) ^ (leaf.isNullNegatable && condition.isNegative);
+            case Condition::Comparator::NOT_NULL:
+                return (valueSize != 0) ^ (leaf.isNullNegatable && condition.isNegative);
+            default:
+                break;
+        }
+        if (valueSize == 0) {
+            return false;
+        }
+        if (leaf.type == PropertyType::TEXT && condition.matcher &&
+            (condition.comp == Condition::Comparator::LIKE || condition.comp == Condition::Comparator::REGEX)) {
+            return condition.matcher->match(value, valueSize) ^ condition.isNegative;
+        }
+        if (!leaf.isInPlace) {
+            return compareBytesValue(Bytes{value, valueSize}, leaf.type, condition);
+        }
+        auto cmpFunction = [&](Condition::Comparator cmp, const Operand &lower, const Operand &upper) {
+            switch (leaf.type) {
+                case PropertyType::TINYINT:
+                    return compare<int64_t>(toRawNumeric<int8_t>(value, valueSize), cmp,
+                                            lower.signedValue, upper.signedValue);
+                case PropertyType::UNSIGNED_TINYINT:
+                    return compare<uint64_t>(toRawNumeric<uint8_t>(value, valueSize), cmp,
+                                             lower.unsignedValue, upper.unsignedValue);
+                case PropertyType::SMALLINT:
+                    return compare<int64_t>(toRawNumeric<int16_t>(value, valueSize), cmp,
+                                            lower.signedValue, upper.signedValue);
+                case PropertyType::UNSIGNED_SMALLINT:
+                    return compare<uint64_t>(toRawNumeric<uint16_t>(value, valueSize), cmp,
+                                             lower.unsignedValue, upper.unsignedValue);
+                case PropertyType::INTEGER:
+                    return compare<int64_t>(toRawNumeric<int32_t>(value, valueSize), cmp,
+                                            lower.signedValue, upper.signedValue);
+                case PropertyType::UNSIGNED_INTEGER:
+                    return compare<uint64_t>(toRawNumeric<uint32_t>(value, valueSize), cmp,
+                                             lower.unsignedValue, upper.unsignedValue);
+                case PropertyType::BIGINT:
+                    return compare<int64_t>(toRawNumeric<int64_t>(value, valueSize), cmp,
+                                            lower.signedValue, upper.signedValue);
+                case PropertyType::UNSIGNED_BIGINT:
+                    return compare<uint64_t>(toRawNumeric<uint64_t>(value, valueSize), cmp,
+                                             lower.unsignedValue, upper.unsignedValue);
+                case PropertyType::REAL:
+                    return compare<double>(toRawNumeric<double>(value, valueSize), cmp,
+                                           lower.realValue, upper.realValue);
+                case PropertyType::TEXT:
+                    return compare(value, valueSize, cmp, lower.textValue, upper.textValue, condition.isIgnoreCase);
+                default:
+                    throw Error(CTX_INVALID_PROPTYPE, Error::Type::CONTEXT);
+            }
+        };
+        if (condition.comp == Condition::Comparator::IN) {
+            for (const auto &operand: leaf.operands) {
+                if (cmpFunction(Condition::Comparator::EQUAL, operand, operand) ^ condition.isNegative) {
+                    return true;
+                }
+            }
+            return false;
+        } else if (condition.comp >= Condition::Comparator::BETWEEN &&
+                   condition.comp <= Condition::Comparator::BETWEEN_NO_BOUND) {
+            return cmpFunction(condition.comp, leaf.operands[0], leaf.operands[1]) ^ condition.isNegative;
+        } else {
+            return cmpFunction(condition.comp, leaf.operands[0], leaf.operands[0]) ^ condition.isNegative;
+        }
+    }
+
+    template<typename T>
+    bool Compare::RawPredicate::compare(const T &value, Condition::Comparator cmp, const T &lower, const T &upper) {
+        switch (cmp) {
+            case Condition::Comparator::EQUAL:
+                return value == lower;
+            case Condition::Comparator::GREATER:
+                return value > lower;
+            case Condition::Comparator::GREATER_EQUAL:
+                return value >= lower;
+            case Condition::Comparator::LESS:
+                return value < lower;
+            case Condition::Comparator::LESS_EQUAL:
+                return value <= lower;
+            case Condition::Comparator::BETWEEN:
+                return (lower <= value) && (value <= upper);
+            case Condition::Comparator::BETWEEN_NO_LOWER:
+                return (lower < value) && (value <= upper);
+            case Condition::Comparator::BETWEEN_NO_UPPER:
+                return (lower <= value) && (value < upper);
+            case Condition::Comparator::BETWEEN_NO_BOUND:
+                return (lower < value) && (value < upper);
+            default:
+                throw Error(CTX_INVALID_COMPARATOR, Error::Type::CONTEXT);
+        }
+    }
+
+    bool Compare::RawPredicate::compare(const unsigned char *value, size_t size, Condition::Comparator cmp,
+                                        const std::string &lower, const std::string &upper, bool isIgnoreCase) {
+        auto compareText = [&](const std::string &text) {
+            return TextSearch::compare(value, size, reinterpret_cast<const unsigned char *>(text.data()), text.size(),
+                                       isIgnoreCase);
+        };
+        auto text = reinterpret_cast<const unsigned char *>(lower.data());
+        switch (cmp) {
+            case Condition::Comparator::EQUAL:
+                return compareText(lower) == 0;
+            case Condition::Comparator::GREATER:
+                return compareText(lower) > 0;
+            case Condition::Comparator::GREATER_EQUAL:
+                return compareText(lower) >= 0;
+            case Condition::Comparator::LESS:
+                return compareText(lower) < 0;
+            case Condition::Comparator::LESS_EQUAL:
+                return compareText(lower) <= 0;
+            case Condition::Comparator::CONTAIN:
+                // a text is only searched up to its first null character as std::string::c_str() does
+                return TextSearch::find(value, size, text, lower.size(), isIgnoreCase) <
+                       strnlen(reinterpret_cast<const char *>(value), size);
+            case Condition::Comparator::BEGIN_WITH:
+                return TextSearch::beginWith(value, size, text, lower.size(), isIgnoreCase);
+            case Condition::Comparator::END_WITH:
+                return TextSearch::endWith(value, size, text, lower.size(), isIgnoreCase);
+            case Condition::Comparator::BETWEEN:
+                return compareText(lower) >= 0 && compareText(upper) <= 0;
+            case Condition::Comparator::BETWEEN_NO_LOWER:
+                return compareText(lower) > 0 && compareText(upper) <= 0;
+            case Condition::Comparator::BETWEEN_NO_UPPER:
+                return compareText(lower) >= 0 && compareText(upper) < 0;
+            case Condition::Comparator::BETWEEN_NO_BOUND:
+                return compareText(lower) > 0 && compareText(upper) < 0;
+            default:
+                throw Error(CTX_INVALID_COMPARATOR, Error::Type::CONTEXT);
+        }
+    }
+
+}
@@ -22,35 +22,247 @@
 #ifndef __CONCURRENT_HPP_INCLUDED_
 #define __CONCURRENT_HPP_INCLUDED_
 
-#include <map>
+#include <array>
+#include <cassert>
+#include <cstdint>
 #include <deque>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
+#include "constant.hpp"
 #include "spinlock.hpp"
 
 #include "nogdb_types.h"
 
 namespace nogdb {
 
-    template<typename Collection, typename Key, typename T>
-    struct ConcurrentHashMap {
+    // A hash map split into shards which have their own locks so that
+    // lookups of different keys do not contend on a single lock
+    // run fn(part) for every part where the first part is run by the calling thread
+    template<typename F>
+    void runParts(unsigned int numParts, const F &fn) {
+        auto errors = std::vector<std::exception_ptr>(numParts);
+        auto run = [&](unsigned int part) {
+            try {
+                fn(part);
+            } catch (...) {
+                errors[part] = std::current_exception();
+            }
+        };
+        auto workers = std::vector<std::thread>{};
+        for (auto part = 1U; part < numParts; ++part) {
+            workers.emplace_back(run, part);
+        }
+        run(0);
+        for (auto &worker: workers) {
+            worker.join();
+        }
+        for (const auto &error: errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+
+    template<typename Key, typename T, typename Hash = std::hash<Key>, typename LockT = AdaptiveRWLock>
+    class ConcurrentHashMap {
+    public:
+        typedef std::unordered_map<Key, std::shared_ptr<T>, Hash> Shard;
+
+        ConcurrentHashMap() = default;
+
+        ConcurrentHashMap(const ConcurrentHashMap &) = delete;
+
+        ConcurrentHashMap &operator=(const ConcurrentHashMap &) = delete;
+
+        std::shared_ptr<T> find(const Key &key) const {
+            const auto &shard = shards[shardOf(key)];
+            RWSpinLockGuard<LockT> _(shard.splock);
+            auto iterator = shard.elements.find(key);
+            return (iterator == shard.elements.cend()) ? nullptr : iterator->second;
+        }
+
+        size_t size() const {
+            auto numElements = size_t{0};
+            for (const auto &shard: shards) {
+                RWSpinLockGuard<LockT> _(shard.splock);
+                numElements += shard.elements.size();
+            }
+            return numElements;
+        }
+
+        // visit all elements where only one shard is locked for reading at a time
+        // NOTE: function may look up elements of the same map but must not modify it, since a writer would wait
+        // for the read lock of the calling thread forever (asserted by modifying operations)
+        template<typename Function>
+        void forEach(Function &&function) const {
+            VisitGuard _(this);
+            for (const auto &shard: shards) {
+                RWSpinLockGuard<LockT> _(shard.splock);
+                for (const auto &element: shard.elements) {
+                    function(element.first, element.second);
+                }
+            }
+        }
+
+        void reserve(size_t numElements) {
+            assert(!isVisited());
+            for (auto &shard: shards) {
+                RWSpinLockGuard<LockT> _(shard.splock, RWSpinLockMode::EXCLUSIVE_SPLOCK);
+                shard.elements.reserve(numElements / CONCURRENT_MAP_NUM_SHARDS + 1);
+            }
+        }
+
         void lockAndErase(const Key &key) {
-            RWSpinLockGuard<RWSpinLock> _(splock, RWSpinLockMode::EXCLUSIVE_SPLOCK);
-            elements.erase(key);
+            assert(!isVisited());
+            auto &shard = shards[shardOf(key)];
+            RWSpinLockGuard<LockT> _(shard.splock, RWSpinLockMode::EXCLUSIVE_SPLOCK);
+            shard.elements.erase(key);
+        }
+
+        void lockAndErase(const std::vector<Key> &keys) {
+            for (const auto &key: keys) {
+                lockAndErase(key);
+            }
         }
 
         void lockAndClear() {
-            RWSpinLockGuard<RWSpinLock> _(splock, RWSpinLockMode::EXCLUSIVE_SPLOCK);
-            elements.clear();
+            assert(!isVisited());
+            for (auto &shard: shards) {
+                RWSpinLockGuard<LockT> _(shard.splock, RWSpinLockMode::EXCLUSIVE_SPLOCK);
+                shard.elements.clear();
+            }
         }
 
         void lockAndEmplace(const Key &key, const std::shared_ptr<T> &element) {
-            RWSpinLockGuard<RWSpinLock> _(splock, RWSpinLockMode::EXCLUSIVE_SPLOCK);
-            elements.emplace(key, element);
+            assert(!isVisited());
+            auto &shard = shards[shardOf(key)];
+            RWSpinLockGuard<LockT> _(shard.splock, RWSpinLockMode::EXCLUSIVE_SPLOCK);
+            shard.elements.emplace(key, element);
         }
 
-        RWSpinLock splock{};
-        Collection elements;
+        // move elements which have already been split by shards (shardElements[shard] may only have keys of the
+        // shard, see shardOf) into the map, where each of numThreads threads locks its own shards once
+        // NOTE: an empty shard takes elements as a whole, and existing keys of a non-empty shard are kept
+        void lockAndMerge(std::vector<Shard> &shardElements, unsigned int numThreads) {
+            assert(!isVisited());
+            assert(shardElements.size() == CONCURRENT_MAP_NUM_SHARDS);
+            runParts(numThreads, [&](unsigned int thread) {
+                for (auto index = size_t{thread}; index < CONCURRENT_MAP_NUM_SHARDS; index += numThreads) {
+                    auto &shard = shards[index];
+                    auto &elements = shardElements[index];
+                    RWSpinLockGuard<LockT> _(shard.splock, RWSpinLockMode::EXCLUSIVE_SPLOCK);
+                    if (shard.elements.empty()) {
+                        shard.elements.swap(elements);
+                    } else {
+                        shard.elements.reserve(shard.elements.size() + elements.size());
+                        shard.elements.insert(std::make_move_iterator(elements.begin()),
+                                              std::make_move_iterator(elements.end()));
+                    }
+                    elements.clear();
+                }
+            });
+        }
+
+        // move elements of many parts (e.g. created by many threads) into the map, where elements of each part are
+        // split by shards and then each of numThreads threads locks its own shards once (existing keys are kept)
+        template<typename KeyOf>
+        void lockAndMerge(std::vector<std::vector<std::shared_ptr<T>>> &parts, const KeyOf &keyOf,
+                          unsigned int numThreads) {
+            assert(!isVisited());
+            typedef std::array<std::vector<size_t>, CONCURRENT_MAP_NUM_SHARDS> ShardPositions;
+            auto positions = std::vector<ShardPositions>(parts.size());
+            runParts(numThreads, [&](unsigned int thread) {
+                for (auto part = size_t{thread}; part < parts.size(); part += numThreads) {
+                    for (auto i = size_t{0}; i < parts[part].size(); ++i) {
+                        positions[part][shardOf(keyOf(parts[part][i]))].push_back(i);
+                    }
+                }
+            });
+            runParts(numThreads, [&](unsigned int thread) {
+                for (auto index = size_t{thread}; index < CONCURRENT_MAP_NUM_SHARDS; index += numThreads) {
+                    auto &shard = shards[index];
+                    auto numElements = size_t{0};
+                    for (const auto &partPositions: positions) {
+                        numElements += partPositions[index].size();
+                    }
+                    RWSpinLockGuard<LockT> _(shard.splock, RWSpinLockMode::EXCLUSIVE_SPLOCK);
+                    shard.elements.reserve(shard.elements.size() + numElements);
+                    for (auto part = size_t{0}; part < parts.size(); ++part) {
+                        for (const auto &i: positions[part][index]) {
+                            auto key = keyOf(parts[part][i]);
+                            shard.elements.emplace(std::move(key), std::move(parts[part][i]));
+                        }
+                    }
+                }
+            });
+            parts.clear();
+        }
+
+        // sum of lock statistics of all shards
+        LockStat getLockStat() const {
+            auto lockStat = LockStat{};
+            for (const auto &shard: shards) {
+                auto shardLockStat = shard.splock.getStat();
+                lockStat.numAcquisitions += shardLockStat.numAcquisitions;
+                lockStat.numContentions += shardLockStat.numContentions;
+                lockStat.waitNanoseconds += shardLockStat.waitNanoseconds;
+            }
+            return lockStat;
+        }
+
+        // a shard of a key, by which callers may split elements beforehand for lockAndMerge
+        static size_t shardOf(const Key &key) {
+            // mix the hash value because shards and buckets of each shard are chosen from the same hash
+            auto hashValue = static_cast<uint64_t>(Hash{}(key)) * UINT64_C(0x9E3779B97F4A7C15);
+            return static_cast<size_t>(hashValue >> 32) % CONCURRENT_MAP_NUM_SHARDS;
+        }
+
+    private:
+        struct LockedShard {
+            mutable LockT splock{};
+            Shard elements{};
+        };
+
+        std::array<LockedShard, CONCURRENT_MAP_NUM_SHARDS> shards{};
+
+        // maps visited by forEach in the calling thread are chained from the innermost one
+        struct VisitGuard {
+            explicit VisitGuard(const ConcurrentHashMap *map) : map{map}, outer{innermostVisit()} {
+                innermostVisit() = this;
+            }
+
+            ~VisitGuard() {
+                innermostVisit() = outer;
+            }
+
+            VisitGuard(const VisitGuard &) = delete;
+
+            VisitGuard &operator=(const VisitGuard &) = delete;
+
+            const ConcurrentHashMap *map;
+            const VisitGuard *outer;
+        };
+
+        static const VisitGuard *&innermostVisit() {
+            static thread_local const VisitGuard *visit = nullptr;
+            return visit;
+        }
+
+        bool isVisited() const {
+            for (auto visit = innermostVisit(); visit != nullptr; visit = visit->outer) {
+                if (visit->map == this) {
+                    return true;
+                }
+            }
+            return false;
+        }
     };
 
     template<typename T>
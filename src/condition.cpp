@@ -19,6 +19,8 @@
  *
  */
 
+#include "text_matcher.hpp"
+
 #include "nogdb_compare.h"
 
 namespace nogdb {
@@ -41,6 +43,18 @@ namespace nogdb {
         return tmp;
     }
 
+    void Condition::compileMatcher() {
+        matcher = nullptr;
+        if (comp == Comparator::LIKE || comp == Comparator::REGEX) {
+            auto kind = (comp == Comparator::LIKE) ? TextMatcher::Kind::LIKE : TextMatcher::Kind::REGEX;
+            try {
+                matcher = std::make_shared<const TextMatcher>(kind, valueBytes.toText(), isIgnoreCase);
+            } catch (const std::regex_error &) {
+                // leave a malformed pattern to be reported when the condition is evaluated
+            }
+        }
+    }
+
     MultiCondition Condition::operator&&(const Condition &c) const {
         return MultiCondition{*this, c, MultiCondition::Operator::AND};
     }
@@ -29,12 +29,30 @@ namespace nogdb {
     constexpr unsigned int MAX_DB_NUM = 1024;
     constexpr unsigned long MAX_DB_SIZE = 1073741824; // 1GB
     constexpr unsigned int MAX_VERSION_CONTROL_SIZE = 128;
+    constexpr size_t INDEX_BUILD_MIN_RECORDS_PER_THREAD = 16384;
+    constexpr size_t GRAPH_LOAD_MIN_RELATIONS_PER_THREAD = 65536;
+    constexpr size_t CLASS_SCAN_MIN_RECORDS_PER_THREAD = 16384;
+    constexpr size_t SLAB_NUM_BLOCKS = 1024;
+    constexpr size_t SLAB_CACHE_NUM_BLOCKS = 64;
+    constexpr size_t SLAB_TRIM_NUM_BLOCKS = 4 * SLAB_NUM_BLOCKS;
+    constexpr size_t CONCURRENT_MAP_NUM_SHARDS = 64;
+    constexpr size_t ACTIVE_TXN_NUM_SLOTS = 256;
+    constexpr size_t CACHE_LINE_SIZE = 64;
+    constexpr size_t ADAPTIVE_RWLOCK_NUM_STRIPES = 8;
+    constexpr size_t ADAPTIVE_RWLOCK_MAX_HELD_SHARED = 16;
     const std::string DB_LOCK_FILE = "/.context.lock";
+    const std::string ADJACENCY_SNAPSHOT_FILE = "/.adjacency.snapshot";
     const std::string TB_CLASSES = ".classes";
     const std::string TB_PROPERTIES = ".properties";
     const std::string TB_RELATIONS = ".relations";
+    const std::string TB_RELATIONS_MIGRATION = ".relations_migration";
     const std::string TB_INDEXES = ".indexes";
     const std::string TB_INDEXING_PREFIX = ".index_";
+    const std::string TB_DBINFO = ".dbinfo";
+    const std::string DBINFO_RECORD_FORMAT = "record_format";
+    const std::string DBINFO_INDEX_FORMAT = "index_format";
+    const std::string DBINFO_RELATION_FORMAT = "relation_format";
+    const std::string RELATION_FORMAT_BINARY_KEY = "b";
     constexpr uint16_t UINT16_EM_INIT = 0;
     const std::string STRING_EM_INIT = ".init";
     constexpr uint32_t EM_MAXRECNUM = 0;
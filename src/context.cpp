@@ -25,6 +25,12 @@
 #include <iomanip>
 #include <sstream>
 #include <cassert>
+#include <algorithm>
+#include <exception>
+#include <limits>
+#include <thread>
+#include <tuple>
+#include <vector>
 #include <sys/file.h>
 #include <sys/stat.h>
 
@@ -35,9 +41,14 @@
 #include "base_txn.hpp"
 #include "env_handler.hpp"
 #include "datastore.hpp"
+#include "dbi_registry.hpp"
 #include "graph.hpp"
 #include "validate.hpp"
 #include "schema.hpp"
+#include "relation.hpp"
+#include "adjacency_snapshot.hpp"
+#include "reclaimer.hpp"
+#include "class_scanner.hpp"
 
 #include "nogdb_context.h"
 
@@ -52,11 +63,18 @@ namespace nogdb {
     Context::Context(const std::string &dbPath, unsigned long maxDbSize)
             : Context{dbPath, MAX_DB_NUM, maxDbSize} {};
 
-    Context::Context(const std::string &dbPath, unsigned int maxDbNum, unsigned long maxDbSize) {
+    Context::Context(const std::string &dbPath, RecordFormat recordFormat)
+            : Context{dbPath, MAX_DB_NUM, MAX_DB_SIZE, recordFormat} {};
+
+    Context::Context(const std::string &dbPath, unsigned int maxDbNum, unsigned long maxDbSize,
+                     RecordFormat recordFormat) {
         dbInfo = std::make_shared<DBInfo>();
         dbSchema = std::make_shared<Schema>();
         dbTxnStat = std::make_shared<TxnStat>();
         dbRelation = std::make_shared<Graph>();
+        dbHandlerRegistry = std::make_shared<DBHandlerRegistry>();
+        dbReclaimer = std::make_shared<Reclaimer>(dbTxnStat, dbSchema, dbRelation);
+        dbScanner = std::make_shared<ClassScanner>();
         dbInfoMutex = std::make_shared<boost::shared_mutex>();
         dbWriterMutex = std::make_shared<boost::shared_mutex>();
         dbInfo->dbPath = dbPath;
@@ -66,6 +84,7 @@ namespace nogdb {
         dbInfo->maxPropertyId = PropertyId{INIT_NUM_PROPERTIES};
         dbInfo->numClass = ClassId{0};
         dbInfo->numProperty = PropertyId{0};
+        dbInfo->recordFormat = recordFormat;
         envHandler = std::make_shared<EnvHandlerPtr>(
                 EnvHandler::create(dbInfo->dbPath, dbInfo->maxDB, dbInfo->maxDBSize, Datastore::MAX_READERS,
                                    Datastore::FLAG, Datastore::PERMISSION));
@@ -74,7 +93,8 @@ namespace nogdb {
 
     Context::Context(const Context &ctx)
             : envHandler{ctx.envHandler}, dbInfo{ctx.dbInfo}, dbSchema{ctx.dbSchema}, dbTxnStat{ctx.dbTxnStat},
-              dbRelation{ctx.dbRelation}, dbInfoMutex{ctx.dbInfoMutex}, dbWriterMutex{ctx.dbWriterMutex} {};
+              dbRelation{ctx.dbRelation}, dbHandlerRegistry{ctx.dbHandlerRegistry}, dbReclaimer{ctx.dbReclaimer},
+              dbScanner{ctx.dbScanner}, dbInfoMutex{ctx.dbInfoMutex}, dbWriterMutex{ctx.dbWriterMutex} {};
 
     Context &Context::operator=(const Context &ctx) {
         if (this != &ctx) {
@@ -88,7 +108,9 @@ namespace nogdb {
     Context::Context(Context &&ctx) noexcept
             : envHandler{std::move(ctx.envHandler)}, dbInfo{std::move(ctx.dbInfo)}, dbSchema{std::move(ctx.dbSchema)},
               dbTxnStat{std::move(ctx.dbTxnStat)}, dbRelation{std::move(ctx.dbRelation)},
-              dbInfoMutex{std::move(ctx.dbInfoMutex)}, dbWriterMutex{std::move(ctx.dbWriterMutex)} {}
+              dbHandlerRegistry{std::move(ctx.dbHandlerRegistry)}, dbReclaimer{std::move(ctx.dbReclaimer)},
+              dbScanner{std::move(ctx.dbScanner)}, dbInfoMutex{std::move(ctx.dbInfoMutex)},
+              dbWriterMutex{std::move(ctx.dbWriterMutex)} {}
 
     Context &Context::operator=(Context &&ctx) noexcept {
         if (this != &ctx) {
@@ -97,12 +119,30 @@ namespace nogdb {
             dbSchema = std::move(ctx.dbSchema);
             dbTxnStat = std::move(ctx.dbTxnStat);
             dbRelation = std::move(ctx.dbRelation);
+            dbHandlerRegistry = std::move(ctx.dbHandlerRegistry);
+            dbReclaimer = std::move(ctx.dbReclaimer);
+            dbScanner = std::move(ctx.dbScanner);
             dbInfoMutex = std::move(ctx.dbInfoMutex);
             dbWriterMutex = std::move(ctx.dbWriterMutex);
         }
         return *this;
     }
 
+    Context::~Context() noexcept {
+        // the last context of a database writes the adjacency snapshot for the next opening
+        if (envHandler != nullptr && envHandler.use_count() == 1 && dbRelation != nullptr) {
+            if (dbReclaimer != nullptr) {
+                dbReclaimer->stop();
+            }
+            try {
+                AdjacencySnapshot::write(dbInfo->dbPath + ADJACENCY_SNAPSHOT_FILE, *dbRelation,
+                                         Datastore::getLastTxnId(envHandler->get()));
+            } catch (...) {
+                // the graph will be rebuilt from the relation table on the next opening
+            }
+        }
+    }
+
     TxnId Context::getMaxVersionId() const {
         return dbTxnStat->maxVersionId;
     }
@@ -115,11 +155,26 @@ namespace nogdb {
         return dbTxnStat->minActiveTxnId();
     }
 
+    void Context::setReclaimInterval(unsigned int intervalMs) {
+        dbReclaimer->start(intervalMs);
+    }
+
+    void Context::setNumScanThreads(unsigned int numThreads) {
+        dbScanner->setNumThreads(numThreads);
+    }
+
+    ScanStat Context::getScanStat() const {
+        return dbScanner->getStat();
+    }
+
     void Context::initDatabase() {
         auto currentTime = std::to_string(currentTimestamp());
+        auto lastTxnId = size_t{0};
         Datastore::TxnHandler *txn = nullptr;
         // create read-write transaction
         try {
+            // an adjacency snapshot is valid only if it was written after the last commit
+            lastTxnId = Datastore::getLastTxnId(envHandler->get());
             txn = Datastore::beginTxn(envHandler->get(), Datastore::TXN_RW);
         } catch (Datastore::ErrorType &err) {
             Datastore::abortTxn(txn);
@@ -130,20 +185,61 @@ namespace nogdb {
         auto propDBHndler = Datastore::DBHandler{};
         auto indexDBHandler = Datastore::DBHandler{};
         auto relationDBHandler = Datastore::DBHandler{};
+        auto dbInfoDBHandler = Datastore::DBHandler{};
         try {
             classDBHandler = Datastore::openDbi(txn, TB_CLASSES, true);
             propDBHndler = Datastore::openDbi(txn, TB_PROPERTIES, true);
             indexDBHandler = Datastore::openDbi(txn, TB_INDEXES, true, false);
             relationDBHandler = Datastore::openDbi(txn, TB_RELATIONS);
+            dbInfoDBHandler = Datastore::openDbi(txn, TB_DBINFO);
+            // a record format is chosen once when a database is created (no init record in the classes table yet)
+            // NOTE: databases created before the record format was introduced are always sequential
+            auto isNewDatabase = Datastore::getRecord(txn, classDBHandler, ClassId{UINT16_EM_INIT}).empty();
+            auto recordFormatKeyValue = Datastore::getRecord(txn, dbInfoDBHandler, DBINFO_RECORD_FORMAT);
+            if (!recordFormatKeyValue.empty()) {
+                auto recordFormat = Datastore::getValueAsString(recordFormatKeyValue);
+                dbInfo->recordFormat = (recordFormat == std::string(1, static_cast<char>(RecordFormat::INDEXED))) ?
+                                       RecordFormat::INDEXED : RecordFormat::SEQUENTIAL;
+            } else {
+                if (!isNewDatabase) {
+                    dbInfo->recordFormat = RecordFormat::SEQUENTIAL;
+                }
+                Datastore::putRecord(txn, dbInfoDBHandler, DBINFO_RECORD_FORMAT,
+                                     std::string(1, static_cast<char>(dbInfo->recordFormat)));
+            }
+            // NOTE: databases created before the index format was introduced always have split signed indexes
+            auto indexFormatKeyValue = Datastore::getRecord(txn, dbInfoDBHandler, DBINFO_INDEX_FORMAT);
+            if (!indexFormatKeyValue.empty()) {
+                auto indexFormat = Datastore::getValueAsString(indexFormatKeyValue);
+                dbInfo->indexFormat = (indexFormat == std::string(1, static_cast<char>(IndexFormat::ORDERED))) ?
+                                      IndexFormat::ORDERED : IndexFormat::SIGNED_SPLIT;
+            } else {
+                dbInfo->indexFormat = (isNewDatabase) ? IndexFormat::ORDERED : IndexFormat::SIGNED_SPLIT;
+                Datastore::putRecord(txn, dbInfoDBHandler, DBINFO_INDEX_FORMAT,
+                                     std::string(1, static_cast<char>(dbInfo->indexFormat)));
+            }
+            // NOTE: relations of databases created before binary keys were introduced are migrated in place
+            auto relationFormatKeyValue = Datastore::getRecord(txn, dbInfoDBHandler, DBINFO_RELATION_FORMAT);
+            if (relationFormatKeyValue.empty()) {
+                if (!isNewDatabase) {
+                    Relation::migrateTextKeys(txn, relationDBHandler);
+                }
+                Datastore::putRecord(txn, dbInfoDBHandler, DBINFO_RELATION_FORMAT, RELATION_FORMAT_BINARY_KEY);
+            }
             Datastore::putRecord(txn, classDBHandler, ClassId{UINT16_EM_INIT}, currentTime);
             Datastore::putRecord(txn, propDBHndler, PropertyId{UINT16_EM_INIT}, currentTime);
             Datastore::putRecord(txn, indexDBHandler, PropertyId{UINT16_EM_INIT}, currentTime);
-            Datastore::putRecord(txn, relationDBHandler, STRING_EM_INIT, currentTime);
             Datastore::commitTxn(txn);
+        } catch (const Error &err) {
+            Datastore::abortTxn(txn);
+            throw err;
         } catch (Datastore::ErrorType &err) {
             Datastore::abortTxn(txn);
             throw Error(err, Error::Type::DATASTORE);
         }
+        dbHandlerRegistry->publish(
+                {{DBHandlerRegistry::makeKey(DBHandlerRegistry::RELATION, 0), relationDBHandler}},
+                dbHandlerRegistry->getEpoch());
         // create read-only transaction
         try {
             txn = Datastore::beginTxn(envHandler->get(), Datastore::TXN_RO);
@@ -154,6 +250,7 @@ namespace nogdb {
         // create read-write in memory transaction
         BaseTxn baseTxn{*this, true, true};
         // retrieve classes information
+        auto edgeClassIds = std::vector<ClassId>{};
         try {
             auto inheritanceInfo = Schema::InheritanceInfo{};
             auto classCursor = Datastore::CursorHandlerWrapper(txn, classDBHandler);
@@ -176,6 +273,9 @@ namespace nogdb {
                 auto className = std::string(reinterpret_cast<char *>(nameBytes), nameLength);
                 auto classDescriptor = std::make_shared<Schema::ClassDescriptor>(ClassId{*key}, className, classType);
                 dbSchema->insert(baseTxn, classDescriptor);
+                if (classType == ClassType::EDGE) {
+                    edgeClassIds.push_back(classDescriptor->id);
+                }
                 inheritanceInfo.emplace_back(std::make_pair(classDescriptor->id, superClassId));
                 if (classDescriptor->id > dbInfo->maxClassId) {
                     baseTxn.dbInfo.maxClassId = classDescriptor->id;
@@ -227,7 +327,25 @@ namespace nogdb {
                     offset = data.retrieve(&isUniqueNumeric, offset, sizeof(isUniqueNumeric));
                     offset = data.retrieve(&indexId, offset, sizeof(IndexId));
                     offset = data.retrieve(&classId, offset, sizeof(ClassId));
-                    propertyDescriptor.indexInfo.emplace(classId, std::make_pair(indexId, isUniqueNumeric));
+                    if (isCompositeNumeric) {
+                        // a composite index is stored under its first property followed by all of its properties
+                        auto numProperty = uint8_t{0};
+                        offset = data.retrieve(&numProperty, offset, sizeof(numProperty));
+                        auto compositeIndex = Schema::CompositeIndexDescriptor{};
+                        compositeIndex.isUnique = (isUniqueNumeric != 0);
+                        for (auto i = 0U; i < numProperty; ++i) {
+                            auto propertyId = PropertyId{0};
+                            offset = data.retrieve(&propertyId, offset, sizeof(PropertyId));
+                            compositeIndex.propertyIds.push_back(propertyId);
+                        }
+                        auto ptrIndexClassDescriptor = dbSchema->find(baseTxn, classId);
+                        assert(ptrIndexClassDescriptor != nullptr);
+                        auto compositeIndexes = ptrIndexClassDescriptor->compositeIndexes.getLatestVersion().first;
+                        compositeIndexes.emplace(indexId, compositeIndex);
+                        ptrIndexClassDescriptor->compositeIndexes.addLatestVersion(compositeIndexes);
+                    } else {
+                        propertyDescriptor.indexInfo.emplace(classId, std::make_pair(indexId, isUniqueNumeric));
+                    }
                     if (indexId > baseTxn.dbInfo.maxIndexId) {
                         baseTxn.dbInfo.maxIndexId = indexId;
                     }
@@ -251,42 +369,114 @@ namespace nogdb {
 
         // retrieve relations information
         try {
-            auto relationCursor = Datastore::CursorHandlerWrapper(txn, relationDBHandler);
-            for (auto relationKeyValue = Datastore::getNextCursor(relationCursor.get());
-                 !relationKeyValue.empty();
-                 relationKeyValue = Datastore::getNextCursor(relationCursor.get())) {
-                auto key = Datastore::getKeyAsString(relationKeyValue);
-                if (key == STRING_EM_INIT) {
-                    continue;
-                }
-                auto data = Datastore::getValueAsBlob(relationKeyValue);
-                // resolve a rid of an edge from a key
-                auto sp = split(key, ':');
-                if (sp.size() != 2) {
-                    throw Error(CTX_UNKNOWN_ERR, Error::Type::CONTEXT);
+            // use the adjacency snapshot written on the last closing if nothing has been committed since then
+            // (see AdjacencySnapshot for what it does not cover)
+            auto relationParts = std::vector<std::vector<Graph::EdgeRelation>>{};
+            auto numRelations = Datastore::getNumRecords(txn, relationDBHandler);
+            if (!AdjacencySnapshot::read(dbInfo->dbPath + ADJACENCY_SNAPSHOT_FILE, lastTxnId, numRelations,
+                                         relationParts)) {
+                // relations are split into ranges of edge record ids which are read by their own threads and txns,
+                // where every range has about the same number of edges according to the sizes of edge classes
+                auto toNumeric = [](const RecordId &rid) {
+                    return (static_cast<uint64_t>(rid.first) << (8 * sizeof(PositionId))) | rid.second;
+                };
+                auto toRecordId = [](uint64_t numeric) {
+                    return RecordId{static_cast<ClassId>(numeric >> (8 * sizeof(PositionId))),
+                                    static_cast<PositionId>(numeric)};
+                };
+                auto bounds = std::vector<uint64_t>{};
+                if (numRelations > 0) {
+                    bounds.push_back(0);
+                    auto numThreads = Graph::getNumLoadThreads(numRelations);
+                    // ranges of edge record ids and numbers of edges of classes in the order of relation keys
+                    auto classRanges = std::vector<std::tuple<uint64_t, uint64_t, uint64_t>>{};
+                    auto numEdges = uint64_t{0};
+                    for (auto classId = edgeClassIds.cbegin(); numThreads > 1 && classId != edgeClassIds.cend();
+                         ++classId) {
+                        auto edgeClassDBHandler = Datastore::openDbi(txn, std::to_string(*classId), true);
+                        // a class table always has a record of its maximum record number
+                        auto numRecords = uint64_t{Datastore::getNumRecords(txn, edgeClassDBHandler)};
+                        if (numRecords <= 1) {
+                            continue;
+                        }
+                        auto firstCursor = Datastore::CursorHandlerWrapper(txn, edgeClassDBHandler);
+                        auto lastCursor = Datastore::CursorHandlerWrapper(txn, edgeClassDBHandler);
+                        auto firstKeyValue = Datastore::getSetRangeCursor(firstCursor.get(),
+                                                                          static_cast<PositionId>(EM_MAXRECNUM + 1));
+                        auto lastKeyValue = Datastore::getPrevCursor(lastCursor.get());
+                        auto first = *Datastore::getKeyAsNumeric<PositionId>(firstKeyValue);
+                        auto last = *Datastore::getKeyAsNumeric<PositionId>(lastKeyValue);
+                        classRanges.emplace_back(toNumeric(RecordId{*classId, first}),
+                                                 toNumeric(RecordId{*classId, last}) + 1, numRecords - 1);
+                        numEdges += numRecords - 1;
+                    }
+                    auto classRange = classRanges.cbegin();
+                    auto numPrevEdges = uint64_t{0};
+                    for (auto i = 1U; i < numThreads && numEdges > 0; ++i) {
+                        auto numTargetEdges = numEdges * i / numThreads;
+                        while (numPrevEdges + std::get<2>(*classRange) <= numTargetEdges) {
+                            numPrevEdges += std::get<2>(*classRange);
+                            ++classRange;
+                        }
+                        auto lower = std::get<0>(*classRange), upper = std::get<1>(*classRange);
+                        auto bound = lower + (upper - lower) * (numTargetEdges - numPrevEdges) /
+                                             std::get<2>(*classRange);
+                        if (bound > bounds.back()) {
+                            bounds.push_back(bound);
+                        }
+                    }
+                    bounds.push_back(std::numeric_limits<uint64_t>::max());
                 }
-                auto edgeId = RecordId{
-                        static_cast<ClassId>(std::stoul(std::string{sp[0]}, nullptr, 0)),
-                        static_cast<PositionId>(std::stoul(std::string{sp[1]}, nullptr, 0))
+                auto numParts = (bounds.empty()) ? 0U : static_cast<unsigned int>(bounds.size() - 1);
+                relationParts.resize(numParts);
+                auto errors = std::vector<std::exception_ptr>(numParts);
+                auto readPart = [&](unsigned int part) {
+                    // the first part is read by the calling thread with its own txn
+                    auto partTxn = (part == 0) ? txn : nullptr;
+                    try {
+                        if (partTxn == nullptr) {
+                            partTxn = Datastore::beginTxn(envHandler->get(), Datastore::TXN_RO);
+                        }
+                        auto relationCursor = Datastore::CursorHandlerWrapper(partTxn, relationDBHandler);
+                        for (auto relationKeyValue = Datastore::getSetRangeCursor(relationCursor.get(),
+                                                                                  Relation::toKey(toRecordId(bounds[part])));
+                             !relationKeyValue.empty();
+                             relationKeyValue = Datastore::getNextCursor(relationCursor.get())) {
+                            auto edgeId = Relation::toEdgeId(relationKeyValue);
+                            if (toNumeric(edgeId) >= bounds[part + 1]) {
+                                break;
+                            }
+                            auto vertexIds = Relation::toVertexIds(relationKeyValue);
+                            assert(dbSchema->find(baseTxn, edgeId.first) != nullptr);
+                            assert(dbSchema->find(baseTxn, vertexIds.first.first) != nullptr);
+                            assert(dbSchema->find(baseTxn, vertexIds.second.first) != nullptr);
+                            relationParts[part].emplace_back(edgeId, vertexIds.first, vertexIds.second);
+                        }
+                    } catch (...) {
+                        errors[part] = std::current_exception();
+                    }
+                    if (part != 0 && partTxn != nullptr) {
+                        Datastore::abortTxn(partTxn);
+                    }
                 };
-                // resolve a rid of source and destination vertices from a value
-                auto classId = ClassId{0};
-                auto positionId = PositionId{0};
-                auto offset = data.retrieve(&classId, 0, sizeof(ClassId));
-                offset = data.retrieve(&positionId, offset, sizeof(PositionId));
-                auto srcRid = RecordId{classId, positionId};
-                offset = data.retrieve(&classId, offset, sizeof(ClassId));
-                data.retrieve(&positionId, offset, sizeof(PositionId));
-                auto dstRid = RecordId{classId, positionId};
-                auto ptrEdgeClassDescriptor = dbSchema->find(baseTxn, edgeId.first);
-                assert(ptrEdgeClassDescriptor != nullptr);
-                auto ptrSrcVertexClassDescriptor = dbSchema->find(baseTxn, srcRid.first);
-                assert(ptrSrcVertexClassDescriptor != nullptr);
-                auto ptrDstVertexClassDescriptor = dbSchema->find(baseTxn, dstRid.first);
-                assert(ptrDstVertexClassDescriptor != nullptr);
-                // update the relation in the graph structure
-                dbRelation->createEdge(baseTxn, edgeId, srcRid, dstRid);
+                auto workers = std::vector<std::thread>{};
+                for (auto part = 1U; part < numParts; ++part) {
+                    workers.emplace_back(readPart, part);
+                }
+                if (numParts > 0) {
+                    readPart(0);
+                }
+                for (auto &worker: workers) {
+                    worker.join();
+                }
+                for (const auto &error: errors) {
+                    if (error) {
+                        std::rethrow_exception(error);
+                    }
+                }
             }
+            // update the relations in the graph structure
+            dbRelation->loadEdges(relationParts, baseTxn.getVersionId());
             baseTxn.commit(*this);
         } catch (const Error &err) {
             baseTxn.rollback(*this);
@@ -38,8 +38,11 @@ namespace nogdb {
 
     ResultSetCursor::ResultSetCursor(const ResultSetCursor &rc) : txn{rc.txn} {
         metadata = rc.metadata;
+        propertyNames = rc.propertyNames;
         classPropertyInfos.reset(new ClassPropertyCache(*rc.classPropertyInfos));
         currentIndex = rc.currentIndex;
+        result = rc.result;
+        isResultLoaded = rc.isResultLoaded;
     }
 
     ResultSetCursor &ResultSetCursor::operator=(const ResultSetCursor &rc) {
@@ -47,7 +50,10 @@ namespace nogdb {
             txn = rc.txn;
             classPropertyInfos.reset(new ClassPropertyCache(*rc.classPropertyInfos));
             metadata = rc.metadata;
+            propertyNames = rc.propertyNames;
             currentIndex = rc.currentIndex;
+            result = rc.result;
+            isResultLoaded = rc.isResultLoaded;
         }
         return *this;
     }
@@ -55,18 +61,24 @@ namespace nogdb {
     ResultSetCursor::ResultSetCursor(ResultSetCursor &&rc) noexcept: txn{rc.txn} {
         txn = rc.txn;
         metadata = std::move(rc.metadata);
+        propertyNames = std::move(rc.propertyNames);
         currentIndex = rc.currentIndex;
         classPropertyInfos = std::move(rc.classPropertyInfos);
         rc.classPropertyInfos = nullptr;
+        result = std::move(rc.result);
+        isResultLoaded = rc.isResultLoaded;
     }
 
     ResultSetCursor &ResultSetCursor::operator=(ResultSetCursor &&rc) noexcept {
         if (this != &rc) {
             txn = rc.txn;
             metadata = std::move(rc.metadata);
+            propertyNames = std::move(rc.propertyNames);
             currentIndex = rc.currentIndex;
             classPropertyInfos = std::move(rc.classPropertyInfos);
             rc.classPropertyInfos = nullptr;
+            result = std::move(rc.result);
+            isResultLoaded = rc.isResultLoaded;
         }
         return *this;
     }
@@ -85,27 +97,23 @@ namespace nogdb {
 
     bool ResultSetCursor::next() {
         if (!metadata.empty() && (currentIndex == -1)) {
-            currentIndex = 0;
+            moveTo(0);
         } else if (hasNext()) {
-            ++currentIndex;
+            moveTo(currentIndex + 1);
         } else {
             return false;
         }
-        auto cursor = metadata.begin() + currentIndex;
-        result = Generic::getRecordResult(txn, resolveClassPropertyInfo(cursor->rid.first), *(cursor));
         return true;
     }
 
     bool ResultSetCursor::previous() {
         if (!metadata.empty() && (currentIndex >= static_cast<long long>(metadata.size()))) {
-            currentIndex = static_cast<long long>(metadata.size() - 1);
+            moveTo(static_cast<long long>(metadata.size() - 1));
         } else if (hasPrevious()) {
-            --currentIndex;
+            moveTo(currentIndex - 1);
         } else {
             return false;
         }
-        auto cursor = metadata.begin() + currentIndex;
-        result = Generic::getRecordResult(txn, resolveClassPropertyInfo(cursor->rid.first), *(cursor));
         return true;
     }
 
@@ -123,19 +131,13 @@ namespace nogdb {
 
     void ResultSetCursor::first() {
         if (!metadata.empty()) {
-            currentIndex = 0;
-            auto cursor = metadata.begin();
-            auto classPropertyInfo = resolveClassPropertyInfo(cursor->rid.first);
-            result = Generic::getRecordResult(txn, classPropertyInfo, *(cursor));
+            moveTo(0);
         }
     }
 
     void ResultSetCursor::last() {
         if (!metadata.empty()) {
-            currentIndex = static_cast<long long>(metadata.size() - 1);
-            auto cursor = metadata.end() - 1;
-            auto classPropertyInfo = resolveClassPropertyInfo(cursor->rid.first);
-            result = Generic::getRecordResult(txn, classPropertyInfo, *(cursor));
+            moveTo(static_cast<long long>(metadata.size() - 1));
         }
     }
 
@@ -143,14 +145,16 @@ namespace nogdb {
         if (index >= metadata.size()) {
             return false;
         }
-        currentIndex = index;
-        auto cursor = metadata.begin() + currentIndex;
-        auto classPropertyInfo = resolveClassPropertyInfo(cursor->rid.first);
-        result = Generic::getRecordResult(txn, classPropertyInfo, *(cursor));
+        moveTo(index);
         return true;
     }
 
     const Result &ResultSetCursor::operator*() const {
+        if (!isResultLoaded && currentIndex >= 0 && currentIndex < static_cast<long long>(metadata.size())) {
+            auto cursor = metadata.begin() + currentIndex;
+            result = Generic::getRecordResult(txn, *resolveClassPropertyInfo(cursor->rid.first), *(cursor));
+            isResultLoaded = true;
+        }
         return result;
     }
 
@@ -158,12 +162,30 @@ namespace nogdb {
         return &(operator*());
     }
 
-    const ClassPropertyInfo ResultSetCursor::resolveClassPropertyInfo(ClassId classId) {
-        auto classPropertyInfo = ClassPropertyInfo{};
+    ResultView ResultSetCursor::getView() const {
+        if (currentIndex < 0 || currentIndex >= static_cast<long long>(metadata.size())) {
+            return ResultView{};
+        }
+        auto cursor = metadata.begin() + currentIndex;
+        return Generic::getRecordViewResult(txn, resolveClassPropertyInfo(cursor->rid.first), *(cursor));
+    }
+
+    void ResultSetCursor::moveTo(long long index) {
+        currentIndex = index;
+        result = Result{};
+        isResultLoaded = false;
+    }
+
+    std::shared_ptr<const ClassPropertyInfo> ResultSetCursor::resolveClassPropertyInfo(ClassId classId) const {
         auto findCacheClassInfo = classPropertyInfos->find(classId);
         if (findCacheClassInfo == classPropertyInfos->cend()) {
             auto classDescriptor = Generic::getClassDescriptor(txn, classId, ClassType::UNDEFINED);
-            auto classPropertyInfo = Generic::getClassMapProperty(*txn.txnBase, classDescriptor);
+            // the layout of all properties is shared with other txns rather than copied
+            auto classPropertyInfo = propertyNames.empty() ?
+                                     Generic::getClassMapProperty(*txn.txnBase, classDescriptor) :
+                                     std::make_shared<const ClassPropertyInfo>(
+                                             Generic::getClassMapProperty(*txn.txnBase, classDescriptor,
+                                                                          propertyNames));
             classPropertyInfos->emplace(classId, classPropertyInfo);
             return classPropertyInfo;
         } else {
@@ -125,6 +125,20 @@ namespace nogdb {
         }
     }
 
+    void Datastore::putRecord(TxnHandler *txnHandler, DBHandler dbHandler, const Blob &key, const Blob &value,
+                              bool isAppend, bool isOverwrite) {
+        MDB_val recordKey;
+        MDB_val recordValue;
+        recordKey.mv_size = key.size();
+        recordKey.mv_data = static_cast<void *>(key.bytes());
+        recordValue.mv_size = value.size();
+        recordValue.mv_data = static_cast<void *>(value.bytes());
+        auto flags = ((isAppend) ? MDB_APPEND : 0U) | ((isOverwrite) ? 0U : MDB_NOOVERWRITE);
+        if (auto error = mdb_put(txnHandler, dbHandler, &recordKey, &recordValue, flags)) {
+            throw error;
+        }
+    }
+
     KeyValue Datastore::getRecord(TxnHandler *txnHandler, DBHandler dbHandler, const std::string &key) {
         MDB_val recordKey;
         MDB_val recordValue;
@@ -166,6 +180,20 @@ namespace nogdb {
         }
     }
 
+    void Datastore::deleteRecord(TxnHandler *txnHandler, DBHandler dbHandler, const Blob &key, const Blob &value) {
+        MDB_val recordKey;
+        MDB_val recordValue;
+        recordKey.mv_size = key.size();
+        recordKey.mv_data = static_cast<void *>(key.bytes());
+        recordValue.mv_size = value.size();
+        recordValue.mv_data = static_cast<void *>(value.bytes());
+        if (auto error = mdb_del(txnHandler, dbHandler, &recordKey, &recordValue)) {
+            if (error != MDB_NOTFOUND) {
+                throw error;
+            }
+        }
+    }
+
     Datastore::CursorHandler *Datastore::openCursor(TxnHandler *txnHandler, DBHandler dbHandler) {
         CursorHandler *cursorHandler = nullptr;
         if (auto error = mdb_cursor_open(txnHandler, dbHandler, &cursorHandler)) {
@@ -248,6 +276,22 @@ namespace nogdb {
         return data;
     }
 
+    KeyValue Datastore::getSetRangeCursor(CursorHandler *cursorHandler, const Blob &key) {
+        MDB_val recordKey;
+        MDB_val recordValue;
+        recordKey.mv_size = key.size();
+        recordKey.mv_data = static_cast<void *>(key.bytes());
+        auto data = KeyValue{};
+        if (auto error = mdb_cursor_get(cursorHandler, &recordKey, &recordValue, MDB_SET_RANGE)) {
+            if (error != MDB_NOTFOUND) {
+                throw error;
+            }
+        } else {
+            data = KeyValue{recordKey, recordValue};
+        }
+        return data;
+    }
+
     void Datastore::deleteCursor(CursorHandler *cursorHandler) {
         if (auto error = mdb_cursor_del(cursorHandler, 0)) {
             throw error;
@@ -266,6 +310,72 @@ namespace nogdb {
         closeCursor(cursorHandler);
     }
 
+    Datastore::AppendCursor::AppendCursor(TxnHandler *txnHandler, DBHandler dbHandler)
+            : txnHandler{txnHandler}, dbHandler{dbHandler}, cursorHandler{nullptr}, isDuplicated{false}, isEmpty{true} {
+        auto flags = 0U;
+        if (auto error = mdb_dbi_flags(txnHandler, dbHandler, &flags)) {
+            throw error;
+        }
+        isDuplicated = (flags & MDB_DUPSORT) != 0;
+        cursorHandler = openCursor(txnHandler, dbHandler);
+        MDB_val key;
+        MDB_val value;
+        auto error = mdb_cursor_get(cursorHandler, &key, &value, MDB_LAST);
+        if (error == 0) {
+            isEmpty = false;
+            lastKey.assign(static_cast<const char *>(key.mv_data), key.mv_size);
+            lastValue.assign(static_cast<const char *>(value.mv_data), value.mv_size);
+        } else if (error != MDB_NOTFOUND) {
+            closeCursor(cursorHandler);
+            throw error;
+        }
+    }
+
+    Datastore::AppendCursor::~AppendCursor() noexcept {
+        closeCursor(cursorHandler);
+    }
+
+    void Datastore::AppendCursor::putRecord(const std::string &key, const Blob &value, bool isOverwrite) {
+        MDB_val recordKey;
+        recordKey.mv_size = strlen(const_cast<char *>(key.c_str()));
+        recordKey.mv_data = const_cast<void *>(reinterpret_cast<const void *>(key.c_str()));
+        put(recordKey, value, isOverwrite);
+    }
+
+    void Datastore::AppendCursor::put(MDB_val &recordKey, const Blob &value, bool isOverwrite) {
+        MDB_val recordValue;
+        recordValue.mv_size = value.size();
+        recordValue.mv_data = static_cast<void *>(value.bytes());
+        auto flags = (isOverwrite) ? 0U : MDB_NOOVERWRITE;
+        auto isLast = isEmpty;
+        if (!isEmpty) {
+            MDB_val key;
+            key.mv_size = lastKey.size();
+            key.mv_data = &lastKey[0];
+            auto order = mdb_cmp(txnHandler, dbHandler, &key, &recordKey);
+            if (order < 0) {
+                flags |= MDB_APPEND;
+                isLast = true;
+            } else if (order == 0 && isDuplicated) {
+                MDB_val data;
+                data.mv_size = lastValue.size();
+                data.mv_data = &lastValue[0];
+                if (mdb_dcmp(txnHandler, dbHandler, &data, &recordValue) < 0) {
+                    flags |= MDB_APPENDDUP;
+                    isLast = true;
+                }
+            }
+        }
+        if (auto error = mdb_cursor_put(cursorHandler, &recordKey, &recordValue, flags)) {
+            throw error;
+        }
+        if (isLast) {
+            isEmpty = false;
+            lastKey.assign(static_cast<const char *>(recordKey.mv_data), recordKey.mv_size);
+            lastValue.assign(static_cast<const char *>(recordValue.mv_data), recordValue.mv_size);
+        }
+    }
+
     std::string Datastore::getKeyAsString(const KeyValue &data) {
         return std::string(static_cast<char *>(data.key().mv_data), data.key().mv_size);
     }
@@ -284,4 +394,24 @@ namespace nogdb {
         }
     }
 
+    size_t Datastore::getLastTxnId(EnvHandler *envHandler) {
+        MDB_envinfo envInfo;
+        if (auto error = mdb_env_info(envHandler, &envInfo)) {
+            throw error;
+        }
+        return envInfo.me_last_txnid;
+    }
+
+    size_t Datastore::getTxnId(TxnHandler *txnHandler) {
+        return mdb_txn_id(txnHandler);
+    }
+
+    size_t Datastore::getNumRecords(TxnHandler *txnHandler, DBHandler dbHandler) {
+        MDB_stat stat;
+        if (auto error = mdb_stat(txnHandler, dbHandler, &stat)) {
+            throw error;
+        }
+        return stat.ms_entries;
+    }
+
 }
@@ -121,6 +121,8 @@ namespace nogdb {
 
         static KeyValue getSetRangeCursor(CursorHandler *cursorHandler, const std::string &key);
 
+        static KeyValue getSetRangeCursor(CursorHandler *cursorHandler, const Blob &key);
+
         static void deleteCursor(CursorHandler *cursorHandler);
 
         static void closeCursor(CursorHandler *cursorHandler);
@@ -139,6 +141,41 @@ namespace nogdb {
             mutable CursorHandler *cursorHandler;
         };
 
+        // writes records in the append mode whenever a record comes after the last one of a table in the order of
+        // the table (including the order of values of a duplicated key), or with an ordinary put otherwise, so that
+        // records written in that order fill pages one after another without searching the tree
+        class AppendCursor {
+        public:
+            AppendCursor(TxnHandler *txnHandler, DBHandler dbHandler);
+
+            ~AppendCursor() noexcept;
+
+            AppendCursor(const AppendCursor &) = delete;
+
+            AppendCursor &operator=(const AppendCursor &) = delete;
+
+            template<typename K>
+            void putRecord(const K &key, const Blob &value, bool isOverwrite = true) {
+                MDB_val recordKey;
+                recordKey.mv_size = sizeof(K);
+                recordKey.mv_data = const_cast<void *>(reinterpret_cast<const void *>(&key));
+                put(recordKey, value, isOverwrite);
+            }
+
+            void putRecord(const std::string &key, const Blob &value, bool isOverwrite = true);
+
+        private:
+            TxnHandler *txnHandler;
+            DBHandler dbHandler;
+            CursorHandler *cursorHandler;
+            bool isDuplicated;
+            bool isEmpty;
+            std::string lastKey;
+            std::string lastValue;
+
+            void put(MDB_val &recordKey, const Blob &value, bool isOverwrite);
+        };
+
         template<typename K>
         static void putRecord(TxnHandler *txnHandler, DBHandler dbHandler, const K &key, const std::string &value,
                               bool isAppend = false, bool isOverwrite = true) {
@@ -177,6 +214,9 @@ namespace nogdb {
         static void putRecord(TxnHandler *txnHandler, DBHandler dbHandler, const std::string &key, const Blob &value,
                               bool isAppend = false, bool isOverwrite = true);
 
+        static void putRecord(TxnHandler *txnHandler, DBHandler dbHandler, const Blob &key, const Blob &value,
+                              bool isAppend = false, bool isOverwrite = true);
+
         template<typename K, typename V>
         static void
         putRecord(TxnHandler *txnHandler, DBHandler dbHandler, const K &key, const V &value, bool isAppend = false,
@@ -244,6 +284,8 @@ namespace nogdb {
         static void
         deleteRecord(TxnHandler *txnHandler, DBHandler dbHandler, const std::string &key, const Blob &value);
 
+        static void deleteRecord(TxnHandler *txnHandler, DBHandler dbHandler, const Blob &key, const Blob &value);
+
         template<typename K>
         static const K *getKeyAsNumeric(const KeyValue &keyValue) noexcept {
             return reinterpret_cast<K *>(keyValue.key().mv_data);
@@ -261,6 +303,14 @@ namespace nogdb {
         static Blob getValueAsBlob(const KeyValue &keyValue);
 
         static void forceFlush(EnvHandler *envHandler);
+
+        // an id of the last committed read-write txn in the environment
+        static size_t getLastTxnId(EnvHandler *envHandler);
+
+        // an id of the snapshot which a txn reads (the same for read-only txns which see the same data)
+        static size_t getTxnId(TxnHandler *txnHandler);
+
+        static size_t getNumRecords(TxnHandler *txnHandler, DBHandler dbHandler);
     };
 }
 
@@ -32,11 +32,17 @@
 
 namespace nogdb {
     Record Db::getRecord(const Txn &txn, const RecordDescriptor &recordDescriptor) {
+        return getRecord(txn, recordDescriptor, PropertyFilter{});
+    }
+
+    Record
+    Db::getRecord(const Txn &txn, const RecordDescriptor &recordDescriptor, const PropertyFilter &propertyFilter) {
         auto classDescriptor = Generic::getClassDescriptor(txn, recordDescriptor.rid.first, ClassType::UNDEFINED);
-        auto classPropertyInfo = Generic::getClassMapProperty(*txn.txnBase, classDescriptor);
+        auto classPropertyInfo = Generic::getClassMapProperty(*txn.txnBase, classDescriptor,
+                                                              propertyFilter.getPropertyName());
         auto keyValue = KeyValue{};
         try {
-            auto classDBHandler = Datastore::openDbi(txn.txnBase->getDsTxnHandler(), std::to_string(classDescriptor->id), true);
+            auto classDBHandler = txn.txnBase->openClassDbi(classDescriptor->id);
             keyValue = Datastore::getRecord(txn.txnBase->getDsTxnHandler(), classDBHandler, recordDescriptor.rid.second);
         } catch (Datastore::ErrorType &err) {
             throw Error(err, Error::Type::DATASTORE);
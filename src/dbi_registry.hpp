@@ -0,0 +1,117 @@
+/*
+ *  Copyright (C) 2018, Throughwave (Thailand) Co., Ltd.
+ *  <peerawich at throughwave dot co dot th>
+ *
+ *  This file is part of libnogdb, the NogDB core library in C++.
+ *
+ *  libnogdb is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef __DBI_REGISTRY_HPP_INCLUDED_
+#define __DBI_REGISTRY_HPP_INCLUDED_
+
+#include <atomic>
+#include <cstdint>
+#include <unordered_map>
+
+#include "datastore.hpp"
+#include "spinlock.hpp"
+
+namespace nogdb {
+
+    // a context-wide cache of lmdb dbi handles which have been opened by committed transactions
+    // NOTE: a handle opened by an uncommitted transaction must not be published here because lmdb
+    // will close it again if that transaction is aborted
+    // NOTE: lmdb rejects a handle in a transaction which began before the handle was opened, so each handle
+    // carries the generation when it was published
+    class DBHandlerRegistry {
+    public:
+        enum DBType : uint32_t {
+            CLASS = 0, INDEX = 1, INDEX_POSITIVE = 2, INDEX_NEGATIVE = 3, RELATION = 4
+        };
+
+        typedef uint64_t Key;
+        typedef std::unordered_map<Key, Datastore::DBHandler> DBHandlers;
+
+        struct Entry {
+            Datastore::DBHandler dbHandler;
+            uint64_t generation;
+        };
+
+        DBHandlerRegistry() = default;
+
+        DBHandlerRegistry(const DBHandlerRegistry &) = delete;
+
+        DBHandlerRegistry &operator=(const DBHandlerRegistry &) = delete;
+
+        inline static Key makeKey(DBType type, uint32_t id) {
+            return (static_cast<Key>(type) << 32) | static_cast<Key>(id);
+        }
+
+        // find a handle which was published before a transaction of txnGeneration began
+        bool find(Key key, uint64_t txnGeneration, Datastore::DBHandler &dbHandler) const {
+            RWSpinLockGuard<RWSpinLock> _(splock, RWSpinLockMode::SHARED_SPLOCK);
+            auto iterator = handlers.find(key);
+            if (iterator == handlers.cend() || iterator->second.generation > txnGeneration) {
+                return false;
+            }
+            dbHandler = iterator->second.dbHandler;
+            return true;
+        }
+
+        uint64_t getEpoch() const {
+            return epoch.load(std::memory_order_acquire);
+        }
+
+        uint64_t getGeneration() const {
+            return generation.load(std::memory_order_acquire);
+        }
+
+        // publish handles from a committed transaction unless some dbi has been dropped since it began
+        void publish(const DBHandlers &newHandlers, uint64_t txnEpoch) {
+            if (newHandlers.empty()) {
+                return;
+            }
+            RWSpinLockGuard<RWSpinLock> _(splock, RWSpinLockMode::EXCLUSIVE_SPLOCK);
+            if (epoch.load(std::memory_order_relaxed) == txnEpoch) {
+                auto newGeneration = generation.fetch_add(1, std::memory_order_acq_rel) + 1;
+                for (const auto &newHandler: newHandlers) {
+                    handlers.emplace(newHandler.first, Entry{newHandler.second, newGeneration});
+                }
+            }
+        }
+
+        uint64_t erase(Key key) {
+            RWSpinLockGuard<RWSpinLock> _(splock, RWSpinLockMode::EXCLUSIVE_SPLOCK);
+            handlers.erase(key);
+            return epoch.fetch_add(1, std::memory_order_acq_rel) + 1;
+        }
+
+        void clear() {
+            RWSpinLockGuard<RWSpinLock> _(splock, RWSpinLockMode::EXCLUSIVE_SPLOCK);
+            handlers.clear();
+            epoch.fetch_add(1, std::memory_order_acq_rel);
+        }
+
+    private:
+        mutable RWSpinLock splock{};
+        std::unordered_map<Key, Entry> handlers{};
+        std::atomic<uint64_t> epoch{0};
+        std::atomic<uint64_t> generation{0};
+    };
+
+}
+
+#endif
@@ -26,6 +26,7 @@
 #include "constant.hpp"
 #include "env_handler.hpp"
 #include "datastore.hpp"
+#include "relation.hpp"
 #include "graph.hpp"
 #include "parser.hpp"
 #include "compare.hpp"
@@ -46,17 +47,17 @@ namespace nogdb {
         auto classDescriptor = Generic::getClassDescriptor(txn, className, ClassType::EDGE);
         auto srcVertexDescriptor = Generic::getClassDescriptor(txn, srcVertexRecordDescriptor.rid.first, ClassType::VERTEX);
         auto dstVertexDescriptor = Generic::getClassDescriptor(txn, dstVertexRecordDescriptor.rid.first, ClassType::VERTEX);
-        auto classInfo = ClassPropertyInfo{};
+        auto classInfo = std::shared_ptr<const ClassPropertyInfo>{};
         auto indexInfos = std::map<std::string, std::tuple<PropertyType, IndexId, bool>>{};
         auto value = Parser::parseRecord(*txn.txnBase, classDescriptor, record, classInfo, indexInfos);
         auto dsTxnHandler = txn.txnBase->getDsTxnHandler();
         try {
-            auto srcDBHandler = Datastore::openDbi(dsTxnHandler, std::to_string(srcVertexRecordDescriptor.rid.first), true);
+            auto srcDBHandler = txn.txnBase->openClassDbi(srcVertexRecordDescriptor.rid.first);
             auto srcKeyValue = Datastore::getRecord(dsTxnHandler, srcDBHandler, srcVertexRecordDescriptor.rid.second);
             if (srcKeyValue.empty()) {
                 throw Error(GRAPH_NOEXST_SRC, Error::Type::GRAPH);
             }
-            auto dstDBHandler = Datastore::openDbi(dsTxnHandler, std::to_string(dstVertexRecordDescriptor.rid.first), true);
+            auto dstDBHandler = txn.txnBase->openClassDbi(dstVertexRecordDescriptor.rid.first);
             auto dstKeyValue = Datastore::getRecord(dsTxnHandler, dstDBHandler, dstVertexRecordDescriptor.rid.second);
             if (dstKeyValue.empty()) {
                 throw Error(GRAPH_NOEXST_DST, Error::Type::GRAPH);
@@ -67,7 +68,7 @@ namespace nogdb {
         const PositionId *maxRecordNum = nullptr;
         auto maxRecordNumValue = 0U;
         try {
-            auto classDBHandler = Datastore::openDbi(dsTxnHandler, std::to_string(classDescriptor->id), true);
+            auto classDBHandler = txn.txnBase->openClassDbi(classDescriptor->id);
             auto keyValue = Datastore::getRecord(dsTxnHandler, classDBHandler, EM_MAXRECNUM);
             maxRecordNum = Datastore::getValueAsNumeric<PositionId>(keyValue);
             maxRecordNumValue = *maxRecordNum;
@@ -82,15 +83,14 @@ namespace nogdb {
                 auto const isUnique = std::get<2>(indexInfo.second);
                 Index::addIndex(*txn.txnBase, indexId, maxRecordNumValue, bytesValue, propertyType, isUnique);
             }
+            Index::addCompositeIndex(*txn.txnBase,
+                                     BaseTxn::getCurrentVersion(*txn.txnBase, classDescriptor->compositeIndexes).first,
+                                     *classInfo, maxRecordNumValue, record);
 
-            auto relationDBHandler = Datastore::openDbi(dsTxnHandler, TB_RELATIONS);
-            auto edgeRecord = Blob((sizeof(ClassId) + sizeof(PositionId)) * 2);
-            edgeRecord.append(&srcVertexRecordDescriptor.rid.first, sizeof(ClassId));
-            edgeRecord.append(&srcVertexRecordDescriptor.rid.second, sizeof(PositionId));
-            edgeRecord.append(&dstVertexRecordDescriptor.rid.first, sizeof(ClassId));
-            edgeRecord.append(&dstVertexRecordDescriptor.rid.second, sizeof(PositionId));
+            auto relationDBHandler = txn.txnBase->openRelationDbi();
             auto key = RecordId{classDescriptor->id, maxRecordNumValue};
-            Datastore::putRecord(dsTxnHandler, relationDBHandler, rid2str(key), edgeRecord);
+            Relation::put(dsTxnHandler, relationDBHandler, key, srcVertexRecordDescriptor.rid,
+                          dstVertexRecordDescriptor.rid);
 
             // update in-memory relations
             txn.txnCtx.dbRelation->createEdge(*txn.txnBase, key, srcVertexRecordDescriptor.rid,
@@ -106,26 +106,80 @@ namespace nogdb {
         return RecordDescriptor{classDescriptor->id, maxRecordNumValue};
     }
 
+    std::vector<RecordDescriptor>
+    Edge::createBatch(Txn &txn, const std::string &className, const std::vector<EdgeRecord> &edgeRecords) {
+        // transaction validations
+        Validate::isTransactionValid(txn);
+        auto classDescriptor = Generic::getClassDescriptor(txn, className, ClassType::EDGE);
+        auto dsTxnHandler = txn.txnBase->getDsTxnHandler();
+        // verify each distinct source and destination vertex only once
+        auto vertexClassIds = std::set<ClassId>{};
+        auto existingVertices = std::set<RecordId>{};
+        auto verifyVertex = [&](const RecordDescriptor &recordDescriptor, int errorCode) {
+            if (existingVertices.find(recordDescriptor.rid) != existingVertices.cend()) {
+                return;
+            }
+            if (vertexClassIds.find(recordDescriptor.rid.first) == vertexClassIds.cend()) {
+                Generic::getClassDescriptor(txn, recordDescriptor.rid.first, ClassType::VERTEX);
+                vertexClassIds.insert(recordDescriptor.rid.first);
+            }
+            auto vertexDBHandler = txn.txnBase->openClassDbi(recordDescriptor.rid.first);
+            auto keyValue = Datastore::getRecord(dsTxnHandler, vertexDBHandler, recordDescriptor.rid.second);
+            if (keyValue.empty()) {
+                throw Error(errorCode, Error::Type::GRAPH);
+            }
+            existingVertices.insert(recordDescriptor.rid);
+        };
+        try {
+            for (const auto &edgeRecord: edgeRecords) {
+                verifyVertex(edgeRecord.srcVertex, GRAPH_NOEXST_SRC);
+                verifyVertex(edgeRecord.dstVertex, GRAPH_NOEXST_DST);
+            }
+        } catch (Datastore::ErrorType &err) {
+            throw Error(err, Error::Type::DATASTORE);
+        }
+        auto result = Generic::appendRecords(txn, classDescriptor, edgeRecords.size(),
+                                             [&edgeRecords](size_t index) -> const Record & {
+                                                 return edgeRecords[index].record;
+                                             });
+        auto edgeRelations = std::vector<Graph::EdgeRelation>{};
+        edgeRelations.reserve(edgeRecords.size());
+        try {
+            auto relationDBHandler = txn.txnBase->openRelationDbi();
+            for (auto i = size_t{0}; i < edgeRecords.size(); ++i) {
+                const auto &srcRid = edgeRecords[i].srcVertex.rid;
+                const auto &dstRid = edgeRecords[i].dstVertex.rid;
+                Relation::put(dsTxnHandler, relationDBHandler, result[i].rid, srcRid, dstRid);
+                edgeRelations.emplace_back(result[i].rid, srcRid, dstRid);
+            }
+        } catch (Datastore::ErrorType &err) {
+            throw Error(err, Error::Type::DATASTORE);
+        }
+        // update in-memory relations
+        txn.txnCtx.dbRelation->createEdges(*txn.txnBase, edgeRelations);
+        return result;
+    }
+
     void Edge::update(Txn &txn, const RecordDescriptor &recordDescriptor, const Record &record) {
         // transaction validations
         Validate::isTransactionValid(txn);
         auto classDescriptor = Generic::getClassDescriptor(txn, recordDescriptor.rid.first, ClassType::EDGE);
-        auto classInfo = ClassPropertyInfo{};
+        auto classInfo = std::shared_ptr<const ClassPropertyInfo>{};
         auto indexInfos = std::map<std::string, std::tuple<PropertyType, IndexId, bool>>{};
         auto value = Parser::parseRecord(*txn.txnBase, classDescriptor, record, classInfo, indexInfos);
         auto dsTxnHandler = txn.txnBase->getDsTxnHandler();
         try {
-            auto classDBHandler = Datastore::openDbi(dsTxnHandler, std::to_string(classDescriptor->id), true);
+            auto classDBHandler = txn.txnBase->openClassDbi(classDescriptor->id);
             auto keyValue = Datastore::getRecord(dsTxnHandler, classDBHandler, recordDescriptor.rid.second);
             if (keyValue.empty()) {
                 throw Error(GRAPH_NOEXST_EDGE, Error::Type::GRAPH);
             }
-            auto existingRecord = Parser::parseRawData(keyValue, classInfo);
+            auto existingRecord = Parser::parseRawData(keyValue, *classInfo);
             auto existingIndexInfos = std::map<std::string, std::tuple<PropertyType, IndexId, bool>>{};
             for (const auto &property: existingRecord.getAll()) {
                 // check if having any index
-                auto foundProperty = classInfo.nameToDesc.find(property.first);
-                if (foundProperty != classInfo.nameToDesc.cend()) {
+                auto foundProperty = classInfo->nameToDesc.find(property.first);
+                if (foundProperty != classInfo->nameToDesc.cend()) {
                     for (const auto &indexIter: foundProperty->second.indexInfo) {
                         if (indexIter.second.first == classDescriptor->id) {
                             existingIndexInfos.emplace(
@@ -156,6 +210,10 @@ namespace nogdb {
                 auto const isUnique = std::get<2>(indexInfo.second);
                 Index::addIndex(*txn.txnBase, indexId, recordDescriptor.rid.second, bytesValue, propertyType, isUnique);
             }
+            auto compositeIndexInfo = BaseTxn::getCurrentVersion(*txn.txnBase, classDescriptor->compositeIndexes).first;
+            Index::deleteCompositeIndex(*txn.txnBase, compositeIndexInfo, *classInfo, recordDescriptor.rid.second,
+                                        existingRecord);
+            Index::addCompositeIndex(*txn.txnBase, compositeIndexInfo, *classInfo, recordDescriptor.rid.second, record);
 
             Datastore::putRecord(dsTxnHandler, classDBHandler, recordDescriptor.rid.second, value);
         } catch (Datastore::ErrorType &err) {
@@ -170,19 +228,19 @@ namespace nogdb {
         auto classInfo = Generic::getClassMapProperty(*txn.txnBase, classDescriptor);
         auto dsTxnHandler = txn.txnBase->getDsTxnHandler();
         try {
-            auto relationDBHandler = Datastore::openDbi(dsTxnHandler, TB_RELATIONS);
-            Datastore::deleteRecord(dsTxnHandler, relationDBHandler, rid2str(recordDescriptor.rid));
+            auto relationDBHandler = txn.txnBase->openRelationDbi();
+            Relation::remove(dsTxnHandler, relationDBHandler, recordDescriptor.rid);
 
-            auto classDBHandler = Datastore::openDbi(dsTxnHandler, std::to_string(classDescriptor->id), true);
+            auto classDBHandler = txn.txnBase->openClassDbi(classDescriptor->id);
             // delete index if existing
             auto keyValue = Datastore::getRecord(dsTxnHandler, classDBHandler, recordDescriptor.rid.second);
             if (!keyValue.empty()) {
                 auto indexInfos = std::map<std::string, std::tuple<PropertyType, IndexId, bool>>{};
-                auto record = Parser::parseRawData(keyValue, classInfo);
+                auto record = Parser::parseRawData(keyValue, *classInfo);
                 for (const auto &property: record.getAll()) {
                     // check if having any index
-                    auto foundProperty = classInfo.nameToDesc.find(property.first);
-                    if (foundProperty != classInfo.nameToDesc.cend()) {
+                    auto foundProperty = classInfo->nameToDesc.find(property.first);
+                    if (foundProperty != classInfo->nameToDesc.cend()) {
                         for (const auto &indexIter: foundProperty->second.indexInfo) {
                             if (indexIter.second.first == classDescriptor->id) {
                                 indexInfos.emplace(
@@ -205,6 +263,9 @@ namespace nogdb {
                     auto const isUnique = std::get<2>(indexInfo.second);
                     Index::deleteIndex(*txn.txnBase, indexId, recordDescriptor.rid.second, bytesValue, propertyType, isUnique);
                 }
+                Index::deleteCompositeIndex(*txn.txnBase,
+                                            BaseTxn::getCurrentVersion(*txn.txnBase, classDescriptor->compositeIndexes).first,
+                                            *classInfo, recordDescriptor.rid.second, record);
             }
             // delete actual record
             Datastore::deleteRecord(dsTxnHandler, classDBHandler, recordDescriptor.rid.second);
@@ -225,7 +286,7 @@ namespace nogdb {
         // remove all index records
         try {
             auto indexInfos = std::vector<std::tuple<PropertyType, IndexId, bool>>{};
-            for (const auto &property: classInfo.nameToDesc) {
+            for (const auto &property: classInfo->nameToDesc) {
                 auto &type = property.second.type;
                 auto &indexInfo = property.second.indexInfo;
                 for (const auto &indexIter: indexInfo) {
@@ -250,9 +311,7 @@ namespace nogdb {
                     case PropertyType::UNSIGNED_SMALLINT:
                     case PropertyType::UNSIGNED_INTEGER:
                     case PropertyType::UNSIGNED_BIGINT: {
-                        auto dataIndexDBHandler = Datastore::openDbi(dsTxnHandler,
-                                                                     TB_INDEXING_PREFIX + std::to_string(indexId),
-                                                                     true, isUnique);
+                        auto dataIndexDBHandler = txn.txnBase->openIndexDbi(indexId, true, isUnique);
                         Datastore::emptyDbi(dsTxnHandler, dataIndexDBHandler);
                         break;
                     }
@@ -261,22 +320,21 @@ namespace nogdb {
                     case PropertyType::INTEGER:
                     case PropertyType::BIGINT:
                     case PropertyType::REAL: {
+                        if (Index::isOrderedIndex(*txn.txnBase, propertyType)) {
+                            auto dataIndexDBHandler = txn.txnBase->openIndexDbi(indexId, false, isUnique);
+                            Datastore::emptyDbi(dsTxnHandler, dataIndexDBHandler);
+                            break;
+                        }
                         auto dataIndexDBHandlerPositive =
-                                Datastore::openDbi(dsTxnHandler,
-                                                   TB_INDEXING_PREFIX + std::to_string(indexId) + "_positive",
-                                                   true, isUnique);
+                                txn.txnBase->openSignedIndexDbi(indexId, true, isUnique);
                         auto dataIndexDBHandlerNegative =
-                                Datastore::openDbi(dsTxnHandler,
-                                                   TB_INDEXING_PREFIX + std::to_string(indexId) + "_negative",
-                                                   true, isUnique);
+                                txn.txnBase->openSignedIndexDbi(indexId, false, isUnique);
                         Datastore::emptyDbi(dsTxnHandler, dataIndexDBHandlerPositive);
                         Datastore::emptyDbi(dsTxnHandler, dataIndexDBHandlerNegative);
                         break;
                     }
                     case PropertyType::TEXT: {
-                        auto dataIndexDBHandler = Datastore::openDbi(dsTxnHandler,
-                                                                     TB_INDEXING_PREFIX + std::to_string(indexId),
-                                                                     false, isUnique);
+                        auto dataIndexDBHandler = txn.txnBase->openIndexDbi(indexId, false, isUnique);
                         Datastore::emptyDbi(dsTxnHandler, dataIndexDBHandler);
                         break;
                     }
@@ -284,14 +342,16 @@ namespace nogdb {
                         break;
                 }
             }
+            Index::emptyCompositeIndex(*txn.txnBase,
+                                       BaseTxn::getCurrentVersion(*txn.txnBase, classDescriptor->compositeIndexes).first);
         } catch (Datastore::ErrorType &err) {
             throw Error(err, Error::Type::DATASTORE);
         }
         // remove all records in database
         try {
-            auto classDBHandler = Datastore::openDbi(dsTxnHandler, std::to_string(classDescriptor->id), true);
+            auto classDBHandler = txn.txnBase->openClassDbi(classDescriptor->id);
             auto cursorHandler = Datastore::openCursor(dsTxnHandler, classDBHandler);
-            auto relationDBHandler = Datastore::openDbi(dsTxnHandler, TB_RELATIONS);
+            auto relationDBHandler = txn.txnBase->openRelationDbi();
             auto keyValue = Datastore::getNextCursor(cursorHandler);
             while (!keyValue.empty()) {
                 auto key = Datastore::getKeyAsNumeric<PositionId>(keyValue);
@@ -299,7 +359,7 @@ namespace nogdb {
                     auto recordDescriptor = RecordDescriptor{classDescriptor->id, *key};
                     recordIds.push_back(recordDescriptor.rid);
                     // delete from relations
-                    Datastore::deleteRecord(dsTxnHandler, relationDBHandler, rid2str(recordDescriptor.rid));
+                    Relation::remove(dsTxnHandler, relationDBHandler, recordDescriptor.rid);
                     // delete a record in a datastore
                     //Datastore::deleteCursor(cursorHandler);
                 }
@@ -326,30 +386,20 @@ namespace nogdb {
                                                             ClassType::VERTEX);
         auto dsTxnHandler = txn.txnBase->getDsTxnHandler();
         try {
-            auto classDBHandler = Datastore::openDbi(dsTxnHandler, std::to_string(classDescriptor->id), true);
+            auto classDBHandler = txn.txnBase->openClassDbi(classDescriptor->id);
             auto keyValue = Datastore::getRecord(dsTxnHandler, classDBHandler, recordDescriptor.rid.second);
             if (keyValue.empty()) {
                 throw Error(GRAPH_NOEXST_EDGE, Error::Type::GRAPH);
             }
-            auto srcDBHandler = Datastore::openDbi(dsTxnHandler, std::to_string(newSrcVertexRecordDescriptor.rid.first), true);
+            auto srcDBHandler = txn.txnBase->openClassDbi(newSrcVertexRecordDescriptor.rid.first);
             keyValue = Datastore::getRecord(dsTxnHandler, srcDBHandler, newSrcVertexRecordDescriptor.rid.second);
             if (keyValue.empty()) {
                 throw Error(GRAPH_NOEXST_SRC, Error::Type::GRAPH);
             }
-            auto key = rid2str(recordDescriptor.rid);
-            auto relationDBHandler = Datastore::openDbi(dsTxnHandler, TB_RELATIONS);
-            keyValue = Datastore::getRecord(dsTxnHandler, relationDBHandler, key);
-            auto data = Datastore::getValueAsBlob(keyValue);
-            auto dstClassId = ClassId{0};
-            auto dstPositionId = PositionId{0};
-            auto offset = data.retrieve(&dstClassId, sizeof(ClassId) + sizeof(PositionId), sizeof(ClassId));
-            data.retrieve(&dstPositionId, offset, sizeof(PositionId));
-            auto edge = Blob((sizeof(ClassId) + sizeof(PositionId)) * 2);
-            edge.append(&newSrcVertexRecordDescriptor.rid.first, sizeof(ClassId));
-            edge.append(&newSrcVertexRecordDescriptor.rid.second, sizeof(PositionId));
-            edge.append(&dstClassId, sizeof(ClassId));
-            edge.append(&dstPositionId, sizeof(PositionId));
-            Datastore::putRecord(dsTxnHandler, relationDBHandler, key, edge);
+            auto relationDBHandler = txn.txnBase->openRelationDbi();
+            auto vertexIds = Relation::get(dsTxnHandler, relationDBHandler, recordDescriptor.rid);
+            Relation::put(dsTxnHandler, relationDBHandler, recordDescriptor.rid, newSrcVertexRecordDescriptor.rid,
+                          vertexIds.second);
 
             // update in-memory relations
             txn.txnCtx.dbRelation->alterVertexSrc(*txn.txnBase, recordDescriptor.rid, newSrcVertexRecordDescriptor.rid);
@@ -369,30 +419,20 @@ namespace nogdb {
         auto vertexDescriptor = Generic::getClassDescriptor(txn, newDstVertexDescriptor.rid.first, ClassType::VERTEX);
         auto dsTxnHandler = txn.txnBase->getDsTxnHandler();
         try {
-            auto classDBHandler = Datastore::openDbi(dsTxnHandler, std::to_string(classDescriptor->id), true);
+            auto classDBHandler = txn.txnBase->openClassDbi(classDescriptor->id);
             auto keyValue = Datastore::getRecord(dsTxnHandler, classDBHandler, recordDescriptor.rid.second);
             if (keyValue.empty()) {
                 throw Error(GRAPH_NOEXST_EDGE, Error::Type::GRAPH);
             }
-            auto srcDBHandler = Datastore::openDbi(dsTxnHandler, std::to_string(newDstVertexDescriptor.rid.first), true);
+            auto srcDBHandler = txn.txnBase->openClassDbi(newDstVertexDescriptor.rid.first);
             keyValue = Datastore::getRecord(dsTxnHandler, srcDBHandler, newDstVertexDescriptor.rid.second);
             if (keyValue.empty()) {
                 throw Error(GRAPH_NOEXST_DST, Error::Type::GRAPH);
             }
-            auto key = rid2str(recordDescriptor.rid);
-            auto relationDBHandler = Datastore::openDbi(dsTxnHandler, TB_RELATIONS);
-            keyValue = Datastore::getRecord(dsTxnHandler, relationDBHandler, key);
-            auto data = Datastore::getValueAsBlob(keyValue);
-            auto srcClassId = 0U;
-            auto srcPositionId = 0U;
-            auto offset = data.retrieve(&srcClassId, 0, sizeof(ClassId));
-            data.retrieve(&srcPositionId, offset, sizeof(PositionId));
-            auto edge = Blob((sizeof(ClassId) + sizeof(PositionId)) * 2);
-            edge.append(&srcClassId, sizeof(ClassId));
-            edge.append(&srcPositionId, sizeof(PositionId));
-            edge.append(&newDstVertexDescriptor.rid.first, sizeof(ClassId));
-            edge.append(&newDstVertexDescriptor.rid.second, sizeof(PositionId));
-            Datastore::putRecord(dsTxnHandler, relationDBHandler, key, edge);
+            auto relationDBHandler = txn.txnBase->openRelationDbi();
+            auto vertexIds = Relation::get(dsTxnHandler, relationDBHandler, recordDescriptor.rid);
+            Relation::put(dsTxnHandler, relationDBHandler, recordDescriptor.rid, vertexIds.first,
+                          newDstVertexDescriptor.rid);
 
             // update in-memory relations
             txn.txnCtx.dbRelation->alterVertexDst(*txn.txnBase, recordDescriptor.rid, newDstVertexDescriptor.rid);
@@ -404,25 +444,50 @@ namespace nogdb {
     }
 
     ResultSet Edge::get(const Txn &txn, const std::string &className) {
+        return get(txn, className, PropertyFilter{});
+    }
+
+    ResultSet Edge::get(const Txn &txn, const std::string &className, const PropertyFilter &propertyFilter) {
         auto result = ResultSet{};
         auto classDescriptors = Generic::getMultipleClassDescriptor(txn, std::set<std::string>{className},
                                                                     ClassType::EDGE);
         for (const auto &classDescriptor: classDescriptors) {
-            auto classPropertyInfo = Generic::getClassMapProperty(*txn.txnBase, classDescriptor);
-            auto classInfo = ClassInfo{classDescriptor->id, className, classPropertyInfo};
+            auto classPropertyInfo = Generic::getClassMapProperty(*txn.txnBase, classDescriptor,
+                                                                  propertyFilter.getPropertyName());
+            auto classInfo = ClassInfo{classDescriptor->id, className, classPropertyInfo, Schema::CompositeIndexInfo{}};
             auto partial = Generic::getRecordFromClassInfo(txn, classInfo);
             result.insert(result.end(), partial.cbegin(), partial.cend());
         }
         return result;
     }
 
+    ResultSetView Edge::getView(const Txn &txn, const std::string &className) {
+        Validate::isReadOnlyTransaction(txn);
+        auto result = ResultSetView{};
+        auto classDescriptors = Generic::getMultipleClassDescriptor(txn, std::set<std::string>{className},
+                                                                    ClassType::EDGE);
+        for (const auto &classDescriptor: classDescriptors) {
+            auto classPropertyInfo = Generic::getClassMapProperty(*txn.txnBase, classDescriptor);
+            auto partial = Generic::getRecordViewFromClassInfo(txn, classDescriptor->id, classPropertyInfo);
+            result.insert(result.end(), partial.cbegin(), partial.cend());
+        }
+        return result;
+    }
+
     ResultSetCursor Edge::getCursor(Txn &txn, const std::string &className) {
+        return getCursor(txn, className, PropertyFilter{});
+    }
+
+    ResultSetCursor
+    Edge::getCursor(Txn &txn, const std::string &className, const PropertyFilter &propertyFilter) {
         auto result = ResultSetCursor{txn};
+        result.propertyNames = propertyFilter.getPropertyName();
         auto classDescriptors = Generic::getMultipleClassDescriptor(txn, std::set<std::string>{className},
                                                                     ClassType::EDGE);
         for (const auto &classDescriptor: classDescriptors) {
-            auto classPropertyInfo = Generic::getClassMapProperty(*txn.txnBase, classDescriptor);
-            auto classInfo = ClassInfo{classDescriptor->id, className, classPropertyInfo};
+            auto classPropertyInfo = Generic::getClassMapProperty(*txn.txnBase, classDescriptor,
+                                                                  propertyFilter.getPropertyName());
+            auto classInfo = ClassInfo{classDescriptor->id, className, classPropertyInfo, Schema::CompositeIndexInfo{}};
             auto metadata = Generic::getRdescFromClassInfo(txn, classInfo);
             result.metadata.insert(result.metadata.end(), metadata.cbegin(), metadata.cend());
         }
@@ -33,6 +33,8 @@
 #include "env_handler.hpp"
 #include "datastore.hpp"
 #include "parser.hpp"
+#include "index.hpp"
+#include "class_scanner.hpp"
 #include "generic.hpp"
 #include "schema.hpp"
 
@@ -43,8 +45,7 @@ namespace nogdb {
                                     const ClassPropertyInfo &classPropertyInfo,
                                     const RecordDescriptor &recordDescriptor) {
         try {
-            auto classDBHandler = Datastore::openDbi(txn.txnBase->getDsTxnHandler(),
-                                                     std::to_string(recordDescriptor.rid.first), true);
+            auto classDBHandler = txn.txnBase->openClassDbi(recordDescriptor.rid.first);
             auto keyValue = Datastore::getRecord(txn.txnBase->getDsTxnHandler(), classDBHandler,
                                                  recordDescriptor.rid.second);
             return Result{recordDescriptor, Parser::parseRawData(keyValue, classPropertyInfo)};
@@ -53,17 +54,30 @@ namespace nogdb {
         }
     }
 
+    ResultView Generic::getRecordViewResult(Txn &txn,
+                                            const std::shared_ptr<const ClassPropertyInfo> &classPropertyInfo,
+                                            const RecordDescriptor &recordDescriptor) {
+        Validate::isReadOnlyTransaction(txn);
+        try {
+            auto classDBHandler = txn.txnBase->openClassDbi(recordDescriptor.rid.first);
+            auto keyValue = Datastore::getRecord(txn.txnBase->getDsTxnHandler(), classDBHandler,
+                                                 recordDescriptor.rid.second);
+            return ResultView{recordDescriptor, Parser::parseRawDataView(keyValue, classPropertyInfo)};
+        } catch (Datastore::ErrorType &err) {
+            throw Error(err, Error::Type::DATASTORE);
+        }
+    }
+
     ResultSet Generic::getRecordFromRdesc(const Txn &txn,
                                           const RecordDescriptor &recordDescriptor) {
         auto result = ResultSet{};
         auto classDescriptor = getClassDescriptor(txn, recordDescriptor.rid.first, ClassType::UNDEFINED);
         auto classPropertyInfo = getClassMapProperty(*txn.txnBase, classDescriptor);
         try {
-            auto classDBHandler = Datastore::openDbi(txn.txnBase->getDsTxnHandler(),
-                                                     std::to_string(recordDescriptor.rid.first), true);
+            auto classDBHandler = txn.txnBase->openClassDbi(recordDescriptor.rid.first);
             auto keyValue = Datastore::getRecord(txn.txnBase->getDsTxnHandler(), classDBHandler,
                                                  recordDescriptor.rid.second);
-            result.emplace_back(Result{recordDescriptor, Parser::parseRawData(keyValue, classPropertyInfo)});
+            result.emplace_back(Result{recordDescriptor, Parser::parseRawData(keyValue, *classPropertyInfo)});
         } catch (Datastore::ErrorType &err) {
             throw Error(err, Error::Type::DATASTORE);
         }
@@ -78,11 +92,11 @@ namespace nogdb {
             auto classDescriptor = getClassDescriptor(txn, classId, ClassType::UNDEFINED);
             auto classPropertyInfo = getClassMapProperty(*txn.txnBase, classDescriptor);
             try {
-                auto classDBHandler = Datastore::openDbi(txn.txnBase->getDsTxnHandler(), std::to_string(classId), true);
+                auto classDBHandler = txn.txnBase->openClassDbi(classId);
                 for (const auto &recordDescriptor: recordDescriptors) {
                     auto keyValue = Datastore::getRecord(txn.txnBase->getDsTxnHandler(), classDBHandler,
                                                          recordDescriptor.rid.second);
-                    result.emplace_back(Result{recordDescriptor, Parser::parseRawData(keyValue, classPropertyInfo)});
+                    result.emplace_back(Result{recordDescriptor, Parser::parseRawData(keyValue, *classPropertyInfo)});
                 }
             } catch (Datastore::ErrorType &err) {
                 throw Error(err, Error::Type::DATASTORE);
@@ -92,16 +106,31 @@ namespace nogdb {
     }
 
     ResultSet Generic::getRecordFromClassInfo(const Txn &txn, const ClassInfo &classInfo) {
-        auto result = ResultSet{};
         try {
-            auto classDBHandler = Datastore::openDbi(txn.txnBase->getDsTxnHandler(), std::to_string(classInfo.id), true);
+            auto visit = [&classInfo](ResultSet &result, size_t classIndex, PositionId positionId,
+                                      const KeyValue &keyValue) {
+                result.push_back(Result{RecordDescriptor{classInfo.id, positionId},
+                                        Parser::parseRawData(keyValue, classInfo.propertyInfo)});
+            };
+            return ClassScanner::scan<Result>(txn, std::vector<ClassInfo>{classInfo}, visit);
+        } catch (Datastore::ErrorType &err) {
+            throw Error(err, Error::Type::DATASTORE);
+        }
+    }
+
+    ResultSetView Generic::getRecordViewFromClassInfo(const Txn &txn, ClassId classId,
+                                                      const std::shared_ptr<const ClassPropertyInfo> &classPropertyInfo) {
+        Validate::isReadOnlyTransaction(txn);
+        auto result = ResultSetView{};
+        try {
+            auto classDBHandler = txn.txnBase->openClassDbi(classId);
             auto cursorHandler = Datastore::CursorHandlerWrapper(txn.txnBase->getDsTxnHandler(), classDBHandler);
             auto keyValue = Datastore::getNextCursor(cursorHandler.get());
             while (!keyValue.empty()) {
                 auto key = Datastore::getKeyAsNumeric<PositionId>(keyValue);
                 if (*key != EM_MAXRECNUM) {
-                    result.push_back(Result{RecordDescriptor{classInfo.id, *key},
-                                            Parser::parseRawData(keyValue, classInfo.propertyInfo)});
+                    result.push_back(ResultView{RecordDescriptor{classId, *key},
+                                                Parser::parseRawDataView(keyValue, classPropertyInfo)});
                 }
                 keyValue = Datastore::getNextCursor(cursorHandler.get());
             }
@@ -112,22 +141,15 @@ namespace nogdb {
     }
 
     std::vector<RecordDescriptor> Generic::getRdescFromClassInfo(Txn &txn, const ClassInfo &classInfo) {
-        auto result = std::vector<RecordDescriptor>{};
         try {
-            auto classDBHandler = Datastore::openDbi(txn.txnBase->getDsTxnHandler(), std::to_string(classInfo.id), true);
-            auto cursorHandler = Datastore::CursorHandlerWrapper(txn.txnBase->getDsTxnHandler(), classDBHandler);
-            auto keyValue = Datastore::getNextCursor(cursorHandler.get());
-            while (!keyValue.empty()) {
-                auto key = Datastore::getKeyAsNumeric<PositionId>(keyValue);
-                if (*key != EM_MAXRECNUM) {
-                    result.emplace_back(RecordDescriptor{classInfo.id, *key});
-                }
-                keyValue = Datastore::getNextCursor(cursorHandler.get());
-            }
+            auto visit = [&classInfo](std::vector<RecordDescriptor> &result, size_t classIndex, PositionId positionId,
+                                      const KeyValue &keyValue) {
+                result.emplace_back(RecordDescriptor{classInfo.id, positionId});
+            };
+            return ClassScanner::scan<RecordDescriptor>(txn, std::vector<ClassInfo>{classInfo}, visit);
         } catch (Datastore::ErrorType &err) {
             throw Error(err, Error::Type::DATASTORE);
         }
-        return result;
     }
 
     std::vector<ClassId> Generic::getEdgeClassId(const Txn &txn, const std::set<std::string> &className) {
@@ -139,6 +161,47 @@ namespace nogdb {
         return edgeClassIds;
     }
 
+    std::vector<RecordDescriptor>
+    Generic::appendRecords(Txn &txn, const Schema::ClassDescriptorPtr &classDescriptor, size_t numRecords,
+                           const std::function<const Record &(size_t)> &getRecord) {
+        auto result = std::vector<RecordDescriptor>{};
+        result.reserve(numRecords);
+        auto classInfo = getClassMapProperty(*txn.txnBase, classDescriptor);
+        auto indexEntries = std::map<IndexId, std::tuple<PropertyType, bool, Index::IndexEntries>>{};
+        auto compositeIndexInfo = BaseTxn::getCurrentVersion(*txn.txnBase, classDescriptor->compositeIndexes).first;
+        auto dsTxnHandler = txn.txnBase->getDsTxnHandler();
+        try {
+            auto classDBHandler = txn.txnBase->openClassDbi(classDescriptor->id);
+            auto keyValue = Datastore::getRecord(dsTxnHandler, classDBHandler, EM_MAXRECNUM);
+            auto maxRecordNumValue = *Datastore::getValueAsNumeric<PositionId>(keyValue);
+            for (auto i = size_t{0}; i < numRecords; ++i) {
+                const auto &record = getRecord(i);
+                auto indexInfos = std::map<std::string, std::tuple<PropertyType, IndexId, bool>>{};
+                auto value = Parser::parseRecord(*txn.txnBase, classDescriptor->id, record, *classInfo, indexInfos);
+                auto positionId = static_cast<PositionId>(maxRecordNumValue + i);
+                Datastore::putRecord(dsTxnHandler, classDBHandler, positionId, value, true);
+                Index::addCompositeIndex(*txn.txnBase, compositeIndexInfo, *classInfo, positionId, record);
+                for (const auto &indexInfo: indexInfos) {
+                    auto &entries = indexEntries.emplace(
+                            std::get<1>(indexInfo.second),
+                            std::make_tuple(std::get<0>(indexInfo.second), std::get<2>(indexInfo.second),
+                                            Index::IndexEntries{})).first->second;
+                    std::get<2>(entries).emplace_back(record.get(indexInfo.first), positionId);
+                }
+                result.emplace_back(RecordDescriptor{classDescriptor->id, positionId});
+            }
+            Datastore::putRecord(dsTxnHandler, classDBHandler, EM_MAXRECNUM,
+                                 PositionId{static_cast<PositionId>(maxRecordNumValue + numRecords)});
+            for (auto &indexEntry: indexEntries) {
+                Index::addIndex(*txn.txnBase, indexEntry.first, std::get<2>(indexEntry.second),
+                                std::get<0>(indexEntry.second), std::get<1>(indexEntry.second));
+            }
+        } catch (Datastore::ErrorType &err) {
+            throw Error(err, Error::Type::DATASTORE);
+        }
+        return result;
+    }
+
     ResultSet Generic::getEdgeNeighbour(const Txn &txn,
                                         const RecordDescriptor &recordDescriptor,
                                         const std::vector<ClassId> &edgeClassIds,
@@ -153,17 +216,17 @@ namespace nogdb {
                 auto result = ResultSet{};
                 try {
                     auto classDescriptor = Schema::ClassDescriptorPtr{};
-                    auto classPropertyInfo = ClassPropertyInfo{};
+                    auto classPropertyInfo = std::shared_ptr<const ClassPropertyInfo>{};
                     auto classDBHandler = Datastore::DBHandler{};
                     auto retrieve = [&](ResultSet &result, const RecordId &edge) {
                         if (classDescriptor == nullptr || classDescriptor->id != edge.first) {
                             classDescriptor = getClassDescriptor(txn, edge.first, ClassType::UNDEFINED);
                             classPropertyInfo = getClassMapProperty(*txn.txnBase, classDescriptor);
-                            classDBHandler = Datastore::openDbi(txn.txnBase->getDsTxnHandler(), std::to_string(edge.first), true);
+                            classDBHandler = txn.txnBase->openClassDbi(edge.first);
                         }
                         auto keyValue = Datastore::getRecord(txn.txnBase->getDsTxnHandler(), classDBHandler, edge.second);
                         result.push_back(
-                                Result{RecordDescriptor{edge}, Parser::parseRawData(keyValue, classPropertyInfo)});
+                                Result{RecordDescriptor{edge}, Parser::parseRawData(keyValue, *classPropertyInfo)});
                     };
                     if (edgeClassIds.empty()) {
                         for (const auto &edge: ((*txn.txnCtx.dbRelation).*func)(*txn.txnBase, recordDescriptor.rid, 0)) {
@@ -233,8 +296,7 @@ namespace nogdb {
         } else {
             auto keyValue = KeyValue{};
             try {
-                auto classDBHandler = Datastore::openDbi(txn.txnBase->getDsTxnHandler(),
-                                                         std::to_string(recordDescriptor.rid.first), true);
+                auto classDBHandler = txn.txnBase->openClassDbi(recordDescriptor.rid.first);
                 keyValue = Datastore::getRecord(txn.txnBase->getDsTxnHandler(), classDBHandler,
                                                 recordDescriptor.rid.second);
             } catch (Datastore::ErrorType &err) {
@@ -263,19 +325,28 @@ namespace nogdb {
         return subClasses;
     }
 
-    const ClassPropertyInfo
+    std::shared_ptr<const ClassPropertyInfo>
     Generic::getClassMapProperty(const BaseTxn &txn, const Schema::ClassDescriptorPtr &classDescriptor) {
-        auto classPropertyInfo = ClassPropertyInfo{};
-        classPropertyInfo.insert(CLASS_NAME_PROPERTY_ID, CLASS_NAME_PROPERTY, PropertyType::TEXT);
-        classPropertyInfo.insert(RECORD_ID_PROPERTY_ID, RECORD_ID_PROPERTY, PropertyType::TEXT);
+        auto &classPropertyTable = txn.getClassPropertyTable();
+        // only a txn without its own schema changes which can see the latest committed schema shares the layouts
+        auto schemaVersionId = classPropertyTable.getVersionId();
+        auto isShared = txn.findUncommittedSchema().empty() && schemaVersionId <= txn.getVersionId();
+        if (isShared) {
+            if (auto classPropertyInfo = classPropertyTable.find(schemaVersionId, classDescriptor->id)) {
+                return classPropertyInfo;
+            }
+        }
+        auto classPropertyInfo = std::make_shared<ClassPropertyInfo>();
+        classPropertyInfo->insert(CLASS_NAME_PROPERTY_ID, CLASS_NAME_PROPERTY, PropertyType::TEXT);
+        classPropertyInfo->insert(RECORD_ID_PROPERTY_ID, RECORD_ID_PROPERTY, PropertyType::TEXT);
         for (const auto &property: BaseTxn::getCurrentVersion(txn, classDescriptor->properties).first) {
-            classPropertyInfo.insert(property.first, property.second);
+            classPropertyInfo->insert(property.first, property.second);
         }
         std::function<void(const Schema::ClassDescriptorPtr &)>
                 getInheritProperties = [&txn, &classPropertyInfo, &getInheritProperties]
                 (const Schema::ClassDescriptorPtr &classDescriptorPtr) -> void {
             for (const auto &property: BaseTxn::getCurrentVersion(txn, classDescriptorPtr->properties).first) {
-                classPropertyInfo.insert(property.first, property.second);
+                classPropertyInfo->insert(property.first, property.second);
             }
             if (auto superClassDescriptor = BaseTxn::getCurrentVersion(txn, classDescriptorPtr->super).first.lock()) {
                 getInheritProperties(superClassDescriptor);
@@ -284,9 +355,30 @@ namespace nogdb {
         if (auto superClassDescriptor = BaseTxn::getCurrentVersion(txn, classDescriptor->super).first.lock()) {
             getInheritProperties(superClassDescriptor);
         }
+        if (isShared) {
+            classPropertyTable.insert(schemaVersionId, classDescriptor->id, classPropertyInfo);
+        }
         return classPropertyInfo;
     }
 
+    const ClassPropertyInfo
+    Generic::getClassMapProperty(const BaseTxn &txn, const Schema::ClassDescriptorPtr &classDescriptor,
+                                 const std::set<std::string> &propertyNames) {
+        auto classPropertyInfo = getClassMapProperty(txn, classDescriptor);
+        if (propertyNames.empty()) {
+            return *classPropertyInfo;
+        }
+        auto result = ClassPropertyInfo{};
+        for (const auto &propertyName: propertyNames) {
+            auto foundProperty = classPropertyInfo->nameToDesc.find(propertyName);
+            if (foundProperty == classPropertyInfo->nameToDesc.cend()) {
+                throw Error(CTX_NOEXST_PROPERTY, Error::Type::CONTEXT);
+            }
+            result.insert(foundProperty->second.id, propertyName, foundProperty->second.type);
+        }
+        return result;
+    }
+
     std::set<Schema::ClassDescriptorPtr>
     Generic::getMultipleClassDescriptor(const Txn &txn, const std::vector<ClassId> &classIds, const ClassType &type) {
         auto setOfClassDescriptors = std::set<Schema::ClassDescriptorPtr>();
@@ -327,7 +419,8 @@ namespace nogdb {
                         ClassInfo{
                                 classDescriptor->id,
                                 BaseTxn::getCurrentVersion(txn, classDescriptor->name).first,
-                                getClassMapProperty(txn, classDescriptor)
+                                *getClassMapProperty(txn, classDescriptor),
+                                BaseTxn::getCurrentVersion(txn, classDescriptor->compositeIndexes).first
                         }
                 );
             }
@@ -64,6 +64,10 @@ namespace nogdb {
                                       const ClassPropertyInfo &classPropertyInfo,
                                       const RecordDescriptor &recordDescriptor);
 
+        static ResultView getRecordViewResult(Txn &txn,
+                                              const std::shared_ptr<const ClassPropertyInfo> &classPropertyInfo,
+                                              const RecordDescriptor &recordDescriptor);
+
         static ResultSet getRecordFromRdesc(const Txn &txn, const RecordDescriptor &recordDescriptor);
 
         static ResultSet
@@ -71,8 +75,17 @@ namespace nogdb {
 
         static ResultSet getRecordFromClassInfo(const Txn &txn, const ClassInfo &classInfo);
 
+        static ResultSetView getRecordViewFromClassInfo(const Txn &txn, ClassId classId,
+                                                        const std::shared_ptr<const ClassPropertyInfo> &classPropertyInfo);
+
         static std::vector<RecordDescriptor> getRdescFromClassInfo(Txn &txn, const ClassInfo &classInfo);
 
+        // append many records to a class by reserving a range of position ids once
+        // and adding their index entries in the key order
+        static std::vector<RecordDescriptor>
+        appendRecords(Txn &txn, const Schema::ClassDescriptorPtr &classDescriptor, size_t numRecords,
+                      const std::function<const Record &(size_t)> &getRecord);
+
         static ResultSet getEdgeNeighbour(const Txn &txn,
                                           const RecordDescriptor &recordDescriptor,
                                           const std::vector<ClassId> &edgeClassIds,
@@ -95,9 +108,15 @@ namespace nogdb {
         static std::set<Schema::ClassDescriptorPtr>
         getClassExtend(const BaseTxn &txn, const std::set<Schema::ClassDescriptorPtr> &classDescriptors);
 
-        static const ClassPropertyInfo
+        // the layout is shared with other txns which see the same committed schema
+        static std::shared_ptr<const ClassPropertyInfo>
         getClassMapProperty(const BaseTxn &txn, const Schema::ClassDescriptorPtr &classDescriptor);
 
+        // the same as above but only contains the given property names (or all properties if it is empty)
+        static const ClassPropertyInfo
+        getClassMapProperty(const BaseTxn &txn, const Schema::ClassDescriptorPtr &classDescriptor,
+                            const std::set<std::string> &propertyNames);
+
         static std::set<Schema::ClassDescriptorPtr>
         getMultipleClassDescriptor(const Txn &txn, const std::vector<ClassId> &classIds, const ClassType &type);
 
@@ -23,11 +23,13 @@
 #define __GRAPH_HPP_INCLUDED_
 
 #include <vector>
+#include <algorithm>
 #include <unordered_map>
 #include <set>
 #include <memory>
 #include <sstream>
 #include <utility>
+#include <tuple>
 #include <cstdint>
 #include <atomic>
 #include <thread>
@@ -36,8 +38,10 @@
 #include <mutex>
 
 #include "boost/functional/hash.hpp"
-#include "multiversion_hashmap.hpp"
+#include "adjacency_map.hpp"
 #include "concurrent.hpp"
+#include "slab_allocator.hpp"
+#include "constant.hpp"
 #include "txn_object.hpp"
 
 #include "nogdb_errors.h"
@@ -59,7 +63,7 @@ namespace nogdb {
         using GraphElements = std::unordered_map<RecordId, std::shared_ptr<T>, RecordIdHash>;
 
         template<typename T>
-        using ConcurrentGraphElements = ConcurrentHashMap<GraphElements<T>, RecordId, T>;
+        using ConcurrentGraphElements = ConcurrentHashMap<RecordId, T, RecordIdHash>;
 
         struct Edge;
 
@@ -68,8 +72,8 @@ namespace nogdb {
                     : TxnObject{}, rid{rid_} {};
             const RecordId rid;
 
-            TwoLevelMultiVersionHashMap<ClassId, PositionId, std::weak_ptr<Edge>> in{};
-            TwoLevelMultiVersionHashMap<ClassId, PositionId, std::weak_ptr<Edge>> out{};
+            AdjacencyMap<ClassId, PositionId, std::weak_ptr<Edge>> in{};
+            AdjacencyMap<ClassId, PositionId, std::weak_ptr<Edge>> out{};
         };
 
         struct Edge : public TxnObject {
@@ -85,10 +89,26 @@ namespace nogdb {
             VersionControl<std::weak_ptr<Vertex>> target{};
         };
 
+        // allocate a vertex or an edge together with its reference counts from a slab pool
+        // NOTE: only the heap allocation is saved, vertices and edges are still shared and weak pointers with the
+        // cost of atomic reference counts. As the object and its counts share one block, the block goes back to the
+        // pool only after the last weak pointer (e.g. in an adjacency or an edge of a removed vertex) has expired
+        inline static std::shared_ptr<Vertex> makeVertex(const RecordId &rid) {
+            return std::allocate_shared<Vertex>(SlabAllocator<Vertex>{}, rid);
+        }
+
+        inline static std::shared_ptr<Edge> makeEdge(const RecordId &rid, const std::weak_ptr<Vertex> &source,
+                                                     const std::weak_ptr<Vertex> &target) {
+            return std::allocate_shared<Edge>(SlabAllocator<Edge>{}, rid, source, target);
+        }
+
         ConcurrentGraphElements<Vertex> vertices{};
         ConcurrentGraphElements<Edge> edges{};
         ConcurrentDeleteQueue<RecordId> deletedVertices;
         ConcurrentDeleteQueue<RecordId> deletedEdges;
+        // vertices and edges whose older versions can be reclaimed once no txn can see them
+        ConcurrentDeleteQueue<RecordId> staleVertices;
+        ConcurrentDeleteQueue<RecordId> staleEdges;
 
         // return false if there is an existing vertex in a graph, otherwise, true
         bool createVertex(BaseTxn &txn, const RecordId &rid);
@@ -99,6 +119,8 @@ namespace nogdb {
 
         void forceDeleteVertices(const std::vector<RecordId> &rids) noexcept;
 
+        // edges of a vertex (all edge classes if classId is 0) which are collected in one pass under a single
+        // read lock of the adjacency, so callers may read records from the datastore while iterating over them
         std::vector<RecordId> getEdgeIn(const BaseTxn &txn, const RecordId &rid, const ClassId &classId = 0);
 
         std::vector<ClassId> getEdgeClassIn(const BaseTxn &txn, const RecordId &rid);
@@ -107,6 +129,7 @@ namespace nogdb {
 
         std::vector<ClassId> getEdgeClassOut(const BaseTxn &txn, const RecordId &rid);
 
+        // in-edges and out-edges in the order of record ids without duplicated self-loops
         std::vector<RecordId> getEdgeInOut(const BaseTxn &txn, const RecordId &rid, const ClassId &classId = 0);
 
         std::vector<ClassId> getEdgeClassInOut(const BaseTxn &txn, const RecordId &rid);
@@ -115,6 +138,24 @@ namespace nogdb {
 
         void createEdge(BaseTxn &txn, const RecordId &rid, const RecordId &srcRid, const RecordId &dstRid);
 
+        // a rid of an edge, a rid of a source vertex, and a rid of a destination vertex
+        typedef std::tuple<RecordId, RecordId, RecordId> EdgeRelation;
+
+        // create many new edges in one pass where each vertex is looked up only once
+        // NOTE: all edges must have new record ids which have never been in the graph
+        void createEdges(BaseTxn &txn, const std::vector<EdgeRelation> &edgeRelations);
+
+        // a number of threads for loading relations (at least one)
+        inline static unsigned int getNumLoadThreads(uint64_t numRelations) {
+            auto numThreads = std::min<uint64_t>(std::thread::hardware_concurrency(),
+                                                 numRelations / GRAPH_LOAD_MIN_RELATIONS_PER_THREAD);
+            return static_cast<unsigned int>(std::max<uint64_t>(numThreads, 1));
+        }
+
+        // build committed edges and their vertices of an opening database with one thread per part of relations
+        // NOTE: no other txns may access the graph while loading
+        void loadEdges(const std::vector<std::vector<EdgeRelation>> &relationParts, TxnId versionId);
+
         void deleteEdge(BaseTxn &txn, const RecordId &rid) noexcept;
 
         void forceDeleteEdge(const RecordId &rid) noexcept;
@@ -144,6 +185,9 @@ namespace nogdb {
             forceDeleteEdges(deletedEdges.pop_front(versionId));
             forceDeleteVertices(deletedVertices.pop_front(versionId));
         }
+
+        // drop versions of vertices and edges which are superseded for every txn since versionId
+        void clearStaleVersions(TxnId versionId);
     };
 
     inline std::string rid2str(const RecordId &rid) {
@@ -20,6 +20,7 @@
  */
 
 #include <utility>
+#include <exception>
 #include <algorithm>
 
 #include "index.hpp"
@@ -44,6 +45,41 @@ namespace nogdb {
     };
 
 
+    uint64_t Index::toOrderedValue(const Bytes &value, PropertyType type) {
+        switch (type) {
+            case PropertyType::TINYINT:
+                return toOrderedValue(value.toTinyInt());
+            case PropertyType::SMALLINT:
+                return toOrderedValue(value.toSmallInt());
+            case PropertyType::INTEGER:
+                return toOrderedValue(value.toInt());
+            case PropertyType::BIGINT:
+                return toOrderedValue(value.toBigInt());
+            case PropertyType::REAL:
+                return toOrderedValue(value.toReal());
+            default:
+                return 0;
+        }
+    }
+
+    std::vector<RecordDescriptor>
+    Index::orderedSearchIndex(const Txn &txn, ClassId classId, IndexId indexId, bool isUnique,
+                              const uint64_t *lower, bool includeLower, const uint64_t *upper, bool includeUpper) {
+        auto result = std::vector<RecordDescriptor>{};
+        auto dataIndexDBHandler = txn.txnBase->openIndexDbi(indexId, false, isUnique);
+        auto cursorHandler = Datastore::CursorHandlerWrapper(txn.txnBase->getDsTxnHandler(), dataIndexDBHandler);
+        auto keyValue = (lower != nullptr) ? Datastore::getSetRangeCursor(cursorHandler.get(), toOrderedKey(*lower))
+                                           : Datastore::getNextCursor(cursorHandler.get());
+        for (; !keyValue.empty(); keyValue = Datastore::getNextCursor(cursorHandler.get())) {
+            auto value = fromOrderedKey(*Datastore::getKeyAsNumeric<OrderedKey>(keyValue));
+            if (lower != nullptr && !includeLower && value == *lower) continue;
+            if (upper != nullptr && ((value > *upper) || (!includeUpper && value == *upper))) break;
+            auto positionId = Datastore::getValueAsNumeric<PositionId>(keyValue);
+            result.emplace_back(RecordDescriptor{classId, *positionId});
+        }
+        return result;
+    }
+
     void Index::addIndex(BaseTxn &txn, IndexId indexId, PositionId positionId, const Bytes &bytesValue,
                          PropertyType type, bool isUnique) {
         auto dsTxnHandler = txn.getDsTxnHandler();
@@ -56,9 +92,7 @@ namespace nogdb {
                     case PropertyType::UNSIGNED_SMALLINT:
                     case PropertyType::UNSIGNED_INTEGER:
                     case PropertyType::UNSIGNED_BIGINT: {
-                        auto dataIndexDBHandler = Datastore::openDbi(dsTxnHandler,
-                                                                     TB_INDEXING_PREFIX + std::to_string(indexId),
-                                                                     true, isUnique);
+                        auto dataIndexDBHandler = txn.openIndexDbi(indexId, true, isUnique);
                         if (type == PropertyType::UNSIGNED_TINYINT) {
                             Datastore::putRecord(dsTxnHandler, dataIndexDBHandler, bytesValue.toTinyIntU(), indexRecord,
                                                  false, !isUnique);
@@ -79,14 +113,17 @@ namespace nogdb {
                     case PropertyType::INTEGER:
                     case PropertyType::BIGINT:
                     case PropertyType::REAL: {
+                        if (isOrderedIndex(txn, type)) {
+                            auto dataIndexDBHandler = txn.openIndexDbi(indexId, false, isUnique);
+                            Datastore::putRecord(dsTxnHandler, dataIndexDBHandler,
+                                                 toOrderedKey(toOrderedValue(bytesValue, type)), indexRecord,
+                                                 false, !isUnique);
+                            break;
+                        }
                         auto dataIndexDBHandlerPositive =
-                                Datastore::openDbi(dsTxnHandler,
-                                                   TB_INDEXING_PREFIX + std::to_string(indexId) + "_positive",
-                                                   true, isUnique);
+                                txn.openSignedIndexDbi(indexId, true, isUnique);
                         auto dataIndexDBHandlerNegative =
-                                Datastore::openDbi(dsTxnHandler,
-                                                   TB_INDEXING_PREFIX + std::to_string(indexId) + "_negative",
-                                                   true, isUnique);
+                                txn.openSignedIndexDbi(indexId, false, isUnique);
                         if (type == PropertyType::TINYINT) {
                             auto value = bytesValue.toTinyInt();
                             Datastore::putRecord(dsTxnHandler,
@@ -116,9 +153,7 @@ namespace nogdb {
                         break;
                     }
                     case PropertyType::TEXT: {
-                        auto dataIndexDBHandler = Datastore::openDbi(dsTxnHandler,
-                                                                     TB_INDEXING_PREFIX + std::to_string(indexId),
-                                                                     false, isUnique);
+                        auto dataIndexDBHandler = txn.openIndexDbi(indexId, false, isUnique);
                         auto value = bytesValue.toText();
                         if (!value.empty()) {
                             Datastore::putRecord(dsTxnHandler, dataIndexDBHandler, value, indexRecord,
@@ -139,6 +174,178 @@ namespace nogdb {
         }
     }
 
+    void Index::addIndex(BaseTxn &txn, IndexId indexId, IndexEntries &entries, PropertyType type, bool isUnique,
+                         unsigned int numThreads) {
+        sortIndexEntries(entries, type, numThreads);
+        addSortedIndex(txn, indexId, entries, type, isUnique);
+    }
+
+    void Index::addSortedIndex(BaseTxn &txn, IndexId indexId, const IndexEntries &entries, PropertyType type,
+                               bool isUnique) {
+        // NOTE: writing keys in order keeps lmdb appending to the last page instead of jumping around the tree
+        auto dsTxnHandler = txn.getDsTxnHandler();
+        auto toIndexRecord = [](PositionId positionId) {
+            auto indexRecord = Blob(sizeof(PositionId));
+            indexRecord.append(&positionId, sizeof(PositionId));
+            return indexRecord;
+        };
+        try {
+            switch (type) {
+                case PropertyType::UNSIGNED_TINYINT:
+                case PropertyType::UNSIGNED_SMALLINT:
+                case PropertyType::UNSIGNED_INTEGER:
+                case PropertyType::UNSIGNED_BIGINT: {
+                    Datastore::AppendCursor cursor(dsTxnHandler, txn.openIndexDbi(indexId, true, isUnique));
+                    for (const auto &entry: entries) {
+                        auto indexRecord = toIndexRecord(entry.second);
+                        if (type == PropertyType::UNSIGNED_TINYINT) {
+                            cursor.putRecord(entry.first.toTinyIntU(), indexRecord, !isUnique);
+                        } else if (type == PropertyType::UNSIGNED_SMALLINT) {
+                            cursor.putRecord(entry.first.toSmallIntU(), indexRecord, !isUnique);
+                        } else if (type == PropertyType::UNSIGNED_INTEGER) {
+                            cursor.putRecord(entry.first.toIntU(), indexRecord, !isUnique);
+                        } else {
+                            cursor.putRecord(entry.first.toBigIntU(), indexRecord, !isUnique);
+                        }
+                    }
+                    break;
+                }
+                case PropertyType::TINYINT:
+                case PropertyType::SMALLINT:
+                case PropertyType::INTEGER:
+                case PropertyType::BIGINT:
+                case PropertyType::REAL: {
+                    if (isOrderedIndex(txn, type)) {
+                        Datastore::AppendCursor cursor(dsTxnHandler, txn.openIndexDbi(indexId, false, isUnique));
+                        for (const auto &entry: entries) {
+                            cursor.putRecord(toOrderedKey(toOrderedValue(entry.first, type)),
+                                             toIndexRecord(entry.second), !isUnique);
+                        }
+                        break;
+                    }
+                    // the positive and negative tables of an older index are written one entry at a time
+                    for (const auto &entry: entries) {
+                        addIndex(txn, indexId, entry.second, entry.first, type, isUnique);
+                    }
+                    break;
+                }
+                case PropertyType::TEXT: {
+                    Datastore::AppendCursor cursor(dsTxnHandler, txn.openIndexDbi(indexId, false, isUnique));
+                    for (const auto &entry: entries) {
+                        auto value = entry.first.toText();
+                        if (!value.empty()) {
+                            cursor.putRecord(value, toIndexRecord(entry.second), !isUnique);
+                        }
+                    }
+                    break;
+                }
+                default:
+                    break;
+            }
+        } catch (Datastore::ErrorType &err) {
+            if (err == MDB_KEYEXIST) {
+                throw Error(CTX_UNIQUE_CONSTRAINT, Error::Type::CONTEXT);
+            } else {
+                throw Error(err, Error::Type::DATASTORE);
+            }
+        }
+    }
+
+    void Index::sortIndexEntries(IndexEntries &entries, PropertyType type, unsigned int numThreads) {
+        switch (type) {
+            case PropertyType::UNSIGNED_TINYINT:
+                sortIndexEntries(entries, &Bytes::toTinyIntU, numThreads);
+                break;
+            case PropertyType::UNSIGNED_SMALLINT:
+                sortIndexEntries(entries, &Bytes::toSmallIntU, numThreads);
+                break;
+            case PropertyType::UNSIGNED_INTEGER:
+                sortIndexEntries(entries, &Bytes::toIntU, numThreads);
+                break;
+            case PropertyType::UNSIGNED_BIGINT:
+                sortIndexEntries(entries, &Bytes::toBigIntU, numThreads);
+                break;
+            case PropertyType::TINYINT:
+                sortIndexEntries(entries, &Bytes::toTinyInt, numThreads);
+                break;
+            case PropertyType::SMALLINT:
+                sortIndexEntries(entries, &Bytes::toSmallInt, numThreads);
+                break;
+            case PropertyType::INTEGER:
+                sortIndexEntries(entries, &Bytes::toInt, numThreads);
+                break;
+            case PropertyType::BIGINT:
+                sortIndexEntries(entries, &Bytes::toBigInt, numThreads);
+                break;
+            case PropertyType::REAL:
+                sortIndexEntries(entries, &Bytes::toReal, numThreads);
+                break;
+            case PropertyType::TEXT:
+                sortIndexEntries(entries, &Bytes::toText, numThreads);
+                break;
+            default:
+                break;
+        }
+    }
+
+    void Index::addClassIndex(BaseTxn &txn, IndexId indexId, ClassId classId, const ClassPropertyInfo &classInfo,
+                              const std::string &propertyName, PropertyType type, bool isUnique) {
+        auto rawRecords = std::vector<KeyValue>{};
+        {
+            auto cursorHandler = Datastore::CursorHandlerWrapper(txn.getDsTxnHandler(), txn.openClassDbi(classId));
+            for (auto keyValue = Datastore::getNextCursor(cursorHandler.get());
+                 !keyValue.empty();
+                 keyValue = Datastore::getNextCursor(cursorHandler.get())) {
+                if (*Datastore::getKeyAsNumeric<PositionId>(keyValue) != EM_MAXRECNUM) {
+                    rawRecords.push_back(keyValue);
+                }
+            }
+        }
+        auto numThreads = getNumBuildThreads(rawRecords.size());
+        auto entries = extractIndexEntries(rawRecords, classInfo, propertyName, numThreads);
+        addIndex(txn, indexId, entries, type, isUnique, numThreads);
+    }
+
+    Index::IndexEntries Index::extractIndexEntries(const std::vector<KeyValue> &rawRecords,
+                                                   const ClassPropertyInfo &classInfo, const std::string &propertyName,
+                                                   unsigned int numThreads) {
+        auto parts = std::vector<IndexEntries>(numThreads);
+        auto errors = std::vector<std::exception_ptr>(numThreads);
+        auto extract = [&](unsigned int part) {
+            try {
+                auto first = rawRecords.size() * part / numThreads;
+                auto last = rawRecords.size() * (part + 1) / numThreads;
+                for (auto i = first; i < last; ++i) {
+                    auto bytesValue = Parser::parseRawData(rawRecords[i], classInfo).get(propertyName);
+                    if (!bytesValue.empty()) {
+                        auto positionId = *Datastore::getKeyAsNumeric<PositionId>(rawRecords[i]);
+                        parts[part].emplace_back(std::move(bytesValue), positionId);
+                    }
+                }
+            } catch (...) {
+                errors[part] = std::current_exception();
+            }
+        };
+        auto workers = std::vector<std::thread>{};
+        for (auto part = 1U; part < numThreads; ++part) {
+            workers.emplace_back(extract, part);
+        }
+        extract(0);
+        for (auto &worker: workers) {
+            worker.join();
+        }
+        for (const auto &error: errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+        auto entries = std::move(parts[0]);
+        for (auto part = 1U; part < numThreads; ++part) {
+            std::move(parts[part].begin(), parts[part].end(), std::back_inserter(entries));
+        }
+        return entries;
+    }
+
     void
     Index::deleteIndex(BaseTxn &txn, IndexId indexId, PositionId positionId, const Bytes &bytesValue, PropertyType type,
                        bool isUnique) {
@@ -149,9 +356,7 @@ namespace nogdb {
                 case PropertyType::UNSIGNED_SMALLINT:
                 case PropertyType::UNSIGNED_INTEGER:
                 case PropertyType::UNSIGNED_BIGINT: {
-                    auto dataIndexDBHandler = Datastore::openDbi(dsTxnHandler,
-                                                                 TB_INDEXING_PREFIX + std::to_string(indexId),
-                                                                 true, isUnique);
+                    auto dataIndexDBHandler = txn.openIndexDbi(indexId, true, isUnique);
                     auto cursorHandler = Datastore::openCursor(dsTxnHandler, dataIndexDBHandler);
                     if (type == PropertyType::UNSIGNED_TINYINT) {
                         deleteIndexCursor(cursorHandler, positionId, bytesValue.toTinyIntU());
@@ -169,12 +374,17 @@ namespace nogdb {
                 case PropertyType::INTEGER:
                 case PropertyType::BIGINT:
                 case PropertyType::REAL: {
+                    if (isOrderedIndex(txn, type)) {
+                        auto dataIndexDBHandler = txn.openIndexDbi(indexId, false, isUnique);
+                        auto cursorHandler = Datastore::CursorHandlerWrapper(dsTxnHandler, dataIndexDBHandler);
+                        deleteIndexCursor(cursorHandler.get(), positionId,
+                                          toOrderedKey(toOrderedValue(bytesValue, type)));
+                        break;
+                    }
                     auto dataIndexDBHandlerPositive =
-                            Datastore::openDbi(dsTxnHandler, TB_INDEXING_PREFIX + std::to_string(indexId) + "_positive",
-                                               true, isUnique);
+                            txn.openSignedIndexDbi(indexId, true, isUnique);
                     auto dataIndexDBHandlerNegative =
-                            Datastore::openDbi(dsTxnHandler, TB_INDEXING_PREFIX + std::to_string(indexId) + "_negative",
-                                               true, isUnique);
+                            txn.openSignedIndexDbi(indexId, false, isUnique);
                     auto cursorHandlerPositive = Datastore::openCursor(dsTxnHandler, dataIndexDBHandlerPositive);
                     auto cursorHandlerNegative = Datastore::openCursor(dsTxnHandler, dataIndexDBHandlerNegative);
                     if (type == PropertyType::TINYINT) {
@@ -201,9 +411,7 @@ namespace nogdb {
                     break;
                 }
                 case PropertyType::TEXT: {
-                    auto dataIndexDBHandler = Datastore::openDbi(dsTxnHandler,
-                                                                 TB_INDEXING_PREFIX + std::to_string(indexId),
-                                                                 false, isUnique);
+                    auto dataIndexDBHandler = txn.openIndexDbi(indexId, false, isUnique);
                     auto cursorHandler = Datastore::openCursor(dsTxnHandler, dataIndexDBHandler);
                     auto value = bytesValue.toText();
                     if (!value.empty()) {
@@ -217,6 +425,254 @@ namespace nogdb {
         }
     }
 
+    void Index::appendCompositeKey(std::string &key, const Bytes &value, PropertyType type) {
+        // NOTE: null sorts before any value so that values of the next property can be ranged over
+        if (value.empty()) {
+            key.push_back('\x00');
+            return;
+        }
+        key.push_back('\x01');
+        auto appendOrderedValue = [&key](uint64_t orderedValue) {
+            for (auto i = 0U; i < sizeof(uint64_t); ++i) {
+                key.push_back(static_cast<char>(orderedValue >> (8 * (sizeof(uint64_t) - 1 - i))));
+            }
+        };
+        switch (type) {
+            case PropertyType::UNSIGNED_TINYINT:
+                appendOrderedValue(value.toTinyIntU());
+                break;
+            case PropertyType::UNSIGNED_SMALLINT:
+                appendOrderedValue(value.toSmallIntU());
+                break;
+            case PropertyType::UNSIGNED_INTEGER:
+                appendOrderedValue(value.toIntU());
+                break;
+            case PropertyType::UNSIGNED_BIGINT:
+                appendOrderedValue(value.toBigIntU());
+                break;
+            case PropertyType::TINYINT:
+            case PropertyType::SMALLINT:
+            case PropertyType::INTEGER:
+            case PropertyType::BIGINT:
+            case PropertyType::REAL:
+                appendOrderedValue(toOrderedValue(value, type));
+                break;
+            case PropertyType::TEXT: {
+                // escape zero bytes and terminate the text so that no encoded text is a prefix of another
+                for (const auto &c: value.toText()) {
+                    key.push_back(c);
+                    if (c == '\x00') {
+                        key.push_back('\xff');
+                    }
+                }
+                key.push_back('\x00');
+                key.push_back('\x01');
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    std::string Index::toCompositeKey(const Schema::CompositeIndexDescriptor &compositeIndex,
+                                      const ClassPropertyInfo &classInfo, const Record &record, bool *isAnyNull) {
+        auto key = std::string{};
+        auto numOfNull = size_t{0};
+        for (const auto &propertyId: compositeIndex.propertyIds) {
+            auto propertyName = classInfo.idToName.find(propertyId);
+            assert(propertyName != classInfo.idToName.cend());
+            auto propertyDescriptor = classInfo.nameToDesc.find(propertyName->second);
+            assert(propertyDescriptor != classInfo.nameToDesc.cend());
+            auto value = record.get(propertyName->second);
+            numOfNull += (value.empty()) ? 1 : 0;
+            appendCompositeKey(key, value, propertyDescriptor->second.type);
+        }
+        if (isAnyNull != nullptr) {
+            *isAnyNull = (numOfNull > 0);
+        }
+        return (numOfNull == compositeIndex.propertyIds.size()) ? std::string{} : key;
+    }
+
+    void Index::addCompositeIndex(BaseTxn &txn, IndexId indexId, const Schema::CompositeIndexDescriptor &compositeIndex,
+                                  const ClassPropertyInfo &classInfo, PositionId positionId, const Record &record) {
+        auto isAnyNull = false;
+        auto key = toCompositeKey(compositeIndex, classInfo, record, &isAnyNull);
+        if (key.empty()) {
+            return;
+        }
+        auto keyBlob = Blob(reinterpret_cast<const Blob::Byte *>(key.data()), key.size());
+        auto indexRecord = Blob(sizeof(PositionId));
+        indexRecord.append(&positionId, sizeof(PositionId));
+        try {
+            auto dataIndexDBHandler = txn.openIndexDbi(indexId, false, false);
+            if (compositeIndex.isUnique && !isAnyNull) {
+                auto cursorHandler = Datastore::CursorHandlerWrapper(txn.getDsTxnHandler(), dataIndexDBHandler);
+                auto keyValue = Datastore::getSetRangeCursor(cursorHandler.get(), keyBlob);
+                if (!keyValue.empty() && keyValue.key().mv_size == key.size() &&
+                    memcmp(keyValue.key().mv_data, key.data(), key.size()) == 0) {
+                    throw Error(CTX_UNIQUE_CONSTRAINT, Error::Type::CONTEXT);
+                }
+            }
+            Datastore::putRecord(txn.getDsTxnHandler(), dataIndexDBHandler, keyBlob, indexRecord);
+        } catch (Datastore::ErrorType &err) {
+            throw Error(err, Error::Type::DATASTORE);
+        }
+    }
+
+    void Index::addCompositeIndex(BaseTxn &txn, const Schema::CompositeIndexInfo &compositeIndexInfo,
+                                  const ClassPropertyInfo &classInfo, PositionId positionId, const Record &record) {
+        for (const auto &compositeIndex: compositeIndexInfo) {
+            addCompositeIndex(txn, compositeIndex.first, compositeIndex.second, classInfo, positionId, record);
+        }
+    }
+
+    void Index::deleteCompositeIndex(BaseTxn &txn, const Schema::CompositeIndexInfo &compositeIndexInfo,
+                                     const ClassPropertyInfo &classInfo, PositionId positionId, const Record &record) {
+        auto indexRecord = Blob(sizeof(PositionId));
+        indexRecord.append(&positionId, sizeof(PositionId));
+        try {
+            for (const auto &compositeIndex: compositeIndexInfo) {
+                auto key = toCompositeKey(compositeIndex.second, classInfo, record);
+                if (!key.empty()) {
+                    auto dataIndexDBHandler = txn.openIndexDbi(compositeIndex.first, false, false);
+                    Datastore::deleteRecord(txn.getDsTxnHandler(), dataIndexDBHandler,
+                                            Blob(reinterpret_cast<const Blob::Byte *>(key.data()), key.size()),
+                                            indexRecord);
+                }
+            }
+        } catch (Datastore::ErrorType &err) {
+            throw Error(err, Error::Type::DATASTORE);
+        }
+    }
+
+    void Index::emptyCompositeIndex(BaseTxn &txn, const Schema::CompositeIndexInfo &compositeIndexInfo) {
+        try {
+            for (const auto &compositeIndex: compositeIndexInfo) {
+                auto dataIndexDBHandler = txn.openIndexDbi(compositeIndex.first, false, false);
+                Datastore::emptyDbi(txn.getDsTxnHandler(), dataIndexDBHandler);
+            }
+        } catch (Datastore::ErrorType &err) {
+            throw Error(err, Error::Type::DATASTORE);
+        }
+    }
+
+    std::pair<Index::CompositeIndexQuery, bool>
+    Index::hasCompositeIndex(const ClassInfo &classInfo, const MultiCondition &conditions) {
+        if (classInfo.compositeIndexInfo.empty()) {
+            return std::make_pair(CompositeIndexQuery{}, false);
+        }
+        // a composite index can only serve a conjunction of conditions
+        std::function<bool(const MultiCondition::CompositeNode *)>
+                isConjunction = [&](const MultiCondition::CompositeNode *compositeNode) -> bool {
+            if (compositeNode->getOperator() != MultiCondition::Operator::AND || compositeNode->getIsNegative()) {
+                return false;
+            }
+            for (const auto &exprNode: {compositeNode->getLeftNode(), compositeNode->getRightNode()}) {
+                if (!exprNode->checkIfCondition() &&
+                    !isConjunction((const MultiCondition::CompositeNode *) exprNode.get())) {
+                    return false;
+                }
+            }
+            return true;
+        };
+        if (!isConjunction(conditions.root.get())) {
+            return std::make_pair(CompositeIndexQuery{}, false);
+        }
+        auto propertyConditions = std::map<std::string, const Condition *>{};
+        for (const auto &conditionNode: conditions.conditions) {
+            auto conditionNodePtr = conditionNode.lock();
+            if (!conditionNodePtr) {
+                return std::make_pair(CompositeIndexQuery{}, false);
+            }
+            auto &condition = conditionNodePtr->getCondition();
+            if (std::find(validComparators.cbegin(), validComparators.cend(), condition.comp) ==
+                validComparators.cend() || condition.isNegative || condition.isIgnoreCase ||
+                !propertyConditions.emplace(condition.propName, &condition).second) {
+                return std::make_pair(CompositeIndexQuery{}, false);
+            }
+        }
+        for (const auto &compositeIndex: classInfo.compositeIndexInfo) {
+            auto query = CompositeIndexQuery{};
+            query.indexId = compositeIndex.first;
+            auto numOfCoveredConditions = size_t{0};
+            for (const auto &propertyId: compositeIndex.second.propertyIds) {
+                auto propertyName = classInfo.propertyInfo.idToName.find(propertyId);
+                if (propertyName == classInfo.propertyInfo.idToName.cend()) break;
+                auto foundCondition = propertyConditions.find(propertyName->second);
+                if (foundCondition == propertyConditions.cend()) break;
+                auto &condition = *foundCondition->second;
+                auto type = classInfo.propertyInfo.nameToDesc.find(propertyName->second)->second.type;
+                ++numOfCoveredConditions;
+                if (condition.comp == Condition::Comparator::EQUAL) {
+                    appendCompositeKey(query.prefix, condition.valueBytes, type);
+                    continue;
+                }
+                query.hasRange = true;
+                switch (condition.comp) {
+                    case Condition::Comparator::GREATER:
+                    case Condition::Comparator::GREATER_EQUAL:
+                        appendCompositeKey(query.lower, condition.valueBytes, type);
+                        query.includeLower = (condition.comp == Condition::Comparator::GREATER_EQUAL);
+                        break;
+                    case Condition::Comparator::LESS:
+                    case Condition::Comparator::LESS_EQUAL:
+                        appendCompositeKey(query.upper, condition.valueBytes, type);
+                        query.includeUpper = (condition.comp == Condition::Comparator::LESS_EQUAL);
+                        break;
+                    default:
+                        appendCompositeKey(query.lower, condition.valueSet[0], type);
+                        appendCompositeKey(query.upper, condition.valueSet[1], type);
+                        query.includeLower = (condition.comp == Condition::Comparator::BETWEEN ||
+                                              condition.comp == Condition::Comparator::BETWEEN_NO_UPPER);
+                        query.includeUpper = (condition.comp == Condition::Comparator::BETWEEN ||
+                                              condition.comp == Condition::Comparator::BETWEEN_NO_LOWER);
+                        break;
+                }
+                break;
+            }
+            if (numOfCoveredConditions == propertyConditions.size()) {
+                return std::make_pair(query, true);
+            }
+        }
+        return std::make_pair(CompositeIndexQuery{}, false);
+    }
+
+    std::vector<RecordDescriptor>
+    Index::getCompositeIndexRecord(const Txn &txn, ClassId classId, const CompositeIndexQuery &query) {
+        // compare the encoded property at the beginning of a key suffix with an encoded bound
+        // (encoded properties are never a prefix of one another)
+        auto compareBound = [](const Blob::Byte *suffix, size_t suffixSize, const std::string &bound) {
+            auto result = memcmp(suffix, bound.data(), std::min(suffixSize, bound.size()));
+            return (result != 0) ? result : ((suffixSize >= bound.size()) ? 0 : -1);
+        };
+        auto result = std::vector<RecordDescriptor>{};
+        auto dataIndexDBHandler = txn.txnBase->openIndexDbi(query.indexId, false, false);
+        auto cursorHandler = Datastore::CursorHandlerWrapper(txn.txnBase->getDsTxnHandler(), dataIndexDBHandler);
+        // NOTE: start after null values of the ranged property if there is no lower bound
+        auto start = query.prefix + ((!query.lower.empty()) ? query.lower : std::string(query.hasRange ? 1 : 0, '\x01'));
+        for (auto keyValue = Datastore::getSetRangeCursor(
+                cursorHandler.get(), Blob(reinterpret_cast<const Blob::Byte *>(start.data()), start.size()));
+             !keyValue.empty();
+             keyValue = Datastore::getNextCursor(cursorHandler.get())) {
+            auto key = static_cast<const Blob::Byte *>(keyValue.key().mv_data);
+            auto keySize = keyValue.key().mv_size;
+            if (keySize < query.prefix.size() || memcmp(key, query.prefix.data(), query.prefix.size()) != 0) break;
+            if (query.hasRange) {
+                auto suffix = key + query.prefix.size();
+                auto suffixSize = keySize - query.prefix.size();
+                if (!query.lower.empty() && !query.includeLower &&
+                    compareBound(suffix, suffixSize, query.lower) == 0) continue;
+                if (!query.upper.empty()) {
+                    auto compareUpper = compareBound(suffix, suffixSize, query.upper);
+                    if (compareUpper > 0 || (!query.includeUpper && compareUpper == 0)) break;
+                }
+            }
+            auto positionId = Datastore::getValueAsNumeric<PositionId>(keyValue);
+            result.emplace_back(RecordDescriptor{classId, *positionId});
+        }
+        return result;
+    }
+
     std::pair<Index::IndexPropertyType, bool>
     Index::hasIndex(ClassId classId, const ClassInfo &classInfo, const Condition &condition) {
         if (std::find(validComparators.cbegin(), validComparators.cend(), condition.comp) != validComparators.cend()) {
@@ -401,8 +857,7 @@ namespace nogdb {
             }
             return result;
         };
-        getRecordFromIndex(conditions.root.get(), false);
-        return std::vector<RecordDescriptor>{};
+        return getRecordFromIndex(conditions.root.get(), false);
     }
 
     std::vector<RecordDescriptor>
@@ -417,9 +872,7 @@ namespace nogdb {
             case PropertyType::UNSIGNED_SMALLINT:
             case PropertyType::UNSIGNED_INTEGER:
             case PropertyType::UNSIGNED_BIGINT: {
-                auto dataIndexDBHandler = Datastore::openDbi(dsTxnHandler,
-                                                             TB_INDEXING_PREFIX + std::to_string(indexId),
-                                                             true, isUnique);
+                auto dataIndexDBHandler = txn.txnBase->openIndexDbi(indexId, true, isUnique);
                 auto cursorHandler = Datastore::openCursor(dsTxnHandler, dataIndexDBHandler);
                 if (propertyType == PropertyType::UNSIGNED_TINYINT) {
                     return backwardSearchIndex(cursorHandler, classId, value.toTinyIntU(), true);
@@ -442,9 +895,7 @@ namespace nogdb {
             case PropertyType::REAL:
                 return getLess(txn, classId, indexId, isUnique, value.toReal(), true);
             case PropertyType::TEXT: {
-                auto dataIndexDBHandler = Datastore::openDbi(dsTxnHandler,
-                                                             TB_INDEXING_PREFIX + std::to_string(indexId),
-                                                             false, isUnique);
+                auto dataIndexDBHandler = txn.txnBase->openIndexDbi(indexId, false, isUnique);
                 auto cursorHandler = Datastore::openCursor(dsTxnHandler, dataIndexDBHandler);
                 return backwardSearchIndex(cursorHandler, classId, value.toText(), true);
             }
@@ -465,9 +916,7 @@ namespace nogdb {
             case PropertyType::UNSIGNED_SMALLINT:
             case PropertyType::UNSIGNED_INTEGER:
             case PropertyType::UNSIGNED_BIGINT: {
-                auto dataIndexDBHandler = Datastore::openDbi(dsTxnHandler,
-                                                             TB_INDEXING_PREFIX + std::to_string(indexId),
-                                                             true, isUnique);
+                auto dataIndexDBHandler = txn.txnBase->openIndexDbi(indexId, true, isUnique);
                 auto cursorHandler = Datastore::openCursor(dsTxnHandler, dataIndexDBHandler);
                 if (propertyType == PropertyType::UNSIGNED_TINYINT) {
                     return backwardSearchIndex(cursorHandler, classId, value.toTinyIntU());
@@ -490,9 +939,7 @@ namespace nogdb {
             case PropertyType::REAL:
                 return getLess(txn, classId, indexId, isUnique, value.toReal());
             case PropertyType::TEXT: {
-                auto dataIndexDBHandler = Datastore::openDbi(dsTxnHandler,
-                                                             TB_INDEXING_PREFIX + std::to_string(indexId),
-                                                             false, isUnique);
+                auto dataIndexDBHandler = txn.txnBase->openIndexDbi(indexId, false, isUnique);
                 auto cursorHandler = Datastore::openCursor(dsTxnHandler, dataIndexDBHandler);
                 return backwardSearchIndex(cursorHandler, classId, value.toText());
             }
@@ -513,9 +960,7 @@ namespace nogdb {
             case PropertyType::UNSIGNED_SMALLINT:
             case PropertyType::UNSIGNED_INTEGER:
             case PropertyType::UNSIGNED_BIGINT: {
-                auto dataIndexDBHandler = Datastore::openDbi(dsTxnHandler,
-                                                             TB_INDEXING_PREFIX + std::to_string(indexId),
-                                                             true, isUnique);
+                auto dataIndexDBHandler = txn.txnBase->openIndexDbi(indexId, true, isUnique);
                 auto cursorHandler = Datastore::openCursor(dsTxnHandler, dataIndexDBHandler);
                 if (propertyType == PropertyType::UNSIGNED_TINYINT) {
                     return exactMatchIndex(cursorHandler, classId, value.toTinyIntU());
@@ -538,9 +983,7 @@ namespace nogdb {
             case PropertyType::REAL:
                 return getEqual(txn, classId, indexId, isUnique, value.toReal());
             case PropertyType::TEXT: {
-                auto dataIndexDBHandler = Datastore::openDbi(dsTxnHandler,
-                                                             TB_INDEXING_PREFIX + std::to_string(indexId),
-                                                             false, isUnique);
+                auto dataIndexDBHandler = txn.txnBase->openIndexDbi(indexId, false, isUnique);
                 auto cursorHandler = Datastore::openCursor(dsTxnHandler, dataIndexDBHandler);
                 return exactMatchIndex(cursorHandler, classId, value.toText());
             }
@@ -562,9 +1005,7 @@ namespace nogdb {
             case PropertyType::UNSIGNED_SMALLINT:
             case PropertyType::UNSIGNED_INTEGER:
             case PropertyType::UNSIGNED_BIGINT: {
-                auto dataIndexDBHandler = Datastore::openDbi(dsTxnHandler,
-                                                             TB_INDEXING_PREFIX + std::to_string(indexId),
-                                                             true, isUnique);
+                auto dataIndexDBHandler = txn.txnBase->openIndexDbi(indexId, true, isUnique);
                 auto cursorHandler = Datastore::openCursor(dsTxnHandler, dataIndexDBHandler);
                 if (propertyType == PropertyType::UNSIGNED_TINYINT) {
                     return forwardSearchIndex(cursorHandler, classId, value.toTinyIntU(), true);
@@ -587,9 +1028,7 @@ namespace nogdb {
             case PropertyType::REAL:
                 return getGreater(txn, classId, indexId, isUnique, value.toReal(), true);
             case PropertyType::TEXT: {
-                auto dataIndexDBHandler = Datastore::openDbi(dsTxnHandler,
-                                                             TB_INDEXING_PREFIX + std::to_string(indexId),
-                                                             false, isUnique);
+                auto dataIndexDBHandler = txn.txnBase->openIndexDbi(indexId, false, isUnique);
                 auto cursorHandler = Datastore::openCursor(dsTxnHandler, dataIndexDBHandler);
                 return forwardSearchIndex(cursorHandler, classId, value.toText(), true);
             }
@@ -610,9 +1049,7 @@ namespace nogdb {
             case PropertyType::UNSIGNED_SMALLINT:
             case PropertyType::UNSIGNED_INTEGER:
             case PropertyType::UNSIGNED_BIGINT: {
-                auto dataIndexDBHandler = Datastore::openDbi(dsTxnHandler,
-                                                             TB_INDEXING_PREFIX + std::to_string(indexId),
-                                                             true, isUnique);
+                auto dataIndexDBHandler = txn.txnBase->openIndexDbi(indexId, true, isUnique);
                 auto cursorHandler = Datastore::openCursor(dsTxnHandler, dataIndexDBHandler);
                 if (propertyType == PropertyType::UNSIGNED_TINYINT) {
                     return forwardSearchIndex(cursorHandler, classId, value.toTinyIntU());
@@ -635,9 +1072,7 @@ namespace nogdb {
             case PropertyType::REAL:
                 return getGreater(txn, classId, indexId, isUnique, value.toReal());
             case PropertyType::TEXT: {
-                auto dataIndexDBHandler = Datastore::openDbi(dsTxnHandler,
-                                                             TB_INDEXING_PREFIX + std::to_string(indexId),
-                                                             false, isUnique);
+                auto dataIndexDBHandler = txn.txnBase->openIndexDbi(indexId, false, isUnique);
                 auto cursorHandler = Datastore::openCursor(dsTxnHandler, dataIndexDBHandler);
                 return forwardSearchIndex(cursorHandler, classId, value.toText());
             }
@@ -662,9 +1097,7 @@ namespace nogdb {
             case PropertyType::UNSIGNED_SMALLINT:
             case PropertyType::UNSIGNED_INTEGER:
             case PropertyType::UNSIGNED_BIGINT: {
-                auto dataIndexDBHandler = Datastore::openDbi(dsTxnHandler,
-                                                             TB_INDEXING_PREFIX + std::to_string(indexId),
-                                                             true, isUnique);
+                auto dataIndexDBHandler = txn.txnBase->openIndexDbi(indexId, true, isUnique);
                 auto cursorHandler = Datastore::openCursor(dsTxnHandler, dataIndexDBHandler);
                 if (propertyType == PropertyType::UNSIGNED_TINYINT) {
                     return betweenSearchIndex(cursorHandler, classId, lowerBound.toTinyIntU(), upperBound.toTinyIntU(),
@@ -696,9 +1129,7 @@ namespace nogdb {
                 return getBetween(txn, classId, indexId, isUnique, lowerBound.toReal(), upperBound.toReal(),
                                   isIncludeBound);
             case PropertyType::TEXT: {
-                auto dataIndexDBHandler = Datastore::openDbi(dsTxnHandler,
-                                                             TB_INDEXING_PREFIX + std::to_string(indexId),
-                                                             false, isUnique);
+                auto dataIndexDBHandler = txn.txnBase->openIndexDbi(indexId, false, isUnique);
                 auto cursorHandler = Datastore::openCursor(dsTxnHandler, dataIndexDBHandler);
                 return betweenSearchIndex(cursorHandler, classId, lowerBound.toText(), upperBound.toText(),
                                           isIncludeBound);
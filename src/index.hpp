@@ -22,9 +22,14 @@
 #ifndef __INDEX_HPP_INCLUDED_
 #define __INDEX_HPP_INCLUDED_
 
+#include <cstring>
 #include <vector>
 #include <tuple>
+#include <utility>
+#include <algorithm>
+#include <thread>
 
+#include "constant.hpp"
 #include "schema.hpp"
 #include "datastore.hpp"
 #include "base_txn.hpp"
@@ -41,9 +46,134 @@ namespace nogdb {
 
         typedef std::tuple<IndexId, bool, PropertyType> IndexPropertyType;
 
+        typedef std::vector<std::pair<Bytes, PositionId>> IndexEntries;
+
+        // a key of a signed numeric or real index in the ordered format which is stored in big-endian
+        // so that the lexicographic order of keys is the same as the order of values
+        typedef uint64_t OrderedKey;
+
+        inline static bool isOrderedIndex(const BaseTxn &txn, PropertyType type) {
+            if (txn.dbInfo.indexFormat != IndexFormat::ORDERED) {
+                return false;
+            }
+            switch (type) {
+                case PropertyType::TINYINT:
+                case PropertyType::SMALLINT:
+                case PropertyType::INTEGER:
+                case PropertyType::BIGINT:
+                case PropertyType::REAL:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        // map a signed integer into an unsigned one with the same order by flipping the sign bit
+        template<typename T>
+        inline static uint64_t toOrderedValue(T value) {
+            return static_cast<uint64_t>(static_cast<int64_t>(value)) ^ (uint64_t{1} << 63);
+        }
+
+        // map an IEEE-754 double into an unsigned integer with the same order
+        // (negative numbers have all bits flipped while positive numbers have only the sign bit flipped)
+        inline static uint64_t toOrderedValue(double value) {
+            auto bits = uint64_t{0};
+            memcpy(&bits, &value, sizeof(bits));
+            // -0.0 and 0.0 are the same key (checked on bits since the library is built with -Ofast)
+            bits = ((bits << 1) == 0) ? 0 : bits;
+            return (bits & (uint64_t{1} << 63)) ? ~bits : (bits | (uint64_t{1} << 63));
+        }
+
+        static uint64_t toOrderedValue(const Bytes &value, PropertyType type);
+
+        inline static OrderedKey toOrderedKey(uint64_t orderedValue) {
+            auto key = OrderedKey{0};
+            auto bytes = reinterpret_cast<unsigned char *>(&key);
+            for (auto i = 0U; i < sizeof(OrderedKey); ++i) {
+                bytes[i] = static_cast<unsigned char>(orderedValue >> (8 * (sizeof(OrderedKey) - 1 - i)));
+            }
+            return key;
+        }
+
+        inline static uint64_t fromOrderedKey(const OrderedKey &key) {
+            auto orderedValue = uint64_t{0};
+            auto bytes = reinterpret_cast<const unsigned char *>(&key);
+            for (auto i = 0U; i < sizeof(OrderedKey); ++i) {
+                orderedValue = (orderedValue << 8) | bytes[i];
+            }
+            return orderedValue;
+        }
+
         static void addIndex(BaseTxn &txn, IndexId indexId, PositionId positionId, const Bytes &bytesValue,
                              PropertyType type, bool isUnique);
 
+        // add index entries of many records at once in the key order (the entries will be sorted in place)
+        static void addIndex(BaseTxn &txn, IndexId indexId, IndexEntries &entries, PropertyType type, bool isUnique,
+                             unsigned int numThreads = 1);
+
+        // add index entries in the order given by sortIndexEntries, which are appended to index tables as long as
+        // they come after the last entries of the tables
+        static void addSortedIndex(BaseTxn &txn, IndexId indexId, const IndexEntries &entries, PropertyType type,
+                                   bool isUnique);
+
+        static void sortIndexEntries(IndexEntries &entries, PropertyType type, unsigned int numThreads);
+
+        // the number of threads worth using for building an index from the given number of records
+        inline static unsigned int getNumBuildThreads(size_t numRecords) {
+            auto numThreads = std::min<size_t>(std::thread::hardware_concurrency(),
+                                               numRecords / INDEX_BUILD_MIN_RECORDS_PER_THREAD);
+            return static_cast<unsigned int>(std::max<size_t>(numThreads, 1));
+        }
+
+        // add index entries of a property of all records in a class table, which are read with a sequential cursor
+        // walk while decoding and sorting entries are split among threads before the index is written in the key order
+        static void addClassIndex(BaseTxn &txn, IndexId indexId, ClassId classId, const ClassPropertyInfo &classInfo,
+                                  const std::string &propertyName, PropertyType type, bool isUnique);
+
+        // extract index entries of a property from raw records (in the same order) with up to numThreads threads
+        static IndexEntries extractIndexEntries(const std::vector<KeyValue> &rawRecords,
+                                                const ClassPropertyInfo &classInfo, const std::string &propertyName,
+                                                unsigned int numThreads);
+
+        // each thread sorts its own part of entries before sorted parts are merged pairwise
+        // NOTE: entries of the same value are in the order of the bytes of their position ids as lmdb keeps
+        // duplicated values of a key
+        template<typename T>
+        static void sortIndexEntries(IndexEntries &entries, T (Bytes::*toValue)() const, unsigned int numThreads) {
+            auto cmp = [toValue](const IndexEntries::value_type &lhs, const IndexEntries::value_type &rhs) {
+                auto lhsValue = (lhs.first.*toValue)();
+                auto rhsValue = (rhs.first.*toValue)();
+                return (lhsValue < rhsValue) ||
+                       (!(rhsValue < lhsValue) && memcmp(&lhs.second, &rhs.second, sizeof(PositionId)) < 0);
+            };
+            auto bounds = std::vector<size_t>{};
+            for (auto i = 0U; i <= numThreads; ++i) {
+                bounds.push_back(entries.size() * i / numThreads);
+            }
+            auto workers = std::vector<std::thread>{};
+            for (auto i = 1U; i < numThreads; ++i) {
+                workers.emplace_back([&entries, &bounds, &cmp, i]() {
+                    std::stable_sort(entries.begin() + bounds[i], entries.begin() + bounds[i + 1], cmp);
+                });
+            }
+            std::stable_sort(entries.begin(), entries.begin() + bounds[1], cmp);
+            for (auto &worker: workers) {
+                worker.join();
+            }
+            for (auto width = 1U; width < numThreads; width *= 2) {
+                workers.clear();
+                for (auto i = 0U; i + width < numThreads; i += 2 * width) {
+                    auto first = entries.begin() + bounds[i];
+                    auto middle = entries.begin() + bounds[i + width];
+                    auto last = entries.begin() + bounds[std::min(i + 2 * width, numThreads)];
+                    workers.emplace_back([first, middle, last, &cmp]() { std::inplace_merge(first, middle, last, cmp); });
+                }
+                for (auto &worker: workers) {
+                    worker.join();
+                }
+            }
+        }
+
         static void deleteIndex(BaseTxn &txn, IndexId indexId, PositionId positionId, const Bytes &bytesValue,
                                 PropertyType type, bool isUnique);
 
@@ -83,6 +213,49 @@ namespace nogdb {
             }
         }
 
+        // a key of a composite index is a concatenation of all of its properties where each property is
+        // a tag byte (null or not) followed by an order-preserving encoding of its value
+        static void appendCompositeKey(std::string &key, const Bytes &value, PropertyType type);
+
+        // NOTE: return an empty key if all properties of the composite index are null in the record
+        static std::string toCompositeKey(const Schema::CompositeIndexDescriptor &compositeIndex,
+                                          const ClassPropertyInfo &classInfo, const Record &record,
+                                          bool *isAnyNull = nullptr);
+
+        // NOTE: a composite index table always allows duplicated keys, and a unique constraint is checked here
+        // only for keys without any null properties
+
+        static void addCompositeIndex(BaseTxn &txn, IndexId indexId,
+                                      const Schema::CompositeIndexDescriptor &compositeIndex,
+                                      const ClassPropertyInfo &classInfo, PositionId positionId, const Record &record);
+
+        static void addCompositeIndex(BaseTxn &txn, const Schema::CompositeIndexInfo &compositeIndexInfo,
+                                      const ClassPropertyInfo &classInfo, PositionId positionId, const Record &record);
+
+        static void deleteCompositeIndex(BaseTxn &txn, const Schema::CompositeIndexInfo &compositeIndexInfo,
+                                         const ClassPropertyInfo &classInfo, PositionId positionId,
+                                         const Record &record);
+
+        static void emptyCompositeIndex(BaseTxn &txn, const Schema::CompositeIndexInfo &compositeIndexInfo);
+
+        // a search on a composite index with equalities on the leading properties of the index
+        // and at most one range on the property right after them
+        struct CompositeIndexQuery {
+            IndexId indexId{0};
+            std::string prefix{};
+            bool hasRange{false};
+            std::string lower{};
+            bool includeLower{false};
+            std::string upper{};
+            bool includeUpper{false};
+        };
+
+        static std::pair<CompositeIndexQuery, bool>
+        hasCompositeIndex(const ClassInfo &classInfo, const MultiCondition &conditions);
+
+        static std::vector<RecordDescriptor>
+        getCompositeIndexRecord(const Txn &txn, ClassId classId, const CompositeIndexQuery &query);
+
         static std::pair<IndexPropertyType, bool>
         hasIndex(ClassId classId, const ClassInfo &classInfo, const Condition &condition);
 
@@ -125,23 +298,21 @@ namespace nogdb {
         template<typename T>
         static std::vector<RecordDescriptor>
         getLess(const Txn &txn, ClassId classId, IndexId indexId, bool isUnique, T value, bool includeEqual = false) {
+            if (txn.txnBase->dbInfo.indexFormat == IndexFormat::ORDERED) {
+                auto upper = toOrderedValue(value);
+                return orderedSearchIndex(txn, classId, indexId, isUnique, nullptr, false, &upper, includeEqual);
+            }
             auto dsTxnHandler = txn.txnBase->getDsTxnHandler();
             if (value < 0) {
                 auto dataIndexDBHandlerNegative =
-                        Datastore::openDbi(dsTxnHandler,
-                                           TB_INDEXING_PREFIX + std::to_string(indexId) + "_negative",
-                                           true, isUnique);
+                        txn.txnBase->openSignedIndexDbi(indexId, false, isUnique);
                 auto cursorHandlerNegative = Datastore::openCursor(dsTxnHandler, dataIndexDBHandlerNegative);
                 return backwardSearchIndex(cursorHandlerNegative, classId, value, includeEqual);
             } else {
                 auto dataIndexDBHandlerPositive =
-                        Datastore::openDbi(dsTxnHandler,
-                                           TB_INDEXING_PREFIX + std::to_string(indexId) + "_positive",
-                                           true, isUnique);
+                        txn.txnBase->openSignedIndexDbi(indexId, true, isUnique);
                 auto dataIndexDBHandlerNegative =
-                        Datastore::openDbi(dsTxnHandler,
-                                           TB_INDEXING_PREFIX + std::to_string(indexId) + "_negative",
-                                           true, isUnique);
+                        txn.txnBase->openSignedIndexDbi(indexId, false, isUnique);
                 auto cursorHandlerPositive = Datastore::openCursor(dsTxnHandler, dataIndexDBHandlerPositive);
                 auto cursorHandlerNegative = Datastore::openCursor(dsTxnHandler, dataIndexDBHandlerNegative);
                 auto positiveResult = backwardSearchIndex(cursorHandlerPositive, classId, value, includeEqual);
@@ -154,19 +325,19 @@ namespace nogdb {
         template<typename T>
         static std::vector<RecordDescriptor>
         getEqual(const Txn &txn, ClassId classId, IndexId indexId, bool isUnique, T value) {
+            if (txn.txnBase->dbInfo.indexFormat == IndexFormat::ORDERED) {
+                auto bound = toOrderedValue(value);
+                return orderedSearchIndex(txn, classId, indexId, isUnique, &bound, true, &bound, true);
+            }
             auto dsTxnHandler = txn.txnBase->getDsTxnHandler();
             if (value < 0) {
                 auto dataIndexDBHandlerNegative =
-                        Datastore::openDbi(dsTxnHandler,
-                                           TB_INDEXING_PREFIX + std::to_string(indexId) + "_negative",
-                                           true, isUnique);
+                        txn.txnBase->openSignedIndexDbi(indexId, false, isUnique);
                 auto cursorHandlerNegative = Datastore::openCursor(dsTxnHandler, dataIndexDBHandlerNegative);
                 return exactMatchIndex(cursorHandlerNegative, classId, value);
             } else {
                 auto dataIndexDBHandlerPositive =
-                        Datastore::openDbi(dsTxnHandler,
-                                           TB_INDEXING_PREFIX + std::to_string(indexId) + "_positive",
-                                           true, isUnique);
+                        txn.txnBase->openSignedIndexDbi(indexId, true, isUnique);
                 auto cursorHandlerPositive = Datastore::openCursor(dsTxnHandler, dataIndexDBHandlerPositive);
                 return exactMatchIndex(cursorHandlerPositive, classId, value);
             }
@@ -176,16 +347,16 @@ namespace nogdb {
         static std::vector<RecordDescriptor>
         getGreater(const Txn &txn, ClassId classId, IndexId indexId, bool isUnique, T value,
                    bool includeEqual = false) {
+            if (txn.txnBase->dbInfo.indexFormat == IndexFormat::ORDERED) {
+                auto lower = toOrderedValue(value);
+                return orderedSearchIndex(txn, classId, indexId, isUnique, &lower, includeEqual, nullptr, false);
+            }
             auto dsTxnHandler = txn.txnBase->getDsTxnHandler();
             if (value < 0) {
                 auto dataIndexDBHandlerPositive =
-                        Datastore::openDbi(dsTxnHandler,
-                                           TB_INDEXING_PREFIX + std::to_string(indexId) + "_positive",
-                                           true, isUnique);
+                        txn.txnBase->openSignedIndexDbi(indexId, true, isUnique);
                 auto dataIndexDBHandlerNegative =
-                        Datastore::openDbi(dsTxnHandler,
-                                           TB_INDEXING_PREFIX + std::to_string(indexId) + "_negative",
-                                           true, isUnique);
+                        txn.txnBase->openSignedIndexDbi(indexId, false, isUnique);
                 auto cursorHandlerPositive = Datastore::openCursor(dsTxnHandler, dataIndexDBHandlerPositive);
                 auto cursorHandlerNegative = Datastore::openCursor(dsTxnHandler, dataIndexDBHandlerNegative);
                 auto positiveResult = forwardSearchIndex(cursorHandlerPositive, classId, value, includeEqual);
@@ -194,9 +365,7 @@ namespace nogdb {
                 return positiveResult;
             } else {
                 auto dataIndexDBHandlerPositive =
-                        Datastore::openDbi(dsTxnHandler,
-                                           TB_INDEXING_PREFIX + std::to_string(indexId) + "_positive",
-                                           true, isUnique);
+                        txn.txnBase->openSignedIndexDbi(indexId, true, isUnique);
                 auto cursorHandlerPositive = Datastore::openCursor(dsTxnHandler, dataIndexDBHandlerPositive);
                 return forwardSearchIndex(cursorHandlerPositive, classId, value, includeEqual);
             }
@@ -210,23 +379,23 @@ namespace nogdb {
                                                         T lowerBound,
                                                         T upperBound,
                                                         const std::pair<bool, bool> &isIncludeBound) {
+            if (txn.txnBase->dbInfo.indexFormat == IndexFormat::ORDERED) {
+                auto lower = toOrderedValue(lowerBound);
+                auto upper = toOrderedValue(upperBound);
+                return orderedSearchIndex(txn, classId, indexId, isUnique, &lower, isIncludeBound.first,
+                                          &upper, isIncludeBound.second);
+            }
             auto dsTxnHandler = txn.txnBase->getDsTxnHandler();
             if (lowerBound < 0 && upperBound < 0) {
                 auto dataIndexDBHandlerNegative =
-                        Datastore::openDbi(dsTxnHandler,
-                                           TB_INDEXING_PREFIX + std::to_string(indexId) + "_negative",
-                                           true, isUnique);
+                        txn.txnBase->openSignedIndexDbi(indexId, false, isUnique);
                 auto cursorHandlerNegative = Datastore::openCursor(dsTxnHandler, dataIndexDBHandlerNegative);
                 return betweenSearchIndex(cursorHandlerNegative, classId, lowerBound, upperBound, isIncludeBound);
             } else if (lowerBound < 0 && upperBound >= 0) {
                 auto dataIndexDBHandlerPositive =
-                        Datastore::openDbi(dsTxnHandler,
-                                           TB_INDEXING_PREFIX + std::to_string(indexId) + "_positive",
-                                           true, isUnique);
+                        txn.txnBase->openSignedIndexDbi(indexId, true, isUnique);
                 auto dataIndexDBHandlerNegative =
-                        Datastore::openDbi(dsTxnHandler,
-                                           TB_INDEXING_PREFIX + std::to_string(indexId) + "_negative",
-                                           true, isUnique);
+                        txn.txnBase->openSignedIndexDbi(indexId, false, isUnique);
                 auto cursorHandlerPositive = Datastore::openCursor(dsTxnHandler, dataIndexDBHandlerPositive);
                 auto cursorHandlerNegative = Datastore::openCursor(dsTxnHandler, dataIndexDBHandlerNegative);
                 auto positiveResult = betweenSearchIndex(cursorHandlerPositive, classId, lowerBound, upperBound,
@@ -237,14 +406,19 @@ namespace nogdb {
                 return positiveResult;
             } else {
                 auto dataIndexDBHandlerPositive =
-                        Datastore::openDbi(dsTxnHandler,
-                                           TB_INDEXING_PREFIX + std::to_string(indexId) + "_positive",
-                                           true, isUnique);
+                        txn.txnBase->openSignedIndexDbi(indexId, true, isUnique);
                 auto cursorHandlerPositive = Datastore::openCursor(dsTxnHandler, dataIndexDBHandlerPositive);
                 return betweenSearchIndex(cursorHandlerPositive, classId, lowerBound, upperBound, isIncludeBound);
             }
         };
 
+        // walk a signed numeric or real index in the ordered format from the lower bound to the upper bound
+        // with a single cursor, so record descriptors are returned in the order of values
+        // NOTE: a bound of nullptr means that the range is unbounded on that side
+        static std::vector<RecordDescriptor>
+        orderedSearchIndex(const Txn &txn, ClassId classId, IndexId indexId, bool isUnique,
+                           const uint64_t *lower, bool includeLower, const uint64_t *upper, bool includeUpper);
+
         template<typename T>
         static std::vector<RecordDescriptor>
         exactMatchIndex(Datastore::CursorHandler *cursorHandler, ClassId classId, const T &value) {
@@ -32,16 +32,17 @@ namespace nogdb {
             throw ErrorType{GRAPH_DUP_EDGE};
         }
         auto sourceVertex = lookupVertex(txn, srcRid);
-        auto targetVertex = lookupVertex(txn, dstRid);
         if (sourceVertex == nullptr) {
-            sourceVertex = std::make_shared<Graph::Vertex>(srcRid);
+            sourceVertex = makeVertex(srcRid);
             txn.addUncommittedVertex(sourceVertex);
         }
+        // a self-loop must refer to the same vertex object on both ends
+        auto targetVertex = (srcRid == dstRid) ? sourceVertex : lookupVertex(txn, dstRid);
         if (targetVertex == nullptr) {
-            targetVertex = std::make_shared<Graph::Vertex>(dstRid);
+            targetVertex = makeVertex(dstRid);
             txn.addUncommittedVertex(targetVertex);
         }
-        auto newEdge = std::make_shared<Graph::Edge>(rid, sourceVertex, targetVertex);
+        auto newEdge = makeEdge(rid, sourceVertex, targetVertex);
         txn.addUncommittedEdge(newEdge);
         // update outgoing edge of a source vertex
         sourceVertex->out.insert(rid.first, rid.second, newEdge);
@@ -49,6 +50,116 @@ namespace nogdb {
         targetVertex->in.insert(rid.first, rid.second, newEdge);
     }
 
+    void Graph::createEdges(BaseTxn &txn, const std::vector<EdgeRelation> &edgeRelations) {
+        auto vertexCache = GraphElements<Vertex>{};
+        auto resolveVertex = [&](const RecordId &rid) -> std::shared_ptr<Vertex> {
+            auto foundVertex = vertexCache.find(rid);
+            if (foundVertex != vertexCache.cend()) {
+                return foundVertex->second;
+            }
+            auto vertex = lookupVertex(txn, rid);
+            if (vertex == nullptr) {
+                vertex = makeVertex(rid);
+                txn.addUncommittedVertex(vertex);
+            }
+            vertexCache.emplace(rid, vertex);
+            return vertex;
+        };
+        for (const auto &edgeRelation: edgeRelations) {
+            auto &rid = std::get<0>(edgeRelation);
+            auto sourceVertex = resolveVertex(std::get<1>(edgeRelation));
+            auto targetVertex = resolveVertex(std::get<2>(edgeRelation));
+            auto newEdge = makeEdge(rid, sourceVertex, targetVertex);
+            txn.addUncommittedEdge(newEdge);
+            sourceVertex->out.insert(rid.first, rid.second, newEdge);
+            targetVertex->in.insert(rid.first, rid.second, newEdge);
+        }
+    }
+
+    void Graph::loadEdges(const std::vector<std::vector<EdgeRelation>> &relationParts, TxnId versionId) {
+        auto numParts = static_cast<unsigned int>(relationParts.size());
+        if (numParts == 0) {
+            return;
+        }
+        // every thread owns some shards of the vertex map, so that vertices are created and linked by one thread
+        // and each shard is later merged into the graph as a whole
+        auto shardOf = [](const RecordId &rid) {
+            return ConcurrentGraphElements<Vertex>::shardOf(rid);
+        };
+        auto ownerOf = [&shardOf, numParts](const RecordId &rid) {
+            return static_cast<unsigned int>(shardOf(rid) % numParts);
+        };
+        // bucket positions of relations in each part by the owners of their source and target vertices
+        // so that every thread below only goes through relations of its own vertices
+        typedef std::vector<std::vector<size_t>> OwnerBuckets;
+        auto sourceBuckets = std::vector<OwnerBuckets>(numParts, OwnerBuckets(numParts));
+        auto targetBuckets = std::vector<OwnerBuckets>(numParts, OwnerBuckets(numParts));
+        runParts(numParts, [&](unsigned int part) {
+            const auto &relations = relationParts[part];
+            for (auto i = size_t{0}; i < relations.size(); ++i) {
+                sourceBuckets[part][ownerOf(std::get<1>(relations[i]))].push_back(i);
+                targetBuckets[part][ownerOf(std::get<2>(relations[i]))].push_back(i);
+            }
+        });
+        // create vertices in the shards of each thread
+        auto vertexShards = std::vector<GraphElements<Vertex>>(CONCURRENT_MAP_NUM_SHARDS);
+        runParts(numParts, [&](unsigned int owner) {
+            auto addVertex = [&](const RecordId &rid) {
+                auto &vertexShard = vertexShards[shardOf(rid)];
+                if (vertexShard.find(rid) == vertexShard.cend()) {
+                    auto vertex = makeVertex(rid);
+                    vertex->updateState(versionId);
+                    vertexShard.emplace(rid, vertex);
+                }
+            };
+            for (auto part = 0U; part < numParts; ++part) {
+                const auto &relations = relationParts[part];
+                for (const auto &i: sourceBuckets[part][owner]) {
+                    addVertex(std::get<1>(relations[i]));
+                }
+                for (const auto &i: targetBuckets[part][owner]) {
+                    addVertex(std::get<2>(relations[i]));
+                }
+            }
+        });
+        // create edges of each part of relations (vertex shards are read only from now on)
+        auto edgeParts = std::vector<std::vector<std::shared_ptr<Edge>>>(numParts);
+        auto findVertex = [&](const RecordId &rid) -> const std::shared_ptr<Vertex> & {
+            return vertexShards[shardOf(rid)].find(rid)->second;
+        };
+        runParts(numParts, [&](unsigned int part) {
+            auto &edgePart = edgeParts[part];
+            edgePart.reserve(relationParts[part].size());
+            for (const auto &relation: relationParts[part]) {
+                auto edge = makeEdge(std::get<0>(relation), findVertex(std::get<1>(relation)),
+                                     findVertex(std::get<2>(relation)));
+                edge->source.upgradeStableVersion(versionId);
+                edge->target.upgradeStableVersion(versionId);
+                edge->updateState(versionId);
+                edgePart.emplace_back(edge);
+            }
+        });
+        // link edges to vertices where each thread only updates its own vertices, which are not published yet
+        runParts(numParts, [&](unsigned int owner) {
+            for (auto part = 0U; part < numParts; ++part) {
+                const auto &relations = relationParts[part];
+                for (const auto &i: sourceBuckets[part][owner]) {
+                    const auto &rid = std::get<0>(relations[i]);
+                    findVertex(std::get<1>(relations[i]))->out.insertUnpublished(rid.first, rid.second,
+                                                                                 edgeParts[part][i]);
+                }
+                for (const auto &i: targetBuckets[part][owner]) {
+                    const auto &rid = std::get<0>(relations[i]);
+                    findVertex(std::get<2>(relations[i]))->in.insertUnpublished(rid.first, rid.second,
+                                                                                edgeParts[part][i]);
+                }
+            }
+        });
+        // merge all shards into the graph with one lock of each shard
+        vertices.lockAndMerge(vertexShards, numParts);
+        edges.lockAndMerge(edgeParts, [](const std::shared_ptr<Edge> &edge) { return edge->rid; }, numParts);
+    }
+
     void Graph::deleteEdge(BaseTxn &txn, const RecordId &rid) noexcept {
         if (auto edge = lookupEdge(txn, rid)) {
             auto findSrcVertex = edge->source.getLatestVersion();
@@ -132,7 +243,7 @@ namespace nogdb {
             if (auto oldSrcVertex = findOldSrcVertex.first.lock()) {
                 auto newSrcVertex = lookupVertex(txn, srcRid);
                 if (newSrcVertex == nullptr) {
-                    newSrcVertex = std::make_shared<Graph::Vertex>(srcRid);
+                    newSrcVertex = makeVertex(srcRid);
                     txn.addUncommittedVertex(newSrcVertex);
                 }
                 // update outgoing edge of an old source vertex
@@ -158,7 +269,7 @@ namespace nogdb {
             if (auto oldDstVertex = findOldDstVertex.first.lock()) {
                 auto newDstVertex = lookupVertex(txn, dstRid);
                 if (newDstVertex == nullptr) {
-                    newDstVertex = std::make_shared<Graph::Vertex>(dstRid);
+                    newDstVertex = makeVertex(dstRid);
                     txn.addUncommittedVertex(newDstVertex);
                 }
                 // update incoming edge of an old destination vertex
@@ -175,9 +286,8 @@ namespace nogdb {
     }
 
     std::shared_ptr<Graph::Edge> Graph::lookupEdge(const BaseTxn &txn, const RecordId &rid) {
-        RWSpinLockGuard<RWSpinLock> _(edges.splock);
-        auto iterator = edges.elements.find(rid);
-        if (iterator == edges.elements.cend()) {
+        auto edge = edges.find(rid);
+        if (edge == nullptr) {
             if (txn.getType() == BaseTxn::TxnType::READ_ONLY) {
                 return nullptr;
             } else {
@@ -188,12 +298,12 @@ namespace nogdb {
                 return nullptr;
             }
         } else {
-            if ((txn.getType() == BaseTxn::TxnType::READ_ONLY && iterator->second->checkReadOnly(txn.getVersionId())) ||
-                (txn.getType() == BaseTxn::TxnType::READ_WRITE && iterator->second->checkReadWrite())) {
+            if ((txn.getType() == BaseTxn::TxnType::READ_ONLY && edge->checkReadOnly(txn.getVersionId())) ||
+                (txn.getType() == BaseTxn::TxnType::READ_WRITE && edge->checkReadWrite())) {
                 return nullptr;
             }
         }
-        return iterator->second;
+        return edge;
     }
 
     void Graph::forceDeleteEdge(const RecordId &rid) noexcept {
@@ -201,9 +311,21 @@ namespace nogdb {
     }
 
     void Graph::forceDeleteEdges(const std::vector<RecordId> &rids) noexcept {
-        RWSpinLockGuard<RWSpinLock> _(edges.splock, RWSpinLockMode::EXCLUSIVE_SPLOCK);
-        for (const auto &rid: rids) {
-            edges.elements.erase(rid);
+        edges.lockAndErase(rids);
+    }
+
+    void Graph::clearStaleVersions(TxnId versionId) {
+        for (const auto &rid: staleEdges.pop_front(versionId)) {
+            if (auto edgePtr = edges.find(rid)) {
+                edgePtr->source.clearStableVersion(versionId);
+                edgePtr->target.clearStableVersion(versionId);
+            }
+        }
+        for (const auto &rid: staleVertices.pop_front(versionId)) {
+            if (auto vertexPtr = vertices.find(rid)) {
+                vertexPtr->in.clear(versionId);
+                vertexPtr->out.clear(versionId);
+            }
         }
     }
 
@@ -29,11 +29,41 @@
 
 namespace nogdb {
 
+    namespace {
+
+        // collect visible edges of an adjacency where keys of the adjacency are record ids of edges
+        // NOTE: the adjacency is locked for reading only while record ids are appended to the result
+        template<typename Adjacency>
+        void collectEdges(const BaseTxn &txn, const Adjacency &adjacency, const ClassId &classId,
+                          std::vector<RecordId> &result) {
+            auto collect = [&result](const ClassId &edgeClassId, const PositionId &posId,
+                                     const std::weak_ptr<Graph::Edge> &edge) {
+                if (!edge.expired()) {
+                    result.emplace_back(RecordId{edgeClassId, posId});
+                }
+            };
+            if (txn.getType() == BaseTxn::TxnType::READ_ONLY) {
+                if (classId) {
+                    adjacency.forEachStable(txn.getVersionId(), classId, collect);
+                } else {
+                    adjacency.forEachStable(txn.getVersionId(), collect);
+                }
+            } else {
+                if (classId) {
+                    adjacency.forEachLatest(classId, collect);
+                } else {
+                    adjacency.forEachLatest(collect);
+                }
+            }
+        }
+
+    }
+
     bool Graph::createVertex(BaseTxn &txn, const RecordId &rid) {
         if (auto vertex = lookupVertex(txn, rid)) {
             return false;
         }
-        auto vertexPtr = std::make_shared<Vertex>(rid);
+        auto vertexPtr = makeVertex(rid);
         txn.addUncommittedVertex(vertexPtr);
         return true;
     }
@@ -113,31 +143,7 @@ namespace nogdb {
             throw ErrorType{GRAPH_NOEXST_VERTEX};
         }
         auto result = std::vector<RecordId> {};
-        if (classId) {
-            for (const auto &posId: vertex->in.keys(classId)) {
-                auto findInEdge = (txn.getType() == BaseTxn::TxnType::READ_ONLY) ?
-                                  vertex->in.find(txn.getVersionId(), classId, posId) : vertex->in.find(classId, posId);
-                if (findInEdge.second) {
-                    if (auto inEdge = findInEdge.first.lock()) {
-                        result.push_back(inEdge->rid);
-                    }
-                }
-            }
-        } else {
-            for (const auto &inEdgeRids: vertex->in.keys()) {
-                auto inEdgeClassId = inEdgeRids.first;
-                for (const auto &inEdgePosId: inEdgeRids.second) {
-                    auto findInEdge = (txn.getType() == BaseTxn::TxnType::READ_ONLY) ?
-                                      vertex->in.find(txn.getVersionId(), inEdgeClassId, inEdgePosId) :
-                                      vertex->in.find(inEdgeClassId, inEdgePosId);
-                    if (findInEdge.second) {
-                        if (auto inEdge = findInEdge.first.lock()) {
-                            result.push_back(inEdge->rid);
-                        }
-                    }
-                }
-            }
-        }
+        collectEdges(txn, vertex->in, classId, result);
         return result;
     }
 
@@ -170,32 +176,7 @@ namespace nogdb {
             throw ErrorType{GRAPH_NOEXST_VERTEX};
         }
         auto result = std::vector<RecordId> {};
-        if (classId) {
-            for (const auto &posId: vertex->out.keys(classId)) {
-                auto findOutEdge = (txn.getType() == BaseTxn::TxnType::READ_ONLY) ?
-                                   vertex->out.find(txn.getVersionId(), classId, posId) :
-                                   vertex->out.find(classId, posId);
-                if (findOutEdge.second) {
-                    if (auto outEdge = findOutEdge.first.lock()) {
-                        result.push_back(outEdge->rid);
-                    }
-                }
-            }
-        } else {
-            for (const auto &outEdgeRids: vertex->out.keys()) {
-                auto outEdgeClassId = outEdgeRids.first;
-                for (const auto &outEdgePosId: outEdgeRids.second) {
-                    auto findOutEdge = (txn.getType() == BaseTxn::TxnType::READ_ONLY) ?
-                                       vertex->out.find(txn.getVersionId(), outEdgeClassId, outEdgePosId) :
-                                       vertex->out.find(outEdgeClassId, outEdgePosId);
-                    if (findOutEdge.second) {
-                        if (auto outEdge = findOutEdge.first.lock()) {
-                            result.push_back(outEdge->rid);
-                        }
-                    }
-                }
-            }
-        }
+        collectEdges(txn, vertex->out, classId, result);
         return result;
     }
 
@@ -228,54 +209,8 @@ namespace nogdb {
             throw ErrorType{GRAPH_NOEXST_VERTEX};
         }
         auto result = std::vector<RecordId> {};
-        if (classId) {
-            for (const auto &posId: vertex->in.keys(classId)) {
-                auto findInEdge = (txn.getType() == BaseTxn::TxnType::READ_ONLY) ?
-                                  vertex->in.find(txn.getVersionId(), classId, posId) : vertex->in.find(classId, posId);
-                if (findInEdge.second) {
-                    if (auto inEdge = findInEdge.first.lock()) {
-                        result.push_back(inEdge->rid);
-                    }
-                }
-            }
-            for (const auto &posId: vertex->out.keys(classId)) {
-                auto findOutEdge = (txn.getType() == BaseTxn::TxnType::READ_ONLY) ?
-                                   vertex->out.find(txn.getVersionId(), classId, posId) :
-                                   vertex->out.find(classId, posId);
-                if (findOutEdge.second) {
-                    if (auto outEdge = findOutEdge.first.lock()) {
-                        result.push_back(outEdge->rid);
-                    }
-                }
-            }
-        } else {
-            for (const auto &inEdgeRids: vertex->in.keys()) {
-                auto inEdgeClassId = inEdgeRids.first;
-                for (const auto &inEdgePosId: inEdgeRids.second) {
-                    auto findInEdge = (txn.getType() == BaseTxn::TxnType::READ_ONLY) ?
-                                      vertex->in.find(txn.getVersionId(), inEdgeClassId, inEdgePosId) :
-                                      vertex->in.find(inEdgeClassId, inEdgePosId);
-                    if (findInEdge.second) {
-                        if (auto inEdge = findInEdge.first.lock()) {
-                            result.push_back(inEdge->rid);
-                        }
-                    }
-                }
-            }
-            for (const auto &outEdgeRids: vertex->out.keys()) {
-                auto outEdgeClassId = outEdgeRids.first;
-                for (const auto &outEdgePosId: outEdgeRids.second) {
-                    auto findOutEdge = (txn.getType() == BaseTxn::TxnType::READ_ONLY) ?
-                                       vertex->out.find(txn.getVersionId(), outEdgeClassId, outEdgePosId) :
-                                       vertex->out.find(outEdgeClassId, outEdgePosId);
-                    if (findOutEdge.second) {
-                        if (auto outEdge = findOutEdge.first.lock()) {
-                            result.push_back(outEdge->rid);
-                        }
-                    }
-                }
-            }
-        }
+        collectEdges(txn, vertex->in, classId, result);
+        collectEdges(txn, vertex->out, classId, result);
         std::sort(result.begin(), result.end(), [](const RecordId &lhs, const RecordId &rhs) {
             return (lhs.first == rhs.first) ? lhs.second < rhs.second : lhs.first < rhs.first;
         });
@@ -323,9 +258,8 @@ namespace nogdb {
     }
 
     std::shared_ptr<Graph::Vertex> Graph::lookupVertex(const BaseTxn &txn, const RecordId &rid) {
-        RWSpinLockGuard<RWSpinLock> _(vertices.splock);
-        auto iterator = vertices.elements.find(rid);
-        if (iterator == vertices.elements.cend()) {
+        auto vertex = vertices.find(rid);
+        if (vertex == nullptr) {
             if (txn.getType() == BaseTxn::TxnType::READ_ONLY) {
                 return nullptr;
             } else {
@@ -336,12 +270,12 @@ namespace nogdb {
                 return nullptr;
             }
         } else {
-            if ((txn.getType() == BaseTxn::TxnType::READ_ONLY && iterator->second->checkReadOnly(txn.getVersionId())) ||
-                (txn.getType() == BaseTxn::TxnType::READ_WRITE && iterator->second->checkReadWrite())) {
+            if ((txn.getType() == BaseTxn::TxnType::READ_ONLY && vertex->checkReadOnly(txn.getVersionId())) ||
+                (txn.getType() == BaseTxn::TxnType::READ_WRITE && vertex->checkReadWrite())) {
                 return nullptr;
             }
         }
-        return iterator->second;
+        return vertex;
     }
 
     void Graph::forceDeleteVertex(const RecordId &rid) noexcept {
@@ -349,10 +283,7 @@ namespace nogdb {
     }
 
     void Graph::forceDeleteVertices(const std::vector<RecordId> &rids) noexcept {
-        RWSpinLockGuard<RWSpinLock> _(vertices.splock, RWSpinLockMode::EXCLUSIVE_SPLOCK);
-        for (const auto &rid: rids) {
-            vertices.elements.erase(rid);
-        }
+        vertices.lockAndErase(rids);
     }
 
 }
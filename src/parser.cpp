@@ -22,8 +22,10 @@
 #include <iostream> // for debugging
 #include <bitset> // for debugging
 #include <vector>
+#include <algorithm>
 #include <cmath>
 #include <cassert>
+#include <tuple>
 
 #include "datastore.hpp"
 #include "generic.hpp"
@@ -42,6 +44,8 @@ namespace nogdb {
             auto value = Blob(SIZE_OF_EMPTY_STRING);
             value.append(static_cast<void *>(&emptyString), SIZE_OF_EMPTY_STRING);
             return value;
+        } else if (txn.dbInfo.recordFormat == RecordFormat::INDEXED) {
+            return parseIndexedRecord(properties, record);
         } else {
             // create properties as a raw data for a class
             auto value = Blob(dataSize);
@@ -66,14 +70,108 @@ namespace nogdb {
         }
     }
 
+    namespace {
+        // an index of the slot width of a numeric value, or NUM_SLOT_WIDTHS if a value is not kept in a slot
+        // NOTE: values are stored as they are set, so a numeric value of any other size is kept with an offset
+        size_t getSlotWidthIndex(PropertyType type, size_t size) {
+            switch (type) {
+                case PropertyType::TINYINT:
+                case PropertyType::UNSIGNED_TINYINT:
+                case PropertyType::SMALLINT:
+                case PropertyType::UNSIGNED_SMALLINT:
+                case PropertyType::INTEGER:
+                case PropertyType::UNSIGNED_INTEGER:
+                case PropertyType::BIGINT:
+                case PropertyType::UNSIGNED_BIGINT:
+                case PropertyType::REAL:
+                    for (auto i = size_t{0}; i < NUM_SLOT_WIDTHS; ++i) {
+                        if (size == SLOT_WIDTHS[i]) {
+                            return i;
+                        }
+                    }
+                    return NUM_SLOT_WIDTHS;
+                default:
+                    return NUM_SLOT_WIDTHS;
+            }
+        }
+    }
+
+    Blob Parser::parseIndexedRecord(const ClassProperty &properties, const Record &record) {
+        // group numeric values by slot widths and sort property ids in each group so that a value of any property
+        // can be found by binary search
+        using RawData = std::tuple<size_t, PropertyId, const Bytes *>;
+        auto rawDataList = std::vector<RawData>{};
+        rawDataList.reserve(properties.size());
+        size_t numSlots[NUM_SLOT_WIDTHS] = {};
+        auto numAllSlots = size_t{0};
+        auto valueSize = size_t{0};
+        auto &values = record.getAll();
+        for (const auto &property: properties) {
+            auto foundValue = values.find(property.first);
+            if (foundValue == values.cend()) {
+                continue;
+            }
+            assert(property.second.id < std::pow(2, UINT16_BITS_COUNT));
+            auto widthIndex = getSlotWidthIndex(property.second.type, foundValue->second.size());
+            if (widthIndex < NUM_SLOT_WIDTHS) {
+                ++numSlots[widthIndex];
+                ++numAllSlots;
+            }
+            rawDataList.emplace_back(widthIndex, static_cast<PropertyId>(property.second.id), &foundValue->second);
+            valueSize += foundValue->second.size();
+        }
+        std::sort(rawDataList.begin(), rawDataList.end(),
+                  [](const RawData &lhs, const RawData &rhs) {
+                      return std::tie(std::get<0>(lhs), std::get<1>(lhs)) < std::tie(std::get<0>(rhs), std::get<1>(rhs));
+                  });
+        auto count = static_cast<uint16_t>(rawDataList.size());
+        auto dataSize = getIndexedRawDataSize(count, numAllSlots, valueSize);
+        assert(dataSize < std::pow(2, UINT32_BITS_COUNT));
+        auto value = Blob(dataSize);
+        auto marker = INDEXED_RAW_DATA_MARKER;
+        value.append(&marker, sizeof(PropertyId));
+        value.append(&count, sizeof(uint16_t));
+        for (const auto &numSlotsOfWidth: numSlots) {
+            auto numSlotsValue = static_cast<uint16_t>(numSlotsOfWidth);
+            value.append(&numSlotsValue, sizeof(uint16_t));
+        }
+        for (const auto &rawData: rawDataList) {
+            value.append(&std::get<1>(rawData), sizeof(PropertyId));
+        }
+        // offsets of the other values start after all slots
+        auto offset = static_cast<uint32_t>(getIndexedRawDataSize(count, numAllSlots, 0));
+        for (const auto &rawData: rawDataList) {
+            offset += static_cast<uint32_t>((std::get<0>(rawData) < NUM_SLOT_WIDTHS) ? std::get<2>(rawData)->size() : 0);
+        }
+        for (const auto &rawData: rawDataList) {
+            if (std::get<0>(rawData) == NUM_SLOT_WIDTHS) {
+                value.append(&offset, sizeof(uint32_t));
+                offset += static_cast<uint32_t>(std::get<2>(rawData)->size());
+            }
+        }
+        value.append(&offset, sizeof(uint32_t));
+        for (const auto &rawData: rawDataList) {
+            value.append(static_cast<void *>(std::get<2>(rawData)->getRaw()), std::get<2>(rawData)->size());
+        }
+        return value;
+    }
+
     Blob Parser::parseRecord(const BaseTxn &txn,
                              const Schema::ClassDescriptorPtr &classDescriptor,
                              const Record &record,
-                             ClassPropertyInfo& classInfo,
+                             std::shared_ptr<const ClassPropertyInfo> &classInfo,
                              std::map<std::string, std::tuple<PropertyType, IndexId, bool>>& indexInfos) {
+        classInfo = Generic::getClassMapProperty(txn, classDescriptor);
+        return parseRecord(txn, classDescriptor->id, record, *classInfo, indexInfos);
+    }
+
+    Blob Parser::parseRecord(const BaseTxn &txn,
+                             ClassId classId,
+                             const Record &record,
+                             const ClassPropertyInfo &classInfo,
+                             std::map<std::string, std::tuple<PropertyType, IndexId, bool>> &indexInfos) {
         auto dataSize = size_t{0};
         auto properties = decltype(classInfo.nameToDesc) {};
-        classInfo = Generic::getClassMapProperty(txn, classDescriptor);
         // calculate a raw data size of properties in a record
         for (const auto &property: record.getAll()) {
             auto foundProperty = classInfo.nameToDesc.find(property.first);
@@ -82,7 +180,7 @@ namespace nogdb {
             }
             // check if having any index
             for (const auto &indexIter: foundProperty->second.indexInfo) {
-                if (indexIter.second.first == classDescriptor->id) {
+                if (indexIter.second.first == classId) {
                     indexInfos.emplace(
                             property.first,
                             std::make_tuple(
@@ -105,51 +203,51 @@ namespace nogdb {
         if (keyValue.empty()) {
             return result;
         }
-        auto rawData = Datastore::getValueAsBlob(keyValue);
-        auto offset = size_t{0};
-        if (rawData.capacity() == 0) {
+        auto &rawData = keyValue.value();
+        if (rawData.mv_size == 0) {
             throw Error(CTX_UNKNOWN_ERR, Error::Type::CONTEXT);
-        } else if (rawData.capacity() >= 2 * sizeof(uint16_t)) {
-            //TODO: should be concerned about ENDIAN?
-            // NOTE: each property block consists of property id, flag, size, and value
-            // when option flag = 0
-            // +----------------------+--------------------+-----------------------+-----------+
-            // | propertyId (16bits)  | option flag (1bit) | propertySize (7bits)  |   value   | (next block) ...
-            // +----------------------+--------------------+-----------------------+-----------+
-            // when option flag = 1 (for extra large size of value)
-            // +----------------------+--------------------+------------------------+-----------+
-            // | propertyId (16bits)  | option flag (1bit) | propertySize (31bits)  |   value   | (next block) ...
-            // +----------------------+--------------------+------------------------+-----------+
-            while (offset < rawData.size()) {
-                auto propertyId = PropertyId{};
-                auto optionFlag = uint8_t{};
-                offset = rawData.retrieve(&propertyId, offset, sizeof(PropertyId));
-                rawData.retrieve(&optionFlag, offset, sizeof(optionFlag));
-                auto propertySize = size_t{};
-                if ((optionFlag & 0x1) == 1) {
-                    //extra large size of value (exceed 127 bytes)
-                    auto tmpSize =  uint32_t{};
-                    offset = rawData.retrieve(&tmpSize, offset, sizeof(uint32_t));
-                    propertySize = static_cast<size_t>(tmpSize >> 1);
-                } else {
-                    //normal size of value (not exceed 127 bytes)
-                    auto tmpSize = uint8_t{};
-                    offset = rawData.retrieve(&tmpSize, offset, sizeof(uint8_t));
-                    propertySize = static_cast<size_t>(tmpSize >> 1);
-                }
-                auto foundInfo = classPropertyInfo.idToName.find(propertyId);
-                if (foundInfo != classPropertyInfo.idToName.cend()) {
-                    if (propertySize > 0) {
-                        Blob::Byte byteData[propertySize];
-                        offset = rawData.retrieve(byteData, offset, propertySize);
-                        result.set(foundInfo->second, Bytes{byteData, propertySize});
-                    } else {
-                        result.set(foundInfo->second, Bytes{});
-                    }
-                } else {
-                    offset += propertySize;
+        }
+        auto data = static_cast<const unsigned char *>(rawData.mv_data);
+        // look up each requested property directly if there are fewer of them than stored properties
+        if (isIndexedRawData(data, rawData.mv_size) &&
+            classPropertyInfo.idToName.size() < getIndexedRawDataCount(data, rawData.mv_size)) {
+            for (const auto &property: classPropertyInfo.idToName) {
+                auto value = static_cast<const unsigned char *>(nullptr);
+                auto size = size_t{0};
+                if (findRawProperty(data, rawData.mv_size, property.first, value, size)) {
+                    result.set(property.second, (size > 0) ? Bytes{value, size} : Bytes{});
                 }
             }
+            return result;
+        }
+        // NOTE: blocks of properties which are not in classPropertyInfo are skipped without being copied
+        // and the iteration stops as soon as all properties in classPropertyInfo have been found
+        auto remaining = classPropertyInfo.idToName.size();
+        forEachRawProperty(data, rawData.mv_size,
+                           [&](PropertyId propertyId, const unsigned char *value, size_t size) {
+                               auto foundInfo = classPropertyInfo.idToName.find(propertyId);
+                               if (foundInfo != classPropertyInfo.idToName.cend()) {
+                                   result.set(foundInfo->second, (size > 0) ? Bytes{value, size} : Bytes{});
+                                   return --remaining > 0;
+                               }
+                               return true;
+                           });
+        return result;
+    }
+
+    RecordView Parser::parseRawDataView(const KeyValue &keyValue,
+                                        const std::shared_ptr<const ClassPropertyInfo> &classPropertyInfo) {
+        auto result = RecordView{};
+        if (keyValue.empty()) {
+            return result;
+        }
+        auto &rawData = keyValue.value();
+        if (rawData.mv_size == 0) {
+            throw Error(CTX_UNKNOWN_ERR, Error::Type::CONTEXT);
+        } else if (rawData.mv_size >= 2 * sizeof(uint16_t)) {
+            result.value_ = static_cast<const unsigned char *>(rawData.mv_data);
+            result.size_ = rawData.mv_size;
+            result.classPropertyInfo_ = classPropertyInfo;
         }
         return result;
     }
@@ -23,8 +23,11 @@
 #define __PARSER_HPP_INCLUDED_
 
 #include <map>
+#include <memory>
+#include <cstring>
 
 #include "blob.hpp"
+#include "constant.hpp"
 #include "keyval.hpp"
 #include "schema.hpp"
 
@@ -35,6 +38,11 @@ namespace nogdb {
     constexpr size_t UINT8_BITS_COUNT = 8 * sizeof(uint8_t);
     constexpr size_t UINT16_BITS_COUNT = 8 * sizeof(uint16_t);
     constexpr size_t UINT32_BITS_COUNT = 8 * sizeof(uint32_t);
+    constexpr PropertyId INDEXED_RAW_DATA_MARKER = CLASS_NAME_PROPERTY_ID;
+    constexpr size_t NUM_SLOT_WIDTHS = 4;
+    constexpr size_t INDEXED_RAW_DATA_HEADER_SIZE = sizeof(PropertyId) + sizeof(uint16_t) + NUM_SLOT_WIDTHS * sizeof(uint16_t);
+    // widths of fixed-width slots for numeric values in the order they are laid out in indexed raw data
+    constexpr size_t SLOT_WIDTHS[NUM_SLOT_WIDTHS] = {8, 4, 2, 1};
 
     struct Parser {
         Parser() = delete;
@@ -46,14 +54,247 @@ namespace nogdb {
         static Blob parseRecord(const BaseTxn &txn,
                                 const Schema::ClassDescriptorPtr &classDescriptor,
                                 const Record &record,
-                                ClassPropertyInfo& classInfo,
+                                std::shared_ptr<const ClassPropertyInfo> &classInfo,
                                 std::map<std::string, std::tuple<PropertyType, IndexId, bool>>& indexInfos);
 
+        // the same as above but with class properties which have been resolved in advance (e.g. for a batch of records)
+        static Blob parseRecord(const BaseTxn &txn,
+                                ClassId classId,
+                                const Record &record,
+                                const ClassPropertyInfo &classInfo,
+                                std::map<std::string, std::tuple<PropertyType, IndexId, bool>> &indexInfos);
+
         static Record parseRawData(const KeyValue &keyValue, const ClassPropertyInfo &classPropertyInfo);
 
+        static RecordView parseRawDataView(const KeyValue &keyValue,
+                                           const std::shared_ptr<const ClassPropertyInfo> &classPropertyInfo);
+
+        static Blob parseIndexedRecord(const ClassProperty &properties, const Record &record);
+
+        // a layout of raw data in the indexed record format
+        // NOTE: each indexed raw data consists of a marker, a number of properties, numbers of fixed-width slots
+        // of 8, 4, 2, and 1 bytes, property ids, offsets of the other values (from the beginning of raw data)
+        // followed by an end offset, slots, and the other values
+        // +-----------------+----------------+----------------------+------------------------+--------------------------
+        // | marker (16bits) | count (16bits) | numSlots (16bits*4)  | propertyIds (16bits*n) | offsets (32bits*(m+1)) ...
+        // +-----------------+----------------+----------------------+------------------------+--------------------------
+        //   --------------------------------------------------------+----------------+
+        //   ... slots (8bytes*n8, 4bytes*n4, 2bytes*n2, 1byte*n1)   |  other values  |
+        //   --------------------------------------------------------+----------------+
+        // where m is a number of the other values (n - n8 - n4 - n2 - n1), numeric values of 8, 4, 2, or 1 bytes are
+        // kept in slots without offsets, and property ids are sorted within each group of slots of the same width and
+        // within the group of the other values
+        // the marker takes the place of the first property id in the sequential format and is always distinguishable
+        // because CLASS_NAME_PROPERTY_ID is never stored as a property block
+        struct IndexedLayout {
+            size_t count;
+            size_t numSlots[NUM_SLOT_WIDTHS];
+            size_t numOffsets;
+            size_t offsetsBegin;
+            size_t slotsBegin;
+        };
+
+        // check if raw data is in the indexed record format
+        inline static bool isIndexedRawData(const unsigned char *data, size_t size) {
+            if (data == nullptr || size < sizeof(PropertyId)) {
+                return false;
+            }
+            auto marker = PropertyId{};
+            memcpy(&marker, data, sizeof(PropertyId));
+            return marker == INDEXED_RAW_DATA_MARKER;
+        }
+
+        // read a layout of indexed raw data, return false if its header, offsets, or slots are truncated
+        static bool getIndexedLayout(const unsigned char *data, size_t size, IndexedLayout &layout) {
+            if (!isIndexedRawData(data, size) || size < INDEXED_RAW_DATA_HEADER_SIZE) {
+                return false;
+            }
+            auto count = uint16_t{};
+            memcpy(&count, data + sizeof(PropertyId), sizeof(uint16_t));
+            layout.count = count;
+            auto numAllSlots = size_t{0};
+            auto slotsSize = size_t{0};
+            for (auto i = size_t{0}; i < NUM_SLOT_WIDTHS; ++i) {
+                auto numSlots = uint16_t{};
+                memcpy(&numSlots, data + sizeof(PropertyId) + (i + 1) * sizeof(uint16_t), sizeof(uint16_t));
+                layout.numSlots[i] = numSlots;
+                numAllSlots += numSlots;
+                slotsSize += numSlots * SLOT_WIDTHS[i];
+            }
+            if (numAllSlots > layout.count) {
+                return false;
+            }
+            layout.numOffsets = layout.count - numAllSlots + 1;
+            layout.offsetsBegin = INDEXED_RAW_DATA_HEADER_SIZE + layout.count * sizeof(PropertyId);
+            layout.slotsBegin = layout.offsetsBegin + layout.numOffsets * sizeof(uint32_t);
+            return layout.slotsBegin + slotsSize <= size &&
+                   getIndexedRawDataOffset(data, layout, layout.numOffsets - 1) <= size;
+        }
+
+        // iterate over property blocks of raw data without copying them
+        // NOTE: a callback returns false to stop the iteration
+        template<typename F>
+        static void forEachRawProperty(const unsigned char *data, size_t size, F &&callback) {
+            if (data == nullptr || size < 2 * sizeof(uint16_t)) {
+                return;
+            }
+            if (isIndexedRawData(data, size)) {
+                auto layout = IndexedLayout{};
+                if (!getIndexedLayout(data, size, layout)) {
+                    return;
+                }
+                auto index = size_t{0};
+                auto slot = layout.slotsBegin;
+                for (auto i = size_t{0}; i < NUM_SLOT_WIDTHS; ++i) {
+                    for (auto j = size_t{0}; j < layout.numSlots[i]; ++j, ++index, slot += SLOT_WIDTHS[i]) {
+                        if (!callback(getIndexedRawDataPropertyId(data, index), data + slot, SLOT_WIDTHS[i])) {
+                            return;
+                        }
+                    }
+                }
+                for (auto j = size_t{0}; index < layout.count; ++j, ++index) {
+                    auto begin = getIndexedRawDataOffset(data, layout, j);
+                    auto end = getIndexedRawDataOffset(data, layout, j + 1);
+                    if (end < begin || end > size) {
+                        return;
+                    }
+                    if (!callback(getIndexedRawDataPropertyId(data, index), data + begin, end - begin)) {
+                        return;
+                    }
+                }
+                return;
+            }
+            //TODO: should be concerned about ENDIAN?
+            // NOTE: each property block consists of property id, flag, size, and value
+            // when option flag = 0
+            // +----------------------+--------------------+-----------------------+-----------+
+            // | propertyId (16bits)  | option flag (1bit) | propertySize (7bits)  |   value   | (next block) ...
+            // +----------------------+--------------------+-----------------------+-----------+
+            // when option flag = 1 (for extra large size of value)
+            // +----------------------+--------------------+------------------------+-----------+
+            // | propertyId (16bits)  | option flag (1bit) | propertySize (31bits)  |   value   | (next block) ...
+            // +----------------------+--------------------+------------------------+-----------+
+            auto offset = size_t{0};
+            while (offset + sizeof(PropertyId) + sizeof(uint8_t) <= size) {
+                auto propertyId = PropertyId{};
+                memcpy(&propertyId, data + offset, sizeof(PropertyId));
+                offset += sizeof(PropertyId);
+                auto propertySize = size_t{};
+                if ((data[offset] & 0x1) == 1) {
+                    //extra large size of value (exceed 127 bytes)
+                    auto tmpSize = uint32_t{};
+                    memcpy(&tmpSize, data + offset, sizeof(uint32_t));
+                    offset += sizeof(uint32_t);
+                    propertySize = static_cast<size_t>(tmpSize >> 1);
+                } else {
+                    //normal size of value (not exceed 127 bytes)
+                    propertySize = static_cast<size_t>(data[offset] >> 1);
+                    offset += sizeof(uint8_t);
+                }
+                if (offset + propertySize > size) {
+                    break;
+                }
+                if (!callback(propertyId, data + offset, propertySize)) {
+                    break;
+                }
+                offset += propertySize;
+            }
+        }
+
+        // find a value of a property in raw data
+        // NOTE: it is a binary search over property ids for the indexed record format
+        // and a linear scan over property blocks for the sequential one
+        static bool findRawProperty(const unsigned char *data, size_t size, PropertyId propertyId,
+                                    const unsigned char *&value, size_t &valueSize) {
+            if (isIndexedRawData(data, size)) {
+                auto layout = IndexedLayout{};
+                if (!getIndexedLayout(data, size, layout)) {
+                    return false;
+                }
+                // a value in a slot is at a fixed position from the beginning of the group of its width
+                auto begin = size_t{0};
+                auto slot = layout.slotsBegin;
+                for (auto i = size_t{0}; i < NUM_SLOT_WIDTHS; ++i) {
+                    auto index = size_t{0};
+                    if (findIndexedRawDataPropertyId(data, begin, begin + layout.numSlots[i], propertyId, index)) {
+                        value = data + slot + (index - begin) * SLOT_WIDTHS[i];
+                        valueSize = SLOT_WIDTHS[i];
+                        return true;
+                    }
+                    begin += layout.numSlots[i];
+                    slot += layout.numSlots[i] * SLOT_WIDTHS[i];
+                }
+                auto index = size_t{0};
+                if (findIndexedRawDataPropertyId(data, begin, layout.count, propertyId, index)) {
+                    auto valueBegin = getIndexedRawDataOffset(data, layout, index - begin);
+                    auto valueEnd = getIndexedRawDataOffset(data, layout, index - begin + 1);
+                    if (valueEnd < valueBegin || valueEnd > size) {
+                        return false;
+                    }
+                    value = data + valueBegin;
+                    valueSize = valueEnd - valueBegin;
+                    return true;
+                }
+                return false;
+            }
+            auto isFound = false;
+            forEachRawProperty(data, size, [&](PropertyId id, const unsigned char *rawValue, size_t rawValueSize) {
+                if (id == propertyId) {
+                    value = rawValue;
+                    valueSize = rawValueSize;
+                    isFound = true;
+                    return false;
+                }
+                return true;
+            });
+            return isFound;
+        }
+
         inline static size_t getRawDataSize(size_t size) {
             return sizeof(PropertyId) + size + ((size >= std::pow(2, UINT8_BITS_COUNT - 1))? sizeof(uint32_t): sizeof(uint8_t));
         };
+
+        inline static size_t getIndexedRawDataSize(size_t count, size_t numSlots, size_t valueSize) {
+            return INDEXED_RAW_DATA_HEADER_SIZE + count * sizeof(PropertyId) + (count - numSlots + 1) * sizeof(uint32_t) +
+                   valueSize;
+        }
+
+        // a number of properties in indexed raw data (or 0 if the header, the offsets, or the slots are truncated)
+        inline static size_t getIndexedRawDataCount(const unsigned char *data, size_t size) {
+            auto layout = IndexedLayout{};
+            return getIndexedLayout(data, size, layout) ? layout.count : 0;
+        }
+
+        inline static PropertyId getIndexedRawDataPropertyId(const unsigned char *data, size_t index) {
+            auto propertyId = PropertyId{};
+            memcpy(&propertyId, data + INDEXED_RAW_DATA_HEADER_SIZE + index * sizeof(PropertyId), sizeof(PropertyId));
+            return propertyId;
+        }
+
+        inline static size_t getIndexedRawDataOffset(const unsigned char *data, const IndexedLayout &layout,
+                                                     size_t index) {
+            auto offset = uint32_t{};
+            memcpy(&offset, data + layout.offsetsBegin + index * sizeof(uint32_t), sizeof(uint32_t));
+            return static_cast<size_t>(offset);
+        }
+
+        // binary search over sorted property ids in [begin, end)
+        static bool findIndexedRawDataPropertyId(const unsigned char *data, size_t begin, size_t end,
+                                                 PropertyId propertyId, size_t &index) {
+            while (begin < end) {
+                auto mid = begin + (end - begin) / 2;
+                auto midPropertyId = getIndexedRawDataPropertyId(data, mid);
+                if (midPropertyId < propertyId) {
+                    begin = mid + 1;
+                } else if (propertyId < midPropertyId) {
+                    end = mid;
+                } else {
+                    index = mid;
+                    return true;
+                }
+            }
+            return false;
+        }
     };
 
 }
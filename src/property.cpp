@@ -19,7 +19,10 @@
  *
  */
 
+#include <cstring>
 #include <memory>
+#include <algorithm>
+#include <limits>
 
 #include "shared_lock.hpp"
 #include "constant.hpp"
@@ -30,11 +33,58 @@
 #include "schema.hpp"
 #include "generic.hpp"
 #include "parser.hpp"
+#include "index.hpp"
+#include "class_scanner.hpp"
 
 #include "nogdb.h"
 
 namespace nogdb {
 
+    namespace {
+
+        // a composite index is stored in the index mapping table under its first property
+        // together with the number of its properties and all of their ids in order
+        Blob toCompositeIndexValue(IndexId indexId, ClassId classId,
+                                   const Schema::CompositeIndexDescriptor &compositeIndex) {
+            auto numProperty = static_cast<uint8_t>(compositeIndex.propertyIds.size());
+            auto totalLength = sizeof(uint8_t) + sizeof(uint8_t) + sizeof(IndexId) + sizeof(ClassId) +
+                               sizeof(numProperty) + sizeof(PropertyId) * numProperty;
+            auto isCompositeNumeric = uint8_t{1};
+            auto isUniqueNumeric = (compositeIndex.isUnique) ? uint8_t{1} : uint8_t{0};
+            auto value = Blob(totalLength);
+            value.append(&isCompositeNumeric, sizeof(isCompositeNumeric));
+            value.append(&isUniqueNumeric, sizeof(isUniqueNumeric));
+            value.append(&indexId, sizeof(IndexId));
+            value.append(&classId, sizeof(ClassId));
+            value.append(&numProperty, sizeof(numProperty));
+            for (const auto &propertyId: compositeIndex.propertyIds) {
+                value.append(&propertyId, sizeof(PropertyId));
+            }
+            return value;
+        }
+
+        std::vector<PropertyId> getCompositeIndexPropertyIds(const BaseTxn &txn,
+                                                             const Schema::ClassDescriptorPtr &classDescriptor,
+                                                             const std::vector<std::string> &propertyNames) {
+            if (propertyNames.size() < 2 || propertyNames.size() > UINT8_MAX) {
+                throw Error(CTX_INVALID_COMPOSITE_INDEX, Error::Type::CONTEXT);
+            }
+            auto propertyIds = std::vector<PropertyId>{};
+            for (const auto &propertyName: propertyNames) {
+                auto foundProperty = Validate::isExistingPropertyExtend(txn, classDescriptor, propertyName).second;
+                if (foundProperty.type == PropertyType::BLOB || foundProperty.type == PropertyType::UNDEFINED) {
+                    throw Error(CTX_INVALID_PROPTYPE_INDEX, Error::Type::CONTEXT);
+                }
+                if (std::find(propertyIds.cbegin(), propertyIds.cend(), foundProperty.id) != propertyIds.cend()) {
+                    throw Error(CTX_INVALID_COMPOSITE_INDEX, Error::Type::CONTEXT);
+                }
+                propertyIds.push_back(foundProperty.id);
+            }
+            return propertyIds;
+        }
+
+    }
+
     const PropertyDescriptor Property::add(Txn &txn,
                                            const std::string &className,
                                            const std::string &propertyName,
@@ -130,6 +180,7 @@ namespace nogdb {
         if (!foundProperty.indexInfo.empty()) {
             throw Error(CTX_IN_USED_PROPERTY, Error::Type::CONTEXT);
         }
+        Validate::isNotUsedInCompositeIndex(*txn.txnBase, foundClass, foundProperty.id);
 
         auto &dbInfo = txn.txnBase->dbInfo;
         auto dsTxnHandler = txn.txnBase->getDsTxnHandler();
@@ -151,6 +202,120 @@ namespace nogdb {
     }
 
     void Property::createIndex(Txn &txn, const std::string &className, const std::string &propertyName, bool isUnique) {
+        createIndex(txn, className, propertyName, isUnique, [&](IndexId indexId, PropertyType type) {
+            auto foundClass = Validate::isExistingClass(txn, className);
+            auto classPropertyInfo = Generic::getClassMapProperty(*txn.txnBase, foundClass,
+                                                                  std::set<std::string>{propertyName});
+            Index::addClassIndex(*txn.txnBase, indexId, foundClass->id, classPropertyInfo, propertyName, type,
+                                 isUnique);
+        });
+    }
+
+    void Property::createIndex(Context &ctx, const std::string &className, const std::string &propertyName,
+                               bool isUnique) {
+        // index entries are extracted from a snapshot by read-only txns over ranges of position ids (see
+        // ClassScanner) and sorted without holding the writer lock
+        auto snapshotTxn = Txn{ctx, Txn::Mode::READ_ONLY};
+        auto foundClass = Validate::isExistingClass(snapshotTxn, className);
+        auto foundProperty = Validate::isExistingPropertyExtend(*snapshotTxn.txnBase, foundClass, propertyName).second;
+        if (foundProperty.type == PropertyType::BLOB || foundProperty.type == PropertyType::UNDEFINED) {
+            throw Error(CTX_INVALID_PROPTYPE_INDEX, Error::Type::CONTEXT);
+        }
+        auto classInfo = ClassInfo{foundClass->id, className,
+                                   Generic::getClassMapProperty(*snapshotTxn.txnBase, foundClass,
+                                                                std::set<std::string>{propertyName}),
+                                   Schema::CompositeIndexInfo{}};
+        auto entries = Index::IndexEntries{};
+        try {
+            auto visit = [&classInfo, &propertyName](Index::IndexEntries &result, size_t classIndex,
+                                                     PositionId positionId, const KeyValue &keyValue) {
+                auto bytesValue = Parser::parseRawData(keyValue, classInfo.propertyInfo).get(propertyName);
+                if (!bytesValue.empty()) {
+                    result.emplace_back(std::move(bytesValue), positionId);
+                }
+            };
+            entries = ClassScanner::scan<Index::IndexEntries::value_type>(snapshotTxn,
+                                                                          std::vector<ClassInfo>{classInfo}, visit);
+        } catch (Datastore::ErrorType &err) {
+            throw Error(err, Error::Type::DATASTORE);
+        }
+        Index::sortIndexEntries(entries, foundProperty.type, Index::getNumBuildThreads(entries.size()));
+
+        // the snapshot is kept until the index is written, so records which have been changed by other txns in the
+        // meantime are found by comparing class tables of both txns
+        auto txn = Txn{ctx, Txn::Mode::READ_WRITE};
+        createIndex(txn, className, propertyName, isUnique, [&](IndexId indexId, PropertyType type) {
+            auto currentClass = Validate::isExistingClass(txn, className);
+            auto currentProperty = Validate::isExistingPropertyExtend(*txn.txnBase, currentClass, propertyName).second;
+            auto classPropertyInfo = Generic::getClassMapProperty(*txn.txnBase, currentClass,
+                                                                  std::set<std::string>{propertyName});
+            if (currentClass->id != foundClass->id || currentProperty.id != foundProperty.id) {
+                // the class or the property has been replaced since the snapshot
+                Index::addClassIndex(*txn.txnBase, indexId, currentClass->id, classPropertyInfo, propertyName, type,
+                                     isUnique);
+                return;
+            }
+            auto snapshotTxnHandler = snapshotTxn.txnBase->getDsTxnHandler();
+            auto dsTxnHandler = txn.txnBase->getDsTxnHandler();
+            auto changedPositionIds = std::vector<PositionId>{};
+            auto changedEntries = Index::IndexEntries{};
+            if (Datastore::getTxnId(dsTxnHandler) != Datastore::getTxnId(snapshotTxnHandler) + 1) {
+                // NOTE: unchanged records of both txns are mostly on the same pages, which are not copied by lmdb
+                auto snapshotCursor = Datastore::CursorHandlerWrapper(snapshotTxnHandler,
+                                                                      snapshotTxn.txnBase->openClassDbi(
+                                                                              foundClass->id));
+                auto cursor = Datastore::CursorHandlerWrapper(dsTxnHandler, txn.txnBase->openClassDbi(foundClass->id));
+                auto snapshotKeyValue = Datastore::getSetRangeCursor(snapshotCursor.get(), PositionId{EM_MAXRECNUM + 1});
+                auto keyValue = Datastore::getSetRangeCursor(cursor.get(), PositionId{EM_MAXRECNUM + 1});
+                while (!snapshotKeyValue.empty() || !keyValue.empty()) {
+                    auto snapshotPositionId = (snapshotKeyValue.empty()) ?
+                                              uint64_t{std::numeric_limits<PositionId>::max()} + 1 :
+                                              uint64_t{*Datastore::getKeyAsNumeric<PositionId>(snapshotKeyValue)};
+                    auto positionId = (keyValue.empty()) ?
+                                      uint64_t{std::numeric_limits<PositionId>::max()} + 1 :
+                                      uint64_t{*Datastore::getKeyAsNumeric<PositionId>(keyValue)};
+                    if (snapshotPositionId < positionId) {
+                        // removed
+                        changedPositionIds.push_back(static_cast<PositionId>(snapshotPositionId));
+                        snapshotKeyValue = Datastore::getNextCursor(snapshotCursor.get());
+                        continue;
+                    }
+                    auto isChanged = positionId < snapshotPositionId;
+                    if (!isChanged) {
+                        const auto &snapshotValue = snapshotKeyValue.value();
+                        const auto &value = keyValue.value();
+                        isChanged = snapshotValue.mv_size != value.mv_size ||
+                                    (snapshotValue.mv_data != value.mv_data &&
+                                     memcmp(snapshotValue.mv_data, value.mv_data, value.mv_size) != 0);
+                        snapshotKeyValue = Datastore::getNextCursor(snapshotCursor.get());
+                    }
+                    if (isChanged) {
+                        // added or updated
+                        changedPositionIds.push_back(static_cast<PositionId>(positionId));
+                        auto bytesValue = Parser::parseRawData(keyValue, classPropertyInfo).get(propertyName);
+                        if (!bytesValue.empty()) {
+                            changedEntries.emplace_back(std::move(bytesValue), static_cast<PositionId>(positionId));
+                        }
+                    }
+                    keyValue = Datastore::getNextCursor(cursor.get());
+                }
+            }
+            if (!changedPositionIds.empty()) {
+                std::sort(changedPositionIds.begin(), changedPositionIds.end());
+                entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                             [&changedPositionIds](const Index::IndexEntries::value_type &entry) {
+                                                 return std::binary_search(changedPositionIds.cbegin(),
+                                                                           changedPositionIds.cend(), entry.second);
+                                             }), entries.end());
+            }
+            Index::addSortedIndex(*txn.txnBase, indexId, entries, type, isUnique);
+            Index::addIndex(*txn.txnBase, indexId, changedEntries, type, isUnique);
+        });
+        txn.commit();
+    }
+
+    void Property::createIndex(Txn &txn, const std::string &className, const std::string &propertyName, bool isUnique,
+                               const std::function<void(IndexId, PropertyType)> &addEntries) {
         // transaction validations
         Validate::isTransactionValid(txn);
 
@@ -188,131 +353,13 @@ namespace nogdb {
             valueIndex.append(&dbInfo.maxIndexId, sizeof(IndexId));
             valueIndex.append(&foundClass->id, sizeof(ClassId));
             Datastore::putRecord(dsTxnHandler, indexDBHandler, foundProperty.id, valueIndex);
-            switch (foundProperty.type) {
-                case PropertyType::UNSIGNED_TINYINT:
-                case PropertyType::UNSIGNED_SMALLINT:
-                case PropertyType::UNSIGNED_INTEGER:
-                case PropertyType::UNSIGNED_BIGINT: {
-                    auto dataIndexDBHandler = Datastore::openDbi(dsTxnHandler,
-                                                                 TB_INDEXING_PREFIX + std::to_string(dbInfo.maxIndexId),
-                                                                 true, isUnique);
-                    auto classPropertyInfo = Generic::getClassMapProperty(*txn.txnBase, foundClass);
-                    auto classDBHandler = Datastore::openDbi(dsTxnHandler, std::to_string(foundClass->id), true);
-                    auto cursorHandler = Datastore::CursorHandlerWrapper(dsTxnHandler, classDBHandler);
-                    auto keyValue = Datastore::getNextCursor(cursorHandler.get());
-                    while (!keyValue.empty()) {
-                        auto key = Datastore::getKeyAsNumeric<PositionId>(keyValue);
-                        if (*key != EM_MAXRECNUM) {
-                            auto const positionId = *key;
-                            auto const record = Parser::parseRawData(keyValue, classPropertyInfo);
-                            auto bytesValue = record.get(propertyName);
-                            if (!bytesValue.empty()) {
-                                auto indexRecord = Blob(sizeof(PositionId));
-                                indexRecord.append(&positionId, sizeof(PositionId));
-                                if (foundProperty.type == PropertyType::UNSIGNED_TINYINT) {
-                                    Datastore::putRecord(dsTxnHandler, dataIndexDBHandler, bytesValue.toTinyIntU(),
-                                                         indexRecord, false, !isUnique);
-                                } else if (foundProperty.type == PropertyType::UNSIGNED_SMALLINT) {
-                                    Datastore::putRecord(dsTxnHandler, dataIndexDBHandler, bytesValue.toSmallIntU(),
-                                                         indexRecord, false, !isUnique);
-                                } else if (foundProperty.type == PropertyType::UNSIGNED_INTEGER) {
-                                    Datastore::putRecord(dsTxnHandler, dataIndexDBHandler, bytesValue.toIntU(),
-                                                         indexRecord, false, !isUnique);
-                                } else if (foundProperty.type == PropertyType::UNSIGNED_BIGINT) {
-                                    Datastore::putRecord(dsTxnHandler, dataIndexDBHandler, bytesValue.toBigIntU(),
-                                                         indexRecord, false, !isUnique);
-                                }
-                            }
-                        }
-                        keyValue = Datastore::getNextCursor(cursorHandler.get());
-                    }
-                    break;
-                }
-                case PropertyType::TINYINT:
-                case PropertyType::SMALLINT:
-                case PropertyType::INTEGER:
-                case PropertyType::BIGINT:
-                case PropertyType::REAL: {
-                    auto dataIndexDBHandlerPositive =
-                            Datastore::openDbi(dsTxnHandler,
-                                               TB_INDEXING_PREFIX + std::to_string(dbInfo.maxIndexId) + "_positive",
-                                               true, isUnique);
-                    auto dataIndexDBHandlerNegative =
-                            Datastore::openDbi(dsTxnHandler,
-                                               TB_INDEXING_PREFIX + std::to_string(dbInfo.maxIndexId) + "_negative",
-                                               true, isUnique);
-                    auto classPropertyInfo = Generic::getClassMapProperty(*txn.txnBase, foundClass);
-                    auto classDBHandler = Datastore::openDbi(dsTxnHandler, std::to_string(foundClass->id), true);
-                    auto cursorHandler = Datastore::CursorHandlerWrapper(dsTxnHandler, classDBHandler);
-                    auto keyValue = Datastore::getNextCursor(cursorHandler.get());
-                    while (!keyValue.empty()) {
-                        auto key = Datastore::getKeyAsNumeric<PositionId>(keyValue);
-                        if (*key != EM_MAXRECNUM) {
-                            auto const positionId = *key;
-                            auto const record = Parser::parseRawData(keyValue, classPropertyInfo);
-                            auto bytesValue = record.get(propertyName);
-                            if (!bytesValue.empty()) {
-                                auto indexRecord = Blob(sizeof(PositionId));
-                                indexRecord.append(&positionId, sizeof(PositionId));
-                                if (foundProperty.type == PropertyType::TINYINT) {
-                                    auto value = bytesValue.toTinyInt();
-                                    Datastore::putRecord(dsTxnHandler, (value >= 0) ? dataIndexDBHandlerPositive
-                                                                                    : dataIndexDBHandlerNegative,
-                                                         value, indexRecord, false, !isUnique);
-                                } else if (foundProperty.type == PropertyType::SMALLINT) {
-                                    auto value = bytesValue.toSmallInt();
-                                    Datastore::putRecord(dsTxnHandler, (value >= 0) ? dataIndexDBHandlerPositive
-                                                                                    : dataIndexDBHandlerNegative,
-                                                         value, indexRecord, false, !isUnique);
-                                } else if (foundProperty.type == PropertyType::INTEGER) {
-                                    auto value = bytesValue.toInt();
-                                    Datastore::putRecord(dsTxnHandler, (value >= 0) ? dataIndexDBHandlerPositive
-                                                                                    : dataIndexDBHandlerNegative,
-                                                         value, indexRecord, false, !isUnique);
-                                } else if (foundProperty.type == PropertyType::BIGINT) {
-                                    auto value = bytesValue.toBigInt();
-                                    Datastore::putRecord(dsTxnHandler, (value >= 0) ? dataIndexDBHandlerPositive
-                                                                                    : dataIndexDBHandlerNegative,
-                                                         value, indexRecord, false, !isUnique);
-                                } else if (foundProperty.type == PropertyType::REAL) {
-                                    auto value = bytesValue.toReal();
-                                    Datastore::putRecord(dsTxnHandler, (value >= 0) ? dataIndexDBHandlerPositive
-                                                                                    : dataIndexDBHandlerNegative,
-                                                         value, indexRecord, false, !isUnique);
-                                }
-                            }
-                        }
-                        keyValue = Datastore::getNextCursor(cursorHandler.get());
-                    }
-                    break;
-                }
-                case PropertyType::TEXT: {
-                    auto dataIndexDBHandler = Datastore::openDbi(dsTxnHandler,
-                                                                 TB_INDEXING_PREFIX + std::to_string(dbInfo.maxIndexId),
-                                                                 false, isUnique);
-                    auto classPropertyInfo = Generic::getClassMapProperty(*txn.txnBase, foundClass);
-                    auto classDBHandler = Datastore::openDbi(dsTxnHandler, std::to_string(foundClass->id), true);
-                    auto cursorHandler = Datastore::CursorHandlerWrapper(dsTxnHandler, classDBHandler);
-                    auto keyValue = Datastore::getNextCursor(cursorHandler.get());
-                    while (!keyValue.empty()) {
-                        auto key = Datastore::getKeyAsNumeric<PositionId>(keyValue);
-                        if (*key != EM_MAXRECNUM) {
-                            auto const positionId = *key;
-                            auto const record = Parser::parseRawData(keyValue, classPropertyInfo);
-                            auto value = record.get(propertyName).toText();
-                            if (!value.empty()) {
-                                auto indexRecord = Blob(sizeof(PositionId));
-                                indexRecord.append(&positionId, sizeof(PositionId));
-                                Datastore::putRecord(dsTxnHandler, dataIndexDBHandler, value, indexRecord,
-                                                     false, !isUnique);
-                            }
-                        }
-                        keyValue = Datastore::getNextCursor(cursorHandler.get());
-                    }
-                    break;
+            try {
+                addEntries(dbInfo.maxIndexId, foundProperty.type);
+            } catch (const Error &err) {
+                if (err.code() == CTX_UNIQUE_CONSTRAINT) {
+                    throw Error(CTX_INVALID_INDEX_CONSTRAINT, Error::Type::CONTEXT);
                 }
-                default:
-                    break;
+                throw;
             }
 
             // update in-memory database schema and info
@@ -370,10 +417,8 @@ namespace nogdb {
                 case PropertyType::UNSIGNED_SMALLINT:
                 case PropertyType::UNSIGNED_INTEGER:
                 case PropertyType::UNSIGNED_BIGINT: {
-                    auto dataIndexDBHandler = Datastore::openDbi(dsTxnHandler,
-                                                                 TB_INDEXING_PREFIX + std::to_string(indexId),
-                                                                 true, isUnique);
-                    Datastore::dropDbi(dsTxnHandler, dataIndexDBHandler);
+                    auto dataIndexDBHandler = txn.txnBase->openIndexDbi(indexId, true, isUnique);
+                    txn.txnBase->dropDbi(DBHandlerRegistry::INDEX, indexId, dataIndexDBHandler);
                     break;
                 }
                 case PropertyType::TINYINT:
@@ -381,21 +426,22 @@ namespace nogdb {
                 case PropertyType::INTEGER:
                 case PropertyType::BIGINT:
                 case PropertyType::REAL: {
+                    if (Index::isOrderedIndex(*txn.txnBase, foundProperty.type)) {
+                        auto dataIndexDBHandler = txn.txnBase->openIndexDbi(indexId, false, isUnique);
+                        txn.txnBase->dropDbi(DBHandlerRegistry::INDEX, indexId, dataIndexDBHandler);
+                        break;
+                    }
                     auto dataIndexDBHandlerPositive =
-                            Datastore::openDbi(dsTxnHandler, TB_INDEXING_PREFIX + std::to_string(indexId) + "_positive",
-                                               true, isUnique);
+                            txn.txnBase->openSignedIndexDbi(indexId, true, isUnique);
                     auto dataIndexDBHandlerNegative =
-                            Datastore::openDbi(dsTxnHandler, TB_INDEXING_PREFIX + std::to_string(indexId) + "_negative",
-                                               true, isUnique);
-                    Datastore::dropDbi(dsTxnHandler, dataIndexDBHandlerPositive);
-                    Datastore::dropDbi(dsTxnHandler, dataIndexDBHandlerNegative);
+                            txn.txnBase->openSignedIndexDbi(indexId, false, isUnique);
+                    txn.txnBase->dropDbi(DBHandlerRegistry::INDEX_POSITIVE, indexId, dataIndexDBHandlerPositive);
+                    txn.txnBase->dropDbi(DBHandlerRegistry::INDEX_NEGATIVE, indexId, dataIndexDBHandlerNegative);
                     break;
                 }
                 case PropertyType::TEXT: {
-                    auto dataIndexDBHandler = Datastore::openDbi(dsTxnHandler,
-                                                                 TB_INDEXING_PREFIX + std::to_string(indexId),
-                                                                 false, isUnique);
-                    Datastore::dropDbi(dsTxnHandler, dataIndexDBHandler);
+                    auto dataIndexDBHandler = txn.txnBase->openIndexDbi(indexId, false, isUnique);
+                    txn.txnBase->dropDbi(DBHandlerRegistry::INDEX, indexId, dataIndexDBHandler);
                     break;
                 }
                 default:
@@ -416,4 +462,115 @@ namespace nogdb {
         }
     }
 
+    void Property::createCompositeIndex(Txn &txn, const std::string &className,
+                                        const std::vector<std::string> &propertyNames, bool isUnique) {
+        // transaction validations
+        Validate::isTransactionValid(txn);
+
+        auto &dbInfo = txn.txnBase->dbInfo;
+        if (dbInfo.maxIndexId >= UINT32_MAX) {
+            throw Error(CTX_LIMIT_DBSCHEMA, Error::Type::CONTEXT);
+        } else {
+            ++dbInfo.maxIndexId;
+        }
+
+        // schema validations
+        auto foundClass = Validate::isExistingClass(txn, className);
+        auto compositeIndex = Schema::CompositeIndexDescriptor{};
+        compositeIndex.propertyIds = getCompositeIndexPropertyIds(*txn.txnBase, foundClass, propertyNames);
+        compositeIndex.isUnique = isUnique;
+
+        // index validations
+        auto compositeIndexInfo = BaseTxn::getCurrentVersion(*txn.txnBase, foundClass->compositeIndexes).first;
+        for (const auto &existingIndex: compositeIndexInfo) {
+            if (existingIndex.second.propertyIds == compositeIndex.propertyIds) {
+                throw Error(CTX_DUPLICATE_INDEX, Error::Type::CONTEXT);
+            }
+        }
+
+        auto dsTxnHandler = txn.txnBase->getDsTxnHandler();
+        try {
+            auto indexDBHandler = Datastore::openDbi(dsTxnHandler, TB_INDEXES, true, false);
+            Datastore::putRecord(dsTxnHandler, indexDBHandler, compositeIndex.propertyIds.front(),
+                                 toCompositeIndexValue(dbInfo.maxIndexId, foundClass->id, compositeIndex));
+            // build the index from existing records
+            auto classPropertyInfo = Generic::getClassMapProperty(*txn.txnBase, foundClass);
+            auto classDBHandler = txn.txnBase->openClassDbi(foundClass->id);
+            auto cursorHandler = Datastore::CursorHandlerWrapper(dsTxnHandler, classDBHandler);
+            for (auto keyValue = Datastore::getNextCursor(cursorHandler.get());
+                 !keyValue.empty();
+                 keyValue = Datastore::getNextCursor(cursorHandler.get())) {
+                auto key = Datastore::getKeyAsNumeric<PositionId>(keyValue);
+                if (*key != EM_MAXRECNUM) {
+                    auto const record = Parser::parseRawData(keyValue, *classPropertyInfo);
+                    try {
+                        Index::addCompositeIndex(*txn.txnBase, dbInfo.maxIndexId, compositeIndex, *classPropertyInfo,
+                                                 *key, record);
+                    } catch (const Error &err) {
+                        if (err.code() == CTX_UNIQUE_CONSTRAINT) {
+                            throw Error(CTX_INVALID_INDEX_CONSTRAINT, Error::Type::CONTEXT);
+                        }
+                        throw;
+                    }
+                }
+            }
+
+            // update in-memory database schema and info
+            compositeIndexInfo.emplace(dbInfo.maxIndexId, compositeIndex);
+            txn.txnCtx.dbSchema->updateCompositeIndex(*txn.txnBase, foundClass->id, compositeIndexInfo);
+            ++dbInfo.numIndex;
+        } catch (Datastore::ErrorType &err) {
+            throw Error(err, Error::Type::DATASTORE);
+        } catch (...) {
+            // NOTE: too risky since this may cause undefined behaviour after throwing any exceptions
+            // other than errors from datastore due to failures in updating in-memory schema or database info
+            std::rethrow_exception(std::current_exception());
+        }
+    }
+
+    void Property::dropCompositeIndex(Txn &txn, const std::string &className,
+                                      const std::vector<std::string> &propertyNames) {
+        // transaction validations
+        Validate::isTransactionValid(txn);
+
+        // schema validations
+        auto foundClass = Validate::isExistingClass(txn, className);
+        auto propertyIds = getCompositeIndexPropertyIds(*txn.txnBase, foundClass, propertyNames);
+
+        // index validations
+        auto compositeIndexInfo = BaseTxn::getCurrentVersion(*txn.txnBase, foundClass->compositeIndexes).first;
+        auto compositeIndex = compositeIndexInfo.begin();
+        while (compositeIndex != compositeIndexInfo.end() && compositeIndex->second.propertyIds != propertyIds) {
+            ++compositeIndex;
+        }
+        if (compositeIndex == compositeIndexInfo.end()) {
+            throw Error(CTX_NOEXST_INDEX, Error::Type::CONTEXT);
+        }
+
+        auto &dbInfo = txn.txnBase->dbInfo;
+        auto dsTxnHandler = txn.txnBase->getDsTxnHandler();
+        try {
+            auto indexId = compositeIndex->first;
+            auto indexDBHandler = Datastore::openDbi(dsTxnHandler, TB_INDEXES, true, false);
+            // delete metadata from index mapping table
+            Datastore::deleteRecord(dsTxnHandler, indexDBHandler, propertyIds.front(),
+                                    toCompositeIndexValue(indexId, foundClass->id, compositeIndex->second));
+            // drop the actual index data table
+            auto dataIndexDBHandler = txn.txnBase->openIndexDbi(indexId, false, false);
+            txn.txnBase->dropDbi(DBHandlerRegistry::INDEX, indexId, dataIndexDBHandler);
+
+            // update in-memory schema
+            compositeIndexInfo.erase(compositeIndex);
+            txn.txnCtx.dbSchema->updateCompositeIndex(*txn.txnBase, foundClass->id, compositeIndexInfo);
+            // update in-memory database info
+            --dbInfo.numIndex;
+        } catch (Datastore::ErrorType &err) {
+            throw Error(err, Error::Type::DATASTORE);
+        } catch (...) {
+            // NOTE: too risky since this may cause undefined behaviour after throwing any exceptions
+            // other than errors from datastore due to failures in updating in-memory schema or database info
+            std::rethrow_exception(std::current_exception());
+        }
+    }
+
 }
@@ -0,0 +1,58 @@
+/*
+ *  Copyright (C) 2018, Throughwave (Thailand) Co., Ltd.
+ *  <peerawich at throughwave dot co dot th>
+ *
+ *  This file is part of libnogdb, the NogDB core library in C++.
+ *
+ *  libnogdb is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "nogdb_compare.h"
+
+namespace nogdb {
+
+    PropertyFilter::PropertyFilter(const std::initializer_list<std::string> &initializerList)
+            : propertyNames{initializerList} {}
+
+    PropertyFilter::PropertyFilter(const std::vector<std::string> &propertyNames_)
+            : propertyNames{propertyNames_.cbegin(), propertyNames_.cend()} {}
+
+    PropertyFilter::PropertyFilter(const std::list<std::string> &propertyNames_)
+            : propertyNames{propertyNames_.cbegin(), propertyNames_.cend()} {}
+
+    PropertyFilter::PropertyFilter(const std::set<std::string> &propertyNames_)
+            : propertyNames{propertyNames_} {}
+
+    void PropertyFilter::add(const std::string &propertyName) {
+        propertyNames.insert(propertyName);
+    }
+
+    void PropertyFilter::remove(const std::string &propertyName) {
+        propertyNames.erase(propertyName);
+    }
+
+    size_t PropertyFilter::size() const {
+        return propertyNames.size();
+    }
+
+    bool PropertyFilter::empty() const {
+        return propertyNames.empty();
+    }
+
+    const std::set<std::string> &PropertyFilter::getPropertyName() const {
+        return propertyNames;
+    }
+
+}
@@ -0,0 +1,87 @@
+/*
+ *  Copyright (C) 2018, Throughwave (Thailand) Co., Ltd.
+ *  <peerawich at throughwave dot co dot th>
+ *
+ *  This file is part of libnogdb, the NogDB core library in C++.
+ *
+ *  libnogdb is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <chrono>
+
+#include "txn_object.hpp"
+#include "schema.hpp"
+#include "graph.hpp"
+#include "reclaimer.hpp"
+
+namespace nogdb {
+
+    Reclaimer::~Reclaimer() noexcept {
+        stop();
+    }
+
+    bool Reclaimer::reclaim() noexcept {
+        auto watermark = txnStat_->minActiveVersionId();
+        // elements are always queued before their version becomes visible, so nothing new is reclaimable
+        // until the watermark advances
+        if (watermark <= watermark_) {
+            return false;
+        }
+        std::unique_lock<std::mutex> lock(reclaimMutex_, std::try_to_lock);
+        if (!lock.owns_lock()) {
+            return false;
+        }
+        try {
+            schema_->clearDeletedElements(watermark);
+            graph_->clearDeletedElements(watermark);
+            schema_->clearStaleVersions(watermark);
+            graph_->clearStaleVersions(watermark);
+        } catch (...) {
+            // the remaining versions are kept and will be reclaimed with a later watermark
+            return false;
+        }
+        watermark_ = watermark;
+        return true;
+    }
+
+    void Reclaimer::start(unsigned int intervalMs) {
+        stop();
+        if (intervalMs == 0) {
+            return;
+        }
+        isStopping_ = false;
+        thread_ = std::thread([this, intervalMs]() {
+            std::unique_lock<std::mutex> lock(threadMutex_);
+            while (!threadCondition_.wait_for(lock, std::chrono::milliseconds(intervalMs),
+                                              [this]() { return isStopping_; })) {
+                lock.unlock();
+                reclaim();
+                lock.lock();
+            }
+        });
+    }
+
+    void Reclaimer::stop() noexcept {
+        if (thread_.joinable()) {
+            {
+                std::lock_guard<std::mutex> _(threadMutex_);
+                isStopping_ = true;
+            }
+            threadCondition_.notify_all();
+            thread_.join();
+        }
+    }
+
+}
@@ -0,0 +1,78 @@
+/*
+ *  Copyright (C) 2018, Throughwave (Thailand) Co., Ltd.
+ *  <peerawich at throughwave dot co dot th>
+ *
+ *  This file is part of libnogdb, the NogDB core library in C++.
+ *
+ *  libnogdb is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef __RECLAIMER_HPP_INCLUDED_
+#define __RECLAIMER_HPP_INCLUDED_
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "nogdb_types.h"
+
+namespace nogdb {
+
+    struct Graph;
+    struct Schema;
+    struct TxnStat;
+
+    // reclaims deleted elements and superseded versions in memory once they are older than a watermark, which is
+    // the oldest version read by an active read-only txn (or the latest version if there are no readers)
+    // NOTE: reclaim is called at the end of every txn and can also be run periodically by a background thread
+    class Reclaimer {
+    public:
+        Reclaimer(const std::shared_ptr<TxnStat> &txnStat, const std::shared_ptr<Schema> &schema,
+                  const std::shared_ptr<Graph> &graph)
+                : txnStat_{txnStat}, schema_{schema}, graph_{graph} {}
+
+        ~Reclaimer() noexcept;
+
+        Reclaimer(const Reclaimer &) = delete;
+
+        Reclaimer &operator=(const Reclaimer &) = delete;
+
+        // return false if the watermark has not advanced or another thread is reclaiming
+        bool reclaim() noexcept;
+
+        // (re)start a background thread reclaiming every intervalMs milliseconds (stop it if intervalMs is 0)
+        void start(unsigned int intervalMs);
+
+        void stop() noexcept;
+
+    private:
+        std::shared_ptr<TxnStat> txnStat_;
+        std::shared_ptr<Schema> schema_;
+        std::shared_ptr<Graph> graph_;
+
+        std::mutex reclaimMutex_{};
+        std::atomic<TxnId> watermark_{0};
+
+        std::mutex threadMutex_{};
+        std::condition_variable threadCondition_{};
+        std::thread thread_{};
+        bool isStopping_{false};
+    };
+
+}
+
+#endif
@@ -0,0 +1,141 @@
+/*
+ *  Copyright (C) 2018, Throughwave (Thailand) Co., Ltd.
+ *  <peerawich at throughwave dot co dot th>
+ *
+ *  This file is part of libnogdb, the NogDB core library in C++.
+ *
+ *  libnogdb is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <algorithm>
+
+#include "parser.hpp"
+#include "schema.hpp"
+
+#include "nogdb_errors.h"
+#include "nogdb_types.h"
+
+namespace nogdb {
+
+    bool RecordView::find(const std::string &propName, const unsigned char *&value, size_t &size) const {
+        if (classPropertyInfo_ == nullptr) {
+            return false;
+        }
+        auto foundProperty = classPropertyInfo_->nameToDesc.find(propName);
+        if (foundProperty == classPropertyInfo_->nameToDesc.cend()) {
+            return false;
+        }
+        return Parser::findRawProperty(value_, size_, foundProperty->second.id, value, size);
+    }
+
+    template<typename T>
+    T RecordView::getNumeric(const std::string &propName) const {
+        auto value = static_cast<const unsigned char *>(nullptr);
+        auto size = size_t{0};
+        if (!find(propName, value, size) || size == 0) {
+            throw Error(CTX_NOEXST_PROPERTY, Error::Type::CONTEXT);
+        }
+        auto result = T{0};
+        memcpy(static_cast<void *>(&result), static_cast<const void *>(value), std::min(size, sizeof(T)));
+        return result;
+    }
+
+    Bytes RecordView::get(const std::string &propName) const {
+        auto value = static_cast<const unsigned char *>(nullptr);
+        auto size = size_t{0};
+        if (!find(propName, value, size) || size == 0) {
+            return Bytes{};
+        }
+        return Bytes{value, size};
+    }
+
+    std::vector<std::string> RecordView::getProperties() const {
+        auto propertyNames = std::vector<std::string>{};
+        if (classPropertyInfo_ != nullptr) {
+            Parser::forEachRawProperty(value_, size_, [&](PropertyId id, const unsigned char *data, size_t dataSize) {
+                auto foundInfo = classPropertyInfo_->idToName.find(id);
+                if (foundInfo != classPropertyInfo_->idToName.cend()) {
+                    propertyNames.emplace_back(foundInfo->second);
+                }
+                return true;
+            });
+        }
+        return propertyNames;
+    }
+
+    uint8_t RecordView::getTinyIntU(const std::string &propName) const {
+        return getNumeric<uint8_t>(propName);
+    }
+
+    int8_t RecordView::getTinyInt(const std::string &propName) const {
+        return getNumeric<int8_t>(propName);
+    }
+
+    uint16_t RecordView::getSmallIntU(const std::string &propName) const {
+        return getNumeric<uint16_t>(propName);
+    }
+
+    int16_t RecordView::getSmallInt(const std::string &propName) const {
+        return getNumeric<int16_t>(propName);
+    }
+
+    uint32_t RecordView::getIntU(const std::string &propName) const {
+        return getNumeric<uint32_t>(propName);
+    }
+
+    int32_t RecordView::getInt(const std::string &propName) const {
+        return getNumeric<int32_t>(propName);
+    }
+
+    uint64_t RecordView::getBigIntU(const std::string &propName) const {
+        return getNumeric<uint64_t>(propName);
+    }
+
+    int64_t RecordView::getBigInt(const std::string &propName) const {
+        return getNumeric<int64_t>(propName);
+    }
+
+    double RecordView::getReal(const std::string &propName) const {
+        return getNumeric<double>(propName);
+    }
+
+    std::string RecordView::getText(const std::string &propName) const {
+        auto value = static_cast<const unsigned char *>(nullptr);
+        auto size = size_t{0};
+        if (!find(propName, value, size) || size == 0) {
+            return "";
+        }
+        return std::string{reinterpret_cast<const char *>(value), size};
+    }
+
+    Record RecordView::toRecord() const {
+        auto result = Record{};
+        if (classPropertyInfo_ != nullptr) {
+            Parser::forEachRawProperty(value_, size_, [&](PropertyId id, const unsigned char *data, size_t dataSize) {
+                auto foundInfo = classPropertyInfo_->idToName.find(id);
+                if (foundInfo != classPropertyInfo_->idToName.cend()) {
+                    result.set(foundInfo->second, (dataSize > 0) ? Bytes{data, dataSize} : Bytes{});
+                }
+                return true;
+            });
+        }
+        return result;
+    }
+
+    bool RecordView::empty() const {
+        return getProperties().empty();
+    }
+
+}
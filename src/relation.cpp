@@ -0,0 +1,127 @@
+/*
+ *  Copyright (C) 2018, Throughwave (Thailand) Co., Ltd.
+ *  <peerawich at throughwave dot co dot th>
+ *
+ *  This file is part of libnogdb, the NogDB core library in C++.
+ *
+ *  libnogdb is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <string>
+
+#include "constant.hpp"
+#include "utils.hpp"
+#include "relation.hpp"
+
+#include "nogdb_errors.h"
+
+namespace nogdb {
+
+    Relation::Key Relation::toKey(const RecordId &edgeId) {
+        auto key = Key{};
+        for (auto i = 0U; i < sizeof(ClassId); ++i) {
+            key[i] = static_cast<unsigned char>(edgeId.first >> (8 * (sizeof(ClassId) - 1 - i)));
+        }
+        for (auto i = 0U; i < sizeof(PositionId); ++i) {
+            key[sizeof(ClassId) + i] = static_cast<unsigned char>(edgeId.second >> (8 * (sizeof(PositionId) - 1 - i)));
+        }
+        return key;
+    }
+
+    RecordId Relation::toEdgeId(const KeyValue &keyValue) {
+        const auto &key = *Datastore::getKeyAsNumeric<Key>(keyValue);
+        auto classId = ClassId{0};
+        auto positionId = PositionId{0};
+        for (auto i = 0U; i < sizeof(ClassId); ++i) {
+            classId = static_cast<ClassId>((classId << 8) | key[i]);
+        }
+        for (auto i = 0U; i < sizeof(PositionId); ++i) {
+            positionId = (positionId << 8) | key[sizeof(ClassId) + i];
+        }
+        return RecordId{classId, positionId};
+    }
+
+    std::pair<RecordId, RecordId> Relation::toVertexIds(const KeyValue &keyValue) {
+        auto data = Datastore::getValueAsBlob(keyValue);
+        auto srcId = RecordId{};
+        auto dstId = RecordId{};
+        auto offset = data.retrieve(&srcId.first, 0, sizeof(ClassId));
+        offset = data.retrieve(&srcId.second, offset, sizeof(PositionId));
+        offset = data.retrieve(&dstId.first, offset, sizeof(ClassId));
+        data.retrieve(&dstId.second, offset, sizeof(PositionId));
+        return std::make_pair(srcId, dstId);
+    }
+
+    void Relation::put(Datastore::TxnHandler *txnHandler, Datastore::DBHandler dbHandler, const RecordId &edgeId,
+                       const RecordId &srcId, const RecordId &dstId, bool isAppend) {
+        auto value = Blob((sizeof(ClassId) + sizeof(PositionId)) * 2);
+        value.append(&srcId.first, sizeof(ClassId));
+        value.append(&srcId.second, sizeof(PositionId));
+        value.append(&dstId.first, sizeof(ClassId));
+        value.append(&dstId.second, sizeof(PositionId));
+        Datastore::putRecord(txnHandler, dbHandler, toKey(edgeId), value, isAppend);
+    }
+
+    std::pair<RecordId, RecordId>
+    Relation::get(Datastore::TxnHandler *txnHandler, Datastore::DBHandler dbHandler, const RecordId &edgeId) {
+        auto keyValue = Datastore::getRecord(txnHandler, dbHandler, toKey(edgeId));
+        if (keyValue.empty()) {
+            return std::make_pair(RecordId{}, RecordId{});
+        }
+        return toVertexIds(keyValue);
+    }
+
+    void Relation::remove(Datastore::TxnHandler *txnHandler, Datastore::DBHandler dbHandler, const RecordId &edgeId) {
+        Datastore::deleteRecord(txnHandler, dbHandler, toKey(edgeId));
+    }
+
+    void Relation::migrateTextKeys(Datastore::TxnHandler *txnHandler, Datastore::DBHandler dbHandler) {
+        auto tmpDBHandler = Datastore::openDbi(txnHandler, TB_RELATIONS_MIGRATION);
+        Datastore::emptyDbi(txnHandler, tmpDBHandler);
+        {
+            auto cursorHandler = Datastore::CursorHandlerWrapper(txnHandler, dbHandler);
+            for (auto keyValue = Datastore::getNextCursor(cursorHandler.get());
+                 !keyValue.empty();
+                 keyValue = Datastore::getNextCursor(cursorHandler.get())) {
+                auto key = Datastore::getKeyAsString(keyValue);
+                if (key == STRING_EM_INIT) {
+                    continue;
+                }
+                auto sp = split(key, ':');
+                if (sp.size() != 2) {
+                    throw Error(CTX_UNKNOWN_ERR, Error::Type::CONTEXT);
+                }
+                auto edgeId = RecordId{
+                        static_cast<ClassId>(std::stoul(std::string{sp[0]}, nullptr, 0)),
+                        static_cast<PositionId>(std::stoul(std::string{sp[1]}, nullptr, 0))
+                };
+                Datastore::putRecord(txnHandler, tmpDBHandler, toKey(edgeId), Datastore::getValueAsBlob(keyValue));
+            }
+        }
+        // keys in the temporary table are already in order
+        Datastore::emptyDbi(txnHandler, dbHandler);
+        {
+            auto cursorHandler = Datastore::CursorHandlerWrapper(txnHandler, tmpDBHandler);
+            for (auto keyValue = Datastore::getNextCursor(cursorHandler.get());
+                 !keyValue.empty();
+                 keyValue = Datastore::getNextCursor(cursorHandler.get())) {
+                Datastore::putRecord(txnHandler, dbHandler, *Datastore::getKeyAsNumeric<Key>(keyValue),
+                                     Datastore::getValueAsBlob(keyValue), true);
+            }
+        }
+        Datastore::dropDbi(txnHandler, tmpDBHandler);
+    }
+
+}
@@ -0,0 +1,66 @@
+/*
+ *  Copyright (C) 2018, Throughwave (Thailand) Co., Ltd.
+ *  <peerawich at throughwave dot co dot th>
+ *
+ *  This file is part of libnogdb, the NogDB core library in C++.
+ *
+ *  libnogdb is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef __RELATION_HPP_INCLUDED_
+#define __RELATION_HPP_INCLUDED_
+
+#include <array>
+#include <utility>
+
+#include "datastore.hpp"
+
+#include "nogdb_types.h"
+
+namespace nogdb {
+
+    // records in the relation table which map edges to their source and destination vertices
+    // NOTE: a key is a packed record id of an edge in big-endian so that keys are in the order of record ids,
+    // and a value is a fixed size pair of record ids of the source and destination vertices
+    struct Relation {
+        Relation() = delete;
+
+        ~Relation() noexcept = delete;
+
+        typedef std::array<unsigned char, sizeof(ClassId) + sizeof(PositionId)> Key;
+
+        static Key toKey(const RecordId &edgeId);
+
+        static RecordId toEdgeId(const KeyValue &keyValue);
+
+        static std::pair<RecordId, RecordId> toVertexIds(const KeyValue &keyValue);
+
+        static void put(Datastore::TxnHandler *txnHandler, Datastore::DBHandler dbHandler, const RecordId &edgeId,
+                        const RecordId &srcId, const RecordId &dstId, bool isAppend = false);
+
+        // return empty record ids if the edge does not exist in the relation table
+        static std::pair<RecordId, RecordId>
+        get(Datastore::TxnHandler *txnHandler, Datastore::DBHandler dbHandler, const RecordId &edgeId);
+
+        static void remove(Datastore::TxnHandler *txnHandler, Datastore::DBHandler dbHandler, const RecordId &edgeId);
+
+        // rewrite a relation table with string keys ("<class id>:<position id>") into binary keys
+        // NOTE: a temporary table is used so that the whole relations need not be held in memory
+        static void migrateTextKeys(Datastore::TxnHandler *txnHandler, Datastore::DBHandler dbHandler);
+    };
+
+}
+
+#endif
@@ -37,9 +37,8 @@ namespace nogdb {
     }
 
     Schema::ClassDescriptorPtr Schema::find(const BaseTxn &txn, const ClassId &classId) {
-        RWSpinLockGuard<RWSpinLock> _(schemaInfo.splock);
-        auto foundClass = schemaInfo.elements.find(classId);
-        if (foundClass == schemaInfo.elements.cend()) {
+        auto foundClass = schemaInfo.find(classId);
+        if (foundClass == nullptr) {
             if (txn.getType() == BaseTxn::TxnType::READ_ONLY) {
                 return nullptr;
             } else {
@@ -51,12 +50,12 @@ namespace nogdb {
             }
         } else {
             if ((txn.getType() == BaseTxn::TxnType::READ_ONLY &&
-                 foundClass->second->checkReadOnly(txn.getVersionId())) ||
-                (txn.getType() == BaseTxn::TxnType::READ_WRITE && foundClass->second->checkReadWrite())) {
+                 foundClass->checkReadOnly(txn.getVersionId())) ||
+                (txn.getType() == BaseTxn::TxnType::READ_WRITE && foundClass->checkReadWrite())) {
                 return nullptr;
             }
         }
-        return foundClass->second;
+        return foundClass;
     }
 
     Schema::ClassDescriptorPtr Schema::find(const BaseTxn &txn, const std::string &className) {
@@ -69,20 +68,17 @@ namespace nogdb {
                 }
             }
         }
-        RWSpinLockGuard<RWSpinLock> _(schemaInfo.splock);
-        for (const auto &element: schemaInfo.elements) {
-            if (auto classPtr = element.second) {
-                if (className == BaseTxn::getCurrentVersion(txn, classPtr->name).first) {
-                    if ((txn.getType() == BaseTxn::TxnType::READ_ONLY && classPtr->checkReadOnly(txn.getVersionId())) ||
-                        (txn.getType() == BaseTxn::TxnType::READ_WRITE && classPtr->checkReadWrite())) {
-                        return nullptr;
-                    }
-                    return classPtr;
+        for (const auto &classId: classNames.find(className)) {
+            auto classPtr = schemaInfo.find(classId);
+            if (classPtr != nullptr && className == BaseTxn::getCurrentVersion(txn, classPtr->name).first) {
+                if ((txn.getType() == BaseTxn::TxnType::READ_ONLY && classPtr->checkReadOnly(txn.getVersionId())) ||
+                    (txn.getType() == BaseTxn::TxnType::READ_WRITE && classPtr->checkReadWrite())) {
+                    continue;
                 }
+                return classPtr;
             }
         }
         return nullptr;
-
     }
 
     void Schema::erase(BaseTxn &txn, const ClassId &classId) noexcept {
@@ -97,14 +93,36 @@ namespace nogdb {
     }
 
     void Schema::forceDelete(const std::vector<ClassId> &classId) noexcept {
-        RWSpinLockGuard<RWSpinLock> _(schemaInfo.splock, RWSpinLockMode::EXCLUSIVE_SPLOCK);
-        for (const auto &cid: classId) {
-            schemaInfo.elements.erase(cid);
+        for (const auto &id: classId) {
+            if (auto classPtr = schemaInfo.find(id)) {
+                classNames.eraseUnless(classPtr->name.getStableVersion().first, id, []() { return false; });
+            }
+        }
+        schemaInfo.lockAndErase(classId);
+    }
+
+    void Schema::clearStaleVersions(TxnId versionId) {
+        for (const auto &classId: staleClassId.pop_front(versionId)) {
+            if (auto classDescriptorPtr = schemaInfo.find(classId)) {
+                classDescriptorPtr->name.clearStableVersion(versionId);
+                classDescriptorPtr->properties.clearStableVersion(versionId);
+                classDescriptorPtr->super.clearStableVersion(versionId);
+                classDescriptorPtr->sub.clearStableVersion(versionId);
+                classDescriptorPtr->compositeIndexes.clearStableVersion(versionId);
+            }
+        }
+        for (const auto &className: staleClassNames.pop_front(versionId)) {
+            classNames.eraseUnless(className.second, className.first, [&]() {
+                auto classPtr = schemaInfo.find(className.first);
+                return classPtr != nullptr && classPtr->name.getStableVersion().first == className.second;
+            });
         }
     }
 
     void Schema::clear() noexcept {
         schemaInfo.lockAndClear();
+        classNames.clear();
+        classProperties.reset(0);
     }
 
     void Schema::addProperty(BaseTxn &txn,
@@ -171,6 +189,15 @@ namespace nogdb {
         }
     }
 
+    void Schema::updateCompositeIndex(BaseTxn &txn,
+                                      const ClassId &classId,
+                                      const CompositeIndexInfo &compositeIndexInfo) {
+        if (auto classDescriptorPtr = find(txn, classId)) {
+            classDescriptorPtr->compositeIndexes.addLatestVersion(compositeIndexInfo);
+            txn.addUncommittedSchema(classDescriptorPtr);
+        }
+    }
+
     void Schema::apply(BaseTxn &txn, const InheritanceInfo &info) {
         for (const auto &inheritance: info) {
             auto subClassId = inheritance.first;
@@ -219,6 +246,18 @@ namespace nogdb {
                 classDescriptor.sub.push_back(BaseTxn::getCurrentVersion(txn, subClassDescriptorPtr->name).first);
             }
         }
+        auto propertyIdToName = std::map<PropertyId, std::string>{};
+        for (const auto &property: classDescriptor.properties) {
+            propertyIdToName.emplace(property.second.id, property.first);
+        }
+        for (const auto &compositeIndex: BaseTxn::getCurrentVersion(txn, compositeIndexes).first) {
+            auto propertyNames = std::vector<std::string>{};
+            for (const auto &propertyId: compositeIndex.second.propertyIds) {
+                propertyNames.push_back(propertyIdToName[propertyId]);
+            }
+            classDescriptor.compositeIndexInfo.emplace(
+                    compositeIndex.first, std::make_pair(propertyNames, compositeIndex.second.isUnique));
+        }
         return classDescriptor;
     }
 
@@ -233,19 +272,17 @@ namespace nogdb {
                 }
             }
         }
-        RWSpinLockGuard<RWSpinLock> _(schemaInfo.splock);
-        for (const auto &element: schemaInfo.elements) {
-            if (auto classDescPtr = element.second) {
-                if ((txn.getType() == BaseTxn::TxnType::READ_ONLY && classDescPtr->checkReadOnly(txn.getVersionId())) ||
-                    (txn.getType() == BaseTxn::TxnType::READ_WRITE && classDescPtr->checkReadWrite())) {
-                    continue;
-                }
-                auto className = BaseTxn::getCurrentVersion(txn, classDescPtr->name).first;
-                if (!className.empty()) {
-                    result.emplace(className, classDescPtr);
-                }
+        schemaInfo.forEach([&](const ClassId &, const ClassDescriptorPtr &classDescPtr) {
+            if (classDescPtr == nullptr ||
+                (txn.getType() == BaseTxn::TxnType::READ_ONLY && classDescPtr->checkReadOnly(txn.getVersionId())) ||
+                (txn.getType() == BaseTxn::TxnType::READ_WRITE && classDescPtr->checkReadWrite())) {
+                return;
             }
-        }
+            auto className = BaseTxn::getCurrentVersion(txn, classDescPtr->name).first;
+            if (!className.empty()) {
+                result.emplace(className, classDescPtr);
+            }
+        });
         return result;
     }
 
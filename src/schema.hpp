@@ -22,8 +22,12 @@
 #ifndef __SCHEMA_HPP_INCLUDED_
 #define __SCHEMA_HPP_INCLUDED_
 
+#include <algorithm>
 #include <map>
 #include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "spinlock.hpp"
 #include "concurrent.hpp"
@@ -35,6 +39,8 @@ namespace nogdb {
 
     class BaseTxn;
 
+    struct ClassPropertyInfo;
+
     struct Schema {
         Schema() = default;
 
@@ -61,13 +67,20 @@ namespace nogdb {
         };
 
         typedef std::map<std::string, PropertyDescriptor> ClassProperty;
+
+        struct CompositeIndexDescriptor {
+            std::vector<PropertyId> propertyIds{};
+            bool isUnique{false};
+        };
+
+        typedef std::map<IndexId, CompositeIndexDescriptor> CompositeIndexInfo;
         typedef std::vector<std::pair<ClassId, ClassId>> InheritanceInfo;
 
         template<typename Key, typename T>
         using SchemaElements = std::map<Key, std::shared_ptr<T>>;
 
         template<typename Key, typename T>
-        using ConcurrentSchemaElements = ConcurrentHashMap<SchemaElements<Key, T>, Key, T>;
+        using ConcurrentSchemaElements = ConcurrentHashMap<Key, T>;
 
         struct ClassDescriptor : public TxnObject {
             ClassDescriptor() = default;
@@ -89,12 +102,108 @@ namespace nogdb {
             VersionControl<ClassProperty> properties{};
             VersionControl<std::weak_ptr<ClassDescriptor>> super{};
             VersionControl<std::vector<std::weak_ptr<ClassDescriptor>>> sub{};
+            VersionControl<CompositeIndexInfo> compositeIndexes{};
         };
 
         typedef std::shared_ptr<ClassDescriptor> ClassDescriptorPtr;
 
+        // committed names of classes mapped to their ids for lookups by name
+        // NOTE: an old name of a renamed class is kept until no txn can see it, so a found id is only a candidate
+        // which has to be checked against the version of a name seen by a txn
+        class ClassNameIndex {
+        public:
+            std::vector<ClassId> find(const std::string &className) const {
+                RWSpinLockGuard<RWSpinLock> _(splock);
+                auto iter = classIds.find(className);
+                return (iter == classIds.cend()) ? std::vector<ClassId>{} : iter->second;
+            }
+
+            void insert(const std::string &className, const ClassId &classId) {
+                RWSpinLockGuard<RWSpinLock> _(splock, RWSpinLockMode::EXCLUSIVE_SPLOCK);
+                auto &ids = classIds[className];
+                if (std::find(ids.cbegin(), ids.cend(), classId) == ids.cend()) {
+                    ids.emplace_back(classId);
+                }
+            }
+
+            // erase a class id from a name unless the class still has that name, which is checked while
+            // no other names can be inserted
+            template<typename Predicate>
+            void eraseUnless(const std::string &className, const ClassId &classId, Predicate &&isStillNamed) {
+                RWSpinLockGuard<RWSpinLock> _(splock, RWSpinLockMode::EXCLUSIVE_SPLOCK);
+                auto iter = classIds.find(className);
+                if (iter == classIds.end() || isStillNamed()) {
+                    return;
+                }
+                auto &ids = iter->second;
+                ids.erase(std::remove(ids.begin(), ids.end(), classId), ids.end());
+                if (ids.empty()) {
+                    classIds.erase(iter);
+                }
+            }
+
+            void clear() {
+                RWSpinLockGuard<RWSpinLock> _(splock, RWSpinLockMode::EXCLUSIVE_SPLOCK);
+                classIds.clear();
+            }
+
+        private:
+            mutable RWSpinLock splock{};
+            std::unordered_map<std::string, std::vector<ClassId>> classIds{};
+        };
+
+        // resolved property layouts of classes (including inherited properties) indexed by class id
+        // NOTE: the table belongs to the latest committed schema version and is emptied whenever a schema change
+        // is committed, so an entry can only be used by txns which see that version of the schema
+        class ClassPropertyTable {
+        public:
+            typedef std::shared_ptr<const ClassPropertyInfo> Entry;
+
+            TxnId getVersionId() const {
+                RWSpinLockGuard<RWSpinLock> _(splock);
+                return versionId;
+            }
+
+            Entry find(TxnId schemaVersionId, const ClassId &classId) const {
+                RWSpinLockGuard<RWSpinLock> _(splock);
+                if (schemaVersionId != versionId || classId >= entries.size()) {
+                    return nullptr;
+                }
+                return entries[classId];
+            }
+
+            void insert(TxnId schemaVersionId, const ClassId &classId, const Entry &entry) {
+                RWSpinLockGuard<RWSpinLock> _(splock, RWSpinLockMode::EXCLUSIVE_SPLOCK);
+                // an entry resolved against a schema version which has just been superseded is dropped
+                if (schemaVersionId != versionId) {
+                    return;
+                }
+                if (classId >= entries.size()) {
+                    entries.resize(classId + size_t{1});
+                }
+                entries[classId] = entry;
+            }
+
+            void reset(TxnId schemaVersionId) {
+                RWSpinLockGuard<RWSpinLock> _(splock, RWSpinLockMode::EXCLUSIVE_SPLOCK);
+                versionId = schemaVersionId;
+                entries.clear();
+            }
+
+        private:
+            mutable RWSpinLock splock{};
+            TxnId versionId{0};
+            std::vector<Entry> entries{};
+        };
+
         ConcurrentSchemaElements<ClassId, ClassDescriptor> schemaInfo;
+        ClassNameIndex classNames;
+        ClassPropertyTable classProperties;
+        // old names of renamed classes which can be dropped from the name index once no txn can see them
+        ConcurrentDeleteQueue<std::pair<ClassId, std::string>> staleClassNames;
         ConcurrentDeleteQueue<ClassId> deletedClassId;
+        // classes whose older versions can be reclaimed once no txn can see them
+        ConcurrentDeleteQueue<ClassId> staleClassId;
 
         std::map<std::string, std::weak_ptr<ClassDescriptor>> getNameToDescMapping(const BaseTxn &txn);
 
@@ -127,11 +236,16 @@ namespace nogdb {
         void updateProperty(BaseTxn &txn, const ClassId &classId, const std::string &propertyName,
                             const PropertyDescriptor &propertyDescriptor);
 
+        void updateCompositeIndex(BaseTxn &txn, const ClassId &classId, const CompositeIndexInfo &compositeIndexInfo);
+
         void apply(BaseTxn &txn, const InheritanceInfo &info);
 
         inline void clearDeletedElements(TxnId versionId) {
             forceDelete(deletedClassId.pop_front(versionId));
         }
+
+        // drop versions of class descriptors which are superseded for every txn since versionId
+        void clearStaleVersions(TxnId versionId);
     };
 
     struct ClassPropertyInfo {
@@ -153,6 +267,7 @@ namespace nogdb {
         ClassId id;
         std::string name;
         ClassPropertyInfo propertyInfo;
+        Schema::CompositeIndexInfo compositeIndexInfo;
     };
 
 
@@ -0,0 +1,286 @@
+/*
+ *  Copyright (C) 2018, Throughwave (Thailand) Co., Ltd.
+ *  <peerawich at throughwave dot co dot th>
+ *
+ *  This file is part of libnogdb, the NogDB core library in C++.
+ *
+ *  libnogdb is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef __SLAB_ALLOCATOR_HPP_INCLUDED_
+#define __SLAB_ALLOCATOR_HPP_INCLUDED_
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include "constant.hpp"
+#include "spinlock.hpp"
+
+namespace nogdb {
+
+    // A pool of fixed-size blocks which are carved out of large slabs. Every thread keeps a cache of free blocks
+    // so that most allocations and deallocations do not take the lock of the shared free list, and blocks are moved
+    // between a cache and the shared free list in batches of SLAB_CACHE_NUM_BLOCKS.
+    // Slabs whose blocks are all in the shared free list are released when it grows beyond a trim threshold.
+    template<size_t BlockSize, size_t BlockAlign>
+    class SlabPool {
+    public:
+        SlabPool(const SlabPool &) = delete;
+
+        SlabPool &operator=(const SlabPool &) = delete;
+
+        static SlabPool &instance() {
+            // never destroyed because graph objects may outlive any static object
+            static SlabPool *pool = new SlabPool{};
+            return *pool;
+        }
+
+        void *allocate() {
+            auto &cache = threadCache();
+            if (cache.isDestroyed) {
+                // a block taken while its thread is exiting comes straight from the shared free list
+                SpinLockGuard<SpinLock> _(spinlock_);
+                if (freeList_ == nullptr) {
+                    grow();
+                }
+                auto block = freeList_;
+                freeList_ = block->next;
+                --numFreeBlocks_;
+                return block;
+            }
+            if (cache.freeList == nullptr) {
+                fill(cache);
+            }
+            auto block = cache.freeList;
+            cache.freeList = block->next;
+            --cache.numBlocks;
+            return block;
+        }
+
+        void deallocate(void *ptr) noexcept {
+            auto block = static_cast<Block *>(ptr);
+            auto &cache = threadCache();
+            if (cache.isDestroyed) {
+                // a block released while its thread is exiting goes straight to the shared free list
+                SpinLockGuard<SpinLock> _(spinlock_);
+                block->next = freeList_;
+                freeList_ = block;
+                ++numFreeBlocks_;
+                return;
+            }
+            block->next = cache.freeList;
+            cache.freeList = block;
+            if (++cache.numBlocks >= 2 * SLAB_CACHE_NUM_BLOCKS) {
+                flush(cache, SLAB_CACHE_NUM_BLOCKS);
+            }
+        }
+
+        // return all free blocks cached by the calling thread to the shared free list
+        void flushThreadCache() noexcept {
+            auto &cache = threadCache();
+            flush(cache, cache.numBlocks);
+        }
+
+        // release slabs without any blocks in use or in a thread cache
+        void trimSlabs() noexcept {
+            SpinLockGuard<SpinLock> _(spinlock_);
+            trim();
+        }
+
+        size_t getNumSlabs() {
+            SpinLockGuard<SpinLock> _(spinlock_);
+            return slabs_.size();
+        }
+
+    private:
+        union Block {
+            Block *next;
+            alignas(BlockAlign) unsigned char data[BlockSize];
+        };
+
+        // NOTE: isDestroyed is still read after the destructor of a cache has run if a block is allocated or
+        // freed by a destructor of another thread-local object later in the same thread
+        struct ThreadCache {
+            ~ThreadCache() noexcept {
+                SlabPool::instance().flush(*this, numBlocks);
+                isDestroyed = true;
+            }
+
+            Block *freeList{nullptr};
+            size_t numBlocks{0};
+            bool isDestroyed{false};
+        };
+
+        SpinLock spinlock_{};
+        Block *freeList_{nullptr};
+        size_t numFreeBlocks_{0};
+        size_t trimNumBlocks_{SLAB_TRIM_NUM_BLOCKS};
+        // ordered by their addresses so that a slab of a block can be found by a binary search
+        std::vector<std::unique_ptr<Block[]>> slabs_{};
+
+        SlabPool() = default;
+
+        static ThreadCache &threadCache() {
+            static thread_local ThreadCache cache{};
+            return cache;
+        }
+
+        void fill(ThreadCache &cache) {
+            SpinLockGuard<SpinLock> _(spinlock_);
+            if (numFreeBlocks_ < SLAB_CACHE_NUM_BLOCKS) {
+                grow();
+            }
+            auto last = freeList_;
+            for (auto i = size_t{1}; i < SLAB_CACHE_NUM_BLOCKS; ++i) {
+                last = last->next;
+            }
+            cache.freeList = freeList_;
+            cache.numBlocks = SLAB_CACHE_NUM_BLOCKS;
+            freeList_ = last->next;
+            last->next = nullptr;
+            numFreeBlocks_ -= SLAB_CACHE_NUM_BLOCKS;
+        }
+
+        void flush(ThreadCache &cache, size_t numBlocks) noexcept {
+            if (numBlocks == 0) {
+                return;
+            }
+            // the first blocks in a cache are the most recently freed ones, so the last blocks are moved
+            auto prev = static_cast<Block *>(nullptr);
+            auto first = cache.freeList;
+            for (auto i = numBlocks; i < cache.numBlocks; ++i) {
+                prev = first;
+                first = first->next;
+            }
+            auto last = first;
+            for (auto i = size_t{1}; i < numBlocks; ++i) {
+                last = last->next;
+            }
+            if (prev == nullptr) {
+                cache.freeList = nullptr;
+            } else {
+                prev->next = nullptr;
+            }
+            cache.numBlocks -= numBlocks;
+            SpinLockGuard<SpinLock> _(spinlock_);
+            last->next = freeList_;
+            freeList_ = first;
+            numFreeBlocks_ += numBlocks;
+            if (numFreeBlocks_ >= trimNumBlocks_) {
+                trim();
+            }
+        }
+
+        void grow() {
+            auto slab = std::unique_ptr<Block[]>(new Block[SLAB_NUM_BLOCKS]);
+            for (auto i = size_t{0}; i < SLAB_NUM_BLOCKS; ++i) {
+                slab[i].next = (i + 1 < SLAB_NUM_BLOCKS) ? &slab[i + 1] : freeList_;
+            }
+            freeList_ = &slab[0];
+            numFreeBlocks_ += SLAB_NUM_BLOCKS;
+            auto position = std::upper_bound(slabs_.begin(), slabs_.end(), slab,
+                                             [](const std::unique_ptr<Block[]> &lhs,
+                                                const std::unique_ptr<Block[]> &rhs) {
+                                                 return lhs.get() < rhs.get();
+                                             });
+            slabs_.insert(position, std::move(slab));
+        }
+
+        // release slabs without any blocks in use, where the next trim is deferred until the shared free list
+        // doubles so that a pool of blocks mostly in use is not walked on every flush
+        void trim() noexcept {
+            auto findSlab = [this](const Block *block) {
+                auto position = std::upper_bound(slabs_.begin(), slabs_.end(), block,
+                                                 [](const Block *lhs, const std::unique_ptr<Block[]> &rhs) {
+                                                     return lhs < rhs.get();
+                                                 });
+                return static_cast<size_t>(position - slabs_.begin()) - 1;
+            };
+            auto numSlabFreeBlocks = std::vector<size_t>{};
+            try {
+                numSlabFreeBlocks.resize(slabs_.size());
+            } catch (...) {
+                // slabs are kept until the next trim
+                return;
+            }
+            for (auto block = freeList_; block != nullptr; block = block->next) {
+                ++numSlabFreeBlocks[findSlab(block)];
+            }
+            auto next = &freeList_;
+            while (*next != nullptr) {
+                if (numSlabFreeBlocks[findSlab(*next)] == SLAB_NUM_BLOCKS) {
+                    *next = (*next)->next;
+                } else {
+                    next = &(*next)->next;
+                }
+            }
+            auto numReleasedSlabs = size_t{0};
+            for (auto i = size_t{0}; i < slabs_.size(); ++i) {
+                if (numSlabFreeBlocks[i] == SLAB_NUM_BLOCKS) {
+                    slabs_[i].reset();
+                    ++numReleasedSlabs;
+                }
+            }
+            slabs_.erase(std::remove(slabs_.begin(), slabs_.end(), nullptr), slabs_.end());
+            numFreeBlocks_ -= numReleasedSlabs * SLAB_NUM_BLOCKS;
+            trimNumBlocks_ = std::max(SLAB_TRIM_NUM_BLOCKS, 2 * numFreeBlocks_);
+        }
+    };
+
+    // A standard allocator which takes single objects from a slab pool of their size (e.g. for std::allocate_shared)
+    // NOTE: with std::allocate_shared a block holds the object along with its control block, so it is deallocated
+    // when the last weak_ptr expires rather than when the object is destroyed
+    template<typename T>
+    class SlabAllocator {
+    public:
+        typedef T value_type;
+
+        SlabAllocator() = default;
+
+        template<typename U>
+        SlabAllocator(const SlabAllocator<U> &) noexcept {}
+
+        T *allocate(size_t n) {
+            if (n != 1) {
+                return static_cast<T *>(::operator new(n * sizeof(T)));
+            }
+            return static_cast<T *>(SlabPool<sizeof(T), alignof(T)>::instance().allocate());
+        }
+
+        void deallocate(T *ptr, size_t n) noexcept {
+            if (n != 1) {
+                ::operator delete(ptr);
+            } else {
+                SlabPool<sizeof(T), alignof(T)>::instance().deallocate(ptr);
+            }
+        }
+
+        template<typename U>
+        bool operator==(const SlabAllocator<U> &) const noexcept {
+            return true;
+        }
+
+        template<typename U>
+        bool operator!=(const SlabAllocator<U> &) const noexcept {
+            return false;
+        }
+    };
+
+}
+
+#endif
@@ -22,18 +22,41 @@
 #ifndef __SPINLOCK_HPP_INCLUDED_
 #define __SPINLOCK_HPP_INCLUDED_
 
+#include <array>
 #include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdint>
 #include <thread>
 
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "constant.hpp"
+
 namespace nogdb {
 
+    // a hint to the processor inside a busy-waiting loop (only a compiler barrier on unknown architectures)
+    inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+        asm volatile("pause\n": : :"memory");
+#elif defined(__aarch64__)
+        asm volatile("yield\n": : :"memory");
+#else
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+    }
+
     class SpinLock {
     public:
         SpinLock() = default;
 
         void acquireLock() {
             while (lock.test_and_set(std::memory_order_acquire)) {
-                asm volatile("pause\n": : :"memory");
+                cpuRelax();
             }
         }
 
@@ -131,6 +154,249 @@ namespace nogdb {
         std::atomic<bool> isWriting{false};
     };
 
+    // statistics of lock acquisitions where the wait time is only measured for contended ones
+    struct LockStat {
+        uint64_t numAcquisitions{0};
+        uint64_t numContentions{0};
+        uint64_t waitNanoseconds{0};
+    };
+
+    // A reader-writer lock which spins for a while and then parks waiting threads on a futex.
+    // Readers are counted in one of several cache lines chosen per thread so that they do not bounce
+    // a single counter between cores, and a pending writer holds off new readers so that it cannot starve.
+    // A thread which already holds a shared lock may take it again even if a writer is pending, since the writer
+    // would otherwise wait for that thread forever, but it must not take the exclusive lock while reading.
+    // NOTE: it is much larger than RWSpinLock, so it suits a few hot locks rather than a lock per object, and only
+    // ADAPTIVE_RWLOCK_MAX_HELD_SHARED shared locks held by a thread at the same time are known to be re-entered
+    class AdaptiveRWLock {
+    public:
+        AdaptiveRWLock() = default;
+
+        AdaptiveRWLock(const AdaptiveRWLock &) = delete;
+
+        AdaptiveRWLock &operator=(const AdaptiveRWLock &) = delete;
+
+        void lock() {
+            auto delayCount = 0U;
+            auto startTime = std::chrono::steady_clock::time_point{};
+            while (!tryLockWriting()) {
+                startWaiting(delayCount, startTime);
+                waitForWriter(delayCount);
+            }
+            while (hasReaders()) {
+                startWaiting(delayCount, startTime);
+                if (++delayCount > SPINLOCK_MAXCOUNT_DELAY) {
+                    std::this_thread::yield();
+                } else {
+                    cpuRelax();
+                }
+            }
+            numWriterAcquisitions_.fetch_add(1U, std::memory_order_relaxed);
+            recordWaiting(delayCount, startTime);
+        }
+
+        bool tryLock() {
+            if (!tryLockWriting()) {
+                return false;
+            }
+            if (hasReaders()) {
+                unlock();
+                return false;
+            }
+            numWriterAcquisitions_.fetch_add(1U, std::memory_order_relaxed);
+            return true;
+        }
+
+        void unlock() {
+            isWriting_.store(0);
+            if (numParked_.load() > 0) {
+                wakeAll();
+            }
+        }
+
+        void lockShared() {
+            auto &readerCount = readerCounts_[readerStripe()];
+            if (reenterShared(readerCount)) {
+                return;
+            }
+            auto delayCount = 0U;
+            auto startTime = std::chrono::steady_clock::time_point{};
+            while (!tryLockShared(readerCount)) {
+                startWaiting(delayCount, startTime);
+                waitForWriter(delayCount);
+            }
+            addHeldShared();
+            recordWaiting(delayCount, startTime);
+        }
+
+        bool tryLockShared() {
+            auto &readerCount = readerCounts_[readerStripe()];
+            if (reenterShared(readerCount)) {
+                return true;
+            }
+            if (!tryLockShared(readerCount)) {
+                return false;
+            }
+            addHeldShared();
+            return true;
+        }
+
+        void unlockShared() {
+            removeHeldShared();
+            readerCounts_[readerStripe()].numReaders.fetch_sub(1U, std::memory_order_release);
+        }
+
+        LockStat getStat() const {
+            auto stat = LockStat{};
+            stat.numAcquisitions = numWriterAcquisitions_.load(std::memory_order_relaxed);
+            for (const auto &readerCount: readerCounts_) {
+                stat.numAcquisitions += readerCount.numAcquisitions.load(std::memory_order_relaxed);
+            }
+            stat.numContentions = numContentions_.load(std::memory_order_relaxed);
+            stat.waitNanoseconds = waitNanoseconds_.load(std::memory_order_relaxed);
+            return stat;
+        }
+
+    private:
+        struct HeldShared {
+            const AdaptiveRWLock *lock;
+            uint32_t depth;
+        };
+
+        struct HeldSharedLocks {
+            std::array<HeldShared, ADAPTIVE_RWLOCK_MAX_HELD_SHARED> locks;
+            size_t numLocks;
+        };
+
+        struct ReaderCount {
+            std::atomic<uint32_t> numReaders{0};
+            std::atomic<uint64_t> numAcquisitions{0};
+            char padding[CACHE_LINE_SIZE - sizeof(std::atomic<uint32_t>) - sizeof(std::atomic<uint64_t>)];
+        };
+
+        std::array<ReaderCount, ADAPTIVE_RWLOCK_NUM_STRIPES> readerCounts_{};
+        std::atomic<uint32_t> isWriting_{0}; // a futex word
+        std::atomic<uint32_t> numParked_{0};
+        std::atomic<uint64_t> numWriterAcquisitions_{0};
+        std::atomic<uint64_t> numContentions_{0};
+        std::atomic<uint64_t> waitNanoseconds_{0};
+
+        // a stripe is fixed per thread so that a reader always releases the counter it has taken
+        static size_t readerStripe() {
+            static std::atomic<size_t> nextStripe{0};
+            static thread_local const size_t stripe = nextStripe.fetch_add(1U) % ADAPTIVE_RWLOCK_NUM_STRIPES;
+            return stripe;
+        }
+
+        static HeldSharedLocks &heldSharedLocks() {
+            static thread_local HeldSharedLocks heldShared{};
+            return heldShared;
+        }
+
+        HeldShared *findHeldShared() const {
+            auto &heldShared = heldSharedLocks();
+            for (auto i = size_t{0}; i < heldShared.numLocks; ++i) {
+                if (heldShared.locks[i].lock == this) {
+                    return &heldShared.locks[i];
+                }
+            }
+            return nullptr;
+        }
+
+        // a reader which is already in does not have to wait for a pending writer
+        bool reenterShared(ReaderCount &readerCount) {
+            if (auto held = findHeldShared()) {
+                ++held->depth;
+                readerCount.numReaders.fetch_add(1U);
+                readerCount.numAcquisitions.fetch_add(1U, std::memory_order_relaxed);
+                return true;
+            }
+            return false;
+        }
+
+        void addHeldShared() {
+            auto &heldShared = heldSharedLocks();
+            if (heldShared.numLocks < heldShared.locks.size()) {
+                heldShared.locks[heldShared.numLocks++] = HeldShared{this, 1U};
+            }
+        }
+
+        void removeHeldShared() {
+            if (auto held = findHeldShared()) {
+                if (--held->depth == 0) {
+                    auto &heldShared = heldSharedLocks();
+                    *held = heldShared.locks[--heldShared.numLocks];
+                }
+            }
+        }
+
+        bool tryLockWriting() {
+            auto notWriting = uint32_t{0};
+            return isWriting_.compare_exchange_strong(notWriting, 1U);
+        }
+
+        bool hasReaders() const {
+            for (const auto &readerCount: readerCounts_) {
+                if (readerCount.numReaders.load() > 0) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool tryLockShared(ReaderCount &readerCount) {
+            if (isWriting_.load(std::memory_order_acquire)) {
+                return false;
+            }
+            readerCount.numReaders.fetch_add(1U);
+            if (isWriting_.load()) {
+                readerCount.numReaders.fetch_sub(1U, std::memory_order_release);
+                return false;
+            }
+            readerCount.numAcquisitions.fetch_add(1U, std::memory_order_relaxed);
+            return true;
+        }
+
+        void waitForWriter(unsigned int &delayCount) {
+            if (++delayCount > SPINLOCK_MAXCOUNT_DELAY) {
+                // the writer is still busy after spinning for a while, so sleep until it unlocks
+                ++numParked_;
+#ifdef __linux__
+                syscall(SYS_futex, reinterpret_cast<uint32_t *>(&isWriting_), FUTEX_WAIT_PRIVATE, 1U,
+                        nullptr, nullptr, 0);
+#else
+                std::this_thread::yield();
+#endif
+                --numParked_;
+            } else {
+                cpuRelax();
+            }
+        }
+
+        void wakeAll() {
+#ifdef __linux__
+            syscall(SYS_futex, reinterpret_cast<uint32_t *>(&isWriting_), FUTEX_WAKE_PRIVATE, INT_MAX,
+                    nullptr, nullptr, 0);
+#endif
+        }
+
+        static void startWaiting(unsigned int delayCount, std::chrono::steady_clock::time_point &startTime) {
+            if (delayCount == 0) {
+                startTime = std::chrono::steady_clock::now();
+            }
+        }
+
+        void recordWaiting(unsigned int delayCount, const std::chrono::steady_clock::time_point &startTime) {
+            if (delayCount > 0) {
+                auto waitTime = std::chrono::steady_clock::now() - startTime;
+                numContentions_.fetch_add(1U, std::memory_order_relaxed);
+                waitNanoseconds_.fetch_add(static_cast<uint64_t>(
+                        std::chrono::duration_cast<std::chrono::nanoseconds>(waitTime).count()),
+                        std::memory_order_relaxed);
+            }
+        }
+    };
+
     enum RWSpinLockMode {
         SHARED_SPLOCK = 0, EXCLUSIVE_SPLOCK = 1
     };
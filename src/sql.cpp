@@ -20,6 +20,7 @@
  */
 
 #include <cassert>
+#include <functional>
 #include <cstring>
 
 #include "constant.hpp"
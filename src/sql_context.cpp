@@ -20,6 +20,7 @@
  */
 
 #include <cassert>
+#include <functional>
 
 #include "constant.hpp"
 #include "sql.hpp"
@@ -0,0 +1,98 @@
+/*
+ *  Copyright (C) 2018, Throughwave (Thailand) Co., Ltd.
+ *  <peerawich at throughwave dot co dot th>
+ *
+ *  This file is part of libnogdb, the NogDB core library in C++.
+ *
+ *  libnogdb is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <algorithm>
+#include <cctype>
+
+#include "text_matcher.hpp"
+#include "text_search.hpp"
+
+namespace nogdb {
+
+    namespace {
+
+        inline char foldCase(unsigned char c) {
+            return static_cast<char>(::tolower(c));
+        }
+
+    }
+
+    TextMatcher::TextMatcher(Kind kind_, const std::string &pattern_, bool isIgnoreCase_)
+            : kind{kind_}, isIgnoreCase{isIgnoreCase_}, pattern{pattern_} {
+        if (isIgnoreCase && !pattern.empty()) {
+            TextSearch::toLower(reinterpret_cast<unsigned char *>(&pattern[0]), pattern.size());
+        }
+        if (kind == Kind::LIKE) {
+            // consecutive '%' are equivalent to a single one
+            pattern.erase(std::unique(pattern.begin(), pattern.end(), [](char lhs, char rhs) {
+                return lhs == '%' && rhs == '%';
+            }), pattern.end());
+        } else {
+            regex = std::regex(pattern);
+        }
+    }
+
+    bool TextMatcher::match(const unsigned char *value, size_t size) const {
+        if (kind == Kind::LIKE) {
+            return matchLike(value, size);
+        }
+        auto text = std::string{reinterpret_cast<const char *>(value), size};
+        if (isIgnoreCase && !text.empty()) {
+            TextSearch::toLower(reinterpret_cast<unsigned char *>(&text[0]), text.size());
+        }
+        return std::regex_match(text, regex);
+    }
+
+    bool TextMatcher::matchLike(const unsigned char *value, size_t size) const {
+        const auto patternSize = pattern.size();
+        auto patternPos = size_t{0};
+        auto valuePos = size_t{0};
+        // on a mismatch, let the latest '%' absorb one more character and retry from there
+        auto starPos = std::string::npos;
+        auto starValuePos = size_t{0};
+        while (valuePos < size) {
+            if (patternPos < patternSize) {
+                auto p = pattern[patternPos];
+                if (p == '%') {
+                    starPos = patternPos++;
+                    starValuePos = valuePos;
+                    continue;
+                }
+                auto c = isIgnoreCase ? foldCase(value[valuePos]) : static_cast<char>(value[valuePos]);
+                if (p == '_' || p == c) {
+                    ++patternPos;
+                    ++valuePos;
+                    continue;
+                }
+            }
+            if (starPos == std::string::npos) {
+                return false;
+            }
+            patternPos = starPos + 1;
+            valuePos = ++starValuePos;
+        }
+        while (patternPos < patternSize && pattern[patternPos] == '%') {
+            ++patternPos;
+        }
+        return patternPos == patternSize;
+    }
+
+}
@@ -0,0 +1,56 @@
+/*
+ *  Copyright (C) 2018, Throughwave (Thailand) Co., Ltd.
+ *  <peerawich at throughwave dot co dot th>
+ *
+ *  This file is part of libnogdb, the NogDB core library in C++.
+ *
+ *  libnogdb is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef __TEXT_MATCHER_HPP_INCLUDED_
+#define __TEXT_MATCHER_HPP_INCLUDED_
+
+#include <string>
+#include <regex>
+
+namespace nogdb {
+
+    // a LIKE or REGEX pattern compiled once per condition and shared by every copy of it
+    class TextMatcher {
+    public:
+        enum class Kind {
+            LIKE, REGEX
+        };
+
+        // throws std::regex_error if a REGEX pattern is malformed
+        TextMatcher(Kind kind_, const std::string &pattern_, bool isIgnoreCase_);
+
+        ~TextMatcher() noexcept = default;
+
+        bool match(const unsigned char *value, size_t size) const;
+
+    private:
+        Kind kind;
+        bool isIgnoreCase;
+        std::string pattern;
+        std::regex regex{};
+
+        // '%' matches any sequence of characters and '_' matches a single character
+        bool matchLike(const unsigned char *value, size_t size) const;
+    };
+
+}
+
+#endif
@@ -0,0 +1,227 @@
+/*
+ *  Copyright (C) 2018, Throughwave (Thailand) Co., Ltd.
+ *  <peerawich at throughwave dot co dot th>
+ *
+ *  This file is part of libnogdb, the NogDB core library in C++.
+ *
+ *  libnogdb is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "text_search.hpp"
+
+namespace nogdb {
+
+    namespace {
+
+        inline unsigned char foldCase(unsigned char c) {
+            return (static_cast<unsigned char>(c - 'A') < 26) ? static_cast<unsigned char>(c | 0x20) : c;
+        }
+
+#if defined(__AVX2__)
+        const size_t BLOCK_SIZE = 32;
+
+        typedef __m256i Block;
+
+        inline Block loadBlock(const unsigned char *p) {
+            return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+        }
+
+        inline Block fillBlock(unsigned char c) {
+            return _mm256_set1_epi8(static_cast<char>(c));
+        }
+
+        inline unsigned int equalMask(const Block &lhs, const Block &rhs) {
+            return static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lhs, rhs)));
+        }
+
+        inline unsigned int bothMask(const Block &lhs1, const Block &rhs1, const Block &lhs2, const Block &rhs2) {
+            return static_cast<unsigned int>(_mm256_movemask_epi8(
+                    _mm256_and_si256(_mm256_cmpeq_epi8(lhs1, rhs1), _mm256_cmpeq_epi8(lhs2, rhs2))));
+        }
+
+        // a byte is an upper case letter if it is at most 'Z' - 'A' after subtracting 'A'
+        inline Block foldBlock(const Block &block) {
+            auto offset = _mm256_sub_epi8(block, _mm256_set1_epi8('A'));
+            auto isUpper = _mm256_cmpeq_epi8(_mm256_min_epu8(offset, _mm256_set1_epi8(25)), offset);
+            return _mm256_or_si256(block, _mm256_and_si256(isUpper, _mm256_set1_epi8(0x20)));
+        }
+
+        inline void storeBlock(unsigned char *p, const Block &block) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), block);
+        }
+
+        const unsigned int FULL_MASK = 0xffffffffu;
+#elif defined(__SSE2__)
+        const size_t BLOCK_SIZE = 16;
+
+        typedef __m128i Block;
+
+        inline Block loadBlock(const unsigned char *p) {
+            return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        }
+
+        inline Block fillBlock(unsigned char c) {
+            return _mm_set1_epi8(static_cast<char>(c));
+        }
+
+        inline unsigned int equalMask(const Block &lhs, const Block &rhs) {
+            return static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(lhs, rhs)));
+        }
+
+        inline unsigned int bothMask(const Block &lhs1, const Block &rhs1, const Block &lhs2, const Block &rhs2) {
+            return static_cast<unsigned int>(_mm_movemask_epi8(
+                    _mm_and_si128(_mm_cmpeq_epi8(lhs1, rhs1), _mm_cmpeq_epi8(lhs2, rhs2))));
+        }
+
+        // a byte is an upper case letter if it is at most 'Z' - 'A' after subtracting 'A'
+        inline Block foldBlock(const Block &block) {
+            auto offset = _mm_sub_epi8(block, _mm_set1_epi8('A'));
+            auto isUpper = _mm_cmpeq_epi8(_mm_min_epu8(offset, _mm_set1_epi8(25)), offset);
+            return _mm_or_si128(block, _mm_and_si128(isUpper, _mm_set1_epi8(0x20)));
+        }
+
+        inline void storeBlock(unsigned char *p, const Block &block) {
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(p), block);
+        }
+
+        const unsigned int FULL_MASK = 0xffffu;
+#endif
+
+        // length of the common prefix of two byte ranges with the same size
+        size_t mismatch(const unsigned char *lhs, const unsigned char *rhs, size_t size, bool isIgnoreCase) {
+            auto pos = size_t{0};
+#if defined(__AVX2__) || defined(__SSE2__)
+            for (; pos + BLOCK_SIZE <= size; pos += BLOCK_SIZE) {
+                auto lhsBlock = loadBlock(lhs + pos);
+                auto rhsBlock = loadBlock(rhs + pos);
+                auto mask = isIgnoreCase ? equalMask(foldBlock(lhsBlock), foldBlock(rhsBlock))
+                                         : equalMask(lhsBlock, rhsBlock);
+                if (mask != FULL_MASK) {
+                    return pos + static_cast<size_t>(__builtin_ctz(~mask));
+                }
+            }
+#endif
+            if (isIgnoreCase) {
+                for (; pos < size && foldCase(lhs[pos]) == foldCase(rhs[pos]); ++pos);
+            } else {
+                for (; pos < size && lhs[pos] == rhs[pos]; ++pos);
+            }
+            return pos;
+        }
+
+        inline bool equal(const unsigned char *lhs, const unsigned char *rhs, size_t size, bool isIgnoreCase) {
+            if (!isIgnoreCase) {
+                return size == 0 || memcmp(lhs, rhs, size) == 0;
+            }
+            return mismatch(lhs, rhs, size, true) == size;
+        }
+
+    }
+
+    int TextSearch::compare(const unsigned char *lhs, size_t lhsSize,
+                            const unsigned char *rhs, size_t rhsSize, bool isIgnoreCase) {
+        auto size = std::min(lhsSize, rhsSize);
+        if (!isIgnoreCase) {
+            auto result = (size > 0) ? memcmp(lhs, rhs, size) : 0;
+            if (result != 0) {
+                return result;
+            }
+        } else {
+            auto pos = mismatch(lhs, rhs, size, true);
+            if (pos < size) {
+                return (foldCase(lhs[pos]) < foldCase(rhs[pos])) ? -1 : 1;
+            }
+        }
+        return (lhsSize < rhsSize) ? -1 : ((lhsSize > rhsSize) ? 1 : 0);
+    }
+
+    size_t TextSearch::find(const unsigned char *text, size_t textSize,
+                            const unsigned char *pattern, size_t patternSize, bool isIgnoreCase) {
+        if (patternSize == 0) {
+            return 0;
+        }
+        if (patternSize > textSize) {
+            return npos;
+        }
+        const auto first = isIgnoreCase ? foldCase(pattern[0]) : pattern[0];
+        const auto last = isIgnoreCase ? foldCase(pattern[patternSize - 1]) : pattern[patternSize - 1];
+        // the first and the last bytes of a pattern filter candidates before the middle ones are compared
+        auto isCandidate = [&](size_t pos) {
+            return patternSize <= 2 || equal(text + pos + 1, pattern + 1, patternSize - 2, isIgnoreCase);
+        };
+        const auto end = textSize - patternSize + 1;
+        auto pos = size_t{0};
+#if defined(__AVX2__) || defined(__SSE2__)
+        const auto firstBlock = fillBlock(first);
+        const auto lastBlock = fillBlock(last);
+        for (; pos + BLOCK_SIZE <= end; pos += BLOCK_SIZE) {
+            auto headBlock = loadBlock(text + pos);
+            auto tailBlock = loadBlock(text + pos + patternSize - 1);
+            if (isIgnoreCase) {
+                headBlock = foldBlock(headBlock);
+                tailBlock = foldBlock(tailBlock);
+            }
+            auto mask = bothMask(headBlock, firstBlock, tailBlock, lastBlock);
+            while (mask != 0) {
+                auto candidate = pos + static_cast<size_t>(__builtin_ctz(mask));
+                if (isCandidate(candidate)) {
+                    return candidate;
+                }
+                mask &= mask - 1;
+            }
+        }
+#endif
+        for (; pos < end; ++pos) {
+            auto head = isIgnoreCase ? foldCase(text[pos]) : text[pos];
+            auto tail = isIgnoreCase ? foldCase(text[pos + patternSize - 1]) : text[pos + patternSize - 1];
+            if (head == first && tail == last && isCandidate(pos)) {
+                return pos;
+            }
+        }
+        return npos;
+    }
+
+    bool TextSearch::beginWith(const unsigned char *text, size_t textSize,
+                               const unsigned char *pattern, size_t patternSize, bool isIgnoreCase) {
+        return textSize >= patternSize && equal(text, pattern, patternSize, isIgnoreCase);
+    }
+
+    bool TextSearch::endWith(const unsigned char *text, size_t textSize,
+                             const unsigned char *pattern, size_t patternSize, bool isIgnoreCase) {
+        return textSize >= patternSize && equal(text + textSize - patternSize, pattern, patternSize, isIgnoreCase);
+    }
+
+    void TextSearch::toLower(unsigned char *text, size_t size) {
+        auto pos = size_t{0};
+#if defined(__AVX2__) || defined(__SSE2__)
+        for (; pos + BLOCK_SIZE <= size; pos += BLOCK_SIZE) {
+            storeBlock(text + pos, foldBlock(loadBlock(text + pos)));
+        }
+#endif
+        for (; pos < size; ++pos) {
+            text[pos] = foldCase(text[pos]);
+        }
+    }
+
+}
@@ -0,0 +1,56 @@
+/*
+ *  Copyright (C) 2018, Throughwave (Thailand) Co., Ltd.
+ *  <peerawich at throughwave dot co dot th>
+ *
+ *  This file is part of libnogdb, the NogDB core library in C++.
+ *
+ *  libnogdb is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef __TEXT_SEARCH_HPP_INCLUDED_
+#define __TEXT_SEARCH_HPP_INCLUDED_
+
+#include <string>
+
+namespace nogdb {
+
+    // text kernels over raw bytes; ignore-case variants fold ASCII letters only as ::tolower does in the "C" locale
+    struct TextSearch {
+        TextSearch() = delete;
+
+        ~TextSearch() noexcept = delete;
+
+        static const size_t npos = std::string::npos;
+
+        // compare two texts in the same order as std::string does
+        static int compare(const unsigned char *lhs, size_t lhsSize,
+                           const unsigned char *rhs, size_t rhsSize, bool isIgnoreCase);
+
+        // position of the first occurrence of a pattern in a text or npos
+        static size_t find(const unsigned char *text, size_t textSize,
+                           const unsigned char *pattern, size_t patternSize, bool isIgnoreCase);
+
+        static bool beginWith(const unsigned char *text, size_t textSize,
+                              const unsigned char *pattern, size_t patternSize, bool isIgnoreCase);
+
+        static bool endWith(const unsigned char *text, size_t textSize,
+                            const unsigned char *pattern, size_t patternSize, bool isIgnoreCase);
+
+        static void toLower(unsigned char *text, size_t size);
+    };
+
+}
+
+#endif
@@ -22,10 +22,14 @@
 #ifndef __TXN_OBJECT_HPP_INCLUDED_
 #define __TXN_OBJECT_HPP_INCLUDED_
 
+#include <algorithm>
+#include <array>
 #include <atomic>
+#include <map>
 #include <set>
 #include <utility>
 
+#include "constant.hpp"
 #include "spinlock.hpp"
 
 #include "nogdb_types.h"
@@ -106,44 +110,110 @@ namespace nogdb {
             return maxTxnId.fetch_add(static_cast<TxnId>(1), std::memory_order_relaxed);
         }
 
+        // NOTE: sequentially consistent so that it is ordered with registrations of readers in minActiveVersionId
         TxnId fetchAddMaxVersionId() {
-            return maxVersionId.fetch_add(static_cast<TxnId>(1), std::memory_order_relaxed);
+            return maxVersionId.fetch_add(static_cast<TxnId>(1));
         }
 
-        void addActiveTxnId(TxnId txnId, TxnId versionId) {
+        // register an active read-only txn with the latest committed version, which is returned in versionId,
+        // and return its slot for removeActiveTxnId
+        // NOTE: a txn is registered before its version is taken and the version is taken again until it is stable,
+        // so minActiveVersionId can never miss a reader and return a newer version than the one it reads
+        // NOTE: a thread mostly gets the slot it used last time so that readers rarely touch the same cache line,
+        // and the map is only used when all slots are taken
+        size_t addActiveTxnId(TxnId txnId, TxnId &versionId) {
+            auto registerVersionId = [&](TxnObject::AtomicTxnId &activeVersionId) {
+                auto latestVersionId = maxVersionId.load();
+                do {
+                    versionId = latestVersionId;
+                    activeVersionId.store(versionId);
+                    latestVersionId = maxVersionId.load();
+                } while (latestVersionId != versionId);
+            };
+            static thread_local size_t lastSlot = 0;
+            for (auto i = size_t{0}; i < ACTIVE_TXN_NUM_SLOTS; ++i) {
+                auto slot = (lastSlot + i) % ACTIVE_TXN_NUM_SLOTS;
+                auto &activeTxn = activeTxnSlots[slot];
+                auto emptyTxnId = TxnId{0};
+                if (activeTxn.txnId.load(std::memory_order_relaxed) == 0 &&
+                    activeTxn.txnId.compare_exchange_strong(emptyTxnId, txnId)) {
+                    auto numSlots = numActiveTxnSlots.load();
+                    while (numSlots <= slot && !numActiveTxnSlots.compare_exchange_weak(numSlots, slot + 1));
+                    registerVersionId(activeTxn.versionId);
+                    lastSlot = slot;
+                    return slot;
+                }
+            }
             SpinLockGuard<SpinLock> _(lockActiveTxnIds);
+            ++numOverflowTxnIds;
+            TxnObject::AtomicTxnId activeVersionId{0};
+            registerVersionId(activeVersionId);
             activeTxnIds.emplace(txnId, versionId);
+            return ACTIVE_TXN_NUM_SLOTS;
         }
 
-        void removeActiveTxnId(TxnId txnId) {
-            SpinLockGuard<SpinLock> _(lockActiveTxnIds);
-            activeTxnIds.erase(txnId);
+        void removeActiveTxnId(TxnId txnId, size_t slot) {
+            if (slot < ACTIVE_TXN_NUM_SLOTS) {
+                // a version of 0 is seen by scanners while the slot is being reused so they will never overestimate it
+                activeTxnSlots[slot].versionId.store(0);
+                activeTxnSlots[slot].txnId.store(0);
+            } else {
+                SpinLockGuard<SpinLock> _(lockActiveTxnIds);
+                activeTxnIds.erase(txnId);
+                --numOverflowTxnIds;
+            }
         }
 
         std::pair<TxnId, TxnId> minActiveTxnId() {
-            SpinLockGuard<SpinLock> _(lockActiveTxnIds);
-            auto iter = activeTxnIds.cbegin();
-            if (iter == activeTxnIds.cend()) {
-                return std::make_pair(TxnId{0}, TxnId{0});
+            auto result = std::make_pair(TxnId{0}, TxnId{0});
+            auto numSlots = numActiveTxnSlots.load();
+            for (auto slot = size_t{0}; slot < numSlots; ++slot) {
+                auto txnId = activeTxnSlots[slot].txnId.load();
+                if (txnId != 0 && (result.first == 0 || txnId < result.first)) {
+                    result = std::make_pair(txnId, activeTxnSlots[slot].versionId.load());
+                }
             }
-            return std::make_pair(iter->first, iter->second);
+            if (numOverflowTxnIds.load() > 0) {
+                SpinLockGuard<SpinLock> _(lockActiveTxnIds);
+                auto iter = activeTxnIds.cbegin();
+                if (iter != activeTxnIds.cend() && (result.first == 0 || iter->first < result.first)) {
+                    result = std::make_pair(iter->first, iter->second);
+                }
+            }
+            return result;
         }
 
-        bool isLastMinVersionId(TxnId txnId) {
-            SpinLockGuard<SpinLock> _(lockActiveTxnIds);
-            auto iter = activeTxnIds.find(txnId);
-            if (iter == activeTxnIds.cbegin()) {
-                auto version = iter->second;
-                if (++iter != activeTxnIds.cend()) {
-                    return version < iter->second;
+        // the oldest version which may be read by an active read-only txn (or the latest version if there are none)
+        // NOTE: the latest version is taken before active txns are scanned (see addActiveTxnId)
+        TxnId minActiveVersionId() {
+            auto result = maxVersionId.load();
+            auto numSlots = numActiveTxnSlots.load();
+            for (auto slot = size_t{0}; slot < numSlots; ++slot) {
+                if (activeTxnSlots[slot].txnId.load() != 0) {
+                    // a version of 0 is seen while a txn is being registered
+                    result = std::min(result, activeTxnSlots[slot].versionId.load());
+                }
+            }
+            if (numOverflowTxnIds.load() > 0) {
+                SpinLockGuard<SpinLock> _(lockActiveTxnIds);
+                for (const auto &activeTxnId: activeTxnIds) {
+                    result = std::min(result, activeTxnId.second);
                 }
-                return true;
             }
-            return false;
+            return result;
         }
 
+        struct ActiveTxnSlot {
+            TxnObject::AtomicTxnId txnId{0};
+            TxnObject::AtomicTxnId versionId{0};
+            char padding[CACHE_LINE_SIZE - 2 * sizeof(TxnObject::AtomicTxnId)];
+        };
+
         TxnObject::AtomicTxnId maxTxnId{1};
         TxnObject::AtomicTxnId maxVersionId{0};
+        std::array<ActiveTxnSlot, ACTIVE_TXN_NUM_SLOTS> activeTxnSlots{};
+        std::atomic<size_t> numActiveTxnSlots{0};
+        std::atomic<size_t> numOverflowTxnIds{0};
         SpinLock lockActiveTxnIds{};
         std::map<TxnId, TxnId> activeTxnIds{};
     };
@@ -37,6 +37,15 @@ namespace nogdb {
         }
     }
 
+    void Validate::isReadOnlyTransaction(const Txn &txn) {
+        if (txn.getTxnMode() != Txn::Mode::READ_ONLY) {
+            throw Error(TXN_INVALID_MODE, Error::Type::TRANSACTION);
+        }
+        if (!txn.txnBase->isNotCompleted()) {
+            throw Error(TXN_COMPLETED, Error::Type::TRANSACTION);
+        }
+    }
+
     void Validate::isClassNameValid(const std::string &className) {
         if (!isNameValid(className)) {
             throw Error(CTX_INVALID_CLASSNAME, Error::Type::CONTEXT);
@@ -160,6 +169,22 @@ namespace nogdb {
             }
         }
     }
+
+    void Validate::isNotUsedInCompositeIndex(const BaseTxn &txn,
+                                             const std::shared_ptr<Schema::ClassDescriptor> &classDescriptor,
+                                             const PropertyId &propertyId) {
+        for (const auto &compositeIndex: BaseTxn::getCurrentVersion(txn, classDescriptor->compositeIndexes).first) {
+            auto &propertyIds = compositeIndex.second.propertyIds;
+            if (std::find(propertyIds.cbegin(), propertyIds.cend(), propertyId) != propertyIds.cend()) {
+                throw Error(CTX_IN_USED_PROPERTY, Error::Type::CONTEXT);
+            }
+        }
+        for (const auto &subClassDescriptor: BaseTxn::getCurrentVersion(txn, classDescriptor->sub).first) {
+            if (auto subClassDescriptorPtr = subClassDescriptor.lock()) {
+                isNotUsedInCompositeIndex(txn, subClassDescriptorPtr, propertyId);
+            }
+        }
+    }
 }
 
 
@@ -38,6 +38,8 @@ namespace nogdb {
 
         static void isTransactionValid(const Txn &txn);
 
+        static void isReadOnlyTransaction(const Txn &txn);
+
         static void isClassNameValid(const std::string &className);
 
         static void isPropertyNameValid(const std::string &propName);
@@ -70,6 +72,10 @@ namespace nogdb {
         static void isNotOverridenProperty(const BaseTxn &txn,
                                            const std::shared_ptr<Schema::ClassDescriptor> &classDescriptor,
                                            const std::string &propertyName);
+
+        static void isNotUsedInCompositeIndex(const BaseTxn &txn,
+                                              const std::shared_ptr<Schema::ClassDescriptor> &classDescriptor,
+                                              const PropertyId &propertyId);
     };
 }
 
@@ -31,7 +31,7 @@
 
 namespace nogdb {
 
-    template<typename T>
+    template<typename T, typename LockT = RWSpinLock>
     class VersionControl {
     public:
         enum Status {
@@ -63,7 +63,7 @@ namespace nogdb {
 
         void deleteLatestVersion() {
             if (unstableVersion_.second == INVISIBLE) {
-                RWSpinLockGuard<RWSpinLock> _(spinlock_);
+                RWSpinLockGuard<LockT> _(spinlock_);
                 auto it = stableVersions_.rbegin();
                 if (it != stableVersions_.crend()) {
                     unstableVersion_ = std::make_pair(ControlObject{it->object}, VISIBLE);
@@ -78,7 +78,7 @@ namespace nogdb {
                     return std::make_pair(unstableVersion_.first.object, true);
                 }
             } else {
-                RWSpinLockGuard<RWSpinLock> _(spinlock_);
+                RWSpinLockGuard<LockT> _(spinlock_);
                 auto it = stableVersions_.rbegin();
                 if (it != stableVersions_.crend()) {
                     if (it->status == ACTIVE) {
@@ -99,7 +99,7 @@ namespace nogdb {
         }
 
         std::pair<T, bool> getStableVersion() const {
-            RWSpinLockGuard<RWSpinLock> _(spinlock_);
+            RWSpinLockGuard<LockT> _(spinlock_);
             auto it = stableVersions_.rbegin();
             if (it != stableVersions_.rend()) {
                 return std::make_pair(it->object, it->status == ACTIVE);
@@ -108,7 +108,7 @@ namespace nogdb {
         };
 
         std::pair<T, bool> getStableVersion(TxnId currentVersionId) const {
-            RWSpinLockGuard<RWSpinLock> _(spinlock_);
+            RWSpinLockGuard<LockT> _(spinlock_);
             for (auto it = stableVersions_.rbegin(); it != stableVersions_.rend(); ++it) {
                 if (it->versionId <= currentVersionId) {
                     if (it->status == ACTIVE) {
@@ -121,11 +121,25 @@ namespace nogdb {
             return std::make_pair(T{}, false);
         }
 
+        // get an object whose only version is visible to every txn since baseVersionId
+        std::pair<T, bool> getSettledVersion(TxnId baseVersionId) const {
+            if (unstableVersion_.second == INVISIBLE) {
+                RWSpinLockGuard<LockT> _(spinlock_);
+                if (stableVersions_.size() == 1 &&
+                    (stableVersions_.cbegin())->versionId <= baseVersionId &&
+                    (stableVersions_.cbegin())->status == ACTIVE) {
+                    return std::make_pair(stableVersions_.cbegin()->object, true);
+                }
+            }
+            return std::make_pair(T{}, false);
+        }
+
         size_t clearStableVersion(TxnId baseVersionId) {
-            RWSpinLockGuard<RWSpinLock> _(spinlock_, RWSpinLockMode::EXCLUSIVE_SPLOCK);
+            RWSpinLockGuard<LockT> _(spinlock_, RWSpinLockMode::EXCLUSIVE_SPLOCK);
             if (stableVersions_.size() > 0) {
+                // a version is still visible to txns since baseVersionId unless its successor is also visible
                 for (auto it = stableVersions_.begin(); it != stableVersions_.end() - 1;) {
-                    if (it->versionId < baseVersionId) {
+                    if ((it + 1)->versionId <= baseVersionId) {
                         it = stableVersions_.erase(it);
                     } else {
                         break; //++it;
@@ -142,12 +156,12 @@ namespace nogdb {
 
         size_t clearUnstableVersion() {
             disableUnstableVersion();
-            RWSpinLockGuard<RWSpinLock> _(spinlock_, RWSpinLockMode::EXCLUSIVE_SPLOCK);
+            RWSpinLockGuard<LockT> _(spinlock_, RWSpinLockMode::EXCLUSIVE_SPLOCK);
             return stableVersions_.size();
         }
 
         bool checkStableVersionSize() {
-            RWSpinLockGuard<RWSpinLock> _(spinlock_, RWSpinLockMode::EXCLUSIVE_SPLOCK);
+            RWSpinLockGuard<LockT> _(spinlock_, RWSpinLockMode::EXCLUSIVE_SPLOCK);
             return stableVersions_.size() <= MAX_VERSION_CONTROL_SIZE;
         }
 
@@ -155,7 +169,7 @@ namespace nogdb {
         void upgradeStableVersion(TxnId versionId) {
             if (unstableVersion_.second == VISIBLE) {
                 disableUnstableVersion();
-                RWSpinLockGuard<RWSpinLock> _(spinlock_, RWSpinLockMode::EXCLUSIVE_SPLOCK);
+                RWSpinLockGuard<LockT> _(spinlock_, RWSpinLockMode::EXCLUSIVE_SPLOCK);
                 unstableVersion_.first.versionId = versionId;
                 stableVersions_.emplace_back(unstableVersion_.first);
             }
@@ -171,7 +185,7 @@ namespace nogdb {
         }
 
     private:
-        mutable RWSpinLock spinlock_{};
+        mutable LockT spinlock_{};
         std::vector<ControlObject> stableVersions_{};
         std::pair<ControlObject, Visibility> unstableVersion_{ControlObject{}, INVISIBLE};
     };
@@ -26,6 +26,7 @@
 #include "constant.hpp"
 #include "env_handler.hpp"
 #include "datastore.hpp"
+#include "relation.hpp"
 #include "graph.hpp"
 #include "parser.hpp"
 #include "compare.hpp"
@@ -40,14 +41,14 @@ namespace nogdb {
         // transaction validations
         Validate::isTransactionValid(txn);
         auto classDescriptor = Generic::getClassDescriptor(txn, className, ClassType::VERTEX);
-        auto classInfo = ClassPropertyInfo{};
+        auto classInfo = std::shared_ptr<const ClassPropertyInfo>{};
         auto indexInfos = std::map<std::string, std::tuple<PropertyType, IndexId, bool>>{};
         auto value = Parser::parseRecord(*txn.txnBase, classDescriptor, record, classInfo, indexInfos);
         const PositionId *maxRecordNum = nullptr;
         auto maxRecordNumValue = 0U;
         auto dsTxnHandler = txn.txnBase->getDsTxnHandler();
         try {
-            auto classDBHandler = Datastore::openDbi(dsTxnHandler, std::to_string(classDescriptor->id), true);
+            auto classDBHandler = txn.txnBase->openClassDbi(classDescriptor->id);
             auto keyValue = Datastore::getRecord(dsTxnHandler, classDBHandler, EM_MAXRECNUM);
             maxRecordNum = Datastore::getValueAsNumeric<PositionId>(keyValue);
             maxRecordNumValue = *maxRecordNum;
@@ -62,6 +63,9 @@ namespace nogdb {
                 auto const isUnique = std::get<2>(indexInfo.second);
                 Index::addIndex(*txn.txnBase, indexId, maxRecordNumValue, bytesValue, propertyType, isUnique);
             }
+            Index::addCompositeIndex(*txn.txnBase,
+                                     BaseTxn::getCurrentVersion(*txn.txnBase, classDescriptor->compositeIndexes).first,
+                                     *classInfo, maxRecordNumValue, record);
         } catch (const Error &err) {
             throw err;
         } catch (Datastore::ErrorType &err) {
@@ -70,26 +74,35 @@ namespace nogdb {
         return RecordDescriptor{classDescriptor->id, maxRecordNumValue};
     }
 
+    std::vector<RecordDescriptor>
+    Vertex::createBatch(Txn &txn, const std::string &className, const std::vector<Record> &records) {
+        // transaction validations
+        Validate::isTransactionValid(txn);
+        auto classDescriptor = Generic::getClassDescriptor(txn, className, ClassType::VERTEX);
+        return Generic::appendRecords(txn, classDescriptor, records.size(),
+                                      [&records](size_t index) -> const Record & { return records[index]; });
+    }
+
     void Vertex::update(Txn &txn, const RecordDescriptor &recordDescriptor, const Record &record) {
         // transaction validations
         Validate::isTransactionValid(txn);
         auto classDescriptor = Generic::getClassDescriptor(txn, recordDescriptor.rid.first, ClassType::VERTEX);
-        auto classInfo = ClassPropertyInfo{};
+        auto classInfo = std::shared_ptr<const ClassPropertyInfo>{};
         auto indexInfos = std::map<std::string, std::tuple<PropertyType, IndexId, bool>>{};
         auto value = Parser::parseRecord(*txn.txnBase, classDescriptor, record, classInfo, indexInfos);
         auto dsTxnHandler = txn.txnBase->getDsTxnHandler();
         try {
-            auto classDBHandler = Datastore::openDbi(dsTxnHandler, std::to_string(classDescriptor->id), true);
+            auto classDBHandler = txn.txnBase->openClassDbi(classDescriptor->id);
             auto keyValue = Datastore::getRecord(dsTxnHandler, classDBHandler, recordDescriptor.rid.second);
             if (keyValue.empty()) {
                 throw Error(GRAPH_NOEXST_VERTEX, Error::Type::GRAPH);
             }
-            auto existingRecord = Parser::parseRawData(keyValue, classInfo);
+            auto existingRecord = Parser::parseRawData(keyValue, *classInfo);
             auto existingIndexInfos = std::map<std::string, std::tuple<PropertyType, IndexId, bool>>{};
             for (const auto &property: existingRecord.getAll()) {
                 // check if having any index
-                auto foundProperty = classInfo.nameToDesc.find(property.first);
-                if (foundProperty != classInfo.nameToDesc.cend()) {
+                auto foundProperty = classInfo->nameToDesc.find(property.first);
+                if (foundProperty != classInfo->nameToDesc.cend()) {
                     for (const auto &indexIter: foundProperty->second.indexInfo) {
                         if (indexIter.second.first == classDescriptor->id) {
                             existingIndexInfos.emplace(
@@ -119,6 +132,10 @@ namespace nogdb {
                 auto const isUnique = std::get<2>(indexInfo.second);
                 Index::addIndex(*txn.txnBase, indexId, recordDescriptor.rid.second, bytesValue, propertyType, isUnique);
             }
+            auto compositeIndexInfo = BaseTxn::getCurrentVersion(*txn.txnBase, classDescriptor->compositeIndexes).first;
+            Index::deleteCompositeIndex(*txn.txnBase, compositeIndexInfo, *classInfo, recordDescriptor.rid.second,
+                                        existingRecord);
+            Index::addCompositeIndex(*txn.txnBase, compositeIndexInfo, *classInfo, recordDescriptor.rid.second, record);
 
             Datastore::putRecord(dsTxnHandler, classDBHandler, recordDescriptor.rid.second, value);
         } catch (Datastore::ErrorType &err) {
@@ -147,16 +164,16 @@ namespace nogdb {
         // delete a record in a datastore
         try {
             auto dsTxnHandler = txn.txnBase->getDsTxnHandler();
-            auto classDBHandler = Datastore::openDbi(dsTxnHandler, std::to_string(classDescriptor->id), true);
+            auto classDBHandler = txn.txnBase->openClassDbi(classDescriptor->id);
             // delete index if existing
             auto keyValue = Datastore::getRecord(dsTxnHandler, classDBHandler, recordDescriptor.rid.second);
             if (!keyValue.empty()) {
                 auto indexInfos = std::map<std::string, std::tuple<PropertyType, IndexId, bool>>{};
-                auto record = Parser::parseRawData(keyValue, classInfo);
+                auto record = Parser::parseRawData(keyValue, *classInfo);
                 for (const auto &property: record.getAll()) {
                     // check if having any index
-                    auto foundProperty = classInfo.nameToDesc.find(property.first);
-                    if (foundProperty != classInfo.nameToDesc.cend()) {
+                    auto foundProperty = classInfo->nameToDesc.find(property.first);
+                    if (foundProperty != classInfo->nameToDesc.cend()) {
                         for (const auto &indexIter: foundProperty->second.indexInfo) {
                             if (indexIter.second.first == classDescriptor->id) {
                                 indexInfos.emplace(
@@ -179,6 +196,9 @@ namespace nogdb {
                     auto const isUnique = std::get<2>(indexInfo.second);
                     Index::deleteIndex(*txn.txnBase, indexId, recordDescriptor.rid.second, bytesValue, propertyType, isUnique);
                 }
+                Index::deleteCompositeIndex(*txn.txnBase,
+                                            BaseTxn::getCurrentVersion(*txn.txnBase, classDescriptor->compositeIndexes).first,
+                                            *classInfo, recordDescriptor.rid.second, record);
             }
             // delete actual record
             Datastore::deleteRecord(dsTxnHandler, classDBHandler, recordDescriptor.rid.second);
@@ -199,7 +219,7 @@ namespace nogdb {
         // remove all index records
         try {
             auto indexInfos = std::vector<std::tuple<PropertyType, IndexId, bool>>{};
-            for (const auto &property: classInfo.nameToDesc) {
+            for (const auto &property: classInfo->nameToDesc) {
                 auto &type = property.second.type;
                 auto &indexInfo = property.second.indexInfo;
                 for (const auto &indexIter: indexInfo) {
@@ -224,9 +244,7 @@ namespace nogdb {
                     case PropertyType::UNSIGNED_SMALLINT:
                     case PropertyType::UNSIGNED_INTEGER:
                     case PropertyType::UNSIGNED_BIGINT: {
-                        auto dataIndexDBHandler = Datastore::openDbi(dsTxnHandler,
-                                                                     TB_INDEXING_PREFIX + std::to_string(indexId),
-                                                                     true, isUnique);
+                        auto dataIndexDBHandler = txn.txnBase->openIndexDbi(indexId, true, isUnique);
                         Datastore::emptyDbi(dsTxnHandler, dataIndexDBHandler);
                         break;
                     }
@@ -235,22 +253,21 @@ namespace nogdb {
                     case PropertyType::INTEGER:
                     case PropertyType::BIGINT:
                     case PropertyType::REAL: {
+                        if (Index::isOrderedIndex(*txn.txnBase, propertyType)) {
+                            auto dataIndexDBHandler = txn.txnBase->openIndexDbi(indexId, false, isUnique);
+                            Datastore::emptyDbi(dsTxnHandler, dataIndexDBHandler);
+                            break;
+                        }
                         auto dataIndexDBHandlerPositive =
-                                Datastore::openDbi(dsTxnHandler,
-                                                   TB_INDEXING_PREFIX + std::to_string(indexId) + "_positive",
-                                                   true, isUnique);
+                                txn.txnBase->openSignedIndexDbi(indexId, true, isUnique);
                         auto dataIndexDBHandlerNegative =
-                                Datastore::openDbi(dsTxnHandler,
-                                                   TB_INDEXING_PREFIX + std::to_string(indexId) + "_negative",
-                                                   true, isUnique);
+                                txn.txnBase->openSignedIndexDbi(indexId, false, isUnique);
                         Datastore::emptyDbi(dsTxnHandler, dataIndexDBHandlerPositive);
                         Datastore::emptyDbi(dsTxnHandler, dataIndexDBHandlerNegative);
                         break;
                     }
                     case PropertyType::TEXT: {
-                        auto dataIndexDBHandler = Datastore::openDbi(dsTxnHandler,
-                                                                     TB_INDEXING_PREFIX + std::to_string(indexId),
-                                                                     false, isUnique);
+                        auto dataIndexDBHandler = txn.txnBase->openIndexDbi(indexId, false, isUnique);
                         Datastore::emptyDbi(dsTxnHandler, dataIndexDBHandler);
                         break;
                     }
@@ -258,14 +275,16 @@ namespace nogdb {
                         break;
                 }
             }
+            Index::emptyCompositeIndex(*txn.txnBase,
+                                       BaseTxn::getCurrentVersion(*txn.txnBase, classDescriptor->compositeIndexes).first);
         } catch (Datastore::ErrorType &err) {
             throw Error(err, Error::Type::DATASTORE);
         }
         // remove all records in a database
         try {
-            auto classDBHandler = Datastore::openDbi(dsTxnHandler, std::to_string(classDescriptor->id), true);
+            auto classDBHandler = txn.txnBase->openClassDbi(classDescriptor->id);
             auto cursorHandler = Datastore::openCursor(dsTxnHandler, classDBHandler);
-            auto relationDBHandler = Datastore::openDbi(dsTxnHandler, TB_RELATIONS);
+            auto relationDBHandler = txn.txnBase->openRelationDbi();
             auto keyValue = Datastore::getNextCursor(cursorHandler);
             while (!keyValue.empty()) {
                 auto key = Datastore::getKeyAsNumeric<PositionId>(keyValue);
@@ -284,8 +303,8 @@ namespace nogdb {
                     }
                     // delete from relations
                     for (const auto &edge: edgeRecordDescriptors) {
-                        Datastore::deleteRecord(dsTxnHandler, relationDBHandler, rid2str(edge.rid));
-                        auto edgeClassHandler = Datastore::openDbi(dsTxnHandler, std::to_string(edge.rid.first), true);
+                        Relation::remove(dsTxnHandler, relationDBHandler, edge.rid);
+                        auto edgeClassHandler = txn.txnBase->openClassDbi(edge.rid.first);
                         Datastore::deleteRecord(dsTxnHandler, edgeClassHandler, edge.rid.second);
                     }
                     // delete a record in a datastore
@@ -305,23 +324,48 @@ namespace nogdb {
     }
 
     ResultSet Vertex::get(const Txn &txn, const std::string &className) {
+        return get(txn, className, PropertyFilter{});
+    }
+
+    ResultSet Vertex::get(const Txn &txn, const std::string &className, const PropertyFilter &propertyFilter) {
         auto result = ResultSet{};
         auto classDescriptors = Generic::getMultipleClassDescriptor(txn, std::set<std::string>{className}, ClassType::VERTEX);
         for (const auto &classDescriptor: classDescriptors) {
-            auto classPropertyInfo = Generic::getClassMapProperty(*txn.txnBase, classDescriptor);
-            auto classInfo = ClassInfo{classDescriptor->id, className, classPropertyInfo};
+            auto classPropertyInfo = Generic::getClassMapProperty(*txn.txnBase, classDescriptor,
+                                                                  propertyFilter.getPropertyName());
+            auto classInfo = ClassInfo{classDescriptor->id, className, classPropertyInfo, Schema::CompositeIndexInfo{}};
             auto partial = Generic::getRecordFromClassInfo(txn, classInfo);
             result.insert(result.end(), partial.cbegin(), partial.cend());
         }
         return result;
     }
 
+    ResultSetView Vertex::getView(const Txn &txn, const std::string &className) {
+        Validate::isReadOnlyTransaction(txn);
+        auto result = ResultSetView{};
+        auto classDescriptors = Generic::getMultipleClassDescriptor(txn, std::set<std::string>{className},
+                                                                    ClassType::VERTEX);
+        for (const auto &classDescriptor: classDescriptors) {
+            auto classPropertyInfo = Generic::getClassMapProperty(*txn.txnBase, classDescriptor);
+            auto partial = Generic::getRecordViewFromClassInfo(txn, classDescriptor->id, classPropertyInfo);
+            result.insert(result.end(), partial.cbegin(), partial.cend());
+        }
+        return result;
+    }
+
     ResultSetCursor Vertex::getCursor(Txn &txn, const std::string &className) {
+        return getCursor(txn, className, PropertyFilter{});
+    }
+
+    ResultSetCursor
+    Vertex::getCursor(Txn &txn, const std::string &className, const PropertyFilter &propertyFilter) {
         auto result = ResultSetCursor{txn};
+        result.propertyNames = propertyFilter.getPropertyName();
         auto classDescriptors = Generic::getMultipleClassDescriptor(txn, std::set<std::string>{className}, ClassType::VERTEX);
         for (const auto &classDescriptor: classDescriptors) {
-            auto classPropertyInfo = Generic::getClassMapProperty(*txn.txnBase, classDescriptor);
-            auto classInfo = ClassInfo{classDescriptor->id, className, classPropertyInfo};
+            auto classPropertyInfo = Generic::getClassMapProperty(*txn.txnBase, classDescriptor,
+                                                                  propertyFilter.getPropertyName());
+            auto classInfo = ClassInfo{classDescriptor->id, className, classPropertyInfo, Schema::CompositeIndexInfo{}};
             auto metadata = Generic::getRdescFromClassInfo(txn, classInfo);
             result.metadata.insert(result.metadata.end(), metadata.cbegin(), metadata.cend());
         }
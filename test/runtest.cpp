@@ -68,6 +68,7 @@ int main() {
     exec(test_create_class_with_properties, "creating a class with pre-defined properties");
     exec(test_drop_class, "dropping a class");
     exec(test_alter_class, "modifying a class name");
+    exec(test_alter_class_multiversion, "modifying a class name while older txns are reading");
     exec(test_create_invalid_class, "creating an invalid class");
     exec(test_create_invalid_class_with_properties, "creating an invalid class with pre-defined properties");
     exec(test_drop_invalid_class, "dropping an invalid class");
@@ -98,11 +99,14 @@ int main() {
     std::cout << "\n\x1B[96mEnd-to-end tests for basic operations for vertices should:\x1B[0m\n";
     exec(test_create_vertex, "creating a vertex");
     exec(test_create_vertices, "creating vertices more than 1 class");
+    exec(test_create_vertices_batch, "creating vertices in a batch");
     exec(test_create_invalid_vertex, "creating an invalid vertex");
     exec(test_get_vertex, "retrieving data from vertices");
     exec(test_get_vertex_v2, "retrieving data from vertices belonging to a class with all property types");
     exec(test_get_invalid_vertices, "retrieving data from invalid vertices");
     exec(test_get_vertex_cursor, "retrieving data from vertices with result set cursor");
+    exec(test_get_vertex_view, "retrieving zero-copy record views from vertices");
+    exec(test_get_vertex_with_property_filter, "retrieving some properties of vertices");
     exec(test_get_invalid_vertex_cursor, "retrieving data from invalid vertices with result set cursor");
     exec(test_get_edge_in, "retrieving incoming edges from a vertex");
     exec(test_get_invalid_edge_in, "retrieving incoming edges from an invalid vertex");
@@ -126,6 +130,7 @@ int main() {
 #ifdef TEST_RECORD_OPERATIONS
     std::cout << "\n\x1B[96mEnd-to-end tests for basic operations for edges should:\x1B[0m\n";
     exec(test_create_edges, "creating edges");
+    exec(test_create_edges_batch, "creating edges in a batch");
     exec(test_create_invalid_edge, "creating an invalid edge");
     exec(test_get_edge, "retrieving data from edges");
     exec(test_get_invalid_edges, "retrieving data from invalid edges");
@@ -154,6 +159,7 @@ int main() {
     exec(test_reopen_ctx_v2, "reopening a context with records");
     exec(test_reopen_ctx_v3, "reopening a context with records and relations");
     exec(test_reopen_ctx_v4, "reopening a context with records, relations, and renaming class/property");
+    exec(test_reopen_ctx_with_self_loops, "reopening a context with self-loop edges");
 #endif
     // misc
 #ifdef TEST_MISC_OPERATIONS
@@ -213,6 +219,7 @@ int main() {
     exec(test_bfs_traverse_cursor_with_condition, "traversing a graph and returning a cursor using bfs algorithm with conditional functions");
     exec(test_dfs_traverse_cursor_with_condition, "traversing a graph and returning a cursor using dfs algorithm with conditional functions");
     exec(test_shortest_path_cursor_with_condition, "finding a cursor of the shortest path in a graph with conditional functions");
+    exec(test_traverse_edges_with_class_filter, "traversing incoming, outgoing and all edges with class filters");
     exec(destroy_test_graph, "destroying the graph for testing graph operations");
 #endif
     // find
@@ -222,6 +229,8 @@ int main() {
     exec(test_range_expression, "constructing condition with range comparators correctly");
     exec(test_extra_string_expression, "constructing condition with additional comparators for string type correctly");
     exec(test_negative_expression, "constructing negative condition/expression and filtering a record correctly");
+    exec(test_like_pattern_expression, "constructing condition with like patterns containing literal and repeated wildcards correctly");
+    exec(test_long_text_expression, "constructing condition with text comparators over long texts correctly");
     exec(init_test_find, "initiating a graph for testing find operations");
     exec(test_create_informative_graph, "creating an informative graph");
     exec(test_find_vertex, "finding records from a vertex class with a given condition");
@@ -284,6 +293,8 @@ int main() {
     exec(test_find_invalid_edge_out_cursor_with_expression, "finding a cursor of outgoing edges from an invalid vertex or with an invalid expression");
     exec(test_find_edge_all_cursor_with_expression, "finding a cursor of incoming and outgoing edges from a vertex with a given expression");
     exec(test_find_invalid_edge_all_cursor_with_expression, "finding a cursor of incoming and outgoing edges from an invalid vertex or with an invalid expression");
+    exec(test_find_vertex_with_raw_types, "finding records from a vertex class with conditions on all property types");
+    exec(test_find_vertex_with_parallel_scan, "finding records from vertex classes with a parallel scan");
     exec(destroy_test_find, "destroying a graph for testing find operations");
 #endif
     // inheritance
@@ -335,11 +346,21 @@ int main() {
     exec(test_drop_index_with_records, "dropping indexes for some properties with existing records");
     exec(test_drop_index_extended_class_with_records, "dropping indexes for some properties which belong to super classes with existing records");
     exec(test_drop_invalid_index_with_records, "dropping invalid indexes with existing records");
+    exec(test_search_index_in_value_order, "searching signed and real indexes in the order of values");
+    exec(test_search_composite_index, "creating, maintaining, and searching a composite index");
+    exec(test_create_index_with_many_records, "creating an index on a class with many records");
+    exec(test_create_index_online, "creating an index from a snapshot while another txn changes records");
 #endif
     // ctx
 #ifdef TEST_CONTEXT_OPERATIONS
     std::cout << "\n\x1B[96mEnd-to-end tests for a database context with indexing should:\x1B[0m\n";
     exec(test_reopen_ctx_v6, "reopening a context with records, extended classes, and indexing");
+    exec(test_reopen_ctx_indexed_record_format, "reopening a context with records in the indexed format");
+    exec(test_reopen_ctx_indexed_record_slots, "reopening a context with numeric values in slots of indexed records");
+    exec(test_reopen_ctx_bulk_loader, "reopening a context with vertices, edges, and relations from a bulk loader");
+    exec(test_reopen_ctx_many_relations, "reopening a context with many relations in edge classes of different sizes");
+    exec(test_reopen_ctx_adjacency_snapshot, "reopening a context with valid, stale, and corrupted adjacency snapshots");
+    exec(test_reopen_ctx_text_relation_keys, "reopening a context with relations in the text key format");
 #endif
     // schema txn
 #ifdef TEST_SCHEMA_TXN_OPERATIONS
@@ -385,6 +406,8 @@ int main() {
     exec(test_schema_txn_create_index_multiversion_rollback, "aborting multi-version schema txn when creating a new index");
     exec(test_schema_txn_drop_index_multiversion_commit, "committing multi-version schema txn when dropping an index");
     exec(test_schema_txn_drop_index_multiversion_rollback, "aborting multi-version schema txn when dropping an index");
+    exec(test_schema_txn_reuse_dbi_after_drop, "reusing cached table handles after dropping and re-creating a class");
+    exec(test_schema_txn_add_property_extend_multiversion, "committing multi-version schema txn when adding a property into a super class");
 #endif
     // txn
 #ifdef TEST_TXN_OPERATIONS
@@ -413,10 +436,20 @@ int main() {
     exec(test_txn_modify_edges_multiversion_commit, "committing multi-version txn when modifying edges with vertices");
     exec(test_txn_modify_edges_multiversion_rollback, "aborting multi-version txn when modifying edges with vertices");
     exec(test_txn_reopen_ctx, "reopening context and committing txn with vertices and edges");
+    exec(test_txn_reopen_ctx_multiversion, "reopening context and committing multi-version txn with loaded edges");
+    exec(test_txn_reclaim_with_active_readers, "reclaiming old versions and deleted elements with active readers");
     exec(test_txn_invalid_operations, "committing txn with invalid operations");
     exec(test_txn_stat, "getting txn stat including current txn id, current version id, and active txn correctly");
+    exec(test_txn_stat_many_readers, "getting active txn correctly with many concurrent readers");
     //exec(test_txn_invalid_concurrent_version, "committing multi-version txn when using over a maximum number of concurrent versions");
     //exec(test_txn_multithreads, "committing txn with multi-threads programming");
+    exec(test_slab_allocator, "allocating and releasing blocks of slabs");
+    exec(test_slab_allocator_multithreads, "allocating and releasing blocks of slabs in many threads");
+    exec(test_adaptive_rwlock, "locking an adaptive reader-writer lock with re-entered readers and parked waiters");
+    exec(test_adaptive_rwlock_multithreads, "locking an adaptive reader-writer lock by many readers and writers");
+    exec(test_concurrent_hash_map_multithreads, "inserting, erasing, and finding elements of a concurrent hash map in many threads");
+    exec(test_concurrent_hash_map_for_each_multithreads, "visiting elements of a concurrent hash map while it is modified by other threads");
+    exec(test_concurrent_hash_map_merge, "merging elements into a concurrent hash map with one lock of each shard");
 #endif
 
     // sql
@@ -45,8 +45,15 @@ extern void test_reopen_ctx(); // without records
 extern void test_reopen_ctx_v2(); // with records
 extern void test_reopen_ctx_v3(); // with records and relations
 extern void test_reopen_ctx_v4(); // with records, relations, and renaming class/property
+extern void test_reopen_ctx_with_self_loops();
 extern void test_reopen_ctx_v5(); // with records, relations, and extended classes
 extern void test_reopen_ctx_v6(); // with records, extended classes, and indexing
+extern void test_reopen_ctx_indexed_record_format();
+extern void test_reopen_ctx_indexed_record_slots();
+extern void test_reopen_ctx_bulk_loader();
+extern void test_reopen_ctx_many_relations();
+extern void test_reopen_ctx_adjacency_snapshot();
+extern void test_reopen_ctx_text_relation_keys();
 extern void test_locked_ctx();
 extern void test_invalid_ctx();
 
@@ -58,6 +65,7 @@ extern void test_create_class();
 extern void test_create_class_with_properties();
 extern void test_drop_class();
 extern void test_alter_class();
+extern void test_alter_class_multiversion();
 extern void test_create_invalid_class();
 extern void test_create_invalid_class_with_properties();
 extern void test_drop_invalid_class();
@@ -77,11 +85,14 @@ extern void test_record_with_bytes();
 extern void test_invalid_record_with_bytes();
 extern void test_create_vertex();
 extern void test_create_vertices();
+extern void test_create_vertices_batch();
 extern void test_create_invalid_vertex();
 extern void test_get_vertex();
 extern void test_get_vertex_v2();
 extern void test_get_invalid_vertices();
 extern void test_get_vertex_cursor();
+extern void test_get_vertex_view();
+extern void test_get_vertex_with_property_filter();
 extern void test_get_invalid_vertex_cursor();
 extern void test_update_vertex();
 extern void test_update_invalid_vertex();
@@ -89,6 +100,7 @@ extern void test_delete_vertex_only();
 extern void test_delete_invalid_vertex();
 extern void test_delete_all_vertices();
 extern void test_create_edges();
+extern void test_create_edges_batch();
 extern void test_create_invalid_edge();
 extern void test_get_edge();
 extern void test_get_invalid_edges();
@@ -184,6 +196,7 @@ extern void test_shortest_path_with_condition();
 extern void test_bfs_traverse_cursor_with_condition();
 extern void test_dfs_traverse_cursor_with_condition();
 extern void test_shortest_path_cursor_with_condition();
+extern void test_traverse_edges_with_class_filter();
 #endif
 
 // find operations testing
@@ -192,6 +205,8 @@ extern void test_expression();
 extern void test_range_expression();
 extern void test_extra_string_expression();
 extern void test_negative_expression();
+extern void test_like_pattern_expression();
+extern void test_long_text_expression();
 extern void init_test_find();
 extern void test_create_informative_graph();
 extern void test_find_vertex();
@@ -254,6 +269,8 @@ extern void test_find_edge_all_cursor_with_expression();
 extern void test_find_invalid_edge_in_cursor_with_expression();
 extern void test_find_invalid_edge_out_cursor_with_expression();
 extern void test_find_invalid_edge_all_cursor_with_expression();
+extern void test_find_vertex_with_raw_types();
+extern void test_find_vertex_with_parallel_scan();
 extern void destroy_test_find();
 #endif
 
@@ -294,6 +311,10 @@ extern void test_create_index_extended_class_with_records();
 extern void test_drop_index_extended_class_with_records();
 extern void test_create_invalid_index_with_records();
 extern void test_drop_invalid_index_with_records();
+extern void test_search_index_in_value_order();
+extern void test_search_composite_index();
+extern void test_create_index_with_many_records();
+extern void test_create_index_online();
 #endif
 
 // schema transaction testing
@@ -338,6 +359,8 @@ extern void test_schema_txn_create_index_multiversion_commit();
 extern void test_schema_txn_create_index_multiversion_rollback();
 extern void test_schema_txn_drop_index_multiversion_commit();
 extern void test_schema_txn_drop_index_multiversion_rollback();
+extern void test_schema_txn_reuse_dbi_after_drop();
+extern void test_schema_txn_add_property_extend_multiversion();
 #endif
 
 // transaction testing
@@ -366,10 +389,20 @@ extern void test_txn_modify_edges_multiversion_commit();
 extern void test_txn_modify_edges_multiversion_rollback();
 extern void test_txn_rollback_when_destroy();
 extern void test_txn_reopen_ctx();
+extern void test_txn_reopen_ctx_multiversion();
+extern void test_txn_reclaim_with_active_readers();
 extern void test_txn_invalid_operations();
 extern void test_txn_stat();
+extern void test_txn_stat_many_readers();
 //extern void test_txn_invalid_concurrent_version();
 extern void test_txn_multithreads();
+extern void test_slab_allocator();
+extern void test_slab_allocator_multithreads();
+extern void test_adaptive_rwlock();
+extern void test_adaptive_rwlock_multithreads();
+extern void test_concurrent_hash_map_multithreads();
+extern void test_concurrent_hash_map_for_each_multithreads();
+extern void test_concurrent_hash_map_merge();
 #endif
 
 // sql operations testing
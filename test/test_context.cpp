@@ -19,7 +19,18 @@
  *
  */
 
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <map>
+#include <set>
+#include <unistd.h>
+
 #include "runtest.h"
+#include "../src/adjacency_snapshot.hpp"
+#include "../tools/bulk_loader.hpp"
+#include "../src/parser.hpp"
+#include "../src/relation.hpp"
 
 void assert_dbinfo(const nogdb::DBInfo &info1, const nogdb::DBInfo &info2) {
 	assert(info1.numClass == info2.numClass);
@@ -406,6 +417,49 @@ void test_reopen_ctx_v3() {
 	}
 }
 
+/* reopening a database with self-loop edges */
+void test_reopen_ctx_with_self_loops() {
+	auto v1 = nogdb::RecordDescriptor{};
+	auto v2 = nogdb::RecordDescriptor{};
+	auto e1 = nogdb::RecordDescriptor{};
+	auto verify = [&]() {
+		auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+		assert(nogdb::Vertex::getInEdge(txn, v1).size() == 1);
+		assert(nogdb::Vertex::getOutEdge(txn, v1).size() == 2);
+		assert(nogdb::Vertex::getInEdge(txn, v2).size() == 1);
+		assert(nogdb::Edge::getSrc(txn, e1).descriptor == v1);
+		assert(nogdb::Edge::getDst(txn, e1).descriptor == v1);
+	};
+	try {
+		auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+		nogdb::Class::create(txn, "test1", nogdb::ClassType::VERTEX);
+		nogdb::Class::create(txn, "test2", nogdb::ClassType::EDGE);
+		v1 = nogdb::Vertex::create(txn, "test1");
+		v2 = nogdb::Vertex::create(txn, "test1");
+		e1 = nogdb::Edge::create(txn, "test2", v1, v1);
+		nogdb::Edge::create(txn, "test2", v1, v2);
+		txn.commit();
+		verify();
+	}  catch(const nogdb::Error& ex) {
+		std::cout << "\nError: " << ex.what() << std::endl;
+		assert(false);
+	}
+
+	delete ctx;
+
+	try {
+		ctx = new nogdb::Context(DATABASE_PATH);
+		verify();
+		auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+		nogdb::Class::drop(txn, "test2");
+		nogdb::Class::drop(txn, "test1");
+		txn.commit();
+	} catch(const nogdb::Error& ex) {
+		std::cout << "\nError: " << ex.what() << std::endl;
+		assert(false);
+	}
+}
+
 /* reopening a database with schema, records, relations, and renaming class/property */
 void test_reopen_ctx_v4() {
 	auto tmp = nogdb::RecordDescriptor{};
@@ -731,3 +785,704 @@ void test_invalid_ctx() {
 	}
     txn.rollback();
 }
+
+void test_reopen_ctx_indexed_record_format() {
+	const auto dbPath = DATABASE_PATH + "_indexed";
+	const auto clearDirCommand = "rm -rf " + dbPath;
+	system(clearDirCommand.c_str());
+	const auto note = std::string(300, 'x');
+	auto indexedCtx = static_cast<nogdb::Context *>(nullptr);
+	auto rdesc1 = nogdb::RecordDescriptor{}, rdesc2 = nogdb::RecordDescriptor{};
+	try {
+		indexedCtx = new nogdb::Context(dbPath, nogdb::RecordFormat::INDEXED);
+		auto txn = nogdb::Txn{*indexedCtx, nogdb::Txn::Mode::READ_WRITE};
+		assert(nogdb::Db::getDbInfo(txn).recordFormat == nogdb::RecordFormat::INDEXED);
+		nogdb::Class::create(txn, "items", nogdb::ClassType::VERTEX);
+		nogdb::Property::add(txn, "items", "name", nogdb::PropertyType::TEXT);
+		nogdb::Property::add(txn, "items", "qty", nogdb::PropertyType::UNSIGNED_INTEGER);
+		nogdb::Property::add(txn, "items", "price", nogdb::PropertyType::REAL);
+		nogdb::Property::add(txn, "items", "note", nogdb::PropertyType::TEXT);
+		rdesc1 = nogdb::Vertex::create(txn, "items", nogdb::Record{}
+				.set("name", "pencil").set("qty", 12U).set("price", 2.5).set("note", note));
+		rdesc2 = nogdb::Vertex::create(txn, "items", nogdb::Record{}.set("qty", 3U));
+		nogdb::Vertex::update(txn, rdesc2, nogdb::Record{}.set("name", "eraser").set("qty", 4U));
+		txn.commit();
+	} catch (const nogdb::Error &ex) {
+		std::cout << "\nError: " << ex.what() << std::endl;
+		assert(false);
+	}
+
+	auto verify = [&](nogdb::Context &context) {
+		auto txn = nogdb::Txn{context, nogdb::Txn::Mode::READ_ONLY};
+		assert(nogdb::Db::getDbInfo(txn).recordFormat == nogdb::RecordFormat::INDEXED);
+		auto record = nogdb::Db::getRecord(txn, rdesc1);
+		assert(record.get("name").toText() == "pencil");
+		assert(record.get("qty").toIntU() == 12U);
+		assert(record.get("price").toReal() == 2.5);
+		assert(record.get("note").toText() == note);
+		record = nogdb::Db::getRecord(txn, rdesc1, nogdb::PropertyFilter{"price"});
+		assert(record.get("price").toReal() == 2.5);
+		assert(record.get("name").empty());
+		record = nogdb::Db::getRecord(txn, rdesc2);
+		assert(record.get("name").toText() == "eraser");
+		assert(record.get("qty").toIntU() == 4U);
+		assert(record.get("price").empty());
+		auto res = nogdb::Vertex::getView(txn, "items");
+		assert(res.size() == 2);
+		assert(res[0].record.getText("note") == note);
+		assert(res[0].record.getIntU("qty") == 12U);
+		assert(res[1].record.get("note").empty());
+		txn.rollback();
+	};
+
+	try {
+		verify(*indexedCtx);
+		delete indexedCtx;
+		// an existing database keeps its own record format
+		indexedCtx = new nogdb::Context(dbPath);
+		verify(*indexedCtx);
+		delete indexedCtx;
+	} catch (const nogdb::Error &ex) {
+		std::cout << "\nError: " << ex.what() << std::endl;
+		assert(false);
+	}
+	system(clearDirCommand.c_str());
+
+	auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+	assert(nogdb::Db::getDbInfo(txn).recordFormat == nogdb::RecordFormat::SEQUENTIAL);
+	txn.rollback();
+}
+
+void test_reopen_ctx_indexed_record_slots() {
+	const auto dbPath = DATABASE_PATH + "_indexed_slots";
+	const auto clearDirCommand = "rm -rf " + dbPath;
+	system(clearDirCommand.c_str());
+	const auto data = std::string{"\x01\x02\x03\x04", 4};
+	auto indexedCtx = static_cast<nogdb::Context *>(nullptr);
+	auto rdesc1 = nogdb::RecordDescriptor{}, rdesc2 = nogdb::RecordDescriptor{};
+	try {
+		indexedCtx = new nogdb::Context(dbPath, nogdb::RecordFormat::INDEXED);
+		auto txn = nogdb::Txn{*indexedCtx, nogdb::Txn::Mode::READ_WRITE};
+		nogdb::Class::create(txn, "numbers", nogdb::ClassType::VERTEX);
+		nogdb::Property::add(txn, "numbers", "name", nogdb::PropertyType::TEXT);
+		nogdb::Property::add(txn, "numbers", "i8", nogdb::PropertyType::TINYINT);
+		nogdb::Property::add(txn, "numbers", "u8", nogdb::PropertyType::UNSIGNED_TINYINT);
+		nogdb::Property::add(txn, "numbers", "i16", nogdb::PropertyType::SMALLINT);
+		nogdb::Property::add(txn, "numbers", "u16", nogdb::PropertyType::UNSIGNED_SMALLINT);
+		nogdb::Property::add(txn, "numbers", "i32", nogdb::PropertyType::INTEGER);
+		nogdb::Property::add(txn, "numbers", "u32", nogdb::PropertyType::UNSIGNED_INTEGER);
+		nogdb::Property::add(txn, "numbers", "i64", nogdb::PropertyType::BIGINT);
+		nogdb::Property::add(txn, "numbers", "u64", nogdb::PropertyType::UNSIGNED_BIGINT);
+		nogdb::Property::add(txn, "numbers", "real", nogdb::PropertyType::REAL);
+		nogdb::Property::add(txn, "numbers", "data", nogdb::PropertyType::BLOB);
+		nogdb::Property::add(txn, "numbers", "small", nogdb::PropertyType::BIGINT);
+		nogdb::Property::add(txn, "numbers", "odd", nogdb::PropertyType::INTEGER);
+		rdesc1 = nogdb::Vertex::create(txn, "numbers", nogdb::Record{}
+				.set("name", "first")
+				.set("i8", int8_t{-8}).set("u8", uint8_t{8})
+				.set("i16", int16_t{-1600}).set("u16", uint16_t{1600})
+				.set("i32", int32_t{-320000}).set("u32", uint32_t{320000})
+				.set("i64", int64_t{-6400000000LL}).set("u64", uint64_t{6400000000ULL})
+				.set("real", 0.25)
+				.set("data", nogdb::Bytes{reinterpret_cast<const unsigned char *>(data.data()), data.size()})
+				// values are kept as they are set, so a value of another size is kept with an offset
+				.set("small", int32_t{7}).set("odd", "abc"));
+		rdesc2 = nogdb::Vertex::create(txn, "numbers", nogdb::Record{}
+				.set("name", "second").set("i32", int32_t{32}).set("real", -1.5).set("odd", ""));
+		txn.commit();
+	} catch (const nogdb::Error &ex) {
+		std::cout << "\nError: " << ex.what() << std::endl;
+		assert(false);
+	}
+
+	auto verify = [&](nogdb::Context &context) {
+		auto txn = nogdb::Txn{context, nogdb::Txn::Mode::READ_ONLY};
+		auto record = nogdb::Db::getRecord(txn, rdesc1);
+		assert(record.getText("name") == "first");
+		assert(record.getTinyInt("i8") == -8);
+		assert(record.getTinyIntU("u8") == 8U);
+		assert(record.getSmallInt("i16") == -1600);
+		assert(record.getSmallIntU("u16") == 1600U);
+		assert(record.getInt("i32") == -320000);
+		assert(record.getIntU("u32") == 320000U);
+		assert(record.getBigInt("i64") == -6400000000LL);
+		assert(record.getBigIntU("u64") == 6400000000ULL);
+		assert(record.getReal("real") == 0.25);
+		assert(record.get("data").size() == data.size());
+		assert(memcmp(record.get("data").getRaw(), data.data(), data.size()) == 0);
+		assert(record.get("small").size() == sizeof(int32_t));
+		assert(record.get("small").toInt() == 7);
+		assert(record.getText("odd") == "abc");
+		record = nogdb::Db::getRecord(txn, rdesc1, nogdb::PropertyFilter{"u16", "i64", "odd"});
+		assert(record.getSmallIntU("u16") == 1600U);
+		assert(record.getBigInt("i64") == -6400000000LL);
+		assert(record.getText("odd") == "abc");
+		assert(record.get("i8").empty());
+		assert(record.get("name").empty());
+		record = nogdb::Db::getRecord(txn, rdesc2);
+		assert(record.getText("name") == "second");
+		assert(record.getInt("i32") == 32);
+		assert(record.getReal("real") == -1.5);
+		assert(record.get("odd").empty());
+		assert(record.get("i64").empty());
+
+		auto res = nogdb::Vertex::getView(txn, "numbers");
+		assert(res.size() == 2);
+		assert(res[0].record.getTinyInt("i8") == -8);
+		assert(res[0].record.getSmallInt("i16") == -1600);
+		assert(res[0].record.getIntU("u32") == 320000U);
+		assert(res[0].record.getBigIntU("u64") == 6400000000ULL);
+		assert(res[0].record.getText("odd") == "abc");
+		assert(res[1].record.getReal("real") == -1.5);
+		assert(res[1].record.get("u8").empty());
+
+		auto found = nogdb::Vertex::get(txn, "numbers", nogdb::Condition("i64").eq(int64_t{-6400000000LL}));
+		assert(found.size() == 1 && found[0].descriptor == rdesc1);
+		found = nogdb::Vertex::get(txn, "numbers", nogdb::Condition("u8").eq(uint8_t{8}));
+		assert(found.size() == 1 && found[0].descriptor == rdesc1);
+		found = nogdb::Vertex::get(txn, "numbers", nogdb::Condition("real").lt(0.0));
+		assert(found.size() == 1 && found[0].descriptor == rdesc2);
+		found = nogdb::Vertex::get(txn, "numbers", nogdb::Condition("i32").gt(int32_t{0}) ||
+		                                           nogdb::Condition("odd").eq("abc"));
+		assert(found.size() == 2);
+		found = nogdb::Vertex::get(txn, "numbers", nogdb::Condition("u16").null());
+		assert(found.size() == 1 && found[0].descriptor == rdesc2);
+		txn.rollback();
+	};
+
+	try {
+		verify(*indexedCtx);
+		delete indexedCtx;
+		indexedCtx = new nogdb::Context(dbPath);
+		verify(*indexedCtx);
+		delete indexedCtx;
+	} catch (const nogdb::Error &ex) {
+		std::cout << "\nError: " << ex.what() << std::endl;
+		assert(false);
+	}
+	system(clearDirCommand.c_str());
+
+	// numeric values are kept in slots grouped by widths and the other values are found by their offsets
+	auto properties = nogdb::ClassProperty{};
+	properties["a"] = nogdb::PropertyDescriptor{9, nogdb::PropertyType::UNSIGNED_BIGINT};
+	properties["b"] = nogdb::PropertyDescriptor{3, nogdb::PropertyType::INTEGER};
+	properties["c"] = nogdb::PropertyDescriptor{7, nogdb::PropertyType::TEXT};
+	properties["d"] = nogdb::PropertyDescriptor{5, nogdb::PropertyType::BIGINT};
+	properties["e"] = nogdb::PropertyDescriptor{4, nogdb::PropertyType::REAL};
+	properties["f"] = nogdb::PropertyDescriptor{6, nogdb::PropertyType::INTEGER};
+	auto blob = nogdb::Parser::parseIndexedRecord(properties, nogdb::Record{}
+			.set("a", uint64_t{90}).set("b", int32_t{30}).set("c", "seven").set("d", int64_t{-50})
+			.set("e", 4.5).set("f", "six"));
+	auto raw = blob.bytes();
+	auto rawSize = blob.size();
+	auto header = std::vector<uint16_t>(6);
+	memcpy(header.data(), raw, header.size() * sizeof(uint16_t));
+	assert((header == std::vector<uint16_t>{nogdb::INDEXED_RAW_DATA_MARKER, 6, 3, 1, 0, 0}));
+	assert(rawSize == nogdb::Parser::getIndexedRawDataSize(6, 4, 8 * 3 + 4 + 5 + 3));
+	assert(nogdb::Parser::getIndexedRawDataCount(raw, rawSize) == 6);
+	auto findValue = [](const unsigned char *data, size_t size, nogdb::PropertyId propertyId) {
+		auto value = static_cast<const unsigned char *>(nullptr);
+		auto valueSize = size_t{0};
+		if (!nogdb::Parser::findRawProperty(data, size, propertyId, value, valueSize)) {
+			return std::string{"<none>"};
+		}
+		return std::string{reinterpret_cast<const char *>(value), valueSize};
+	};
+	auto toString = [](const void *value, size_t size) {
+		return std::string{static_cast<const char *>(value), size};
+	};
+	auto u64 = uint64_t{90};
+	auto i64 = int64_t{-50};
+	auto real = 4.5;
+	auto i32 = int32_t{30};
+	assert(findValue(raw, rawSize, 9) == toString(&u64, sizeof(u64)));
+	assert(findValue(raw, rawSize, 5) == toString(&i64, sizeof(i64)));
+	assert(findValue(raw, rawSize, 4) == toString(&real, sizeof(real)));
+	assert(findValue(raw, rawSize, 3) == toString(&i32, sizeof(i32)));
+	assert(findValue(raw, rawSize, 7) == "seven");
+	assert(findValue(raw, rawSize, 6) == "six");
+	assert(findValue(raw, rawSize, 8) == "<none>");
+	auto visited = std::vector<std::pair<nogdb::PropertyId, std::string>>{};
+	nogdb::Parser::forEachRawProperty(raw, rawSize, [&](nogdb::PropertyId id, const unsigned char *value, size_t size) {
+		visited.emplace_back(id, toString(value, size));
+		return true;
+	});
+	assert((visited == std::vector<std::pair<nogdb::PropertyId, std::string>>{
+			{4, toString(&real, sizeof(real))}, {5, toString(&i64, sizeof(i64))}, {9, toString(&u64, sizeof(u64))},
+			{3, toString(&i32, sizeof(i32))}, {6, "six"}, {7, "seven"}}));
+	// truncated slots are never read
+	auto valuesBegin = rawSize - (5 + 3);
+	assert(nogdb::Parser::getIndexedRawDataCount(raw, valuesBegin - 1) == 0);
+	assert(findValue(raw, valuesBegin - 1, 9) == "<none>");
+	assert(nogdb::Parser::getIndexedRawDataCount(raw, 10) == 0);
+	// so are truncated values
+	assert(findValue(raw, rawSize - 1, 7) == "<none>");
+
+}
+
+void test_reopen_ctx_bulk_loader() {
+	const auto dbPath = DATABASE_PATH + "_bulk";
+	const auto clearDirCommand = "rm -rf " + dbPath;
+	system(clearDirCommand.c_str());
+	const auto numVertices = 1000;
+	const auto numBatches = 4;
+	auto vertices = std::vector<nogdb::RecordDescriptor>{};
+	auto numKnows = std::vector<size_t>(numVertices), numLikes = std::vector<size_t>(numVertices);
+	auto numIn = std::vector<size_t>(numVertices);
+	auto bulkCtx = static_cast<nogdb::Context *>(nullptr);
+	try {
+		bulkCtx = new nogdb::Context(dbPath);
+		{
+			auto txn = nogdb::Txn{*bulkCtx, nogdb::Txn::Mode::READ_WRITE};
+			nogdb::Class::create(txn, "persons", nogdb::ClassType::VERTEX);
+			nogdb::Property::add(txn, "persons", "name", nogdb::PropertyType::TEXT);
+			nogdb::Property::createIndex(txn, "persons", "name", true);
+			nogdb::Class::create(txn, "knows", nogdb::ClassType::EDGE);
+			nogdb::Property::add(txn, "knows", "since", nogdb::PropertyType::INTEGER);
+			nogdb::Class::create(txn, "likes", nogdb::ClassType::EDGE);
+			nogdb::Property::add(txn, "likes", "since", nogdb::PropertyType::INTEGER);
+			txn.commit();
+		}
+		for (auto batch = 0; batch < numBatches; ++batch) {
+			auto records = std::vector<nogdb::Record>{};
+			for (auto i = batch * numVertices / numBatches; i < (batch + 1) * numVertices / numBatches; ++i) {
+				records.emplace_back(nogdb::Record{}.set("name", "p" + std::to_string(i)));
+			}
+			auto txn = nogdb::Txn{*bulkCtx, nogdb::Txn::Mode::READ_WRITE};
+			auto result = nogdb::BulkLoader::appendVertices(txn, "persons", records);
+			txn.commit();
+			vertices.insert(vertices.end(), result.begin(), result.end());
+		}
+		// every batch of edges is written with its relations in its own txn, and the last batch of knows is
+		// written after likes so that its relations cannot be appended at the end of the relation table
+		auto loadEdges = [&](const std::string &className, int batch, std::vector<size_t> &numOut) {
+			auto edgeRecords = std::vector<nogdb::EdgeRecord>{};
+			for (auto i = batch * numVertices / numBatches; i < (batch + 1) * numVertices / numBatches; ++i) {
+				for (auto j = 1; j <= i % 3 + 1; ++j) {
+					auto dst = (i * j + 7) % numVertices;
+					edgeRecords.emplace_back(vertices[i], vertices[dst], nogdb::Record{}.set("since", i));
+					++numOut[i];
+					++numIn[dst];
+				}
+			}
+			auto edgeRelations = std::vector<nogdb::Graph::EdgeRelation>{};
+			auto txn = nogdb::Txn{*bulkCtx, nogdb::Txn::Mode::READ_WRITE};
+			nogdb::BulkLoader::appendEdges(txn, className, edgeRecords, edgeRelations);
+			assert(edgeRelations.size() == edgeRecords.size());
+			nogdb::BulkLoader::appendRelations(txn, edgeRelations);
+			txn.commit();
+		};
+		for (auto batch = 0; batch < numBatches - 1; ++batch) {
+			loadEdges("knows", batch, numKnows);
+		}
+		for (auto batch = 0; batch < numBatches; ++batch) {
+			loadEdges("likes", batch, numLikes);
+		}
+		loadEdges("knows", numBatches - 1, numKnows);
+		delete bulkCtx;
+		bulkCtx = nullptr;
+	} catch (const nogdb::Error &ex) {
+		std::cout << "\nError: " << ex.what() << std::endl;
+		assert(false);
+	}
+
+	auto sum = [](const std::vector<size_t> &counts) {
+		auto total = size_t{0};
+		for (auto count: counts) {
+			total += count;
+		}
+		return total;
+	};
+	try {
+		bulkCtx = new nogdb::Context(dbPath);
+		auto txn = nogdb::Txn{*bulkCtx, nogdb::Txn::Mode::READ_ONLY};
+		assert(nogdb::Vertex::get(txn, "persons").size() == static_cast<size_t>(numVertices));
+		assert(nogdb::Edge::get(txn, "knows").size() == sum(numKnows));
+		assert(nogdb::Edge::get(txn, "likes").size() == sum(numLikes));
+		auto res = nogdb::Vertex::get(txn, "persons", nogdb::Condition("name").eq("p123"));
+		assert(res.size() == 1 && res[0].descriptor == vertices[123]);
+		for (auto i = 0; i < numVertices; ++i) {
+			auto knows = nogdb::Vertex::getOutEdge(txn, vertices[i], nogdb::ClassFilter{"knows"});
+			assert(knows.size() == numKnows[i]);
+			for (const auto &edge: knows) {
+				assert(edge.record.getInt("since") == i);
+				assert(nogdb::Edge::getSrc(txn, edge.descriptor).descriptor == vertices[i]);
+				auto dst = nogdb::Edge::getDst(txn, edge.descriptor).descriptor;
+				auto isValidDst = false;
+				for (auto j = 1; j <= i % 3 + 1; ++j) {
+					isValidDst = isValidDst || dst == vertices[(i * j + 7) % numVertices];
+				}
+				assert(isValidDst);
+			}
+			assert(nogdb::Vertex::getOutEdge(txn, vertices[i], nogdb::ClassFilter{"likes"}).size() == numLikes[i]);
+			assert(nogdb::Vertex::getInEdge(txn, vertices[i]).size() == numIn[i]);
+		}
+		txn.rollback();
+		delete bulkCtx;
+	} catch (const nogdb::Error &ex) {
+		std::cout << "\nError: " << ex.what() << std::endl;
+		assert(false);
+	}
+	system(clearDirCommand.c_str());
+}
+
+void test_reopen_ctx_many_relations() {
+	const auto dbPath = DATABASE_PATH + "_relations";
+	const auto clearDirCommand = "rm -rf " + dbPath;
+	system(clearDirCommand.c_str());
+	// enough relations in edge classes of very different sizes to be loaded by several threads
+	const auto numVertices = 1000;
+	const auto numEdges = std::vector<int>{100, 150000, 1000};
+	const auto classNames = std::vector<std::string>{"few", "many", "some"};
+	auto vertices = std::vector<nogdb::RecordDescriptor>{};
+	auto numOut = std::vector<std::vector<size_t>>(classNames.size(), std::vector<size_t>(numVertices));
+	auto numIn = std::vector<size_t>(numVertices);
+	try {
+		auto bulkCtx = nogdb::Context{dbPath};
+		auto txn = nogdb::Txn{bulkCtx, nogdb::Txn::Mode::READ_WRITE};
+		nogdb::Class::create(txn, "nodes", nogdb::ClassType::VERTEX);
+		for (const auto &className: classNames) {
+			nogdb::Class::create(txn, className, nogdb::ClassType::EDGE);
+		}
+		vertices = nogdb::BulkLoader::appendVertices(txn, "nodes", std::vector<nogdb::Record>(numVertices));
+		for (auto c = size_t{0}; c < classNames.size(); ++c) {
+			auto edgeRecords = std::vector<nogdb::EdgeRecord>{};
+			for (auto i = 0; i < numEdges[c]; ++i) {
+				// every class also has self-loops
+				auto src = (i * 7) % numVertices, dst = (i % 10 == 0) ? src : (i * 13 + 5) % numVertices;
+				edgeRecords.emplace_back(vertices[src], vertices[dst]);
+				++numOut[c][src];
+				++numIn[dst];
+			}
+			auto edgeRelations = std::vector<nogdb::Graph::EdgeRelation>{};
+			nogdb::BulkLoader::appendEdges(txn, classNames[c], edgeRecords, edgeRelations);
+			nogdb::BulkLoader::appendRelations(txn, edgeRelations);
+		}
+		txn.commit();
+	} catch (const nogdb::Error &ex) {
+		std::cout << "\nError: " << ex.what() << std::endl;
+		assert(false);
+	}
+
+	try {
+		auto relationCtx = nogdb::Context{dbPath};
+		auto txn = nogdb::Txn{relationCtx, nogdb::Txn::Mode::READ_ONLY};
+		for (auto c = size_t{0}; c < classNames.size(); ++c) {
+			assert(nogdb::Edge::get(txn, classNames[c]).size() == static_cast<size_t>(numEdges[c]));
+		}
+		for (auto i = 0; i < numVertices; ++i) {
+			for (auto c = size_t{0}; c < classNames.size(); ++c) {
+				auto edges = nogdb::Vertex::getOutEdge(txn, vertices[i], nogdb::ClassFilter{classNames[c]});
+				assert(edges.size() == numOut[c][i]);
+			}
+			assert(nogdb::Vertex::getInEdge(txn, vertices[i]).size() == numIn[i]);
+		}
+		txn.rollback();
+	} catch (const nogdb::Error &ex) {
+		std::cout << "\nError: " << ex.what() << std::endl;
+		assert(false);
+	}
+	system(clearDirCommand.c_str());
+}
+
+void test_reopen_ctx_adjacency_snapshot() {
+	const auto dbPath = DATABASE_PATH + "_snapshot";
+	const auto clearDirCommand = "rm -rf " + dbPath;
+	const auto snapshotPath = dbPath + nogdb::ADJACENCY_SNAPSHOT_FILE;
+	system(clearDirCommand.c_str());
+	typedef std::map<std::string, std::pair<std::string, std::string>> Relations;
+	auto readHeader = [&snapshotPath](std::streamoff offset) {
+		auto value = uint64_t{0};
+		auto file = std::ifstream{snapshotPath, std::ios::binary};
+		file.seekg(offset);
+		file.read(reinterpret_cast<char *>(&value), sizeof(value));
+		assert(file.good());
+		return value;
+	};
+	auto copyFile = [](const std::string &from, const std::string &to) {
+		auto src = std::ifstream{from, std::ios::binary};
+		auto dst = std::ofstream{to, std::ios::binary | std::ios::trunc};
+		dst << src.rdbuf();
+		assert(src.good() && dst.good());
+	};
+	auto verifyGraph = [&dbPath](const Relations &expected) {
+		try {
+			auto snapshotCtx = nogdb::Context{dbPath};
+			auto txn = nogdb::Txn{snapshotCtx, nogdb::Txn::Mode::READ_ONLY};
+			auto edges = nogdb::Edge::get(txn, "links");
+			assert(edges.size() == expected.size());
+			for (const auto &edge: edges) {
+				const auto &relation = expected.at(edge.record.get("name").toText());
+				assert(nogdb::Edge::getSrc(txn, edge.descriptor).record.get("name").toText() == relation.first);
+				assert(nogdb::Edge::getDst(txn, edge.descriptor).record.get("name").toText() == relation.second);
+			}
+			for (const auto &vertex: nogdb::Vertex::get(txn, "nodes")) {
+				auto name = vertex.record.get("name").toText();
+				auto outNames = std::set<std::string>{}, inNames = std::set<std::string>{};
+				for (const auto &relation: expected) {
+					if (relation.second.first == name) {
+						outNames.insert(relation.first);
+					}
+					if (relation.second.second == name) {
+						inNames.insert(relation.first);
+					}
+				}
+				auto outEdges = std::set<std::string>{}, inEdges = std::set<std::string>{};
+				for (const auto &edge: nogdb::Vertex::getOutEdge(txn, vertex.descriptor)) {
+					outEdges.insert(edge.record.get("name").toText());
+				}
+				for (const auto &edge: nogdb::Vertex::getInEdge(txn, vertex.descriptor)) {
+					inEdges.insert(edge.record.get("name").toText());
+				}
+				assert(outEdges == outNames);
+				assert(inEdges == inNames);
+			}
+			txn.rollback();
+		} catch (const nogdb::Error &ex) {
+			std::cout << "\nError: " << ex.what() << std::endl;
+			assert(false);
+		}
+	};
+
+	auto expected = Relations{{"e0", {"v0", "v1"}}, {"e1", {"v1", "v2"}}, {"loop", {"v2", "v2"}},
+	                          {"e3", {"v3", "v0"}}, {"e4", {"v0", "v4"}}};
+	auto vertexNames = std::vector<std::string>{"v0", "v1", "v2", "v3", "v4"};
+	auto vertices = std::map<std::string, nogdb::RecordDescriptor>{};
+	auto edges = std::map<std::string, nogdb::RecordDescriptor>{};
+	try {
+		auto snapshotCtx = nogdb::Context{dbPath};
+		auto txn = nogdb::Txn{snapshotCtx, nogdb::Txn::Mode::READ_WRITE};
+		nogdb::Class::create(txn, "nodes", nogdb::ClassType::VERTEX);
+		nogdb::Property::add(txn, "nodes", "name", nogdb::PropertyType::TEXT);
+		nogdb::Class::create(txn, "links", nogdb::ClassType::EDGE);
+		nogdb::Property::add(txn, "links", "name", nogdb::PropertyType::TEXT);
+		for (const auto &name: vertexNames) {
+			vertices[name] = nogdb::Vertex::create(txn, "nodes", nogdb::Record{}.set("name", name));
+		}
+		for (const auto &relation: expected) {
+			edges[relation.first] = nogdb::Edge::create(txn, "links", vertices[relation.second.first],
+			                                            vertices[relation.second.second],
+			                                            nogdb::Record{}.set("name", relation.first));
+		}
+		txn.commit();
+	} catch (const nogdb::Error &ex) {
+		std::cout << "\nError: " << ex.what() << std::endl;
+		assert(false);
+	}
+
+	// the last context writes a snapshot of all committed relations including the self-loop
+	auto snapshotTxnId = readHeader(16);
+	assert(readHeader(32) == expected.size());
+	auto relationParts = std::vector<std::vector<nogdb::Graph::EdgeRelation>>{};
+	assert(nogdb::AdjacencySnapshot::read(snapshotPath, snapshotTxnId, expected.size(), relationParts));
+	auto relations = std::set<nogdb::Graph::EdgeRelation>{};
+	for (const auto &part: relationParts) {
+		relations.insert(part.cbegin(), part.cend());
+	}
+	assert(relations.size() == expected.size());
+	for (const auto &relation: expected) {
+		assert(relations.count(nogdb::Graph::EdgeRelation{edges[relation.first].rid,
+		                                                  vertices[relation.second.first].rid,
+		                                                  vertices[relation.second.second].rid}) == 1);
+	}
+	assert(!nogdb::AdjacencySnapshot::read(snapshotPath, snapshotTxnId + 1, expected.size(), relationParts));
+	assert(relationParts.empty());
+	assert(!nogdb::AdjacencySnapshot::read(snapshotPath, snapshotTxnId, expected.size() - 1, relationParts));
+	verifyGraph(expected);
+
+	// edges changed or deleted after a snapshot is written are in the next snapshot
+	const auto staleSnapshotPath = dbPath + "/stale.snapshot";
+	copyFile(snapshotPath, staleSnapshotPath);
+	try {
+		auto snapshotCtx = nogdb::Context{dbPath};
+		auto txn = nogdb::Txn{snapshotCtx, nogdb::Txn::Mode::READ_WRITE};
+		nogdb::Edge::destroy(txn, edges["e1"]);
+		nogdb::Edge::updateDst(txn, edges["e4"], vertices["v3"]);
+		nogdb::Edge::updateSrc(txn, edges["e3"], vertices["v4"]);
+		edges["e5"] = nogdb::Edge::create(txn, "links", vertices["v1"], vertices["v1"],
+		                                  nogdb::Record{}.set("name", "e5"));
+		txn.commit();
+	} catch (const nogdb::Error &ex) {
+		std::cout << "\nError: " << ex.what() << std::endl;
+		assert(false);
+	}
+	expected.erase("e1");
+	expected["e4"] = {"v0", "v3"};
+	expected["e3"] = {"v4", "v0"};
+	expected["e5"] = {"v1", "v1"};
+	auto lastTxnId = readHeader(16);
+	assert(lastTxnId != snapshotTxnId);
+	assert(readHeader(32) == expected.size());
+	assert(nogdb::AdjacencySnapshot::read(snapshotPath, lastTxnId, expected.size(), relationParts));
+	verifyGraph(expected);
+
+	// a stale snapshot is ignored and the graph is loaded from the relation table
+	// NOTE: every opening commits its initialization, so the snapshot of each closing has a new txn id
+	lastTxnId = readHeader(16);
+	copyFile(staleSnapshotPath, snapshotPath);
+	assert(!nogdb::AdjacencySnapshot::read(snapshotPath, lastTxnId, expected.size(), relationParts));
+	verifyGraph(expected);
+
+	// so are truncated and corrupted snapshots
+	lastTxnId = readHeader(16);
+	auto fileSize = static_cast<off_t>(std::ifstream{snapshotPath, std::ios::binary | std::ios::ate}.tellg());
+	assert(::truncate(snapshotPath.c_str(), fileSize / 2) == 0);
+	assert(!nogdb::AdjacencySnapshot::read(snapshotPath, lastTxnId, expected.size(), relationParts));
+	verifyGraph(expected);
+	lastTxnId = readHeader(16);
+	assert(::truncate(snapshotPath.c_str(), 8) == 0);
+	assert(!nogdb::AdjacencySnapshot::read(snapshotPath, lastTxnId, expected.size(), relationParts));
+	verifyGraph(expected);
+	lastTxnId = readHeader(16);
+	{
+		// the destination of the last edge points out of the vertices
+		auto file = std::fstream{snapshotPath, std::ios::binary | std::ios::in | std::ios::out};
+		file.seekp(fileSize - static_cast<std::streamoff>(sizeof(uint64_t)));
+		auto target = std::numeric_limits<uint64_t>::max();
+		file.write(reinterpret_cast<const char *>(&target), sizeof(target));
+		assert(file.good());
+	}
+	assert(!nogdb::AdjacencySnapshot::read(snapshotPath, lastTxnId, expected.size(), relationParts));
+	verifyGraph(expected);
+	lastTxnId = readHeader(16);
+	{
+		auto file = std::fstream{snapshotPath, std::ios::binary | std::ios::in | std::ios::out};
+		file.write("XXXXXXXX", 8);
+		assert(file.good());
+	}
+	assert(!nogdb::AdjacencySnapshot::read(snapshotPath, lastTxnId, expected.size(), relationParts));
+	verifyGraph(expected);
+	assert(nogdb::AdjacencySnapshot::read(snapshotPath, readHeader(16), expected.size(), relationParts));
+	system(clearDirCommand.c_str());
+}
+
+void test_reopen_ctx_text_relation_keys() {
+	const auto dbPath = DATABASE_PATH + "_relation_keys";
+	const auto clearDirCommand = "rm -rf " + dbPath;
+	system(clearDirCommand.c_str());
+	auto vertices = std::map<std::string, nogdb::RecordDescriptor>{};
+	auto edges = std::map<std::string, nogdb::RecordDescriptor>{};
+	const auto relations = std::map<std::string, std::pair<std::string, std::string>>{
+			{"ab", {"a", "b"}}, {"bc", {"b", "c"}}, {"cc", {"c", "c"}}, {"ca", {"c", "a"}}};
+	try {
+		auto keyCtx = nogdb::Context{dbPath};
+		auto txn = nogdb::Txn{keyCtx, nogdb::Txn::Mode::READ_WRITE};
+		nogdb::Class::create(txn, "nodes", nogdb::ClassType::VERTEX);
+		nogdb::Property::add(txn, "nodes", "name", nogdb::PropertyType::TEXT);
+		nogdb::Class::create(txn, "links", nogdb::ClassType::EDGE);
+		for (const auto &name: {"a", "b", "c"}) {
+			vertices[name] = nogdb::Vertex::create(txn, "nodes", nogdb::Record{}.set("name", name));
+		}
+		for (const auto &relation: relations) {
+			edges[relation.first] = nogdb::Edge::create(txn, "links", vertices[relation.second.first],
+			                                            vertices[relation.second.second]);
+		}
+		txn.commit();
+	} catch (const nogdb::Error &ex) {
+		std::cout << "\nError: " << ex.what() << std::endl;
+		assert(false);
+	}
+
+	// call access(txn, relationDBHandler, dbInfoDBHandler) on the datastore of a closed database
+	auto accessDatastore = [&dbPath](nogdb::Datastore::Txn txnType,
+	                                 const std::function<void(nogdb::Datastore::TxnHandler *,
+	                                                          nogdb::Datastore::DBHandler,
+	                                                          nogdb::Datastore::DBHandler)> &access) {
+		auto env = static_cast<nogdb::Datastore::EnvHandler *>(nullptr);
+		auto txn = static_cast<nogdb::Datastore::TxnHandler *>(nullptr);
+		try {
+			env = nogdb::Datastore::createEnv(dbPath, nogdb::MAX_DB_NUM, nogdb::MAX_DB_SIZE,
+			                                  nogdb::Datastore::MAX_READERS, nogdb::Datastore::FLAG,
+			                                  nogdb::Datastore::PERMISSION);
+			txn = nogdb::Datastore::beginTxn(env, txnType);
+			access(txn, nogdb::Datastore::openDbi(txn, nogdb::TB_RELATIONS),
+			       nogdb::Datastore::openDbi(txn, nogdb::TB_DBINFO));
+			if (txnType == nogdb::Datastore::TXN_RW) {
+				nogdb::Datastore::commitTxn(txn);
+			} else {
+				nogdb::Datastore::abortTxn(txn);
+			}
+		} catch (nogdb::Datastore::ErrorType &err) {
+			std::cout << "\nError: datastore error " << err << std::endl;
+			assert(false);
+		}
+		nogdb::Datastore::destroyEnv(env);
+	};
+	typedef std::vector<std::pair<std::string, std::string>> KeyValues;
+	auto dumpRelations = [&accessDatastore]() {
+		auto keyValues = KeyValues{};
+		accessDatastore(nogdb::Datastore::TXN_RO, [&keyValues](nogdb::Datastore::TxnHandler *txn,
+		                                                      nogdb::Datastore::DBHandler relationDBHandler,
+		                                                      nogdb::Datastore::DBHandler dbInfoDBHandler) {
+			auto relationFormat = nogdb::Datastore::getRecord(txn, dbInfoDBHandler, nogdb::DBINFO_RELATION_FORMAT);
+			assert(nogdb::Datastore::getValueAsString(relationFormat) == nogdb::RELATION_FORMAT_BINARY_KEY);
+			auto cursorHandler = nogdb::Datastore::CursorHandlerWrapper(txn, relationDBHandler);
+			for (auto keyValue = nogdb::Datastore::getNextCursor(cursorHandler.get());
+			     !keyValue.empty();
+			     keyValue = nogdb::Datastore::getNextCursor(cursorHandler.get())) {
+				keyValues.emplace_back(nogdb::Datastore::getKeyAsString(keyValue),
+				                       nogdb::Datastore::getValueAsString(keyValue));
+			}
+		});
+		return keyValues;
+	};
+	auto verifyGraph = [&]() {
+		try {
+			auto keyCtx = nogdb::Context{dbPath};
+			auto txn = nogdb::Txn{keyCtx, nogdb::Txn::Mode::READ_ONLY};
+			for (const auto &relation: relations) {
+				const auto &edge = edges.at(relation.first);
+				assert(nogdb::Edge::getSrc(txn, edge).descriptor == vertices.at(relation.second.first));
+				assert(nogdb::Edge::getDst(txn, edge).descriptor == vertices.at(relation.second.second));
+			}
+			assert(nogdb::Vertex::getOutEdge(txn, vertices.at("a")).size() == 1);
+			assert(nogdb::Vertex::getInEdge(txn, vertices.at("a")).size() == 1);
+			assert(nogdb::Vertex::getOutEdge(txn, vertices.at("c")).size() == 2);
+			assert(nogdb::Vertex::getInEdge(txn, vertices.at("c")).size() == 2);
+			assert(nogdb::Vertex::getAllEdge(txn, vertices.at("c")).size() == 3);
+			txn.rollback();
+		} catch (const nogdb::Error &ex) {
+			std::cout << "\nError: " << ex.what() << std::endl;
+			assert(false);
+		}
+		system(("rm -f " + dbPath + nogdb::ADJACENCY_SNAPSHOT_FILE).c_str());
+	};
+
+	// rewrite relations with the text keys and the init record of databases before binary keys
+	auto binaryKeyValues = dumpRelations();
+	assert(binaryKeyValues.size() == relations.size());
+	accessDatastore(nogdb::Datastore::TXN_RW, [](nogdb::Datastore::TxnHandler *txn,
+	                                             nogdb::Datastore::DBHandler relationDBHandler,
+	                                             nogdb::Datastore::DBHandler dbInfoDBHandler) {
+		auto textKeyValues = std::vector<std::pair<std::string, nogdb::Blob>>{};
+		{
+			auto cursorHandler = nogdb::Datastore::CursorHandlerWrapper(txn, relationDBHandler);
+			for (auto keyValue = nogdb::Datastore::getNextCursor(cursorHandler.get());
+			     !keyValue.empty();
+			     keyValue = nogdb::Datastore::getNextCursor(cursorHandler.get())) {
+				textKeyValues.emplace_back(nogdb::rid2str(nogdb::Relation::toEdgeId(keyValue)),
+				                           nogdb::Datastore::getValueAsBlob(keyValue));
+			}
+		}
+		nogdb::Datastore::emptyDbi(txn, relationDBHandler);
+		nogdb::Datastore::putRecord(txn, relationDBHandler, nogdb::STRING_EM_INIT, std::string{"0"});
+		for (const auto &keyValue: textKeyValues) {
+			nogdb::Datastore::putRecord(txn, relationDBHandler, keyValue.first, keyValue.second);
+		}
+		nogdb::Datastore::deleteRecord(txn, dbInfoDBHandler, nogdb::DBINFO_RELATION_FORMAT);
+	});
+	system(("rm -f " + dbPath + nogdb::ADJACENCY_SNAPSHOT_FILE).c_str());
+
+	// the first opening migrates the keys in place
+	verifyGraph();
+	auto migratedKeyValues = dumpRelations();
+	assert(migratedKeyValues == binaryKeyValues);
+	for (const auto &keyValue: migratedKeyValues) {
+		assert(keyValue.first.size() == sizeof(nogdb::Relation::Key));
+	}
+
+	// and the next one leaves them as they are
+	verifyGraph();
+	assert(dumpRelations() == binaryKeyValues);
+	system(clearDirCommand.c_str());
+}
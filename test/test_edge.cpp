@@ -63,6 +63,55 @@ void test_create_edges() {
     destroy_vertex_book();
 }
 
+void test_create_edges_batch() {
+    init_vertex_book();
+    init_vertex_person();
+    init_edge_author();
+
+    auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+    nogdb::RecordDescriptor v1_1{}, v1_2{}, v2{};
+    try {
+        v1_1 = nogdb::Vertex::create(txn, "books", nogdb::Record{}.set("title", "Harry Potter"));
+        v1_2 = nogdb::Vertex::create(txn, "books", nogdb::Record{}.set("title", "Fantastic Beasts"));
+        v2 = nogdb::Vertex::create(txn, "persons", nogdb::Record{}.set("name", "J.K. Rowlings"));
+
+        auto edgeRecords = std::vector<nogdb::EdgeRecord>{};
+        edgeRecords.emplace_back(v1_1, v2, nogdb::Record{}.set("time_used", 365U));
+        edgeRecords.emplace_back(v1_2, v2, nogdb::Record{}.set("time_used", 180U));
+        edgeRecords.emplace_back(v1_1, v2);
+        auto rdescs = nogdb::Edge::createBatch(txn, "authors", edgeRecords);
+        assert(rdescs.size() == 3);
+
+        assert(nogdb::Vertex::getOutEdge(txn, v1_1).size() == 2);
+        assert(nogdb::Vertex::getOutEdge(txn, v1_2).size() == 1);
+        assert(nogdb::Vertex::getInEdge(txn, v2).size() == 3);
+        assert(nogdb::Edge::getSrc(txn, rdescs[1]).descriptor == v1_2);
+        assert(nogdb::Edge::getDst(txn, rdescs[1]).descriptor == v2);
+        assert(nogdb::Db::getRecord(txn, rdescs[0]).get("time_used").toIntU() == 365U);
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+    txn.commit();
+
+    txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+    try {
+        auto edgeRecords = std::vector<nogdb::EdgeRecord>{};
+        edgeRecords.emplace_back(v1_1, v2);
+        edgeRecords.emplace_back(v1_1, nogdb::RecordDescriptor{v2.rid.first, 9999});
+        nogdb::Edge::createBatch(txn, "authors", edgeRecords);
+        assert(false);
+    } catch (const nogdb::Error &ex) {
+        REQUIRE(ex, GRAPH_NOEXST_DST, "GRAPH_NOEXST_DST");
+    }
+    assert(nogdb::Edge::get(txn, "authors").size() == 3);
+    txn.rollback();
+
+    destroy_edge_author();
+    destroy_vertex_person();
+    destroy_vertex_book();
+}
+
 void test_create_invalid_edge() {
     init_vertex_book();
     init_vertex_person();
@@ -19,6 +19,7 @@
  *
  */
 
+#include <iterator>
 #include <map>
 #include <string>
 #include "runtest.h"
@@ -351,3 +352,101 @@ void test_negative_expression() {
 
 }
 
+
+void test_like_pattern_expression() {
+    nogdb::PropertyMapType propTypes;
+    propTypes.emplace("name", nogdb::PropertyType::TEXT);
+
+    nogdb::Record r1{}, r2{}, r3{}, r4{};
+    r1.set("name", "a.b.c.d");
+    r2.set("name", "aXbXcXd");
+    r3.set("name", "Mississippi");
+    r4.set("name", "(x)+[y]");
+
+    auto like1 = nogdb::Condition("name").like("a.b%");
+    auto like2 = nogdb::Condition("name").like("%ss%ss%pi");
+    auto like3 = nogdb::Condition("name").like("m%%I_sI%").ignoreCase();
+    auto like4 = nogdb::Condition("name").like("(x)+[%]");
+    auto like5 = nogdb::Condition("name").like("%");
+    auto like6 = nogdb::Condition("name").like("a_b_c_d");
+
+    try {
+        // wildcards other than '%' and '_' are matched literally
+        assert((like1 && like1).execute(r1, propTypes) == true);
+        assert((like1 && like1).execute(r2, propTypes) == false);
+        assert((like2 && like2).execute(r3, propTypes) == true);
+        assert((like2 && like2).execute(r1, propTypes) == false);
+        assert((like3 && like3).execute(r3, propTypes) == true);
+        assert((like3 && !like1).execute(r3, propTypes) == true);
+        assert((like4 && like5).execute(r4, propTypes) == true);
+        assert((like4 && like5).execute(r3, propTypes) == false);
+        assert((like6 && like5).execute(r1, propTypes) == true);
+        assert((like6 && like5).execute(r2, propTypes) == true);
+        assert((!like6 && like5).execute(r3, propTypes) == true);
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+}
+
+void test_long_text_expression() {
+    nogdb::PropertyMapType propTypes;
+    propTypes.emplace("text", nogdb::PropertyType::TEXT);
+    propTypes.emplace("status", nogdb::PropertyType::TEXT);
+
+    auto to_lower = [](const std::string &text) {
+        auto tmp = std::string{};
+        std::transform(text.cbegin(), text.cend(), std::back_inserter(tmp), ::tolower);
+        return tmp;
+    };
+    auto baseCondition = nogdb::Condition("status").null();
+    auto patterns = std::vector<std::string>{"x", "Zq", "needle", "NeEdLe@[`{", "aaab"};
+
+    try {
+        // texts longer than a vector register with patterns at every position
+        for (const auto &pattern: patterns) {
+            for (auto length = size_t{0}; length < 80; length += 7) {
+                for (auto pos = size_t{0}; pos <= length; pos += 5) {
+                    auto text = std::string(length, 'a');
+                    for (auto i = size_t{0}; i < length; i += 3) {
+                        text[i] = static_cast<char>('A' + (i % 26));
+                    }
+                    text.replace(pos, std::min(pattern.size(), length - pos), to_lower(pattern));
+                    nogdb::Record r{};
+                    r.set("text", text);
+                    auto lowerText = to_lower(text);
+                    for (auto isIgnoreCase: {false, true}) {
+                        auto value = isIgnoreCase ? lowerText : text;
+                        auto cmpValue = isIgnoreCase ? to_lower(pattern) : pattern;
+                        auto contain = nogdb::Condition("text").contain(pattern);
+                        auto beginWith = nogdb::Condition("text").beginWith(pattern);
+                        auto endWith = nogdb::Condition("text").endWith(pattern);
+                        auto eq = nogdb::Condition("text").eq(text);
+                        auto gt = nogdb::Condition("text").gt(pattern);
+                        if (isIgnoreCase) {
+                            contain = contain.ignoreCase();
+                            beginWith = beginWith.ignoreCase();
+                            endWith = endWith.ignoreCase();
+                            eq = nogdb::Condition("text").eq(lowerText).ignoreCase();
+                            gt = gt.ignoreCase();
+                        }
+                        assert((baseCondition && contain).execute(r, propTypes) ==
+                               (value.find(cmpValue) != std::string::npos));
+                        assert((baseCondition && beginWith).execute(r, propTypes) ==
+                               (value.compare(0, cmpValue.size(), cmpValue) == 0 && value.size() >= cmpValue.size()));
+                        assert((baseCondition && endWith).execute(r, propTypes) ==
+                               (value.size() >= cmpValue.size() &&
+                                value.compare(value.size() - cmpValue.size(), cmpValue.size(), cmpValue) == 0));
+                        assert((baseCondition && eq).execute(r, propTypes) == !text.empty());
+                        assert((baseCondition && gt).execute(r, propTypes) == (!text.empty() && value > cmpValue));
+                    }
+                }
+            }
+        }
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+}
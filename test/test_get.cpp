@@ -3510,3 +3510,252 @@ void test_find_invalid_edge_all_cursor_with_expression() {
         REQUIRE(ex, GRAPH_NOEXST_VERTEX, "GRAPH_NOEXST_VERTEX");
     }
 }
+
+template<typename T>
+void verify_raw_condition(nogdb::Txn &txn, const T &condition, bool (*expected)(const nogdb::Record &)) {
+    auto toPositions = [](const nogdb::ResultSet &res) {
+        auto positions = std::vector<nogdb::PositionId>{};
+        for (const auto &r: res) {
+            assert(r.record.getText("@className") == "raw_types");
+            positions.push_back(r.descriptor.rid.second);
+        }
+        std::sort(positions.begin(), positions.end());
+        return positions;
+    };
+    auto res = nogdb::Vertex::get(txn, "raw_types", condition);
+    auto expectedRes = nogdb::Vertex::get(txn, "raw_types", expected);
+    assert(!expectedRes.empty());
+    assert(toPositions(res) == toPositions(expectedRes));
+    assert(nogdb::Vertex::getCursor(txn, "raw_types", condition).size() == expectedRes.size());
+}
+
+void test_find_vertex_with_raw_types() {
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Class::create(txn, "raw_types", nogdb::ClassType::VERTEX);
+        nogdb::Property::add(txn, "raw_types", "ti", nogdb::PropertyType::TINYINT);
+        nogdb::Property::add(txn, "raw_types", "uti", nogdb::PropertyType::UNSIGNED_TINYINT);
+        nogdb::Property::add(txn, "raw_types", "si", nogdb::PropertyType::SMALLINT);
+        nogdb::Property::add(txn, "raw_types", "usi", nogdb::PropertyType::UNSIGNED_SMALLINT);
+        nogdb::Property::add(txn, "raw_types", "i", nogdb::PropertyType::INTEGER);
+        nogdb::Property::add(txn, "raw_types", "ui", nogdb::PropertyType::UNSIGNED_INTEGER);
+        nogdb::Property::add(txn, "raw_types", "bi", nogdb::PropertyType::BIGINT);
+        nogdb::Property::add(txn, "raw_types", "ubi", nogdb::PropertyType::UNSIGNED_BIGINT);
+        nogdb::Property::add(txn, "raw_types", "r", nogdb::PropertyType::REAL);
+        nogdb::Property::add(txn, "raw_types", "t", nogdb::PropertyType::TEXT);
+        for (auto i = 0; i < 20; ++i) {
+            auto record = nogdb::Record{};
+            record.set("ti", static_cast<int8_t>(i * 13 - 120))
+                    .set("uti", static_cast<uint8_t>(i * 13))
+                    .set("si", static_cast<int16_t>(i * 1000 - 9000))
+                    .set("usi", static_cast<uint16_t>(i * 3000))
+                    .set("i", static_cast<int32_t>(i * i - 100))
+                    .set("ui", static_cast<uint32_t>(i * 100000))
+                    .set("bi", static_cast<int64_t>(i) * -1000000000000LL)
+                    .set("ubi", static_cast<uint64_t>(i) << 40)
+                    .set("r", i * 0.5 - 3.0);
+            if (i % 5 != 0) {
+                record.set("t", "text" + std::to_string(i));
+            }
+            nogdb::Vertex::create(txn, "raw_types", record);
+        }
+        txn.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    // conditions evaluated on raw data of records should match the same conditions on parsed records
+    auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+    try {
+        verify_raw_condition(txn, nogdb::Condition("ti").lt(static_cast<int8_t>(0)), [](const nogdb::Record &r) {
+            return r.getTinyInt("ti") < 0;
+        });
+        verify_raw_condition(txn, nogdb::Condition("uti").between(static_cast<uint8_t>(50), static_cast<uint8_t>(200),
+                                                                  {false, true}), [](const nogdb::Record &r) {
+            return r.getTinyIntU("uti") > 50 && r.getTinyIntU("uti") <= 200;
+        });
+        verify_raw_condition(txn, !nogdb::Condition("si").ge(static_cast<int16_t>(0)), [](const nogdb::Record &r) {
+            return r.getSmallInt("si") < 0;
+        });
+        verify_raw_condition(txn, nogdb::Condition("usi").in(static_cast<uint16_t>(0), static_cast<uint16_t>(3000),
+                                                             static_cast<uint16_t>(60000)), [](const nogdb::Record &r) {
+            return r.getSmallIntU("usi") == 0 || r.getSmallIntU("usi") == 3000 || r.getSmallIntU("usi") == 60000;
+        });
+        verify_raw_condition(txn, nogdb::Condition("i").gt(0) && nogdb::Condition("ui").le(1500000U),
+                             [](const nogdb::Record &r) {
+                                 return r.getInt("i") > 0 && r.getIntU("ui") <= 1500000U;
+                             });
+        verify_raw_condition(txn, nogdb::Condition("bi").lt(static_cast<int64_t>(-15000000000000LL)) ||
+                                  nogdb::Condition("r").eq(2.0), [](const nogdb::Record &r) {
+            return r.getBigInt("bi") < -15000000000000LL || r.getReal("r") == 2.0;
+        });
+        verify_raw_condition(txn, nogdb::Condition("ubi").ge(static_cast<uint64_t>(1) << 44),
+                             [](const nogdb::Record &r) {
+                                 return r.getBigIntU("ubi") >= (static_cast<uint64_t>(1) << 44);
+                             });
+        verify_raw_condition(txn, nogdb::Condition("t").null(), [](const nogdb::Record &r) {
+            return r.get("t").empty();
+        });
+        verify_raw_condition(txn, nogdb::Condition("t").beginWith("text1") || nogdb::Condition("t").endWith("7"),
+                             [](const nogdb::Record &r) {
+                                 auto t = r.get("t").empty() ? std::string{} : r.getText("t");
+                                 return t.find("text1") == 0 || (!t.empty() && t.back() == '7');
+                             });
+        verify_raw_condition(txn, nogdb::Condition("t").contain("xt1") && !nogdb::Condition("t").gt("text15"),
+                             [](const nogdb::Record &r) {
+                                 auto t = r.get("t").empty() ? std::string{} : r.getText("t");
+                                 return t.find("xt1") != std::string::npos && t <= "text15";
+                             });
+        verify_raw_condition(txn, nogdb::Condition("t").in("text2", "text7", "text10"), [](const nogdb::Record &r) {
+            auto t = r.get("t").empty() ? std::string{} : r.getText("t");
+            return t == "text2" || t == "text7";
+        });
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+    txn.commit();
+
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Class::drop(txn, "raw_types");
+        txn.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+}
+
+bool is_scan_value_even(const nogdb::Record &r) {
+    return r.getInt("value") % 2 == 0;
+}
+
+void test_find_vertex_with_parallel_scan() {
+    // enough records to split a scan of each class among several threads
+    const auto numRecords = int32_t{50000};
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Class::create(txn, "scan_base", nogdb::ClassType::VERTEX);
+        nogdb::Property::add(txn, "scan_base", "value", nogdb::PropertyType::INTEGER);
+        nogdb::Property::add(txn, "scan_base", "text", nogdb::PropertyType::TEXT);
+        nogdb::Class::createExtend(txn, "scan_sub", "scan_base");
+        for (auto i = int32_t{0}; i < numRecords; ++i) {
+            nogdb::Vertex::create(txn, (i % 5 == 0) ? "scan_sub" : "scan_base", nogdb::Record{}
+                    .set("value", i)
+                    .set("text", "text" + std::to_string(i)));
+        }
+        txn.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    auto toRids = [](const nogdb::ResultSet &res) {
+        auto rids = std::vector<nogdb::RecordId>{};
+        for (const auto &r: res) {
+            rids.push_back(r.descriptor.rid);
+        }
+        return rids;
+    };
+    auto toCursorRids = [](nogdb::ResultSetCursor res) {
+        auto rids = std::vector<nogdb::RecordId>{};
+        while (res.next()) {
+            rids.push_back(res->descriptor.rid);
+        }
+        return rids;
+    };
+    auto condition = nogdb::Condition("text").endWith("7");
+    auto expression = nogdb::Condition("value").ge(1000) && nogdb::Condition("text").contain("99");
+    auto getAll = [&](nogdb::Txn &txn) {
+        return std::vector<std::vector<nogdb::RecordId>>{
+                toRids(nogdb::Vertex::get(txn, "scan_base")),
+                toRids(nogdb::Vertex::get(txn, "scan_base", condition)),
+                toRids(nogdb::Vertex::get(txn, "scan_base", expression)),
+                toRids(nogdb::Vertex::get(txn, "scan_base", is_scan_value_even)),
+                toCursorRids(nogdb::Vertex::getCursor(txn, "scan_base")),
+                toCursorRids(nogdb::Vertex::getCursor(txn, "scan_base", condition)),
+                toCursorRids(nogdb::Vertex::getCursor(txn, "scan_base", expression)),
+                toCursorRids(nogdb::Vertex::getCursor(txn, "scan_base", is_scan_value_even))
+        };
+    };
+
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+        auto expected = getAll(txn);
+        assert(expected[0].size() == static_cast<size_t>(numRecords));
+        assert(expected[1].size() == static_cast<size_t>(numRecords / 10));
+        assert(expected[3].size() == static_cast<size_t>(numRecords / 2));
+        assert(ctx->getScanStat().numParallelScans == 0);
+        ctx->setNumScanThreads(4);
+        assert(getAll(txn) == expected);
+        ctx->setNumScanThreads(0);
+        assert(getAll(txn) == expected);
+        auto stat = ctx->getScanStat();
+        assert(stat.numParallelScans > 0);
+        assert(stat.numSnapshotFallbacks == 0);
+
+        // a read-only txn still sees its own snapshot while the other threads would see a newer one
+        {
+            auto writeTxn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+            nogdb::Vertex::create(writeTxn, "scan_sub", nogdb::Record{}.set("value", 7).set("text", "7"));
+            // a read-write txn is always scanned on the calling thread
+            assert(nogdb::Vertex::get(writeTxn, "scan_base").size() == static_cast<size_t>(numRecords + 1));
+            writeTxn.commit();
+        }
+        // the other threads cannot read the snapshot of the txn any more, so its scans stay on the calling thread
+        ctx->setNumScanThreads(4);
+        assert(getAll(txn) == expected);
+        assert(ctx->getScanStat().numParallelScans == stat.numParallelScans);
+        assert(ctx->getScanStat().numSnapshotFallbacks > 0);
+        ctx->setNumScanThreads(1);
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    // after a reopen, class tables are first opened by a read-only txn whose handles are not valid in other txns yet
+    // NOTE: classes may be in another order in a new context
+    auto getAllSorted = [&](nogdb::Txn &txn) {
+        auto all = getAll(txn);
+        for (auto &rids: all) {
+            std::sort(rids.begin(), rids.end());
+        }
+        return all;
+    };
+    delete ctx;
+    try {
+        ctx = new nogdb::Context(DATABASE_PATH);
+        auto expected = std::vector<std::vector<nogdb::RecordId>>{};
+        {
+            auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+            expected = getAllSorted(txn);
+            assert(expected[0].size() == static_cast<size_t>(numRecords + 1));
+        }
+        delete ctx;
+        ctx = new nogdb::Context(DATABASE_PATH);
+        ctx->setNumScanThreads(4);
+        {
+            auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+            assert(getAllSorted(txn) == expected);
+        }
+        {
+            auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+            assert(getAllSorted(txn) == expected);
+        }
+        ctx->setNumScanThreads(1);
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Class::drop(txn, "scan_sub");
+        nogdb::Class::drop(txn, "scan_base");
+        txn.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+}
@@ -21,7 +21,11 @@
 
 #include "runtest.h"
 #include "test_exec.h"
+#include <atomic>
+#include <exception>
 #include <set>
+#include <string>
+#include <thread>
 #include <vector>
 #include <list>
 
@@ -4392,4 +4396,158 @@ void test_shortest_path_cursor_with_condition() {
     }
 
     txn.commit();
-}
\ No newline at end of file
+}
+
+void test_traverse_edges_with_class_filter() {
+    typedef std::multiset<std::string> Names;
+    typedef std::vector<std::string> Path;
+    auto edgeNames = [](const nogdb::ResultSet &result) {
+        auto names = Names{};
+        for (const auto &res: result) {
+            names.insert(res.record.get("name").toText());
+        }
+        return names;
+    };
+    auto cursorNames = [](nogdb::ResultSetCursor &&result) {
+        auto names = Names{};
+        while (result.next()) {
+            names.insert(result->record.get("name").toText());
+        }
+        return names;
+    };
+    auto vertexNames = [](const nogdb::ResultSet &result) {
+        auto names = Path{};
+        for (const auto &res: result) {
+            names.push_back(res.record.get("name").toText());
+        }
+        return names;
+    };
+    auto hub = nogdb::RecordDescriptor{}, v1 = nogdb::RecordDescriptor{};
+    auto v2 = nogdb::RecordDescriptor{}, v3 = nogdb::RecordDescriptor{};
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Class::create(txn, "traverse_nodes", nogdb::ClassType::VERTEX);
+        nogdb::Property::add(txn, "traverse_nodes", "name", nogdb::PropertyType::TEXT);
+        nogdb::Class::create(txn, "traverse_a", nogdb::ClassType::EDGE);
+        nogdb::Property::add(txn, "traverse_a", "name", nogdb::PropertyType::TEXT);
+        nogdb::Class::create(txn, "traverse_b", nogdb::ClassType::EDGE);
+        nogdb::Property::add(txn, "traverse_b", "name", nogdb::PropertyType::TEXT);
+        hub = nogdb::Vertex::create(txn, "traverse_nodes", nogdb::Record{}.set("name", "hub"));
+        v1 = nogdb::Vertex::create(txn, "traverse_nodes", nogdb::Record{}.set("name", "v1"));
+        v2 = nogdb::Vertex::create(txn, "traverse_nodes", nogdb::Record{}.set("name", "v2"));
+        v3 = nogdb::Vertex::create(txn, "traverse_nodes", nogdb::Record{}.set("name", "v3"));
+        nogdb::Edge::create(txn, "traverse_a", hub, v1, nogdb::Record{}.set("name", "a1"));
+        nogdb::Edge::create(txn, "traverse_a", v2, hub, nogdb::Record{}.set("name", "a2"));
+        nogdb::Edge::create(txn, "traverse_a", hub, hub, nogdb::Record{}.set("name", "loop"));
+        nogdb::Edge::create(txn, "traverse_b", hub, v2, nogdb::Record{}.set("name", "b1"));
+        nogdb::Edge::create(txn, "traverse_b", v3, hub, nogdb::Record{}.set("name", "b2"));
+        txn.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+        auto filterA = nogdb::ClassFilter{"traverse_a"};
+        auto filterB = nogdb::ClassFilter{"traverse_b"};
+        auto filterAB = nogdb::ClassFilter{"traverse_a", "traverse_b"};
+        assert(edgeNames(nogdb::Vertex::getInEdge(txn, hub, filterA)) == (Names{"a2", "loop"}));
+        assert(edgeNames(nogdb::Vertex::getInEdge(txn, hub, filterB)) == (Names{"b2"}));
+        assert(edgeNames(nogdb::Vertex::getInEdge(txn, hub, filterAB)) == (Names{"a2", "loop", "b2"}));
+        assert(edgeNames(nogdb::Vertex::getOutEdge(txn, hub, filterA)) == (Names{"a1", "loop"}));
+        assert(edgeNames(nogdb::Vertex::getOutEdge(txn, hub, filterB)) == (Names{"b1"}));
+        assert(edgeNames(nogdb::Vertex::getOutEdge(txn, hub, filterAB)) == (Names{"a1", "loop", "b1"}));
+        // a self-loop is returned once when both directions are traversed
+        assert(edgeNames(nogdb::Vertex::getAllEdge(txn, hub, filterA)) == (Names{"a1", "a2", "loop"}));
+        assert(edgeNames(nogdb::Vertex::getAllEdge(txn, hub, filterB)) == (Names{"b1", "b2"}));
+        assert(edgeNames(nogdb::Vertex::getAllEdge(txn, hub, filterAB)) ==
+               (Names{"a1", "a2", "loop", "b1", "b2"}));
+        assert(cursorNames(nogdb::Vertex::getInEdgeCursor(txn, hub, filterB)) == (Names{"b2"}));
+        assert(cursorNames(nogdb::Vertex::getOutEdgeCursor(txn, hub, filterA)) == (Names{"a1", "loop"}));
+        assert(cursorNames(nogdb::Vertex::getAllEdgeCursor(txn, hub, filterAB)) ==
+               (Names{"a1", "a2", "loop", "b1", "b2"}));
+        assert(nogdb::Vertex::getOutEdge(txn, v1, filterAB).empty());
+        assert(edgeNames(nogdb::Vertex::getInEdge(txn, v1, filterA)) == (Names{"a1"}));
+        assert(nogdb::Vertex::getInEdge(txn, v1, filterB).empty());
+
+        assert(vertexNames(nogdb::Traverse::outEdgeBfs(txn, hub, 1, 2, filterA)) == (Path{"v1"}));
+        assert(vertexNames(nogdb::Traverse::outEdgeBfs(txn, hub, 1, 2, filterB)) == (Path{"v2"}));
+        assert(vertexNames(nogdb::Traverse::inEdgeBfs(txn, hub, 1, 1, filterB)) == (Path{"v3"}));
+        assert(vertexNames(nogdb::Traverse::inEdgeBfs(txn, hub, 1, 2, filterA)) == (Path{"v2"}));
+        auto allB = vertexNames(nogdb::Traverse::allEdgeBfs(txn, hub, 1, 1, filterB));
+        assert(std::set<std::string>(allB.cbegin(), allB.cend()) == (std::set<std::string>{"v2", "v3"}));
+        assert(nogdb::Traverse::shortestPath(txn, v3, v1, filterA).empty());
+        assert(vertexNames(nogdb::Traverse::shortestPath(txn, v3, v1, filterAB)) == (Path{"v3", "hub", "v1"}));
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    // uncommitted edges are traversed only by their own txn
+    try {
+        auto txnRo = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+        auto txnRw = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Edge::create(txnRw, "traverse_b", v1, hub, nogdb::Record{}.set("name", "b3"));
+        assert(edgeNames(nogdb::Vertex::getInEdge(txnRw, hub, nogdb::ClassFilter{"traverse_b"})) ==
+               (std::multiset<std::string>{"b2", "b3"}));
+        assert(edgeNames(nogdb::Vertex::getAllEdge(txnRw, v1, nogdb::ClassFilter{"traverse_b"})) ==
+               (std::multiset<std::string>{"b3"}));
+        assert(vertexNames(nogdb::Traverse::outEdgeBfs(txnRw, v1, 1, 1, nogdb::ClassFilter{"traverse_b"})) ==
+               (std::vector<std::string>{"hub"}));
+        assert(edgeNames(nogdb::Vertex::getInEdge(txnRo, hub, nogdb::ClassFilter{"traverse_b"})) ==
+               (std::multiset<std::string>{"b2"}));
+        assert(nogdb::Traverse::outEdgeBfs(txnRo, v1, 1, 1, nogdb::ClassFilter{"traverse_b"}).empty());
+        txnRw.rollback();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    // readers traverse a vertex while a writer keeps adding edges to it
+    const auto numWrites = 50;
+    std::atomic<bool> isDone{false};
+    auto readerError = std::exception_ptr{};
+    auto reader = std::thread([&]() {
+        try {
+            while (!isDone.load()) {
+                auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+                auto numIn = nogdb::Vertex::getInEdge(txn, hub, nogdb::ClassFilter{"traverse_b"}).size();
+                auto numOut = nogdb::Vertex::getOutEdge(txn, hub, nogdb::ClassFilter{"traverse_a"}).size();
+                auto numAll = nogdb::Vertex::getAllEdge(txn, hub).size();
+                assert(numIn >= 1 && numIn <= 1 + numWrites);
+                assert(numOut == 2);
+                assert(numAll == 4 + numIn);
+            }
+        } catch (...) {
+            readerError = std::current_exception();
+        }
+    });
+    try {
+        for (auto i = 0; i < numWrites; ++i) {
+            auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+            nogdb::Edge::create(txn, "traverse_b", v1, hub, nogdb::Record{}.set("name", "w" + std::to_string(i)));
+            txn.commit();
+        }
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+    isDone.store(true);
+    reader.join();
+    if (readerError) {
+        std::rethrow_exception(readerError);
+    }
+
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        assert(nogdb::Vertex::getInEdge(txn, hub, nogdb::ClassFilter{"traverse_b"}).size() == 1 + numWrites);
+        nogdb::Class::drop(txn, "traverse_a");
+        nogdb::Class::drop(txn, "traverse_b");
+        nogdb::Class::drop(txn, "traverse_nodes");
+        txn.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+}
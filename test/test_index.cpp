@@ -19,6 +19,9 @@
  *
  */
 
+#include <atomic>
+#include <chrono>
+#include <thread>
 #include "runtest.h"
 #include "test_exec.h"
 
@@ -870,3 +873,366 @@ void test_drop_invalid_index_with_records() {
     }
     destroy_vertex_index_test();
 }
+
+void test_search_index_in_value_order() {
+    init_vertex_index_test();
+    auto intValues = std::vector<int32_t>{5, -3, 0, -100, 42, -1, 7, INT32_MIN, INT32_MAX};
+    auto realValues = std::vector<double>{2.5, -0.5, 0.0, -1000.25, 1e10, -1e-3, 3.75, -1e10, 0.125};
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Property::createIndex(txn, "index_test", "index_int", false);
+        nogdb::Property::createIndex(txn, "index_test", "index_real", false);
+        for (auto i = size_t{0}; i < intValues.size(); ++i) {
+            nogdb::Vertex::create(txn, "index_test", nogdb::Record{}
+                    .set("index_int", intValues[i])
+                    .set("index_real", realValues[i]));
+        }
+        txn.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    auto getInts = [](const nogdb::ResultSet &res) {
+        auto values = std::vector<int32_t>{};
+        for (const auto &r: res) values.push_back(r.record.getInt("index_int"));
+        return values;
+    };
+    auto getReals = [](const nogdb::ResultSet &res) {
+        auto values = std::vector<double>{};
+        for (const auto &r: res) values.push_back(r.record.getReal("index_real"));
+        return values;
+    };
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+        auto res = nogdb::Vertex::getIndex(txn, "index_test", nogdb::Condition("index_int").lt(int32_t{6}));
+        assert((getInts(res) == std::vector<int32_t>{INT32_MIN, -100, -3, -1, 0, 5}));
+        res = nogdb::Vertex::getIndex(txn, "index_test", nogdb::Condition("index_int").ge(int32_t{-1}));
+        assert((getInts(res) == std::vector<int32_t>{-1, 0, 5, 7, 42, INT32_MAX}));
+        res = nogdb::Vertex::getIndex(txn, "index_test",
+                                      nogdb::Condition("index_int").between(int32_t{-100}, int32_t{7}, {false, true}));
+        assert((getInts(res) == std::vector<int32_t>{-3, -1, 0, 5, 7}));
+        res = nogdb::Vertex::getIndex(txn, "index_test", nogdb::Condition("index_int").eq(int32_t{INT32_MIN}));
+        assert((getInts(res) == std::vector<int32_t>{INT32_MIN}));
+
+        res = nogdb::Vertex::getIndex(txn, "index_test", nogdb::Condition("index_real").le(0.0));
+        assert((getReals(res) == std::vector<double>{-1e10, -1000.25, -0.5, -1e-3, 0.0}));
+        res = nogdb::Vertex::getIndex(txn, "index_test", nogdb::Condition("index_real").gt(-0.5));
+        assert((getReals(res) == std::vector<double>{-1e-3, 0.0, 0.125, 2.5, 3.75, 1e10}));
+        res = nogdb::Vertex::getIndex(txn, "index_test", nogdb::Condition("index_real").between(-1000.25, 2.5));
+        assert((getReals(res) == std::vector<double>{-1000.25, -0.5, -1e-3, 0.0, 0.125, 2.5}));
+        res = nogdb::Vertex::getIndex(txn, "index_test", nogdb::Condition("index_real").eq(-0.0));
+        assert((getReals(res) == std::vector<double>{0.0}));
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Property::dropIndex(txn, "index_test", "index_int");
+        nogdb::Property::dropIndex(txn, "index_test", "index_real");
+        txn.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+    destroy_vertex_index_test();
+}
+
+void test_search_composite_index() {
+    init_vertex_index_test();
+    auto tenants = std::vector<std::string>{"b", "a", "c", "b", "b", "a", "b", "b"};
+    auto times = std::vector<int32_t>{3, 1, 2, -5, 10, 4, 7, 3};
+    auto rdescs = std::vector<nogdb::RecordDescriptor>{};
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        for (auto i = size_t{0}; i < tenants.size(); ++i) {
+            rdescs.push_back(nogdb::Vertex::create(txn, "index_test", nogdb::Record{}
+                    .set("index_text", tenants[i])
+                    .set("index_int", times[i])));
+        }
+        nogdb::Vertex::create(txn, "index_test", nogdb::Record{}.set("index_text", "b"));
+        nogdb::Property::createCompositeIndex(txn, "index_test", {"index_text", "index_int"});
+        nogdb::Vertex::create(txn, "index_test", nogdb::Record{}.set("index_text", "b").set("index_int", 5));
+        txn.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        try {
+            nogdb::Property::createCompositeIndex(txn, "index_test", {"index_text"});
+            assert(false);
+        } catch (const nogdb::Error &ex) {
+            REQUIRE(ex, CTX_INVALID_COMPOSITE_INDEX, "CTX_INVALID_COMPOSITE_INDEX");
+        }
+        try {
+            nogdb::Property::createCompositeIndex(txn, "index_test", {"index_text", "index_blob"});
+            assert(false);
+        } catch (const nogdb::Error &ex) {
+            REQUIRE(ex, CTX_INVALID_PROPTYPE_INDEX, "CTX_INVALID_PROPTYPE_INDEX");
+        }
+        try {
+            nogdb::Property::createCompositeIndex(txn, "index_test", {"index_text", "index_int"}, true);
+            assert(false);
+        } catch (const nogdb::Error &ex) {
+            REQUIRE(ex, CTX_DUPLICATE_INDEX, "CTX_DUPLICATE_INDEX");
+        }
+        try {
+            nogdb::Property::remove(txn, "index_test", "index_int");
+            assert(false);
+        } catch (const nogdb::Error &ex) {
+            REQUIRE(ex, CTX_IN_USED_PROPERTY, "CTX_IN_USED_PROPERTY");
+        }
+        try {
+            nogdb::Property::createCompositeIndex(txn, "index_test", {"index_int", "index_real"}, true);
+            nogdb::Vertex::create(txn, "index_test", nogdb::Record{}.set("index_int", 1).set("index_real", 0.5));
+            nogdb::Vertex::create(txn, "index_test", nogdb::Record{}.set("index_int", 1).set("index_real", 0.5));
+            assert(false);
+        } catch (const nogdb::Error &ex) {
+            REQUIRE(ex, CTX_UNIQUE_CONSTRAINT, "CTX_UNIQUE_CONSTRAINT");
+        }
+        txn.rollback();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    auto getInts = [](const nogdb::ResultSet &res) {
+        auto values = std::vector<int32_t>{};
+        for (const auto &r: res) values.push_back(r.record.getInt("index_int"));
+        return values;
+    };
+    auto verify = [&getInts](const std::vector<int32_t> &greaterThanZero) {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+        auto schema = nogdb::Db::getSchema(txn, "index_test");
+        assert(schema.compositeIndexInfo.size() == 1);
+        assert((schema.compositeIndexInfo.cbegin()->second.first ==
+                std::vector<std::string>{"index_text", "index_int"}));
+        auto res = nogdb::Vertex::getIndex(txn, "index_test",
+                                           nogdb::Condition("index_text").eq("b") &&
+                                           nogdb::Condition("index_int").gt(int32_t{0}));
+        assert(getInts(res) == greaterThanZero);
+        res = nogdb::Vertex::getIndex(txn, "index_test",
+                                      nogdb::Condition("index_int").between(int32_t{-5}, int32_t{3}, {false, true}) &&
+                                      nogdb::Condition("index_text").eq("b"));
+        assert((getInts(res) == std::vector<int32_t>{3, 3}));
+        res = nogdb::Vertex::getIndex(txn, "index_test",
+                                      nogdb::Condition("index_text").eq("a") &&
+                                      nogdb::Condition("index_int").eq(int32_t{4}));
+        assert((getInts(res) == std::vector<int32_t>{4}));
+        // a disjunction cannot be answered by a composite index
+        res = nogdb::Vertex::getIndex(txn, "index_test",
+                                      nogdb::Condition("index_text").eq("a") ||
+                                      nogdb::Condition("index_int").eq(int32_t{4}));
+        assert(res.empty());
+    };
+    try {
+        verify(std::vector<int32_t>{3, 3, 5, 7, 10});
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Vertex::update(txn, rdescs[4], nogdb::Record{}.set("index_text", "b").set("index_int", 6));
+        nogdb::Vertex::destroy(txn, rdescs[6]);
+        txn.commit();
+        verify(std::vector<int32_t>{3, 3, 5, 6});
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    delete ctx;
+    try {
+        ctx = new nogdb::Context(DATABASE_PATH);
+        verify(std::vector<int32_t>{3, 3, 5, 6});
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Property::dropCompositeIndex(txn, "index_test", {"index_text", "index_int"});
+        nogdb::Vertex::destroy(txn, "index_test");
+        txn.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+    destroy_vertex_index_test();
+}
+
+void test_create_index_with_many_records() {
+    init_vertex_index_test();
+    // enough records to split building the index among several threads
+    const auto numRecords = int32_t{40000};
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        for (auto i = int32_t{0}; i < numRecords; ++i) {
+            auto value = (i * 7919) % numRecords - numRecords / 2;
+            nogdb::Vertex::create(txn, "index_test", nogdb::Record{}
+                    .set("index_int", value)
+                    .set("index_text", std::to_string(value)));
+        }
+        nogdb::Property::createIndex(txn, "index_test", "index_int", true);
+        nogdb::Property::createIndex(txn, "index_test", "index_text");
+        txn.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+        auto res = nogdb::Vertex::getIndex(txn, "index_test", nogdb::Condition("index_int").ge(int32_t{-100}));
+        assert(res.size() == static_cast<size_t>(numRecords / 2 + 100));
+        auto prev = int32_t{-101};
+        for (const auto &r: res) {
+            auto value = r.record.getInt("index_int");
+            assert(value == prev + 1);
+            prev = value;
+        }
+        res = nogdb::Vertex::getIndex(txn, "index_test", nogdb::Condition("index_text").eq(std::string{"-123"}));
+        assert(res.size() == 1);
+        assert(res[0].record.getInt("index_int") == -123);
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Property::dropIndex(txn, "index_test", "index_int");
+        nogdb::Vertex::create(txn, "index_test", nogdb::Record{}.set("index_int", int32_t{0}));
+        try {
+            nogdb::Property::createIndex(txn, "index_test", "index_int", true);
+            assert(false);
+        } catch (const nogdb::Error &ex) {
+            REQUIRE(ex, CTX_INVALID_INDEX_CONSTRAINT, "CTX_INVALID_INDEX_CONSTRAINT");
+        }
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Property::dropIndex(txn, "index_test", "index_int");
+        nogdb::Property::dropIndex(txn, "index_test", "index_text");
+        nogdb::Vertex::destroy(txn, "index_test");
+        txn.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+    destroy_vertex_index_test();
+}
+
+void test_create_index_online() {
+    init_vertex_index_test();
+    const auto numRecords = int32_t{20000};
+    auto rids = std::vector<nogdb::RecordDescriptor>{};
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        for (auto i = int32_t{0}; i < numRecords; ++i) {
+            rids.push_back(nogdb::Vertex::create(txn, "index_test", nogdb::Record{}
+                    .set("index_int", i)
+                    .set("index_text", std::to_string(i))));
+        }
+        txn.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    // another txn holds the writer lock while the index is built from a snapshot and commits changes before
+    // the index is written
+    std::atomic<bool> isWriterReady{false};
+    auto writer = std::thread([&]() {
+        try {
+            auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+            isWriterReady = true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            for (auto i = int32_t{0}; i < 100; ++i) {
+                nogdb::Vertex::update(txn, rids[i], nogdb::Record{}
+                        .set("index_int", -i - 1)
+                        .set("index_text", std::to_string(-i - 1)));
+                nogdb::Vertex::destroy(txn, rids[100 + i]);
+                nogdb::Vertex::create(txn, "index_test", nogdb::Record{}
+                        .set("index_int", numRecords + i)
+                        .set("index_text", std::to_string(numRecords + i)));
+            }
+            txn.commit();
+        } catch (const nogdb::Error &ex) {
+            std::cout << "\nError: " << ex.what() << std::endl;
+            assert(false);
+        }
+    });
+    while (!isWriterReady) {
+        std::this_thread::yield();
+    }
+    try {
+        nogdb::Property::createIndex(*ctx, "index_test", "index_int", true);
+        nogdb::Property::createIndex(*ctx, "index_test", "index_text");
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+    writer.join();
+
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+        auto res = nogdb::Vertex::getIndex(txn, "index_test", nogdb::Condition("index_int").ge(int32_t{-100}));
+        assert(res.size() == static_cast<size_t>(numRecords));
+        auto prev = int32_t{-101};
+        for (const auto &r: res) {
+            auto value = r.record.getInt("index_int");
+            assert(value > prev && (value < 100 || value >= 200));
+            prev = value;
+        }
+        assert(prev == numRecords + 99);
+        res = nogdb::Vertex::getIndex(txn, "index_test", nogdb::Condition("index_int").eq(int32_t{50}));
+        assert(res.empty());
+        res = nogdb::Vertex::getIndex(txn, "index_test", nogdb::Condition("index_int").eq(int32_t{150}));
+        assert(res.empty());
+        res = nogdb::Vertex::getIndex(txn, "index_test", nogdb::Condition("index_text").eq(std::string{"-51"}));
+        assert(res.size() == 1);
+        assert(res[0].descriptor.rid == rids[50].rid);
+        res = nogdb::Vertex::getIndex(txn, "index_test", nogdb::Condition("index_text").eq(std::string{"150"}));
+        assert(res.empty());
+        res = nogdb::Vertex::getIndex(txn, "index_test", nogdb::Condition("index_text").eq(std::string{"12345"}));
+        assert(res.size() == 1);
+        assert(res[0].descriptor.rid == rids[12345].rid);
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    try {
+        nogdb::Property::createIndex(*ctx, "index_test", "index_int");
+        assert(false);
+    } catch (const nogdb::Error &ex) {
+        REQUIRE(ex, CTX_DUPLICATE_INDEX, "CTX_DUPLICATE_INDEX");
+    }
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Property::dropIndex(txn, "index_test", "index_int");
+        nogdb::Vertex::create(txn, "index_test", nogdb::Record{}.set("index_int", int32_t{12345}));
+        txn.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+    try {
+        nogdb::Property::createIndex(*ctx, "index_test", "index_int", true);
+        assert(false);
+    } catch (const nogdb::Error &ex) {
+        REQUIRE(ex, CTX_INVALID_INDEX_CONSTRAINT, "CTX_INVALID_INDEX_CONSTRAINT");
+    }
+
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Property::dropIndex(txn, "index_test", "index_text");
+        nogdb::Vertex::destroy(txn, "index_test");
+        txn.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+    destroy_vertex_index_test();
+}
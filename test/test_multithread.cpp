@@ -21,9 +21,13 @@
 
 #include <thread>
 #include <mutex>
+#include <ctime>
 #include <unistd.h>
 #include "runtest.h"
 #include "test_exec.h"
+#include "../src/concurrent.hpp"
+#include "../src/slab_allocator.hpp"
+#include "../src/spinlock.hpp"
 
 std::mutex wlock;
 
@@ -221,5 +225,458 @@ void test_txn_multithreads() {
     destroy_vertex_island();
 }
 
+namespace {
 
+    // a size which is not shared with any graph objects so that the pool is only used by these tests
+    struct SlabTestBlock {
+        uint64_t words[100];
+    };
+
+    typedef nogdb::SlabPool<sizeof(SlabTestBlock), alignof(SlabTestBlock)> SlabTestPool;
+
+    void fillSlabTestBlock(SlabTestBlock *block, uint64_t value) {
+        for (auto &word: block->words) {
+            word = value;
+        }
+    }
+
+    bool isSlabTestBlockFilled(const SlabTestBlock *block, uint64_t value) {
+        for (const auto &word: block->words) {
+            if (word != value) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+}
+
+void test_slab_allocator() {
+    auto allocator = nogdb::SlabAllocator<SlabTestBlock>{};
+    auto &pool = SlabTestPool::instance();
+    assert(pool.getNumSlabs() == 0);
+
+    // blocks of several slabs are distinct and aligned
+    const auto numBlocks = 3 * nogdb::SLAB_NUM_BLOCKS;
+    auto blocks = std::vector<SlabTestBlock *>{};
+    for (auto i = size_t{0}; i < numBlocks; ++i) {
+        auto block = allocator.allocate(1);
+        assert(reinterpret_cast<uintptr_t>(block) % alignof(SlabTestBlock) == 0);
+        fillSlabTestBlock(block, i);
+        blocks.push_back(block);
+    }
+    assert(pool.getNumSlabs() == 3);
+    for (auto i = size_t{0}; i < numBlocks; ++i) {
+        assert(isSlabTestBlockFilled(blocks[i], i));
+    }
+    auto sortedBlocks = blocks;
+    std::sort(sortedBlocks.begin(), sortedBlocks.end());
+    assert(std::adjacent_find(sortedBlocks.begin(), sortedBlocks.end()) == sortedBlocks.end());
+
+    // a block freed by a thread is taken again by the same thread
+    allocator.deallocate(blocks.back(), 1);
+    assert(allocator.allocate(1) == blocks.back());
+    fillSlabTestBlock(blocks.back(), numBlocks - 1);
+
+    // slabs are kept while any of their blocks are in use
+    for (auto i = size_t{0}; i < numBlocks; i += 2) {
+        allocator.deallocate(blocks[i], 1);
+    }
+    pool.flushThreadCache();
+    pool.trimSlabs();
+    assert(pool.getNumSlabs() == 3);
+    for (auto i = size_t{1}; i < numBlocks; i += 2) {
+        assert(isSlabTestBlockFilled(blocks[i], i));
+        allocator.deallocate(blocks[i], 1);
+    }
+    // blocks in a cache of a thread are not released
+    pool.trimSlabs();
+    assert(pool.getNumSlabs() >= 1);
+    pool.flushThreadCache();
+    pool.trimSlabs();
+    assert(pool.getNumSlabs() == 0);
+
+    // arrays are not taken from a pool
+    auto array = allocator.allocate(2);
+    allocator.deallocate(array, 2);
+    assert(pool.getNumSlabs() == 0);
+}
+
+void test_slab_allocator_multithreads() {
+    const auto numThreads = size_t{4};
+    const auto numRounds = size_t{200};
+    const auto numBlocksPerRound = size_t{100};
+    auto &pool = SlabTestPool::instance();
+    // blocks are handed over to the next thread to be freed there
+    auto queues = std::vector<std::vector<std::pair<SlabTestBlock *, uint64_t>>>(numThreads);
+    auto queueMutexes = std::vector<std::mutex>(numThreads);
+    std::atomic<bool> isValid{true};
+    auto run = [&](size_t id) {
+        auto allocator = nogdb::SlabAllocator<SlabTestBlock>{};
+        auto ownBlocks = std::vector<std::pair<SlabTestBlock *, uint64_t>>{};
+        auto freeBlocks = [&](std::vector<std::pair<SlabTestBlock *, uint64_t>> &blocks) {
+            for (const auto &block: blocks) {
+                if (!isSlabTestBlockFilled(block.first, block.second)) {
+                    isValid = false;
+                }
+                allocator.deallocate(block.first, 1);
+            }
+            blocks.clear();
+        };
+        for (auto round = size_t{0}; round < numRounds; ++round) {
+            auto handedBlocks = std::vector<std::pair<SlabTestBlock *, uint64_t>>{};
+            for (auto i = size_t{0}; i < numBlocksPerRound; ++i) {
+                auto block = allocator.allocate(1);
+                auto value = (id << 32) | (round * numBlocksPerRound + i);
+                fillSlabTestBlock(block, value);
+                ((i % 2 == 0) ? ownBlocks : handedBlocks).emplace_back(block, value);
+            }
+            {
+                std::lock_guard<std::mutex> _(queueMutexes[(id + 1) % numThreads]);
+                auto &queue = queues[(id + 1) % numThreads];
+                queue.insert(queue.end(), handedBlocks.begin(), handedBlocks.end());
+            }
+            auto receivedBlocks = std::vector<std::pair<SlabTestBlock *, uint64_t>>{};
+            {
+                std::lock_guard<std::mutex> _(queueMutexes[id]);
+                receivedBlocks.swap(queues[id]);
+            }
+            freeBlocks(receivedBlocks);
+            if (round % 10 == 0) {
+                freeBlocks(ownBlocks);
+            }
+        }
+        freeBlocks(ownBlocks);
+    };
+    auto workers = std::vector<std::thread>{};
+    for (auto id = size_t{0}; id < numThreads; ++id) {
+        workers.emplace_back(run, id);
+    }
+    for (auto &worker: workers) {
+        worker.join();
+    }
+    assert(isValid);
+    for (auto &queue: queues) {
+        auto allocator = nogdb::SlabAllocator<SlabTestBlock>{};
+        for (const auto &block: queue) {
+            assert(isSlabTestBlockFilled(block.first, block.second));
+            allocator.deallocate(block.first, 1);
+        }
+    }
+    // caches of exited threads have been returned to the pool
+    pool.flushThreadCache();
+    pool.trimSlabs();
+    assert(pool.getNumSlabs() == 0);
+}
+
+void test_adaptive_rwlock() {
+    nogdb::AdaptiveRWLock lock{};
+    // a reader of another thread cannot get in while a writer holds or waits for the lock
+    auto isWriterIn = [&lock]() {
+        auto isBlocked = false;
+        std::thread([&]() {
+            if (lock.tryLockShared()) {
+                lock.unlockShared();
+            } else {
+                isBlocked = true;
+            }
+        }).join();
+        return isBlocked;
+    };
+    assert(lock.tryLock());
+    assert(!lock.tryLock());
+    assert(!lock.tryLockShared());
+    lock.unlock();
+    assert(lock.tryLockShared());
+    assert(lock.tryLockShared());
+    assert(!lock.tryLock());
+    lock.unlockShared();
+    assert(!lock.tryLock());
+    lock.unlockShared();
+    assert(lock.tryLock());
+    lock.unlock();
+    auto stat = lock.getStat();
+    assert(stat.numAcquisitions == 4);
+    assert(stat.numContentions == 0);
+    assert(stat.waitNanoseconds == 0);
+
+    // a pending writer holds off new readers but not a thread which is already reading
+    lock.lockShared();
+    std::atomic<bool> isWritten{false};
+    auto writer = std::thread([&]() {
+        lock.lock();
+        isWritten = true;
+        lock.unlock();
+    });
+    while (!isWriterIn()) {
+        std::this_thread::yield();
+    }
+    lock.lockShared();
+    assert(lock.tryLockShared());
+    lock.unlockShared();
+    lock.unlockShared();
+    usleep(10000);
+    assert(!isWritten);
+    lock.unlockShared();
+    writer.join();
+    assert(isWritten);
+    stat = lock.getStat();
+    assert(stat.numAcquisitions >= 8);
+    assert(stat.numContentions == 1);
+
+    // a reader waiting for a long writer sleeps on a futex rather than spinning
+    const auto writeNanoseconds = int64_t{200000000};
+    lock.lock();
+    std::atomic<bool> isRead{false};
+    auto readerCpuNanoseconds = int64_t{0};
+    auto reader = std::thread([&]() {
+        lock.lockShared();
+        isRead = true;
+        lock.unlockShared();
+        auto cpuTime = timespec{};
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpuTime);
+        readerCpuNanoseconds = int64_t{cpuTime.tv_sec} * 1000000000 + cpuTime.tv_nsec;
+    });
+    usleep(writeNanoseconds / 1000);
+    assert(!isRead);
+    lock.unlock();
+    reader.join();
+    assert(isRead);
+#ifdef __linux__
+    assert(readerCpuNanoseconds < writeNanoseconds / 2);
+#endif
+    auto lastStat = lock.getStat();
+    assert(lastStat.numAcquisitions == stat.numAcquisitions + 2);
+    assert(lastStat.numContentions == stat.numContentions + 1);
+    assert(lastStat.waitNanoseconds >= stat.waitNanoseconds + writeNanoseconds / 2);
+
+    // elements of a map can be looked up while visiting the map even if a writer waits for the same shard
+    nogdb::ConcurrentHashMap<int, int> map{};
+    for (auto i = 0; i < 1000; ++i) {
+        map.lockAndEmplace(i, std::make_shared<int>(i));
+    }
+    auto numVisited = 0;
+    auto clearer = std::thread{};
+    map.forEach([&](const int &key, const std::shared_ptr<int> &value) {
+        if (numVisited++ == 0) {
+            clearer = std::thread([&map]() { map.lockAndClear(); });
+            usleep(10000);
+        }
+        assert(map.find(key) == value);
+    });
+    clearer.join();
+    assert(numVisited > 0);
+    assert(map.size() == 0);
+}
+
+void test_adaptive_rwlock_multithreads() {
+    const auto numReaders = 4;
+    const auto numWriters = 4;
+    const auto numIterations = 20000;
+    nogdb::AdaptiveRWLock lock{};
+    auto first = uint64_t{0}, second = uint64_t{0};
+    std::atomic<int> numWriting{0};
+    std::atomic<uint64_t> numNested{0};
+    std::atomic<bool> isValid{true};
+    auto write = [&]() {
+        for (auto i = 0; i < numIterations; ++i) {
+            if (i % 8 == 0) {
+                while (!lock.tryLock()) {
+                    std::this_thread::yield();
+                }
+            } else {
+                lock.lock();
+            }
+            if (numWriting.fetch_add(1) != 0) {
+                isValid = false;
+            }
+            ++first;
+            ++second;
+            numWriting.fetch_sub(1);
+            lock.unlock();
+        }
+    };
+    auto read = [&]() {
+        for (auto i = 0; i < numIterations; ++i) {
+            lock.lockShared();
+            if (numWriting.load() != 0 || first != second) {
+                isValid = false;
+            }
+            if (i % 16 == 0) {
+                lock.lockShared();
+                ++numNested;
+                lock.unlockShared();
+            }
+            lock.unlockShared();
+        }
+    };
+    auto workers = std::vector<std::thread>{};
+    for (auto i = 0; i < numWriters; ++i) {
+        workers.emplace_back(write);
+    }
+    for (auto i = 0; i < numReaders; ++i) {
+        workers.emplace_back(read);
+    }
+    for (auto &worker: workers) {
+        worker.join();
+    }
+    assert(isValid);
+    assert(first == uint64_t{numWriters} * numIterations);
+    assert(second == first);
+    auto stat = lock.getStat();
+    assert(stat.numAcquisitions == uint64_t{numWriters + numReaders} * numIterations + numNested);
+    assert(stat.numContentions <= stat.numAcquisitions);
+    assert(lock.tryLock());
+    lock.unlock();
+}
+
+void test_concurrent_hash_map_multithreads() {
+    const auto numThreads = 4;
+    const auto numKeys = 4000;
+    const auto numRounds = 20;
+    nogdb::ConcurrentHashMap<int, int> map{};
+    std::atomic<bool> isValid{true};
+    // every thread inserts and erases its own keys while it also looks up keys of the others
+    auto run = [&](int id) {
+        for (auto round = 0; round < numRounds; ++round) {
+            for (auto key = id; key < numKeys; key += numThreads) {
+                map.lockAndEmplace(key, std::make_shared<int>(key * numRounds + round));
+            }
+            for (auto key = 0; key < numKeys; ++key) {
+                auto value = map.find(key);
+                if (key % numThreads == id) {
+                    if (value == nullptr || *value != key * numRounds + round) {
+                        isValid = false;
+                    }
+                } else if (value != nullptr && *value / numRounds != key) {
+                    isValid = false;
+                }
+            }
+            auto erasedKeys = std::vector<int>{};
+            for (auto key = id; key < numKeys; key += numThreads) {
+                if ((key / numThreads) % 2 == 0 || round + 1 < numRounds) {
+                    erasedKeys.push_back(key);
+                }
+            }
+            map.lockAndErase(erasedKeys);
+            for (const auto &key: erasedKeys) {
+                if (map.find(key) != nullptr) {
+                    isValid = false;
+                }
+            }
+        }
+    };
+    auto workers = std::vector<std::thread>{};
+    for (auto id = 0; id < numThreads; ++id) {
+        workers.emplace_back(run, id);
+    }
+    for (auto &worker: workers) {
+        worker.join();
+    }
+    assert(isValid);
+    // only keys of odd indexes are left after the last round
+    assert(map.size() == numKeys / 2);
+    for (auto key = 0; key < numKeys; ++key) {
+        auto value = map.find(key);
+        if ((key / numThreads) % 2 == 1) {
+            assert(value != nullptr && *value == key * numRounds + numRounds - 1);
+        } else {
+            assert(value == nullptr);
+        }
+    }
+    assert(map.getLockStat().numAcquisitions > 0);
+}
+
+void test_concurrent_hash_map_for_each_multithreads() {
+    const auto numStableKeys = 1000;
+    const auto numChangingKeys = 1000;
+    const auto numMutators = 3;
+    const auto numPasses = 50;
+    nogdb::ConcurrentHashMap<int, int> map{};
+    for (auto key = 0; key < numStableKeys; ++key) {
+        map.lockAndEmplace(key, std::make_shared<int>(key));
+    }
+    std::atomic<bool> isDone{false};
+    std::atomic<bool> isValid{true};
+    // other keys are inserted and erased all the time
+    auto mutate = [&](int id) {
+        while (!isDone) {
+            for (auto key = numStableKeys + id; key < numStableKeys + numChangingKeys; key += numMutators) {
+                map.lockAndEmplace(key, std::make_shared<int>(key));
+            }
+            for (auto key = numStableKeys + id; key < numStableKeys + numChangingKeys; key += numMutators) {
+                map.lockAndErase(key);
+            }
+        }
+    };
+    auto mutators = std::vector<std::thread>{};
+    for (auto id = 0; id < numMutators; ++id) {
+        mutators.emplace_back(mutate, id);
+    }
+    // every pass sees each stable element exactly once and only valid elements of the others
+    for (auto pass = 0; pass < numPasses; ++pass) {
+        auto numVisits = std::vector<int>(numStableKeys + numChangingKeys, 0);
+        map.forEach([&](const int &key, const std::shared_ptr<int> &value) {
+            if (key < 0 || key >= numStableKeys + numChangingKeys || value == nullptr || *value != key) {
+                isValid = false;
+                return;
+            }
+            ++numVisits[key];
+            if (map.find(key) != value) {
+                isValid = false;
+            }
+        });
+        for (auto key = 0; key < numStableKeys + numChangingKeys; ++key) {
+            if ((key < numStableKeys) ? numVisits[key] != 1 : numVisits[key] > 1) {
+                isValid = false;
+            }
+        }
+    }
+    isDone = true;
+    for (auto &mutator: mutators) {
+        mutator.join();
+    }
+    assert(isValid);
+    auto numElements = size_t{0};
+    map.forEach([&](const int &key, const std::shared_ptr<int> &) {
+        assert(key < numStableKeys);
+        ++numElements;
+    });
+    assert(numElements == numStableKeys);
+    assert(map.size() == numStableKeys);
+}
+
+void test_concurrent_hash_map_merge() {
+    typedef nogdb::ConcurrentHashMap<int, int> Map;
+    const auto numThreads = 4U;
+    const auto numKeys = 10000;
+    Map map{};
+    for (auto key = 0; key < numKeys; key += 10) {
+        map.lockAndEmplace(key, std::make_shared<int>(-key));
+    }
+    // elements split by shards beforehand, where existing keys are kept
+    auto shardElements = std::vector<Map::Shard>(nogdb::CONCURRENT_MAP_NUM_SHARDS);
+    for (auto key = 0; key < numKeys / 2; ++key) {
+        shardElements[Map::shardOf(key)].emplace(key, std::make_shared<int>(key));
+    }
+    map.lockAndMerge(shardElements, numThreads);
+    for (const auto &elements: shardElements) {
+        assert(elements.empty());
+    }
+    // elements of many parts in any order
+    auto parts = std::vector<std::vector<std::shared_ptr<int>>>(numThreads + 1);
+    for (auto key = numKeys / 2; key < numKeys; ++key) {
+        parts[key % parts.size()].push_back(std::make_shared<int>(key));
+    }
+    auto lockStat = map.getLockStat();
+    map.lockAndMerge(parts, [](const std::shared_ptr<int> &value) { return *value; }, numThreads);
+    assert(parts.empty());
+    // each shard is locked only once by each merge
+    assert(map.getLockStat().numAcquisitions - lockStat.numAcquisitions == nogdb::CONCURRENT_MAP_NUM_SHARDS);
+    assert(map.size() == numKeys);
+    for (auto key = 0; key < numKeys; ++key) {
+        auto value = map.find(key);
+        assert(value != nullptr && *value == ((key % 10 == 0) ? -key : key));
+    }
+}
 
@@ -110,6 +110,70 @@ void test_alter_class() {
     }
 }
 
+void test_alter_class_multiversion() {
+    auto oldClassId = nogdb::ClassId{0};
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        oldClassId = nogdb::Class::create(txn, "files", nogdb::ClassType::VERTEX).id;
+        txn.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    try {
+        // a reader keeps seeing old names while a class is renamed and its old name is taken by another class
+        auto txnRo0 = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+        auto txnRw0 = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Class::alter(txnRw0, "files", "file");
+        auto newClassId = nogdb::Class::create(txnRw0, "files", nogdb::ClassType::VERTEX).id;
+        assert(nogdb::Db::getSchema(txnRw0, "files").id == newClassId);
+        assert(nogdb::Db::getSchema(txnRw0, "file").id == oldClassId);
+        txnRw0.commit();
+
+        auto txnRo1 = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+        assert(nogdb::Db::getSchema(txnRo0, "files").id == oldClassId);
+        assert(nogdb::Db::getSchema(txnRo1, "files").id == newClassId);
+        assert(nogdb::Db::getSchema(txnRo1, "file").id == oldClassId);
+        try {
+            nogdb::Db::getSchema(txnRo0, "file");
+            assert(false);
+        } catch (const nogdb::Error &ex) {
+            REQUIRE(ex, CTX_NOEXST_CLASS, "CTX_NOEXST_CLASS");
+        }
+        txnRo0.commit();
+        txnRo1.commit();
+
+        auto txnRw1 = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Class::alter(txnRw1, "file", "folders");
+        txnRw1.commit();
+
+        auto txnRo2 = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+        assert(nogdb::Db::getSchema(txnRo2, "files").id == newClassId);
+        assert(nogdb::Db::getSchema(txnRo2, "folders").id == oldClassId);
+        try {
+            nogdb::Db::getSchema(txnRo2, "file");
+            assert(false);
+        } catch (const nogdb::Error &ex) {
+            REQUIRE(ex, CTX_NOEXST_CLASS, "CTX_NOEXST_CLASS");
+        }
+        txnRo2.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Class::drop(txn, "files");
+        nogdb::Class::drop(txn, "folders");
+        txn.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+}
+
 void test_alter_invalid_class() {
     try {
         auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
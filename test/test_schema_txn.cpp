@@ -3202,3 +3202,132 @@ void test_schema_txn_drop_index_multiversion_rollback() {
         assert(false);
     }
 }
+
+void test_schema_txn_reuse_dbi_after_drop() {
+    try {
+        nogdb::Txn txnRw{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Class::create(txnRw, "test_110", nogdb::ClassType::VERTEX);
+        nogdb::Property::add(txnRw, "test_110", "prop1", nogdb::PropertyType::INTEGER);
+        nogdb::Property::createIndex(txnRw, "test_110", "prop1");
+        nogdb::Vertex::create(txnRw, "test_110", nogdb::Record{}.set("prop1", 10));
+        nogdb::Vertex::create(txnRw, "test_110", nogdb::Record{}.set("prop1", -10));
+        txnRw.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "Error: " << ex.what() << std::endl;
+        assert(false);
+    }
+    try {
+        nogdb::Txn txnRo1{*ctx, nogdb::Txn::Mode::READ_ONLY};
+        assert(nogdb::Vertex::get(txnRo1, "test_110").size() == 2);
+        assert(nogdb::Vertex::getIndex(txnRo1, "test_110", nogdb::Condition("prop1").eq(10)).size() == 1);
+        txnRo1.commit();
+
+        nogdb::Txn txnRw1{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Property::dropIndex(txnRw1, "test_110", "prop1");
+        txnRw1.rollback();
+
+        nogdb::Txn txnRo2{*ctx, nogdb::Txn::Mode::READ_ONLY};
+        assert(nogdb::Vertex::getIndex(txnRo2, "test_110", nogdb::Condition("prop1").eq(-10)).size() == 1);
+        txnRo2.commit();
+
+        nogdb::Txn txnRw2{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Property::dropIndex(txnRw2, "test_110", "prop1");
+        nogdb::Property::remove(txnRw2, "test_110", "prop1");
+        nogdb::Class::drop(txnRw2, "test_110");
+        txnRw2.commit();
+
+        nogdb::Txn txnRw3{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Class::create(txnRw3, "test_110", nogdb::ClassType::VERTEX);
+        nogdb::Property::add(txnRw3, "test_110", "prop1", nogdb::PropertyType::INTEGER);
+        nogdb::Property::createIndex(txnRw3, "test_110", "prop1");
+        nogdb::Vertex::create(txnRw3, "test_110", nogdb::Record{}.set("prop1", 20));
+        txnRw3.commit();
+
+        nogdb::Txn txnRo3{*ctx, nogdb::Txn::Mode::READ_ONLY};
+        auto res = nogdb::Vertex::get(txnRo3, "test_110");
+        assert(res.size() == 1);
+        assert(res[0].record.get("prop1").toInt() == 20);
+        assert(nogdb::Vertex::getIndex(txnRo3, "test_110", nogdb::Condition("prop1").eq(20)).size() == 1);
+        txnRo3.commit();
+
+        nogdb::Txn txnRw4{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Property::dropIndex(txnRw4, "test_110", "prop1");
+        nogdb::Class::drop(txnRw4, "test_110");
+        txnRw4.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "Error: " << ex.what() << std::endl;
+        assert(false);
+    }
+}
+
+void test_schema_txn_add_property_extend_multiversion() {
+    try {
+        nogdb::Txn txnRw{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Class::create(txnRw, "test_111", nogdb::ClassType::VERTEX);
+        nogdb::Class::createExtend(txnRw, "test_112", "test_111");
+        nogdb::Property::add(txnRw, "test_112", "prop1", nogdb::PropertyType::INTEGER);
+        nogdb::Vertex::create(txnRw, "test_112", nogdb::Record{}.set("prop1", 10));
+        txnRw.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "Error: " << ex.what() << std::endl;
+        assert(false);
+    }
+    try {
+        // a reader resolves the properties of the sub class before a property is added into its super class
+        nogdb::Txn txnRo0{*ctx, nogdb::Txn::Mode::READ_ONLY};
+        assert(nogdb::Vertex::get(txnRo0, "test_112").size() == 1);
+
+        nogdb::Txn txnRw0{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Property::add(txnRw0, "test_111", "prop2", nogdb::PropertyType::TEXT);
+        nogdb::Vertex::create(txnRw0, "test_112", nogdb::Record{}.set("prop1", 20).set("prop2", "hello"));
+        txnRw0.rollback();
+
+        nogdb::Txn txnRw1{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        try {
+            nogdb::Vertex::create(txnRw1, "test_112", nogdb::Record{}.set("prop2", "hello"));
+            assert(false);
+        } catch (const nogdb::Error &ex) {
+            REQUIRE(ex, CTX_NOEXST_PROPERTY, "CTX_NOEXST_PROPERTY");
+        }
+        nogdb::Property::add(txnRw1, "test_111", "prop2", nogdb::PropertyType::TEXT);
+        nogdb::Vertex::create(txnRw1, "test_112", nogdb::Record{}.set("prop1", 20).set("prop2", "hello"));
+        txnRw1.commit();
+
+        nogdb::Txn txnRw2{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Vertex::create(txnRw2, "test_112", nogdb::Record{}.set("prop1", 30).set("prop2", "world"));
+        txnRw2.commit();
+
+        nogdb::Txn txnRo1{*ctx, nogdb::Txn::Mode::READ_ONLY};
+        auto res = nogdb::Vertex::get(txnRo1, "test_112");
+        assert(res.size() == 3);
+        auto count = 0;
+        for (const auto &r: res) {
+            if (!r.record.get("prop2").empty()) {
+                assert(r.record.get("prop1").toInt() == ((r.record.getText("prop2") == "hello") ? 20 : 30));
+                ++count;
+            }
+        }
+        assert(count == 2);
+        assert(nogdb::Vertex::get(txnRo0, "test_112").size() == 1);
+        try {
+            nogdb::Vertex::get(txnRo0, "test_112", nogdb::Condition("prop2").eq("hello"));
+            assert(false);
+        } catch (const nogdb::Error &ex) {
+            REQUIRE(ex, CTX_NOEXST_PROPERTY, "CTX_NOEXST_PROPERTY");
+        }
+        txnRo0.commit();
+        txnRo1.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "Error: " << ex.what() << std::endl;
+        assert(false);
+    }
+    try {
+        nogdb::Txn txnRw{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Class::drop(txnRw, "test_112");
+        nogdb::Class::drop(txnRw, "test_111");
+        txnRw.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "Error: " << ex.what() << std::endl;
+        assert(false);
+    }
+}
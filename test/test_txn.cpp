@@ -18,8 +18,13 @@
  *  along with this program. If not, see <http://www.gnu.org/licenses/>.
  *
  */
+#include <thread>
 #include "runtest.h"
 #include "test_exec.h"
+#include "../src/txn_object.hpp"
+#include "../src/schema.hpp"
+#include "../src/graph.hpp"
+#include "../src/reclaimer.hpp"
 
 void test_txn_commit_nothing() {
     init_vertex_island();
@@ -1771,6 +1776,49 @@ void test_txn_stat() {
     destroy_vertex_island();
 }
 
+void test_txn_stat_many_readers() {
+    try {
+        auto baseTxnId = ctx->getMaxTxnId();
+        auto baseVersionId = ctx->getMaxVersionId();
+        // more readers than the registry has slots
+        auto txnRos = std::vector<nogdb::Txn>{};
+        for (auto i = 0; i < 300; ++i) {
+            txnRos.emplace_back(*ctx, nogdb::Txn::Mode::READ_ONLY);
+        }
+        assert(ctx->getMinActiveTxnId() == std::make_pair(baseTxnId, baseVersionId));
+
+        for (auto i = size_t{0}; i < txnRos.size(); i += 2) {
+            txnRos[i].commit();
+        }
+        assert(ctx->getMinActiveTxnId() == std::make_pair(baseTxnId + 1, baseVersionId));
+        for (auto i = txnRos.size() - 1; i > 1; i -= 2) {
+            txnRos[i].commit();
+        }
+        assert(ctx->getMinActiveTxnId() == std::make_pair(baseTxnId + 1, baseVersionId));
+
+        auto workers = std::vector<std::thread>{};
+        for (auto i = 0; i < 4; ++i) {
+            workers.emplace_back([]() {
+                for (auto j = 0; j < 1000; ++j) {
+                    nogdb::Txn txnRo{*ctx, nogdb::Txn::Mode::READ_ONLY};
+                    assert(ctx->getMinActiveTxnId().first <= txnRo.getTxnId());
+                    txnRo.commit();
+                }
+            });
+        }
+        for (auto &worker: workers) {
+            worker.join();
+        }
+        assert(ctx->getMinActiveTxnId() == std::make_pair(baseTxnId + 1, baseVersionId));
+
+        txnRos[1].commit();
+        assert(ctx->getMinActiveTxnId() == std::make_pair(nogdb::TxnId{0}, nogdb::TxnId{0}));
+    } catch (const nogdb::Error &ex) {
+        std::cout << "Error: " << ex.what() << std::endl;
+        assert(false);
+    }
+}
+
 void test_txn_reopen_ctx() {
     init_vertex_island();
 
@@ -1833,6 +1881,190 @@ void test_txn_reopen_ctx() {
 
 }
 
+void test_txn_reopen_ctx_multiversion() {
+    init_vertex_island();
+    init_edge_bridge();
+
+    auto v1 = nogdb::RecordDescriptor{}, v2 = nogdb::RecordDescriptor{};
+    auto e1 = nogdb::RecordDescriptor{}, e2 = nogdb::RecordDescriptor{};
+    try {
+        nogdb::Txn txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        v1 = nogdb::Vertex::create(txn, "islands", nogdb::Record{}.set("name", "Koh Samui"));
+        v2 = nogdb::Vertex::create(txn, "islands", nogdb::Record{}.set("name", "Koh Tao"));
+        e1 = nogdb::Edge::create(txn, "bridge", v1, v2, nogdb::Record{}.set("name", "red"));
+        e2 = nogdb::Edge::create(txn, "bridge", v1, v2, nogdb::Record{}.set("name", "blue"));
+        txn.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "Error: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    delete ctx;
+
+    try {
+        ctx = new nogdb::Context{DATABASE_PATH};
+    } catch (const nogdb::Error &ex) {
+        std::cout << "Error: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    auto getNames = [](const nogdb::ResultSet &res) {
+        auto names = std::set<std::string>{};
+        for (const auto &r: res) {
+            names.insert(r.record.get("name").toText());
+        }
+        return names;
+    };
+
+    try {
+        // edges loaded from the datastore must keep their old versions for readers
+        nogdb::Txn txnRo0{*ctx, nogdb::Txn::Mode::READ_ONLY};
+        nogdb::Txn txnRw0{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Edge::destroy(txnRw0, e1);
+        auto e3 = nogdb::Edge::create(txnRw0, "bridge", v1, v2, nogdb::Record{}.set("name", "green"));
+        assert((getNames(nogdb::Vertex::getOutEdge(txnRw0, v1)) == std::set<std::string>{"blue", "green"}));
+        txnRw0.commit();
+
+        nogdb::Txn txnRo1{*ctx, nogdb::Txn::Mode::READ_ONLY};
+        assert((getNames(nogdb::Vertex::getOutEdge(txnRo0, v1)) == std::set<std::string>{"red", "blue"}));
+        assert((getNames(nogdb::Vertex::getInEdge(txnRo0, v2)) == std::set<std::string>{"red", "blue"}));
+        assert((getNames(nogdb::Vertex::getOutEdge(txnRo1, v1)) == std::set<std::string>{"blue", "green"}));
+        assert((getNames(nogdb::Vertex::getInEdge(txnRo1, v2)) == std::set<std::string>{"blue", "green"}));
+
+        nogdb::Txn txnRw1{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Edge::destroy(txnRw1, e2);
+        nogdb::Edge::destroy(txnRw1, e3);
+        assert(nogdb::Vertex::getOutEdge(txnRw1, v1).empty());
+        txnRw1.rollback();
+
+        txnRo0.commit();
+        txnRo1.commit();
+
+        nogdb::Txn txnRw2{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Edge::create(txnRw2, "bridge", v2, v1, nogdb::Record{}.set("name", "yellow"));
+        txnRw2.commit();
+
+        nogdb::Txn txnRo2{*ctx, nogdb::Txn::Mode::READ_ONLY};
+        assert((getNames(nogdb::Vertex::getOutEdge(txnRo2, v1)) == std::set<std::string>{"blue", "green"}));
+        assert((getNames(nogdb::Vertex::getInEdge(txnRo2, v1)) == std::set<std::string>{"yellow"}));
+        assert((getNames(nogdb::Vertex::getAllEdge(txnRo2, v2)) ==
+                std::set<std::string>{"blue", "green", "yellow"}));
+    } catch (const nogdb::Error &ex) {
+        std::cout << "Error: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    destroy_edge_bridge();
+    destroy_vertex_island();
+}
+
+void test_txn_reclaim_with_active_readers() {
+    init_vertex_island();
+    init_edge_bridge();
+
+    // old versions are reclaimed at the end of every txn
+    try {
+        nogdb::Txn txnRw0{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        auto v1 = nogdb::Vertex::create(txnRw0, "islands", nogdb::Record{}.set("name", "Koh Samui"));
+        auto v2 = nogdb::Vertex::create(txnRw0, "islands", nogdb::Record{}.set("name", "Koh Tao"));
+        auto v3 = nogdb::Vertex::create(txnRw0, "islands", nogdb::Record{}.set("name", "Koh Phangan"));
+        auto e1 = nogdb::Edge::create(txnRw0, "bridge", v1, v2, nogdb::Record{}.set("name", "red"));
+        auto e2 = nogdb::Edge::create(txnRw0, "bridge", v2, v3, nogdb::Record{}.set("name", "blue"));
+        txnRw0.commit();
+
+        // versions seen by the oldest reader must survive every reclamation until it ends
+        nogdb::Txn txnRo0{*ctx, nogdb::Txn::Mode::READ_ONLY};
+        nogdb::Txn txnRw1{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Edge::updateSrc(txnRw1, e1, v3);
+        nogdb::Edge::destroy(txnRw1, e2);
+        txnRw1.commit();
+
+        nogdb::Txn txnRo1{*ctx, nogdb::Txn::Mode::READ_ONLY};
+        nogdb::Txn txnRw2{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Edge::updateSrc(txnRw2, e1, v2);
+        nogdb::Vertex::destroy(txnRw2, v1);
+        txnRw2.commit();
+
+        assert(nogdb::Edge::getSrc(txnRo0, e1).record.get("name").toText() == "Koh Samui");
+        assert(nogdb::Edge::getSrc(txnRo1, e1).record.get("name").toText() == "Koh Phangan");
+        assert(nogdb::Vertex::getOutEdge(txnRo0, v1).size() == 1);
+        assert(nogdb::Vertex::getOutEdge(txnRo0, v2).size() == 1);
+        assert(nogdb::Vertex::getOutEdge(txnRo1, v2).empty());
+        assert(nogdb::Vertex::getOutEdge(txnRo1, v3).size() == 1);
+        txnRo0.commit();
+
+        assert(nogdb::Edge::getSrc(txnRo1, e1).record.get("name").toText() == "Koh Phangan");
+        assert(nogdb::Vertex::getOutEdge(txnRo1, v3).size() == 1);
+        txnRo1.commit();
+
+        nogdb::Txn txnRo2{*ctx, nogdb::Txn::Mode::READ_ONLY};
+        assert(nogdb::Edge::getSrc(txnRo2, e1).record.get("name").toText() == "Koh Tao");
+        assert(nogdb::Vertex::getOutEdge(txnRo2, v2).size() == 1);
+        assert(nogdb::Vertex::getInEdge(txnRo2, v2).size() == 1);
+        assert(nogdb::Vertex::getAllEdge(txnRo2, v3).empty());
+    } catch (const nogdb::Error &ex) {
+        std::cout << "Error: " << ex.what() << std::endl;
+        assert(false);
+    }
+
+    destroy_edge_bridge();
+    destroy_vertex_island();
+
+    // deleted elements are reclaimed exactly when no active reader can see them
+    auto txnStat = std::make_shared<nogdb::TxnStat>();
+    auto graph = std::make_shared<nogdb::Graph>();
+    auto reclaimer = std::make_shared<nogdb::Reclaimer>(txnStat, std::make_shared<nogdb::Schema>(), graph);
+    auto exists = [&](nogdb::PositionId positionId) {
+        return graph->vertices.find(nogdb::RecordId{1, positionId}) != nullptr;
+    };
+    // a vertex at each position is deleted in the version of the same number
+    for (auto positionId = nogdb::PositionId{1}; positionId <= 6; ++positionId) {
+        auto rid = nogdb::RecordId{1, positionId};
+        graph->vertices.lockAndEmplace(rid, nogdb::Graph::makeVertex(rid));
+        graph->deletedVertices.push_back(nogdb::DeleteQueue<nogdb::RecordId>{{rid, nogdb::TxnId{positionId}}});
+    }
+    txnStat->maxVersionId = 2;
+    auto versionId0 = nogdb::TxnId{0}, versionId1 = nogdb::TxnId{0};
+    auto slot0 = txnStat->addActiveTxnId(1, versionId0);
+    assert(versionId0 == 2);
+    txnStat->fetchAddMaxVersionId();
+    txnStat->fetchAddMaxVersionId();
+    auto slot1 = txnStat->addActiveTxnId(2, versionId1);
+    assert(versionId1 == 4);
+    assert(txnStat->minActiveVersionId() == 2);
+    assert(reclaimer->reclaim());
+    assert(!exists(1) && !exists(2) && exists(3) && exists(4));
+    // nothing more is reclaimed until the watermark advances
+    assert(!reclaimer->reclaim());
+    txnStat->removeActiveTxnId(1, slot0);
+    assert(txnStat->minActiveVersionId() == 4);
+    assert(reclaimer->reclaim());
+    assert(!exists(3) && !exists(4) && exists(5));
+
+    // a reader registered after all slots are taken also holds the watermark
+    txnStat->fetchAddMaxVersionId();
+    auto slots = std::vector<size_t>{};
+    for (auto txnId = nogdb::TxnId{3}; slots.empty() || slots.back() != nogdb::ACTIVE_TXN_NUM_SLOTS; ++txnId) {
+        auto versionId = nogdb::TxnId{0};
+        slots.push_back(txnStat->addActiveTxnId(txnId, versionId));
+        assert(versionId == 5);
+    }
+    auto overflowTxnId = nogdb::TxnId{2 + slots.size()};
+    txnStat->removeActiveTxnId(2, slot1);
+    for (auto i = size_t{0}; i + 1 < slots.size(); ++i) {
+        txnStat->removeActiveTxnId(3 + i, slots[i]);
+    }
+    txnStat->fetchAddMaxVersionId();
+    assert(txnStat->minActiveVersionId() == 5);
+    assert(reclaimer->reclaim());
+    assert(!exists(5) && exists(6));
+    txnStat->removeActiveTxnId(overflowTxnId, slots.back());
+    assert(txnStat->minActiveVersionId() == 6);
+    assert(reclaimer->reclaim());
+    assert(!exists(6));
+    assert(txnStat->minActiveTxnId() == std::make_pair(nogdb::TxnId{0}, nogdb::TxnId{0}));
+}
+
 void test_txn_invalid_operations() {
     init_vertex_island();
     init_edge_bridge();
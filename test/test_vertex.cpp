@@ -47,6 +47,69 @@ void test_create_vertex() {
     destroy_vertex_book();
 }
 
+void test_create_vertices_batch() {
+    init_vertex_book();
+    try {
+        auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Property::createIndex(txn, "books", "title", true);
+        nogdb::Property::createIndex(txn, "books", "pages");
+        txn.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+    auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+    try {
+        auto first = nogdb::Vertex::create(txn, "books", nogdb::Record{}.set("title", "Percy Jackson"));
+        auto records = std::vector<nogdb::Record>{};
+        records.push_back(nogdb::Record{}.set("title", "Harry Potter").set("pages", 456));
+        records.push_back(nogdb::Record{}.set("title", "Fantastic Beasts").set("pages", -1));
+        records.push_back(nogdb::Record{}.set("pages", 342).set("price", 21.0));
+        auto rdescs = nogdb::Vertex::createBatch(txn, "books", records);
+        assert(rdescs.size() == 3);
+        for (auto i = size_t{0}; i < rdescs.size(); ++i) {
+            assert(rdescs[i].rid.first == first.rid.first);
+            assert(rdescs[i].rid.second == first.rid.second + i + 1);
+        }
+        auto last = nogdb::Vertex::create(txn, "books", nogdb::Record{}.set("title", "Batman"));
+        assert(last.rid.second == rdescs.back().rid.second + 1);
+
+        auto res = nogdb::Vertex::get(txn, "books");
+        assert(res.size() == 5);
+        auto record = nogdb::Db::getRecord(txn, rdescs[2]);
+        assert(record.get("pages").toInt() == 342);
+        assert(record.get("price").toReal() == 21.0);
+
+        res = nogdb::Vertex::getIndex(txn, "books", nogdb::Condition("title").eq("Fantastic Beasts"));
+        assert(res.size() == 1 && res[0].descriptor == rdescs[1]);
+        res = nogdb::Vertex::getIndex(txn, "books", nogdb::Condition("pages").eq(342));
+        assert(res.size() == 1 && res[0].descriptor == rdescs[2]);
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+    try {
+        auto records = std::vector<nogdb::Record>{};
+        records.push_back(nogdb::Record{}.set("title", "Lion King"));
+        records.push_back(nogdb::Record{}.set("title", "Lion King"));
+        nogdb::Vertex::createBatch(txn, "books", records);
+        assert(false);
+    } catch (const nogdb::Error &ex) {
+        REQUIRE(ex, CTX_UNIQUE_CONSTRAINT, "CTX_UNIQUE_CONSTRAINT");
+    }
+    txn.rollback();
+    try {
+        txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+        nogdb::Property::dropIndex(txn, "books", "title");
+        nogdb::Property::dropIndex(txn, "books", "pages");
+        txn.commit();
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+    destroy_vertex_book();
+}
+
 void test_create_invalid_vertex() {
     init_vertex_book();
     init_edge_author();
@@ -321,6 +384,101 @@ void test_get_vertex_cursor() {
     destroy_vertex_person();
 }
 
+void test_get_vertex_view() {
+    init_vertex_book();
+    auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+    try {
+        nogdb::Vertex::create(txn, "books", nogdb::Record{}
+                .set("title", "Percy Jackson")
+                .set("pages", 456)
+                .set("price", 24.5));
+        nogdb::Vertex::create(txn, "books", nogdb::Record{}
+                .set("title", "Batman VS Superman")
+                .set("words", 9999999ULL));
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+    try {
+        nogdb::Vertex::getView(txn, "books");
+        assert(false);
+    } catch (const nogdb::Error &ex) {
+        REQUIRE(ex, TXN_INVALID_MODE, "TXN_INVALID_MODE");
+    }
+    txn.commit();
+
+    txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_ONLY};
+    try {
+        auto res = nogdb::Vertex::getView(txn, "books");
+        assert(res.size() == 2);
+        assert(res[0].record.getText("title") == "Percy Jackson");
+        assert(res[0].record.getInt("pages") == 456);
+        assert(res[0].record.getReal("price") == 24.5);
+        assert(res[0].record.get("words").empty());
+        assert(res[1].record.getText("title") == "Batman VS Superman");
+        assert(res[1].record.getBigIntU("words") == 9999999);
+        assert(res[1].record.get("pages").empty());
+
+        auto record = res[0].record.toRecord();
+        assert(record.get("title").toText() == "Percy Jackson");
+        assert(record.get("pages").toInt() == 456);
+
+        auto cursor = nogdb::Vertex::getCursor(txn, "books");
+        assert(cursor.next());
+        auto view = cursor.getView();
+        assert(view.descriptor == res[0].descriptor);
+        assert(view.record.getText("title") == "Percy Jackson");
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+    txn.rollback();
+    destroy_vertex_book();
+}
+
+void test_get_vertex_with_property_filter() {
+    init_vertex_book();
+    auto txn = nogdb::Txn{*ctx, nogdb::Txn::Mode::READ_WRITE};
+    try {
+        auto rdesc = nogdb::Vertex::create(txn, "books", nogdb::Record{}
+                .set("title", "Percy Jackson")
+                .set("pages", 456)
+                .set("price", 24.5));
+        nogdb::Vertex::create(txn, "books", nogdb::Record{}
+                .set("title", "Batman VS Superman")
+                .set("words", 9999999ULL));
+
+        auto res = nogdb::Vertex::get(txn, "books", nogdb::PropertyFilter{"title", "price"});
+        assert(res.size() == 2);
+        assert(res[0].record.get("title").toText() == "Percy Jackson");
+        assert(res[0].record.get("price").toReal() == 24.5);
+        assert(res[0].record.get("pages").empty());
+        assert(res[1].record.get("title").toText() == "Batman VS Superman");
+        assert(res[1].record.get("words").empty());
+
+        auto record = nogdb::Db::getRecord(txn, rdesc, nogdb::PropertyFilter{"pages"});
+        assert(record.get("pages").toInt() == 456);
+        assert(record.get("title").empty());
+
+        auto cursor = nogdb::Vertex::getCursor(txn, "books", nogdb::PropertyFilter{"title"});
+        assert(cursor.size() == 2);
+        assert(cursor.next());
+        assert(cursor->record.get("title").toText() == "Percy Jackson");
+        assert(cursor->record.get("price").empty());
+    } catch (const nogdb::Error &ex) {
+        std::cout << "\nError: " << ex.what() << std::endl;
+        assert(false);
+    }
+    try {
+        nogdb::Vertex::get(txn, "books", nogdb::PropertyFilter{"title", "author"});
+        assert(false);
+    } catch (const nogdb::Error &ex) {
+        REQUIRE(ex, CTX_NOEXST_PROPERTY, "CTX_NOEXST_PROPERTY");
+    }
+    txn.commit();
+    destroy_vertex_book();
+}
+
 void test_get_invalid_vertex_cursor() {
     init_vertex_person();
     init_vertex_book();
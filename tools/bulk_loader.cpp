@@ -0,0 +1,92 @@
+/*
+ *  Copyright (C) 2018, Throughwave (Thailand) Co., Ltd.
+ *  <peerawich at throughwave dot co dot th>
+ *
+ *  This file is part of libnogdb, the NogDB core library in C++.
+ *
+ *  libnogdb is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <algorithm>
+#include <tuple>
+
+#include "../src/constant.hpp"
+#include "../src/datastore.hpp"
+#include "../src/validate.hpp"
+#include "../src/generic.hpp"
+#include "../src/relation.hpp"
+#include "bulk_loader.hpp"
+
+#include "nogdb_errors.h"
+
+namespace nogdb {
+
+    std::vector<RecordDescriptor>
+    BulkLoader::appendVertices(Txn &txn, const std::string &className, const std::vector<Record> &records) {
+        // transaction validations
+        Validate::isTransactionValid(txn);
+        auto classDescriptor = Generic::getClassDescriptor(txn, className, ClassType::VERTEX);
+        return Generic::appendRecords(txn, classDescriptor, records.size(),
+                                      [&records](size_t index) -> const Record & { return records[index]; });
+    }
+
+    std::vector<RecordDescriptor>
+    BulkLoader::appendEdges(Txn &txn, const std::string &className, const std::vector<EdgeRecord> &edgeRecords,
+                            std::vector<Graph::EdgeRelation> &edgeRelations) {
+        // transaction validations
+        Validate::isTransactionValid(txn);
+        auto classDescriptor = Generic::getClassDescriptor(txn, className, ClassType::EDGE);
+        auto result = Generic::appendRecords(txn, classDescriptor, edgeRecords.size(),
+                                             [&edgeRecords](size_t index) -> const Record & {
+                                                 return edgeRecords[index].record;
+                                             });
+        edgeRelations.reserve(edgeRelations.size() + edgeRecords.size());
+        for (auto i = size_t{0}; i < edgeRecords.size(); ++i) {
+            edgeRelations.emplace_back(result[i].rid, edgeRecords[i].srcVertex.rid, edgeRecords[i].dstVertex.rid);
+        }
+        return result;
+    }
+
+    void BulkLoader::appendRelations(Txn &txn, std::vector<Graph::EdgeRelation> &edgeRelations) {
+        // transaction validations
+        Validate::isTransactionValid(txn);
+        if (edgeRelations.empty()) {
+            return;
+        }
+        // keys in the relation table are in the order of record ids of edges
+        std::sort(edgeRelations.begin(), edgeRelations.end(),
+                  [](const Graph::EdgeRelation &lhs, const Graph::EdgeRelation &rhs) {
+                      return std::get<0>(lhs) < std::get<0>(rhs);
+                  });
+        auto dsTxnHandler = txn.txnBase->getDsTxnHandler();
+        try {
+            auto relationDBHandler = txn.txnBase->openRelationDbi();
+            auto isAppend = true;
+            {
+                // keys can be appended only if all of them are greater than the last key in the table
+                auto cursorHandler = Datastore::CursorHandlerWrapper(dsTxnHandler, relationDBHandler);
+                auto keyValue = Datastore::getPrevCursor(cursorHandler.get());
+                isAppend = keyValue.empty() || Relation::toEdgeId(keyValue) < std::get<0>(edgeRelations.front());
+            }
+            for (const auto &edgeRelation: edgeRelations) {
+                Relation::put(dsTxnHandler, relationDBHandler, std::get<0>(edgeRelation), std::get<1>(edgeRelation),
+                              std::get<2>(edgeRelation), isAppend);
+            }
+        } catch (Datastore::ErrorType &err) {
+            throw Error(err, Error::Type::DATASTORE);
+        }
+    }
+
+}
@@ -0,0 +1,72 @@
+/*
+ *  Copyright (C) 2018, Throughwave (Thailand) Co., Ltd.
+ *  <peerawich at throughwave dot co dot th>
+ *
+ *  This file is part of libnogdb, the NogDB core library in C++.
+ *
+ *  libnogdb is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef __BULK_LOADER_HPP_INCLUDED_
+#define __BULK_LOADER_HPP_INCLUDED_
+
+#include <string>
+#include <vector>
+
+#include "../src/graph.hpp"
+
+#include "nogdb_types.h"
+#include "nogdb_txn.h"
+
+namespace nogdb {
+
+    // offline loading of records and relations straight into the datastore for building a new database, which is
+    // only used by nogdb_import (and its tests) and is not a part of the library
+    // NOTE: edges are neither validated against their vertices nor added into the in-memory graph,
+    // so the context must be reopened after loading to rebuild the graph from the relation table
+    // NOTE: each table is written in the order of its keys, in the append mode of lmdb wherever possible
+    // - class tables: records get position ids after the last one of the class, so they are always appended
+    // - relation table: relations of a batch are sorted and appended when they come after the last one, which holds
+    //   for every batch of edges loaded after the previous one (see appendRelations)
+    // - index tables: entries of a batch are sorted and appended as long as they come after the last entry, or put
+    //   otherwise (see Index::addSortedIndex), so nogdb_import creates new indexes after a whole file is loaded to
+    //   write each of them in one sorted pass instead of merging batches into them
+    // NOTE: a normal read-write txn is used instead of a raw lmdb txn since it holds the writer lock of a context,
+    // which also keeps other writers of the same context out, and has the schema and dbi handles which are needed
+    // for indexing. Nothing is versioned per record because no uncommitted vertices or edges are added to the txn,
+    // so a commit only publishes the datastore txn and a new version id
+    struct BulkLoader {
+        BulkLoader() = delete;
+
+        ~BulkLoader() noexcept = delete;
+
+        // append vertices at the end of the class (with indexing)
+        static std::vector<RecordDescriptor>
+        appendVertices(Txn &txn, const std::string &className, const std::vector<Record> &records);
+
+        // append edges at the end of the class (with indexing) and collect their relations for appendRelations
+        static std::vector<RecordDescriptor>
+        appendEdges(Txn &txn, const std::string &className, const std::vector<EdgeRecord> &edgeRecords,
+                    std::vector<Graph::EdgeRelation> &edgeRelations);
+
+        // write relations ordered by their keys in the relation table
+        // (using the append mode if all of them are after the last relation in the table, which holds for every batch
+        // of a class loaded after the previous one since keys are ordered by class ids and then position ids)
+        static void appendRelations(Txn &txn, std::vector<Graph::EdgeRelation> &edgeRelations);
+    };
+
+}
+
+#endif
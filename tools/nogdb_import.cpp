@@ -0,0 +1,470 @@
+/*
+ *  Copyright (C) 2018, Throughwave (Thailand) Co., Ltd.
+ *  <peerawich at throughwave dot co dot th>
+ *
+ *  This file is part of libnogdb, the NogDB core library in C++.
+ *
+ *  libnogdb is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// nogdb_import: an offline bulk loader which builds a database from CSV/TSV files
+//
+// Each input file starts with a header line of columns in the form of "name:TYPE[:index|:unique]"
+// where TYPE is one of the SQL property types (e.g. INTEGER, TEXT, REAL). Special columns are
+//   @id          an external id of a vertex (vertex files only, unique across all vertex files)
+//   @src, @dst   external ids of source and destination vertices (edge files only, required)
+// Empty fields are left unset. Vertex files must be given before edge files which refer to them.
+
+#include <strings.h>
+
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <functional>
+#include <chrono>
+
+#include "constant.hpp"
+#include "bulk_loader.hpp"
+
+#include "nogdb.h"
+
+namespace {
+
+    struct InputFile {
+        nogdb::ClassType type;
+        std::string className;
+        std::string path;
+    };
+
+    struct Column {
+        std::string name;
+        nogdb::PropertyType type;
+        bool isIndexed;
+        bool isUnique;
+    };
+
+    const std::string ID_COLUMN = "@id";
+    const std::string SRC_COLUMN = "@src";
+    const std::string DST_COLUMN = "@dst";
+    const auto DEFAULT_BATCH_SIZE = size_t{100000};
+
+    void usage(const char *program) {
+        std::cerr << "usage: " << program << " [options] <db_path> (-v <class> <file> | -e <class> <file>)..." << std::endl
+                  << "options:" << std::endl
+                  << "  -f <format>      record format of a new database: sequential (default) or indexed" << std::endl
+                  << "  -s <size_mb>     maximum size of the database in megabytes" << std::endl
+                  << "  -d <delimiter>   field delimiter (default: ',' or a tab for .tsv files)" << std::endl
+                  << "  -b <batch_size>  number of records per transaction (default: " << DEFAULT_BATCH_SIZE << ")"
+                  << std::endl;
+    }
+
+    nogdb::PropertyType toPropertyType(const std::string &typeName) {
+        static const std::map<std::string, nogdb::PropertyType, std::function<bool(const std::string &,
+                                                                                  const std::string &)>> mapType(
+                {
+                        {"TINYINT",           nogdb::PropertyType::TINYINT},
+                        {"UNSIGNED_TINYINT",  nogdb::PropertyType::UNSIGNED_TINYINT},
+                        {"SMALLINT",          nogdb::PropertyType::SMALLINT},
+                        {"UNSIGNED_SMALLINT", nogdb::PropertyType::UNSIGNED_SMALLINT},
+                        {"INTEGER",           nogdb::PropertyType::INTEGER},
+                        {"UNSIGNED_INTEGER",  nogdb::PropertyType::UNSIGNED_INTEGER},
+                        {"BIGINT",            nogdb::PropertyType::BIGINT},
+                        {"UNSIGNED_BIGINT",   nogdb::PropertyType::UNSIGNED_BIGINT},
+                        {"TEXT",              nogdb::PropertyType::TEXT},
+                        {"REAL",              nogdb::PropertyType::REAL},
+                        {"BLOB",              nogdb::PropertyType::BLOB},
+                },
+                [](const std::string &a, const std::string &b) { return strcasecmp(a.c_str(), b.c_str()) < 0; }
+        );
+        auto foundType = mapType.find(typeName);
+        return (foundType != mapType.cend()) ? foundType->second : nogdb::PropertyType::UNDEFINED;
+    }
+
+    // read one record of delimited fields where a quoted field may contain delimiters, newlines and "" escapes
+    bool readFields(std::istream &input, char delimiter, std::vector<std::string> &fields) {
+        fields.clear();
+        auto line = std::string{};
+        if (!std::getline(input, line)) {
+            return false;
+        }
+        auto field = std::string{};
+        auto isQuoted = false;
+        auto i = size_t{0};
+        while (true) {
+            if (i == line.size()) {
+                if (isQuoted && std::getline(input, line)) {
+                    field.push_back('\n');
+                    i = 0;
+                    continue;
+                }
+                break;
+            }
+            auto c = line[i++];
+            if (isQuoted) {
+                if (c == '"') {
+                    if (i < line.size() && line[i] == '"') {
+                        field.push_back('"');
+                        ++i;
+                    } else {
+                        isQuoted = false;
+                    }
+                } else {
+                    field.push_back(c);
+                }
+            } else if (c == '"' && field.empty()) {
+                isQuoted = true;
+            } else if (c == delimiter) {
+                fields.emplace_back(std::move(field));
+                field.clear();
+            } else if (c != '\r' || i != line.size()) {
+                field.push_back(c);
+            }
+        }
+        fields.emplace_back(std::move(field));
+        return true;
+    }
+
+    // parse a whole field as an integer of type T
+    // NOTE: std::invalid_argument or std::out_of_range is thrown if any character is left or a value does not fit
+    template<typename T>
+    T toSigned(const std::string &value) {
+        auto pos = size_t{0};
+        auto result = std::stoll(value, &pos);
+        if (pos != value.size()) {
+            throw std::invalid_argument(value);
+        }
+        if (result < std::numeric_limits<T>::min() || result > std::numeric_limits<T>::max()) {
+            throw std::out_of_range(value);
+        }
+        return static_cast<T>(result);
+    }
+
+    template<typename T>
+    T toUnsigned(const std::string &value) {
+        // std::stoull accepts a minus sign and negates the result
+        if (value.find('-') != std::string::npos) {
+            throw std::out_of_range(value);
+        }
+        auto pos = size_t{0};
+        auto result = std::stoull(value, &pos);
+        if (pos != value.size()) {
+            throw std::invalid_argument(value);
+        }
+        if (result > std::numeric_limits<T>::max()) {
+            throw std::out_of_range(value);
+        }
+        return static_cast<T>(result);
+    }
+
+    double toReal(const std::string &value) {
+        auto pos = size_t{0};
+        auto result = std::stod(value, &pos);
+        if (pos != value.size()) {
+            throw std::invalid_argument(value);
+        }
+        return result;
+    }
+
+    void setValue(nogdb::Record &record, const Column &column, const std::string &value) {
+        switch (column.type) {
+            case nogdb::PropertyType::TINYINT:
+                record.set(column.name, toSigned<int8_t>(value));
+                break;
+            case nogdb::PropertyType::UNSIGNED_TINYINT:
+                record.set(column.name, toUnsigned<uint8_t>(value));
+                break;
+            case nogdb::PropertyType::SMALLINT:
+                record.set(column.name, toSigned<int16_t>(value));
+                break;
+            case nogdb::PropertyType::UNSIGNED_SMALLINT:
+                record.set(column.name, toUnsigned<uint16_t>(value));
+                break;
+            case nogdb::PropertyType::INTEGER:
+                record.set(column.name, toSigned<int32_t>(value));
+                break;
+            case nogdb::PropertyType::UNSIGNED_INTEGER:
+                record.set(column.name, toUnsigned<uint32_t>(value));
+                break;
+            case nogdb::PropertyType::BIGINT:
+                record.set(column.name, toSigned<int64_t>(value));
+                break;
+            case nogdb::PropertyType::UNSIGNED_BIGINT:
+                record.set(column.name, toUnsigned<uint64_t>(value));
+                break;
+            case nogdb::PropertyType::REAL:
+                record.set(column.name, toReal(value));
+                break;
+            default:
+                record.set(column.name, value);
+                break;
+        }
+    }
+
+    class Importer {
+    public:
+        Importer(nogdb::Context &ctx, char delimiter, size_t batchSize)
+                : ctx_{ctx}, delimiter_{delimiter}, batchSize_{batchSize} {}
+
+        void load(const InputFile &inputFile) {
+            auto input = std::ifstream{inputFile.path};
+            if (!input) {
+                throw std::runtime_error("cannot open " + inputFile.path);
+            }
+            auto delimiter = delimiter_;
+            if (delimiter == '\0') {
+                auto isTsv = inputFile.path.size() >= 4 &&
+                             strcasecmp(inputFile.path.c_str() + inputFile.path.size() - 4, ".tsv") == 0;
+                delimiter = isTsv ? '\t' : ',';
+            }
+            auto fields = std::vector<std::string>{};
+            if (!readFields(input, delimiter, fields)) {
+                throw std::runtime_error("missing a header line in " + inputFile.path);
+            }
+            auto columns = std::vector<Column>{};
+            auto idColumn = -1, srcColumn = -1, dstColumn = -1;
+            for (auto i = 0; i < static_cast<int>(fields.size()); ++i) {
+                if (fields[i] == ID_COLUMN) {
+                    idColumn = i;
+                } else if (fields[i] == SRC_COLUMN) {
+                    srcColumn = i;
+                } else if (fields[i] == DST_COLUMN) {
+                    dstColumn = i;
+                }
+                columns.emplace_back(parseColumn(fields[i], inputFile.path));
+            }
+            auto isEdge = inputFile.type == nogdb::ClassType::EDGE;
+            if (isEdge && (srcColumn < 0 || dstColumn < 0)) {
+                throw std::runtime_error("missing @src or @dst columns in " + inputFile.path);
+            }
+            auto indexedColumns = createSchema(inputFile, columns);
+
+            auto records = std::vector<nogdb::Record>{};
+            auto edgeRecords = std::vector<nogdb::EdgeRecord>{};
+            auto externalIds = std::vector<std::string>{};
+            auto lineNumber = size_t{1};
+            auto numRecords = size_t{0};
+            auto flush = [&]() {
+                auto txn = nogdb::Txn{ctx_, nogdb::Txn::Mode::READ_WRITE};
+                if (isEdge) {
+                    // relations of a batch are written with its edges so that only a batch of them is kept in memory
+                    auto edgeRelations = std::vector<nogdb::Graph::EdgeRelation>{};
+                    nogdb::BulkLoader::appendEdges(txn, inputFile.className, edgeRecords, edgeRelations);
+                    nogdb::BulkLoader::appendRelations(txn, edgeRelations);
+                    numRelations_ += edgeRelations.size();
+                } else {
+                    auto result = nogdb::BulkLoader::appendVertices(txn, inputFile.className, records);
+                    for (auto i = size_t{0}; i < externalIds.size(); ++i) {
+                        if (!externalIds[i].empty() && !vertices_.emplace(externalIds[i], result[i]).second) {
+                            throw std::runtime_error("duplicate vertex id '" + externalIds[i] + "'");
+                        }
+                    }
+                }
+                txn.commit();
+                numRecords += isEdge ? edgeRecords.size() : records.size();
+                records.clear();
+                edgeRecords.clear();
+                externalIds.clear();
+            };
+            while (readFields(input, delimiter, fields)) {
+                ++lineNumber;
+                if (fields.size() == 1 && fields[0].empty()) {
+                    continue;
+                }
+                if (fields.size() != columns.size()) {
+                    throw std::runtime_error(inputFile.path + ":" + std::to_string(lineNumber) +
+                                             ": expected " + std::to_string(columns.size()) + " fields");
+                }
+                auto record = nogdb::Record{};
+                for (auto i = size_t{0}; i < columns.size(); ++i) {
+                    if (columns[i].type != nogdb::PropertyType::UNDEFINED && !fields[i].empty()) {
+                        try {
+                            setValue(record, columns[i], fields[i]);
+                        } catch (const std::logic_error &) {
+                            throw std::runtime_error(inputFile.path + ":" + std::to_string(lineNumber) +
+                                                     ": invalid value of " + columns[i].name);
+                        }
+                    }
+                }
+                if (isEdge) {
+                    edgeRecords.emplace_back(findVertex(fields[srcColumn]), findVertex(fields[dstColumn]),
+                                             std::move(record));
+                } else {
+                    records.emplace_back(std::move(record));
+                    externalIds.emplace_back((idColumn >= 0) ? fields[idColumn] : std::string{});
+                }
+                if (records.size() + edgeRecords.size() >= batchSize_) {
+                    flush();
+                }
+            }
+            if (!records.empty() || !edgeRecords.empty()) {
+                flush();
+            }
+            for (const auto &column: indexedColumns) {
+                nogdb::Property::createIndex(ctx_, inputFile.className, column.name, column.isUnique);
+            }
+            std::cout << inputFile.path << ": " << numRecords << (isEdge ? " edges" : " vertices")
+                      << " loaded into " << inputFile.className << std::endl;
+        }
+
+        size_t getNumRelations() const { return numRelations_; }
+
+    private:
+        nogdb::Context &ctx_;
+        char delimiter_;
+        size_t batchSize_;
+        std::unordered_map<std::string, nogdb::RecordDescriptor> vertices_{};
+        size_t numRelations_{0};
+
+        Column parseColumn(const std::string &header, const std::string &path) {
+            if (!header.empty() && header[0] == '@') {
+                return Column{header, nogdb::PropertyType::UNDEFINED, false, false};
+            }
+            auto parts = std::vector<std::string>{};
+            auto start = size_t{0};
+            for (auto pos = header.find(':'); pos != std::string::npos; pos = header.find(':', start)) {
+                parts.emplace_back(header.substr(start, pos - start));
+                start = pos + 1;
+            }
+            parts.emplace_back(header.substr(start));
+            auto column = Column{parts[0], nogdb::PropertyType::UNDEFINED, false, false};
+            if (parts.size() >= 2) {
+                column.type = toPropertyType(parts[1]);
+            }
+            if (parts.size() >= 3) {
+                column.isIndexed = strcasecmp(parts[2].c_str(), "index") == 0 ||
+                                   strcasecmp(parts[2].c_str(), "unique") == 0;
+                column.isUnique = strcasecmp(parts[2].c_str(), "unique") == 0;
+            }
+            if (column.name.empty() || column.type == nogdb::PropertyType::UNDEFINED || parts.size() > 3 ||
+                (parts.size() == 3 && !column.isIndexed)) {
+                throw std::runtime_error("invalid column '" + header + "' in " + path);
+            }
+            return column;
+        }
+
+        // create a class and its properties if they do not exist yet, and return columns whose indexes do not exist
+        // NOTE: those indexes are created after loading so that each of them is written in one sorted pass
+        std::vector<Column> createSchema(const InputFile &inputFile, const std::vector<Column> &columns) {
+            auto txn = nogdb::Txn{ctx_, nogdb::Txn::Mode::READ_WRITE};
+            auto properties = nogdb::ClassProperty{};
+            try {
+                properties = nogdb::Db::getSchema(txn, inputFile.className).properties;
+            } catch (const nogdb::Error &err) {
+                if (err.code() != CTX_NOEXST_CLASS) {
+                    throw;
+                }
+                nogdb::Class::create(txn, inputFile.className, inputFile.type);
+            }
+            auto indexedColumns = std::vector<Column>{};
+            for (const auto &column: columns) {
+                if (column.type == nogdb::PropertyType::UNDEFINED) {
+                    continue;
+                }
+                auto foundProperty = properties.find(column.name);
+                if (foundProperty == properties.cend()) {
+                    nogdb::Property::add(txn, inputFile.className, column.name, column.type);
+                    if (column.isIndexed) {
+                        indexedColumns.push_back(column);
+                    }
+                } else if (column.isIndexed && foundProperty->second.indexInfo.empty()) {
+                    indexedColumns.push_back(column);
+                }
+            }
+            txn.commit();
+            return indexedColumns;
+        }
+
+        const nogdb::RecordDescriptor &findVertex(const std::string &externalId) const {
+            auto foundVertex = vertices_.find(externalId);
+            if (foundVertex == vertices_.cend()) {
+                throw std::runtime_error("unknown vertex id '" + externalId + "'");
+            }
+            return foundVertex->second;
+        }
+    };
+
+}
+
+int main(int argc, char *argv[]) {
+    auto recordFormat = nogdb::RecordFormat::SEQUENTIAL;
+    auto maxDbSize = nogdb::MAX_DB_SIZE;
+    auto delimiter = '\0';
+    auto batchSize = DEFAULT_BATCH_SIZE;
+    auto dbPath = std::string{};
+    auto inputFiles = std::vector<InputFile>{};
+    for (auto i = 1; i < argc; ++i) {
+        auto arg = std::string{argv[i]};
+        auto hasValues = [&](int numValues) { return i + numValues < argc; };
+        if (arg == "-f" && hasValues(1)) {
+            auto format = std::string{argv[++i]};
+            if (format == "indexed") {
+                recordFormat = nogdb::RecordFormat::INDEXED;
+            } else if (format != "sequential") {
+                usage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "-s" && hasValues(1)) {
+            maxDbSize = std::strtoul(argv[++i], nullptr, 10) * 1024UL * 1024UL;
+        } else if (arg == "-d" && hasValues(1)) {
+            auto value = std::string{argv[++i]};
+            delimiter = (value == "\\t") ? '\t' : value[0];
+        } else if (arg == "-b" && hasValues(1)) {
+            batchSize = std::strtoul(argv[++i], nullptr, 10);
+        } else if ((arg == "-v" || arg == "-e") && hasValues(2)) {
+            auto type = (arg == "-v") ? nogdb::ClassType::VERTEX : nogdb::ClassType::EDGE;
+            inputFiles.emplace_back(InputFile{type, argv[i + 1], argv[i + 2]});
+            i += 2;
+        } else if (arg[0] != '-' && dbPath.empty()) {
+            dbPath = arg;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (dbPath.empty() || inputFiles.empty() || maxDbSize == 0 || batchSize == 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    try {
+        auto start = std::chrono::steady_clock::now();
+        {
+            auto ctx = nogdb::Context{dbPath, nogdb::MAX_DB_NUM, maxDbSize, recordFormat};
+            auto importer = Importer{ctx, delimiter, batchSize};
+            for (const auto &inputFile: inputFiles) {
+                importer.load(inputFile);
+            }
+            std::cout << importer.getNumRelations() << " relations written" << std::endl;
+        }
+        // reopen the database to make sure that the graph can be rebuilt from the loaded relations
+        auto ctx = nogdb::Context{dbPath};
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start).count();
+        std::cout << "done in " << elapsed << " ms" << std::endl;
+    } catch (const nogdb::Error &err) {
+        std::cerr << "error: " << err.what() << std::endl;
+        return 1;
+    } catch (const std::exception &err) {
+        std::cerr << "error: " << err.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}